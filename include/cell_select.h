@@ -0,0 +1,103 @@
+/**
+ * @file cell_select.h
+ * @brief Left stick → grid cell, with hysteresis, filtering and calibration
+ *
+ * Two layouts:
+ *   square  — each axis is split into three bands; cell = row * 3 + col
+ *   radial  — a neutral disc for the center cell and eight 45° sectors
+ *
+ * A stick near a boundary no longer flickers between neighbours: leaving
+ * the current cell takes `hysteresis` extra stick units of travel. Raw
+ * samples can pass through a one-pole low-pass filter first (off by
+ * default); it steps by elapsed time, not by sample, so the lag does not
+ * depend on the poll rate, and a button edge snaps it to the raw stick
+ * so a flick and press in one sample picks the cell flicked to. The rest
+ * position and dead zone are measured from the pad during the session's
+ * grace period, so a drifting or noisy stick keeps a clean neutral.
+ *
+ * Square mode is one table lookup per axis; the tables are rebuilt only
+ * when the configuration or calibration changes.
+ */
+
+#ifndef CELL_SELECT_H
+#define CELL_SELECT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ─── Defaults (Makefile CELL_MODE, or override with -D) ──────────── */
+
+#define TG_CELLSEL_SQUARE  0
+#define TG_CELLSEL_RADIAL  1
+
+#ifndef TG_CELLSEL_MODE
+#define TG_CELLSEL_MODE          TG_CELLSEL_SQUARE
+#endif
+#define TG_CELLSEL_DEAD_ZONE     50  /* neutral half-width / radius from rest */
+#define TG_CELLSEL_HYSTERESIS     8  /* travel past a boundary to switch cells */
+#ifndef TG_CELLSEL_FILTER_SHIFT
+#define TG_CELLSEL_FILTER_SHIFT   0  /* each step moves 1/2^n of the way; 0 = off */
+#endif
+#define TG_CELLSEL_FILTER_STEP_US 4000  /* filter step period */
+#define TG_CELLSEL_FILTER_STEPS_MAX  8  /* a longer gap restarts at the raw stick */
+
+/* Calibration: samples this close to 128 count towards the rest position */
+#define TG_CELLSEL_CAL_RANGE     32
+#define TG_CELLSEL_CAL_MIN        8  /* samples needed before it is applied */
+#define TG_CELLSEL_DEAD_ZONE_MAX 100
+
+/* ─── Types ───────────────────────────────────────────────────────── */
+
+typedef struct TgCellSelConfig {
+    uint8_t mode;               /* TG_CELLSEL_SQUARE / TG_CELLSEL_RADIAL */
+    uint8_t dead_zone;          /* minimum neutral size, stick units */
+    uint8_t hysteresis;         /* stick units, 0 = none */
+    uint8_t filter_shift;       /* 0 = no filtering */
+} TgCellSelConfig;
+
+typedef struct TgCellSelect {
+    TgCellSelConfig cfg;
+    int32_t  cell;              /* current cell, 0-8 */
+
+    /* Calibrated rest position and effective dead zone */
+    uint8_t  center_x;
+    uint8_t  center_y;
+    uint8_t  dead_zone;
+
+    /* Low-pass filter state, Q8 stick units, stepped up to filt_us */
+    int32_t  filt_x;
+    int32_t  filt_y;
+    uint64_t filt_us;
+
+    /* Calibration accumulators */
+    bool     cal_done;
+    uint32_t cal_n;
+    uint32_t cal_sum_x, cal_sum_y;
+    uint8_t  cal_min_x, cal_max_x;
+    uint8_t  cal_min_y, cal_max_y;
+
+    /* Square mode: [current band][stick value] -> next band (0-2) */
+    uint8_t  band_x[3][256];
+    uint8_t  band_y[3][256];
+} TgCellSelect;
+
+/* ─── API ─────────────────────────────────────────────────────────── */
+
+/** Reset to the center cell with @p cfg, or the defaults when NULL. */
+void    cell_select_init(TgCellSelect *cs, const TgCellSelConfig *cfg);
+
+/**
+ * Feed one raw stick sample taken at @p now_us; returns the selected
+ * cell. With @p snap (a button was pressed or released in this
+ * sample) the filter jumps to the raw position.
+ */
+int32_t cell_select_update(TgCellSelect *cs, uint8_t stick_x, uint8_t stick_y,
+                           uint64_t now_us, bool snap);
+
+/** Offer a rest sample for calibration (ignored once it has been applied). */
+void    cell_select_calibrate(TgCellSelect *cs, uint8_t stick_x, uint8_t stick_y);
+
+/** Apply the collected calibration, if there were enough samples. */
+void    cell_select_calibrate_end(TgCellSelect *cs);
+
+#endif /* CELL_SELECT_H */
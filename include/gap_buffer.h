@@ -0,0 +1,82 @@
+/**
+ * @file gap_buffer.h
+ * @brief Chunked UTF-16 gap buffer for the IME text session
+ *
+ * The text is stored with a hole (the gap) at the last edit point:
+ *
+ *   [ text before | ...gap... | text after ]
+ *   0             gap_start   gap_end      capacity
+ *
+ * Inserting or deleting at the gap is O(1). Editing somewhere else first
+ * moves the gap there, copying only the units between the two points, so
+ * a run of edits at one cursor costs O(1) each however long the text is.
+ * Reads go through gap_buffer_at() or gap_buffer_copy(), which hide the
+ * gap; nothing keeps a linear copy up to date between edits.
+ *
+ * The storage is a table of fixed-size chunks taken from a GapPool as
+ * the text grows, never more than the buffer's limit needs. Positions
+ * above are indices into the chunks laid end to end. Growing appends
+ * chunks and slides the text after the gap up into them, once per
+ * GAP_CHUNK_UNITS inserted; clearing gives every chunk back.
+ */
+
+#ifndef GAP_BUFFER_H
+#define GAP_BUFFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GAP_CHUNK_SHIFT  8
+#define GAP_CHUNK_UNITS  (1u << GAP_CHUNK_SHIFT)    /* 512 bytes */
+#define GAP_MAX_CHUNKS   16                         /* per buffer */
+#define GAP_MAX_UNITS    (GAP_MAX_CHUNKS * GAP_CHUNK_UNITS)
+#define GAP_POOL_MAX     32
+
+/* Free chunks over an arena owned by the caller */
+typedef struct GapPool {
+    uint16_t *free[GAP_POOL_MAX];
+    uint32_t  free_count;
+} GapPool;
+
+typedef struct GapBuffer {
+    GapPool  *pool;
+    uint16_t *chunk[GAP_MAX_CHUNKS];
+    uint32_t  chunk_count;
+    uint32_t  limit;            /* most units the text may hold */
+    uint32_t  capacity;         /* chunk_count * GAP_CHUNK_UNITS */
+    uint32_t  gap_start;        /* == length of the text before the gap */
+    uint32_t  gap_end;
+} GapBuffer;
+
+/** Hand the @p count chunks of @p arena to @p p, forgetting any it held. */
+void     gap_pool_init(GapPool *p, uint16_t (*arena)[GAP_CHUNK_UNITS], uint32_t count);
+
+/** Empty buffer drawing chunks from @p pool, holding at most @p limit units. */
+void     gap_buffer_init(GapBuffer *g, GapPool *pool, uint32_t limit);
+
+/** Delete the whole text and return its chunks to the pool. */
+void     gap_buffer_clear(GapBuffer *g);
+
+static inline uint32_t gap_buffer_length(const GapBuffer *g) {
+    return g->capacity - (g->gap_end - g->gap_start);
+}
+
+/** Unit at logical index @p i (must be < length). */
+static inline uint16_t gap_buffer_at(const GapBuffer *g, uint32_t i) {
+    uint32_t p = i < g->gap_start ? i : i + (g->gap_end - g->gap_start);
+    return g->chunk[p >> GAP_CHUNK_SHIFT][p & (GAP_CHUNK_UNITS - 1)];
+}
+
+/**
+ * Insert @p n units at @p pos. Returns false, changing nothing, if they
+ * would pass the limit or the pool has run dry.
+ */
+bool     gap_buffer_insert(GapBuffer *g, uint32_t pos, const uint16_t *src, uint32_t n);
+
+/** Delete @p n units from @p pos (clamped to the text). */
+void     gap_buffer_delete(GapBuffer *g, uint32_t pos, uint32_t n);
+
+/** Copy up to @p n units from @p pos into @p dst. Returns the count copied. */
+uint32_t gap_buffer_copy(const GapBuffer *g, uint32_t pos, uint32_t n, uint16_t *dst);
+
+#endif /* GAP_BUFFER_H */
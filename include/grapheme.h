@@ -0,0 +1,73 @@
+/**
+ * @file grapheme.h
+ * @brief Grapheme cluster boundaries (UAX #29) over UTF-16 text
+ *
+ * Editing steps by user-perceived character: a surrogate pair, a base
+ * letter with its combining marks, a Hangul syllable, an emoji ZWJ
+ * sequence or a flag is one cursor step and one backspace.
+ *
+ * Break properties come from a two-stage table generated from the
+ * Unicode data files by tools/gbtable (src/grapheme_table.c): the high
+ * bits of a code point pick a block, the low bits an entry in it, and
+ * identical blocks are stored once. A lookup is two loads.
+ *
+ * A lone surrogate counts as a control character, so it forms a
+ * cluster of its own and can be deleted.
+ */
+
+#ifndef GRAPHEME_H
+#define GRAPHEME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gap_buffer.h"
+
+/* Grapheme_Cluster_Break values; GRAPHEME_PICTO is or'ed in */
+typedef enum GraphemeProp {
+    GRAPHEME_OTHER = 0,
+    GRAPHEME_CR,
+    GRAPHEME_LF,
+    GRAPHEME_CONTROL,
+    GRAPHEME_EXTEND,
+    GRAPHEME_ZWJ,
+    GRAPHEME_RI,                /* Regional_Indicator */
+    GRAPHEME_PREPEND,
+    GRAPHEME_SPACING_MARK,
+    GRAPHEME_L,                 /* Hangul jamo and syllables */
+    GRAPHEME_V,
+    GRAPHEME_T,
+    GRAPHEME_LV,
+    GRAPHEME_LVT,
+    GRAPHEME_PROP_COUNT,
+} GraphemeProp;
+
+#define GRAPHEME_PICTO      0x10    /* Extended_Pictographic */
+#define GRAPHEME_PROP_MASK  0x0F
+
+#define GRAPHEME_SHIFT      7       /* code points per block = 1 << SHIFT */
+#define GRAPHEME_BLOCKS     (0x110000 >> GRAPHEME_SHIFT)
+
+/* Generated tables (src/grapheme_table.c) */
+extern const uint8_t grapheme_stage1[GRAPHEME_BLOCKS];
+extern const uint8_t grapheme_stage2[];
+
+/** Break property of code point @p cp (<= 0x10FFFF), with GRAPHEME_PICTO. */
+static inline uint8_t grapheme_prop(uint32_t cp) {
+    uint32_t block = grapheme_stage1[cp >> GRAPHEME_SHIFT];
+    return grapheme_stage2[(block << GRAPHEME_SHIFT) | (cp & ((1u << GRAPHEME_SHIFT) - 1))];
+}
+
+/** True if a cluster may begin at unit @p pos (0 and the length always). */
+bool     grapheme_is_boundary(const GapBuffer *g, uint32_t pos);
+
+/** The last boundary before @p pos, or 0. */
+uint32_t grapheme_before(const GapBuffer *g, uint32_t pos);
+
+/** The first boundary after @p pos, or the length. */
+uint32_t grapheme_after(const GapBuffer *g, uint32_t pos);
+
+/** Longest prefix of @p src[0..n) ending on a cluster boundary, at most @p max. */
+uint32_t grapheme_fit(const uint16_t *src, uint32_t n, uint32_t max);
+
+#endif /* GRAPHEME_H */
@@ -9,7 +9,11 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-#define IME_MAX_OUTPUT_LENGTH  256
+#include "gap_buffer.h"
+#include "ime_journal.h"
+#include "word_index.h"
+
+#define IME_MAX_OUTPUT_LENGTH  GAP_MAX_UNITS   /* 4096; longer limits are clamped */
 #define IME_MAX_CHARSET_SIZE   96
 
 static const char IME_DEFAULT_CHARSET[] =
@@ -44,8 +48,11 @@ typedef struct ImeSession {
     const char    *charset;
     uint32_t       charset_length;
     uint32_t       cursor_index;
-    uint16_t       output[IME_MAX_OUTPUT_LENGTH];
-    uint32_t       output_length;
+    /* Text: a gap buffer kept at the last edit, growing a chunk at a time
+     * up to max_output_length. Read it with ime_session_char_at() or
+     * ime_session_get_text(). */
+    GapBuffer      text;
+    uint32_t       output_length;  /* text length in UTF-16 units */
     uint32_t       max_output_length;
     uint32_t       text_cursor;    /* position within output buffer, 0 to output_length */
     bool           selected_all;   /* true = all text selected, next input replaces */
@@ -58,23 +65,62 @@ typedef struct ImeSession {
     ImeCycleConfig cycle_config;
     uint16_t      *caller_buffer;
     int32_t        panel_type;
-    /* Internal clipboard for cut/copy/paste */
-    uint16_t       clipboard[IME_MAX_OUTPUT_LENGTH];
+    /* Clipboard for cut/copy/paste, chunked like the text: what was
+     * copied in this session, or the history entry being pasted */
+    GapBuffer      clipboard;
     uint32_t       clipboard_length;
+    /* The last paste, which ime_session_paste_older() may replace */
+    bool           paste_valid;
+    uint32_t       paste_start;
+    uint32_t       paste_end;
+    uint32_t       paste_age;      /* history entry pasted, 0 = newest */
+    uint32_t       paste_op;       /* journal op count just after it */
+    /* Undo/redo history of the text edits above */
+    ImeJournal     journal;
+    /* Where words start, for word-wise movement and deletion */
+    WordIndex      words;
+    /* Latency trace id of the input that produced the current state
+     * (0 = none or tracing compiled out); published over IPC */
+    uint32_t       input_seq;
 } ImeSession;
 
+struct TgClipStore;
+
+/*
+ * Clipboard history shared across dialogs and games (thumbgrid_ipc.h),
+ * or NULL to keep copies within the session. Copy and cut push to it,
+ * paste takes its newest entry.
+ */
+void    ime_clipboard_attach(volatile struct TgClipStore *store);
+
+/*
+ * Text and clipboard chunks come from one pool sized for both at the
+ * longest limit, which ime_session_init() refills: one session at a time.
+ */
 int32_t ime_session_init(ImeSession *session, int32_t panel_type,
     uint32_t max_length, uint16_t *caller_buffer, const uint16_t *prefill);
 void    ime_session_cycle(ImeSession *session, int8_t delta);
 bool    ime_session_confirm_char(ImeSession *session);
 bool    ime_session_add_char(ImeSession *session, char c);
 bool    ime_session_add_char16(ImeSession *session, uint16_t c);
+bool    ime_session_add_text(ImeSession *session, const uint16_t *text, uint32_t n);
+bool    ime_session_replace_before(ImeSession *session, uint32_t del,
+            const uint16_t *text, uint32_t n);
 bool    ime_session_backspace(ImeSession *session);
+bool    ime_session_delete_word(ImeSession *session);
 void    ime_session_select_all(ImeSession *session);
 void    ime_session_cursor_left(ImeSession *session);
 void    ime_session_cursor_right(ImeSession *session);
 void    ime_session_cursor_home(ImeSession *session);
 void    ime_session_cursor_end(ImeSession *session);
+void    ime_session_word_left(ImeSession *session);
+void    ime_session_word_right(ImeSession *session);
+/* Cluster boundary before / after pos (pos itself at either end) */
+uint32_t ime_session_cluster_before(const ImeSession *session, uint32_t pos);
+uint32_t ime_session_cluster_after(const ImeSession *session, uint32_t pos);
+/* Start of the word before pos / of the next word after pos (or the end) */
+uint32_t ime_session_word_before(const ImeSession *session, uint32_t pos);
+uint32_t ime_session_word_after(const ImeSession *session, uint32_t pos);
 void    ime_session_delete_selection(ImeSession *session);
 void    ime_session_set_selection(ImeSession *session, uint32_t start, uint32_t end);
 void    ime_session_clear_selection(ImeSession *session);
@@ -83,9 +129,21 @@ void    ime_session_cancel(ImeSession *session);
 void    ime_session_copy(ImeSession *session);
 void    ime_session_cut(ImeSession *session);
 void    ime_session_paste(ImeSession *session);
+/* Right after a paste: replace it with the next older history entry */
+void    ime_session_paste_older(ImeSession *session);
+bool    ime_session_undo(ImeSession *session);
+bool    ime_session_redo(ImeSession *session);
 char    ime_session_current_char(const ImeSession *session);
 void    ime_session_get_neighbors(const ImeSession *session,
             char *prev_out, char *next_out);
 void    ime_session_update_timing(ImeSession *session, uint64_t current_us);
 
+/* Copy the text into dst (up to dst_len - 1 units) and NUL-terminate it */
+uint32_t ime_session_get_text(const ImeSession *session, uint16_t *dst, uint32_t dst_len);
+
+/* Text unit at index i (< output_length) */
+static inline uint16_t ime_session_char_at(const ImeSession *session, uint32_t i) {
+    return gap_buffer_at(&session->text, i);
+}
+
 #endif /* IME_CUSTOM_H */
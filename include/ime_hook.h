@@ -9,6 +9,15 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/*
+ * Input thread rate (Makefile INPUT_THREAD_HZ). 0 reads the pad only when
+ * the game calls sceImeDialogGetStatus; a rate such as 250 samples it on
+ * a dedicated thread instead, so taps between slow game polls still land.
+ */
+#ifndef TG_INPUT_THREAD_HZ
+#define TG_INPUT_THREAD_HZ 0
+#endif
+
 /* ─── System Module IDs ───────────────────────────────────────────── */
 
 #define SCE_SYSMODULE_IME_DIALOG               0x0096
@@ -36,6 +45,18 @@ typedef enum OrbisImePanelType {
     ORBIS_IME_PANEL_TYPE_NUMBER      = 4,
 } OrbisImePanelType;
 
+/* OrbisImeDialogParam.option bits */
+typedef enum OrbisImeOption {
+    ORBIS_IME_OPTION_DEFAULT                = 0x00,
+    ORBIS_IME_OPTION_MULTILINE              = 0x01,
+    ORBIS_IME_OPTION_NO_AUTO_CAPITALIZATION = 0x02,
+    ORBIS_IME_OPTION_PASSWORD               = 0x04,
+    ORBIS_IME_OPTION_LANGUAGES_FORCED       = 0x08,
+    ORBIS_IME_OPTION_EXT_KEYBOARD           = 0x10,
+    ORBIS_IME_OPTION_NO_LEARNING            = 0x20,
+    ORBIS_IME_OPTION_FIXED_POSITION         = 0x40,
+} OrbisImeOption;
+
 /* ─── IME Dialog Structures ───────────────────────────────────────── */
 
 /*
@@ -0,0 +1,84 @@
+/**
+ * @file ime_journal.h
+ * @brief Undo/redo journal of text edits
+ *
+ * Each edit is recorded as an operation, not a snapshot: where it
+ * happened and the units it inserted or deleted, so recording costs
+ * only the size of the edit. Consecutive typed characters extend one
+ * insert until the word ends (a space is followed by a non-space), the
+ * cursor moves, or it reaches IME_JOURNAL_COALESCE_MAX; a run of
+ * backspaces, a cluster each, grows one delete the same way. An edit that replaces a
+ * selection is a delete plus an insert joined into one undo step.
+ *
+ * Operations and their text live in two fixed rings inside the session.
+ * When either fills, the oldest operations are dropped; an edit too big
+ * for the text ring clears the journal, since older steps could no
+ * longer be replayed over it. A new edit discards anything undone.
+ */
+
+#ifndef IME_JOURNAL_H
+#define IME_JOURNAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gap_buffer.h"
+
+#define IME_JOURNAL_OPS           64    /* power of two */
+#define IME_JOURNAL_UNITS       4096    /* power of two */
+#define IME_JOURNAL_COALESCE_MAX  32    /* units per coalesced op */
+
+typedef enum ImeJournalKind {
+    IME_JOURNAL_INSERT = 0,
+    IME_JOURNAL_DELETE,
+} ImeJournalKind;
+
+typedef struct ImeJournalOp {
+    uint32_t pos;
+    uint32_t len;
+    uint32_t text;              /* first payload unit, as a running count */
+    uint8_t  kind;              /* ImeJournalKind */
+    uint8_t  joined;            /* undone and redone with the op before */
+    uint8_t  reversed;          /* payload runs backward (backspaces) */
+    uint8_t  reserved;
+} ImeJournalOp;
+
+typedef struct ImeJournal {
+    ImeJournalOp ops[IME_JOURNAL_OPS];
+    uint16_t     units[IME_JOURNAL_UNITS];
+    uint32_t     first;         /* running index of the oldest op */
+    uint32_t     applied;       /* ops from first that are in the text */
+    uint32_t     count;         /* ops held; past applied they can be redone */
+    uint32_t     unit_head;     /* running count of payload units written */
+    bool         sealed;        /* next edit starts a new op */
+} ImeJournal;
+
+_Static_assert((IME_JOURNAL_OPS & (IME_JOURNAL_OPS - 1)) == 0, "IME_JOURNAL_OPS");
+_Static_assert((IME_JOURNAL_UNITS & (IME_JOURNAL_UNITS - 1)) == 0, "IME_JOURNAL_UNITS");
+
+void ime_journal_reset(ImeJournal *j);
+
+/** Stop coalescing into the last op (the cursor moved). */
+static inline void ime_journal_seal(ImeJournal *j) {
+    j->sealed = true;
+}
+
+/*
+ * Record an edit of @p n units at @p pos of @p g: call insert just after
+ * inserting, delete just before deleting. A joined edit is undone
+ * together with the one recorded before it.
+ */
+void ime_journal_insert(ImeJournal *j, const GapBuffer *g, uint32_t pos,
+                        uint32_t n, bool joined);
+
+void ime_journal_delete(ImeJournal *j, const GapBuffer *g, uint32_t pos,
+                        uint32_t n, bool joined);
+
+/**
+ * Revert the last step in @p g, or reapply the last undone one. Returns
+ * false if there is none; otherwise @p cursor is where the edit ended.
+ */
+bool ime_journal_undo(ImeJournal *j, GapBuffer *g, uint32_t *cursor);
+bool ime_journal_redo(ImeJournal *j, GapBuffer *g, uint32_t *cursor);
+
+#endif /* IME_JOURNAL_H */
@@ -11,6 +11,7 @@
 
 /* PS4 button masks */
 #define PAD_BUTTON_L3         0x00000002
+#define PAD_BUTTON_R3         0x00000004
 #define PAD_BUTTON_OPTIONS    0x00000008
 #define PAD_BUTTON_UP         0x00000010
 #define PAD_BUTTON_RIGHT      0x00000020
@@ -40,8 +41,18 @@ typedef enum ImeAction {
     IME_ACTION_PAGE_NEXT,
     IME_ACTION_PAGE_PREV,
     IME_ACTION_CANCEL,
+    IME_ACTION_ACCEPT_WORD,
 } ImeAction;
 
+/* One action from a button edge, stamped with its sample's time */
+typedef struct InputEvent {
+    ImeAction action;
+    uint64_t  timestamp_us;
+} InputEvent;
+
+/* Upper bound on events from one sample (one per mapped button) */
+#define INPUT_MAX_EVENTS  12
+
 typedef struct InputState {
     uint32_t buttons_current;
     uint32_t buttons_previous;
@@ -58,7 +69,8 @@ void      input_update(InputState *state, uint32_t raw_buttons,
                        uint8_t stick_x, uint8_t stick_y,
                        uint8_t rstick_x, uint8_t rstick_y,
                        uint64_t timestamp_us);
-ImeAction input_get_action(const InputState *state);
+uint32_t  input_get_actions(const InputState *state, InputEvent *out,
+                            uint32_t max_events);
 bool      input_just_pressed(const InputState *state, uint32_t button);
 bool      input_is_held(const InputState *state, uint32_t button);
 
@@ -0,0 +1,81 @@
+/**
+ * @file log_ring.h
+ * @brief Asynchronous per-thread log rings with a background flusher
+ *
+ * Shared by both PRXes. Callers never format or do I/O: a log call
+ * copies the format pointer and its raw arguments into the calling
+ * thread's ring, and a flusher thread formats and hands batches to the
+ * module's sink (klog printf in the game, a file in SceShellUI).
+ */
+
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ─── Levels ──────────────────────────────────────────────────────── */
+
+#define TG_LOG_LVL_NONE   0
+#define TG_LOG_LVL_ERROR  1
+#define TG_LOG_LVL_WARN   2
+#define TG_LOG_LVL_INFO   3
+#define TG_LOG_LVL_DEBUG  4
+
+/* Calls above this level compile to nothing */
+#ifndef TG_LOG_LEVEL
+#define TG_LOG_LEVEL TG_LOG_LVL_DEBUG
+#endif
+
+/* ─── Sizing ──────────────────────────────────────────────────────── */
+
+#define LOG_RING_THREADS      8     /* distinct logging threads */
+#define LOG_RING_SLOTS        32    /* records per thread (power of 2) */
+#define LOG_RING_ARG_BYTES    192   /* encoded arguments per record */
+#define LOG_RING_FLUSH_US     50000 /* flusher period */
+
+/* Receives one batch of formatted lines */
+typedef void (*LogSinkFn)(const char *buf, size_t len, void *ctx);
+
+/* ─── API ─────────────────────────────────────────────────────────── */
+
+/**
+ * Start the flusher thread. Records emitted before this call are kept
+ * (up to the ring capacity) and written on the first flush.
+ */
+int      log_ring_init(LogSinkFn sink, void *ctx);
+
+/** Stop the flusher and write everything still queued. */
+void     log_ring_shutdown(void);
+
+/** Drain all rings to the sink now, from the calling thread. */
+void     log_ring_flush(void);
+
+/**
+ * Queue one record. @p fmt must be a string literal (the macros
+ * guarantee this); only its pointer is stored.
+ */
+void     log_ring_emit(const char *fmt, ...)
+    __attribute__((format(printf, 1, 2)));
+
+/**
+ * Give the calling thread's ring back now, so another thread can claim
+ * it. Records still queued are flushed as usual. Rings are also given
+ * back when their thread exits, so threads need not call this.
+ */
+void     log_ring_thread_exit(void);
+
+/** Records lost to full rings or thread-table exhaustion. */
+uint32_t log_ring_dropped(void);
+
+/*
+ * Level-gated emit. A disabled level still type-checks its arguments
+ * but generates no code.
+ */
+#define LOG_RING_AT(lvl, fmt, ...)                                  \
+    do {                                                            \
+        if ((lvl) <= TG_LOG_LEVEL)                                  \
+            log_ring_emit(fmt, ##__VA_ARGS__);                      \
+    } while (0)
+
+#endif /* LOG_RING_H */
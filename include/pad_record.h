@@ -0,0 +1,79 @@
+/**
+ * @file pad_record.h
+ * @brief Pad trace recorder and its on-disk format
+ *
+ * With TG_PAD_RECORD=1 (Makefile PAD_RECORD=1) every pad sample the
+ * engine steps on is appended to TG_PADREC_PATH with the time it was
+ * taken; a poll that drains several buffered samples records each of
+ * them at its own time. tools/replay plays the file back through the
+ * same ime_hook.c code on a host with a virtual clock, one sample per
+ * poll, with that time as both the clock and the pad timestamp.
+ *
+ * File layout (little-endian):
+ *   TgPadRecHeader
+ *   uint16_t prefill[header.prefill_len]   caller's initial text
+ *   TgPadRecSample[...]                    until end of file
+ */
+
+#ifndef PAD_RECORD_H
+#define PAD_RECORD_H
+
+#include <stdint.h>
+
+#include <orbis/Pad.h>
+
+#ifndef TG_PAD_RECORD
+#define TG_PAD_RECORD 0
+#endif
+
+#define TG_PADREC_PATH     "/user/data/thumbgrid_pad.rec"
+#define TG_PADREC_MAGIC    0x52504754u  /* "TGPR" */
+#define TG_PADREC_VERSION  1
+
+/* ─── File format ─────────────────────────────────────────────────── */
+
+typedef struct TgPadRecHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t sample_size;       /* sizeof(TgPadRecSample) */
+    int32_t  panel_type;        /* OrbisImeDialogParam.type */
+    uint32_t max_text_length;   /* after the default for 0 was applied */
+    uint16_t prefill_len;       /* UTF-16 units following the header */
+    uint16_t reserved[3];
+} TgPadRecHeader;
+
+#define TG_PADREC_READ_OK  0x01  /* the pad read succeeded */
+
+typedef struct TgPadRecSample {
+    uint32_t t_us;              /* sample time, since sceImeDialogInit */
+    uint32_t buttons;
+    uint8_t  lx, ly;
+    uint8_t  rx, ry;
+    uint8_t  l2, r2;
+    uint8_t  flags;             /* TG_PADREC_* */
+    uint8_t  reserved;
+} TgPadRecSample;
+
+_Static_assert(sizeof(TgPadRecHeader) == 24, "TgPadRecHeader layout");
+_Static_assert(sizeof(TgPadRecSample) == 16, "TgPadRecSample layout");
+
+/* ─── Recorder (pad_record.c) ─────────────────────────────────────── */
+
+void pad_record_begin(int32_t panel_type, uint32_t max_text_length,
+                      const uint16_t *prefill);
+void pad_record_sample(uint64_t t_us, int32_t read_rc,
+                       const OrbisPadData *pad);
+void pad_record_end(void);
+
+#if TG_PAD_RECORD
+#define PAD_REC_BEGIN(type, max_len, prefill) \
+    pad_record_begin((type), (max_len), (prefill))
+#define PAD_REC_SAMPLE(t_us, rc, pad) pad_record_sample((t_us), (rc), (pad))
+#define PAD_REC_END()                 pad_record_end()
+#else
+#define PAD_REC_BEGIN(type, max_len, prefill) do { } while (0)
+#define PAD_REC_SAMPLE(t_us, rc, pad) do { (void)(rc); } while (0)
+#define PAD_REC_END()                 do { } while (0)
+#endif
+
+#endif /* PAD_RECORD_H */
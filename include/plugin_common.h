@@ -37,21 +37,28 @@
 
 /* ─── Logging ─────────────────────────────────────────────────────── */
 
+/*
+ * All four levels go through the asynchronous log ring (log_ring.h):
+ * the call site only copies its arguments, and the flusher thread
+ * writes batches to klog. Levels above TG_LOG_LEVEL compile out.
+ */
+
 #include <stdio.h>
+#include "log_ring.h"
 
 #define LOG_PREFIX "[TGIME] "
 
 #define LOG_INFO(fmt, ...)  \
-    printf(LOG_PREFIX "INFO: " fmt "\n", ##__VA_ARGS__)
+    LOG_RING_AT(TG_LOG_LVL_INFO, LOG_PREFIX "INFO: " fmt "\n", ##__VA_ARGS__)
 
 #define LOG_WARN(fmt, ...)  \
-    printf(LOG_PREFIX "WARN: " fmt "\n", ##__VA_ARGS__)
+    LOG_RING_AT(TG_LOG_LVL_WARN, LOG_PREFIX "WARN: " fmt "\n", ##__VA_ARGS__)
 
 #define LOG_ERROR(fmt, ...) \
-    printf(LOG_PREFIX "ERROR: " fmt "\n", ##__VA_ARGS__)
+    LOG_RING_AT(TG_LOG_LVL_ERROR, LOG_PREFIX "ERROR: " fmt "\n", ##__VA_ARGS__)
 
 #define LOG_DEBUG(fmt, ...) \
-    printf(LOG_PREFIX "DBG: " fmt "\n", ##__VA_ARGS__)
+    LOG_RING_AT(TG_LOG_LVL_DEBUG, LOG_PREFIX "DBG: " fmt "\n", ##__VA_ARGS__)
 
 /* ─── On-Screen Notification (implemented in main.c) ─────────────── */
 
@@ -0,0 +1,153 @@
+/**
+ * @file profile.h
+ * @brief Build-time selectable instrumentation with named probe points
+ *
+ * TG_PROFILE selects what PROF_* macros compile to (Makefile PROFILE=):
+ *   off       nothing — probes, clock reads and reports are removed
+ *   counters  a call counter per probe, reported at session end, plus
+ *             the per-phase latency histograms in the IPC stats page
+ *   trace     counters plus per-span timing, reported once per second,
+ *             and a span ring exportable as a Chrome/Perfetto trace
+ *
+ * A probe is a span between PROF_BEGIN(id) and PROF_END(id) in the
+ * same scope, or a bare event via PROF_COUNT(id). Probes may fire on any
+ * thread and are updated atomically; each report logs only what no
+ * other report has claimed.
+ *
+ * Phases (TgPhase, thumbgrid_ipc.h) are timed with the TSC between
+ * PROF_PHASE_BEGIN/END and recorded into the histogram page attached
+ * with PROF_ATTACH_STATS(); nothing is recorded while detached.
+ *
+ * Input-to-photon tracing (TgTracePage, same profiles as phases):
+ * PROF_LAT_BEGIN() allocates an id for a new input event (or
+ * PROF_LAT_BEGIN_AT_PHASE(ph), stamped when phase ph began), and each
+ * later stage stamps it with PROF_LAT_STAMP(id, stage). The FLIP and
+ * SHELL stamps also feed the input_to_flip / input_to_shell phases.
+ *
+ * In trace mode every PROF_BEGIN/END span is also kept, with its TSC
+ * start time in microseconds and its thread, in a ring of the last PROF_SPAN_RING spans.
+ * PROF_TRACE_DUMP writes that ring as Chrome trace JSON; each PRX dumps
+ * when an IME session ends.
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+
+#include "thumbgrid_ipc.h"
+
+#define TG_PROFILE_OFF       0
+#define TG_PROFILE_COUNTERS  1
+#define TG_PROFILE_TRACE     2
+
+#ifndef TG_PROFILE
+#define TG_PROFILE TG_PROFILE_OFF
+#endif
+
+/* ─── Probe points ────────────────────────────────────────────────── */
+
+typedef enum ProfProbe {
+    /* Game side (thumbgrid_ime.prx) */
+    PROF_IME_POLL = 0,      /* hooked_ime_dialog_get_status, active path */
+    PROF_IME_INPUT,         /* pad read */
+    PROF_IME_STEP,          /* tg_engine_step */
+    PROF_IME_PREDICT,       /* word completion lookup */
+    PROF_IME_IPC_SYNC,      /* ipc_sync_state */
+    PROF_FLIP,              /* hooked_submit_flip, including the original */
+    PROF_FLIP_DRAW,         /* draw callback inside the flip hook */
+    PROF_FORCE_DRAW,        /* overlay_force_draw, all buffers */
+    PROF_DRAW_BACKDROP,     /* thumbgrid_draw sections */
+    PROF_DRAW_TEXTBAR,
+    PROF_DRAW_GRID,
+    PROF_DRAW_STATUS,
+
+    /* Shell side (shell_overlay.prx) */
+    PROF_SHELL_POLL,        /* one poll thread iteration */
+    PROF_SHELL_UPDATE,      /* update_widgets */
+
+    PROF_PROBE_COUNT
+} ProfProbe;
+
+#define PROF_REPORT_INTERVAL_US  1000000
+#define PROF_SPAN_RING           4096     /* trace spans kept (power of 2) */
+
+/* Chrome trace output, one file and process id per PRX */
+#define PROF_PID_GAME   1
+#define PROF_PID_SHELL  2
+#define TG_TRACE_JSON_GAME   "/user/data/thumbgrid_trace_game.json"
+#define TG_TRACE_JSON_SHELL  "/user/data/thumbgrid_trace_shell.json"
+
+/* ─── Runtime (profile.c) ─────────────────────────────────────────── */
+
+uint64_t prof_now_us(void);
+void     prof_count(ProfProbe id);
+void     prof_record(ProfProbe id, uint64_t start_us, uint64_t end_us);
+void     prof_report(const char *tag);
+void     prof_report_periodic(void);
+int      prof_trace_dump(const char *path, int pid);
+
+uint64_t prof_tsc(void);
+void     prof_attach_stats(volatile TgStatsPage *stats);
+void     prof_phase_record(TgPhase phase, uint64_t tsc_ticks);
+
+void     prof_attach_trace(volatile TgTracePage *trace);
+uint32_t prof_lat_begin(uint64_t tsc);
+void     prof_lat_stamp(uint32_t seq, TgLatStage stage, uint64_t tsc);
+void     prof_lat_publish(uint32_t seq);
+void     prof_lat_flip(uint64_t tsc);
+
+/* ─── Probe macros ────────────────────────────────────────────────── */
+
+#if TG_PROFILE >= TG_PROFILE_TRACE
+
+#define PROF_BEGIN(id)   uint64_t prof_t0_##id = prof_now_us()
+#define PROF_END(id)     prof_record((id), prof_t0_##id, prof_now_us())
+#define PROF_COUNT(id)   prof_count(id)
+#define PROF_TICK()      prof_report_periodic()
+#define PROF_SUMMARY(tag) prof_report(tag)
+#define PROF_TRACE_DUMP(path, pid) prof_trace_dump((path), (pid))
+
+#elif TG_PROFILE >= TG_PROFILE_COUNTERS
+
+#define PROF_BEGIN(id)   do { } while (0)
+#define PROF_END(id)     prof_count(id)
+#define PROF_COUNT(id)   prof_count(id)
+#define PROF_TICK()      do { } while (0)
+#define PROF_SUMMARY(tag) prof_report(tag)
+#define PROF_TRACE_DUMP(path, pid) do { } while (0)
+
+#else
+
+#define PROF_BEGIN(id)   do { } while (0)
+#define PROF_END(id)     do { } while (0)
+#define PROF_COUNT(id)   do { } while (0)
+#define PROF_TICK()      do { } while (0)
+#define PROF_SUMMARY(tag) do { } while (0)
+#define PROF_TRACE_DUMP(path, pid) do { } while (0)
+
+#endif
+
+#if TG_PROFILE >= TG_PROFILE_COUNTERS
+#define PROF_ATTACH_STATS(p)  prof_attach_stats(p)
+#define PROF_ATTACH_TRACE(p)  prof_attach_trace(p)
+#define PROF_PHASE_BEGIN(ph)  uint64_t prof_ph_##ph = prof_tsc()
+#define PROF_PHASE_END(ph)    prof_phase_record((ph), prof_tsc() - prof_ph_##ph)
+#define PROF_LAT_BEGIN()      prof_lat_begin(prof_tsc())
+#define PROF_LAT_BEGIN_AT_PHASE(ph) prof_lat_begin(prof_ph_##ph)
+#define PROF_LAT_STAMP(seq, stage) prof_lat_stamp((seq), (stage), prof_tsc())
+#define PROF_LAT_PUBLISH(seq) prof_lat_publish(seq)
+#define PROF_LAT_FLIP()       prof_lat_flip(prof_tsc())
+#else
+#define PROF_ATTACH_STATS(p)  do { (void)(p); } while (0)
+#define PROF_ATTACH_TRACE(p)  do { (void)(p); } while (0)
+#define PROF_PHASE_BEGIN(ph)  do { } while (0)
+#define PROF_PHASE_END(ph)    do { } while (0)
+#define PROF_LAT_BEGIN()      0u
+#define PROF_LAT_BEGIN_AT_PHASE(ph) 0u
+#define PROF_LAT_STAMP(seq, stage) do { (void)(seq); } while (0)
+#define PROF_LAT_PUBLISH(seq) do { (void)(seq); } while (0)
+#define PROF_LAT_FLIP()       do { } while (0)
+#endif
+
+#endif /* PROFILE_H */
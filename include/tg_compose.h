@@ -0,0 +1,116 @@
+/**
+ * @file tg_compose.h
+ * @brief Accent composition: (base letter, diacritic) <-> precomposed letter
+ *
+ * Covers every letter of Latin-1 Supplement and Latin Extended-A
+ * (U+00C0..U+017F) except U+0149, which Unicode deprecates. Letters with
+ * a canonical decomposition compose from their base and mark; the rest
+ * (stroke letters, ligatures, eth, thorn, eng, ...) sit on the STROKE
+ * and OTHER layers under the ASCII letter they are typed from.
+ *
+ * Both directions are O(1) over tables generated by tools/composegen
+ * (src/tg_compose_table.c):
+ *   - decompose: a direct table over the range, one entry per code point.
+ *   - compose: a hash-and-displace perfect hash of (base, diacritic). The
+ *     key's bucket picks a displacement, the displaced hash picks a slot,
+ *     and the slot's entry is checked against the decompose table, so a
+ *     pair with no letter misses without a probe sequence.
+ *
+ * Shared with the shell overlay, which previews the current layer on the
+ * key labels.
+ */
+
+#ifndef TG_COMPOSE_H
+#define TG_COMPOSE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Diacritic layers, in L3 cycle order */
+typedef enum TgDiacritic {
+    TG_DIA_NONE = 0,
+    TG_DIA_ACUTE,               /* U+0301 */
+    TG_DIA_GRAVE,               /* U+0300 */
+    TG_DIA_CIRCUMFLEX,          /* U+0302 */
+    TG_DIA_DIAERESIS,           /* U+0308 */
+    TG_DIA_TILDE,               /* U+0303 */
+    TG_DIA_CEDILLA,             /* U+0327 */
+    TG_DIA_RING,                /* U+030A */
+    TG_DIA_CARON,               /* U+030C */
+    TG_DIA_MACRON,              /* U+0304 */
+    TG_DIA_BREVE,               /* U+0306 */
+    TG_DIA_OGONEK,              /* U+0328 */
+    TG_DIA_DOT,                 /* U+0307 */
+    TG_DIA_DOUBLE_ACUTE,        /* U+030B */
+    TG_DIA_STROKE,              /* đ ħ ł ø ŧ */
+    TG_DIA_OTHER,               /* æ œ ß ð þ ŋ ı ĸ ĳ ŀ ſ */
+    TG_DIA_COUNT,
+} TgDiacritic;
+
+#define TG_COMPOSE_FIRST     0x00C0
+#define TG_COMPOSE_COUNT     192        /* U+00C0..U+017F */
+#define TG_COMPOSE_BUCKETS   64         /* power of two */
+#define TG_COMPOSE_SLOT_BITS 8
+#define TG_COMPOSE_SLOTS     (1u << TG_COMPOSE_SLOT_BITS)
+#define TG_COMPOSE_EMPTY     0xFF
+
+_Static_assert(TG_COMPOSE_COUNT < TG_COMPOSE_EMPTY, "slot entries are uint8_t");
+_Static_assert(TG_DIA_COUNT <= 16, "keys hold the diacritic in 4 bits");
+
+/* Generated tables (src/tg_compose_table.c) */
+extern const uint16_t tg_compose_decomp[TG_COMPOSE_COUNT];  /* base | dia << 8, 0 = none */
+extern const uint8_t  tg_compose_disp[TG_COMPOSE_BUCKETS];
+extern const uint8_t  tg_compose_slot[TG_COMPOSE_SLOTS];    /* decomp index or EMPTY */
+
+/* Perfect-hash key and mixer, shared with the generator */
+static inline uint32_t tg_compose_key(uint32_t base, uint32_t dia) {
+    return base | dia << 7;
+}
+
+static inline uint32_t tg_compose_mix(uint32_t x) {
+    x *= 0x9E3779B1u;
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    return x;
+}
+
+static inline uint32_t tg_compose_bucket(uint32_t key) {
+    return tg_compose_mix(key) & (TG_COMPOSE_BUCKETS - 1);
+}
+
+static inline uint32_t tg_compose_slot_of(uint32_t key, uint32_t disp) {
+    return tg_compose_mix(key | disp << 11) >> (32 - TG_COMPOSE_SLOT_BITS);
+}
+
+/** Letter for ASCII @p base under @p dia, 0 if there is none. */
+static inline uint16_t tg_compose(uint16_t base, uint8_t dia) {
+    if (base >= 0x80 || dia == TG_DIA_NONE || dia >= TG_DIA_COUNT) return 0;
+    uint32_t key = tg_compose_key(base, dia);
+    uint32_t idx = tg_compose_slot[tg_compose_slot_of(key, tg_compose_disp[tg_compose_bucket(key)])];
+    if (idx == TG_COMPOSE_EMPTY || tg_compose_decomp[idx] != (uint16_t)(base | dia << 8))
+        return 0;
+    return (uint16_t)(TG_COMPOSE_FIRST + idx);
+}
+
+/** Base and diacritic of @p ch as base | dia << 8; ASCII is itself, anything else 0. */
+static inline uint16_t tg_decompose(uint16_t ch) {
+    if (ch < 0x80) return ch;
+    if (ch < TG_COMPOSE_FIRST || ch >= TG_COMPOSE_FIRST + TG_COMPOSE_COUNT) return 0;
+    return tg_compose_decomp[ch - TG_COMPOSE_FIRST];
+}
+
+/* ─── Layer names (tg_compose.c) ──────────────────────────────────── */
+
+/** Short ASCII name of a layer ("acute"), "" for NONE. */
+const char *tg_dia_name(uint8_t dia);
+
+/** The layer's mark as UTF-8 for labels ("\xc2\xb4"), "" for NONE. */
+const char *tg_dia_mark(uint8_t dia);
+
+/** The layer after @p dia in the L3 cycle; the last wraps to NONE. */
+static inline uint8_t tg_dia_next(uint8_t dia) {
+    return (uint8_t)((dia + 1u) % TG_DIA_COUNT);
+}
+
+#endif /* TG_COMPOSE_H */
@@ -0,0 +1,105 @@
+/**
+ * @file tg_composer.h
+ * @brief Kana and Hangul composition over the session text
+ *
+ * On a page with a composer (tg_pages.h), one-unit keys do not go
+ * straight into the text. They are fed to the composer, which keeps a
+ * composition span ending at the cursor and rewrites its tail as each
+ * key arrives:
+ *
+ *   - Romaji (hiragana, katakana): Latin letters spell kana through a
+ *     bitmap trie generated by tools/kanagen (src/tg_kana_table.c).
+ *     Letters that do not yet spell anything stay in the span as typed.
+ *     A doubled consonant gives a small tsu, and n before a consonant
+ *     gives ん. The span grows until space or submit commits it.
+ *   - Hangul: compatibility jamo (U+3131..U+3163) build a syllable
+ *     arithmetically, with compound vowels and finals. A final moves to
+ *     the next syllable when a vowel follows. The span is the syllable
+ *     being built; finished syllables are committed as they complete.
+ *
+ * The span is ordinary session text, so it is drawn, shipped over IPC
+ * and submitted like any other. Each edit replaces at most a few units
+ * before the cursor (ime_session_replace_before) and looks up a fixed
+ * number of table entries, so a key costs constant time. The composer
+ * lives in the engine, with no heap. Backspace takes back one key.
+ * Anything else that edits or moves commits the span first.
+ */
+
+#ifndef TG_COMPOSER_H
+#define TG_COMPOSER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "tg_pages.h"
+#include "ime_custom.h"
+
+#define TG_HANGUL_KEYS_MAX  5   /* initial, vowel, vowel, final, final */
+
+typedef struct TgComposer {
+    uint8_t  mode;              /* TgComposerMode of the span */
+    uint32_t start;             /* span [start, start + length) of the text */
+    uint32_t length;            /* 0 = not composing */
+    /* Romaji: trie node of the Latin letters that end the span */
+    uint16_t node;
+    uint8_t  pending;           /* those letters, in units */
+    /* Hangul: jamo typed into the syllable the span holds */
+    uint16_t jamo[TG_HANGUL_KEYS_MAX];
+    uint8_t  jamo_count;
+} TgComposer;
+
+/* ─── Romaji trie (src/tg_kana_table.c) ───────────────────────────── */
+
+/*
+ * Node 0 is the root. A node's children are stored together in input
+ * order from child; the child for input i is child + the number of
+ * lower bits set in next.
+ */
+typedef struct TgKanaNode {
+    uint32_t next;              /* bit i: a child for input i */
+    uint16_t child;
+    uint16_t kana[2];           /* hiragana spelled here, [0] = 0: none */
+} TgKanaNode;
+
+#define TG_KANA_INPUTS  28      /* a-z, '-', '\'' */
+
+extern const TgKanaNode tg_kana_nodes[];
+
+/* Trie input of a typed unit, or -1; capitals spell as lowercase */
+static inline int32_t tg_kana_input(uint16_t c) {
+    if (c >= 'a' && c <= 'z') return c - 'a';
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c == '-') return 26;
+    if (c == '\'') return 27;
+    return -1;
+}
+
+/* Child of @p node for input @p in, or -1 */
+static inline int32_t tg_kana_child(uint32_t node, int32_t in) {
+    const TgKanaNode *n = &tg_kana_nodes[node];
+    if (in < 0 || !(n->next & (1u << in))) return -1;
+    return n->child + __builtin_popcount(n->next & ((1u << in) - 1));
+}
+
+/* ─── API ─────────────────────────────────────────────────────────── */
+
+static inline bool tg_composer_active(const TgComposer *c) {
+    return c->length != 0;
+}
+
+void tg_composer_reset(TgComposer *c);
+
+/**
+ * Feed a key's unit on a page composing in @p mode. Returns false if
+ * the composer does not take it; the span is then committed and the
+ * caller types the key as usual.
+ */
+bool tg_composer_feed(TgComposer *c, ImeSession *s, uint8_t mode, uint16_t unit);
+
+/** Take back the last key of the span. Returns false if not composing. */
+bool tg_composer_backspace(TgComposer *c, ImeSession *s);
+
+/** End the span, turning a trailing romaji n into its kana. */
+void tg_composer_commit(TgComposer *c, ImeSession *s);
+
+#endif /* TG_COMPOSER_H */
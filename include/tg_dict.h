@@ -0,0 +1,79 @@
+/**
+ * @file tg_dict.h
+ * @brief Word-completion dictionary: on-disk trie format and top-N query
+ *
+ * The dictionary is a prefix trie with shared suffixes (identical
+ * subtrees are stored once), built offline by tools/dictc and mapped
+ * read-only at TG_DICT_PATH. Every node records the highest word
+ * frequency beneath it, so a best-first walk from the prefix node finds
+ * the top-N completions without visiting the rest of the subtree.
+ *
+ * File layout (little-endian):
+ *   TgDictHeader
+ *   TgDictNode[header.node_count]
+ *
+ * Children of a node are contiguous and sorted by label. Labels are
+ * lowercase ASCII letters and apostrophe.
+ */
+
+#ifndef TG_DICT_H
+#define TG_DICT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TG_DICT_PATH     "/user/data/thumbgrid_dict.bin"
+#define TG_DICT_MAGIC    0x43444754u  /* "TGDC" */
+#define TG_DICT_VERSION  1
+#define TG_DICT_WORD_MAX 24           /* longest word + NUL */
+
+/* ─── File format ─────────────────────────────────────────────────── */
+
+typedef struct TgDictHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t node_size;         /* sizeof(TgDictNode) */
+    uint32_t node_count;
+    uint32_t word_count;
+    uint32_t root;              /* node index of the empty prefix */
+    uint32_t reserved;
+} TgDictHeader;
+
+typedef struct TgDictNode {
+    uint32_t first_child;       /* index of the first child */
+    uint8_t  child_count;
+    uint8_t  ch;                /* label of the edge into this node */
+    uint8_t  freq;              /* 1-255 if a word ends here, else 0 */
+    uint8_t  best;              /* highest freq in this subtree */
+} TgDictNode;
+
+_Static_assert(sizeof(TgDictHeader) == 24, "TgDictHeader layout");
+_Static_assert(sizeof(TgDictNode) == 8, "TgDictNode layout");
+
+/* ─── Query (tg_dict.c) ───────────────────────────────────────────── */
+
+typedef struct TgDict {
+    const TgDictNode *nodes;
+    uint32_t          node_count;
+    uint32_t          word_count;
+    uint32_t          root;
+} TgDict;
+
+/**
+ * Validate a mapped dictionary file and point @p d at it. Every child
+ * range is bounds-checked here so queries can trust the indices.
+ * Returns IME_OK or IME_ERROR_INVALID_PARAM.
+ */
+int32_t  tg_dict_attach(TgDict *d, const void *data, size_t size);
+
+/**
+ * Up to @p max completions of the lowercase @p prefix, most frequent
+ * first. Words equal to the prefix are skipped. Returns the count.
+ */
+uint32_t tg_dict_complete(const TgDict *d, const char *prefix, uint32_t len,
+                          char out[][TG_DICT_WORD_MAX], uint32_t max);
+
+/** Frequency (1-255) of the lowercase @p word, or 0 if it is not listed. */
+uint8_t  tg_dict_freq(const TgDict *d, const char *word, uint32_t len);
+
+#endif /* TG_DICT_H */
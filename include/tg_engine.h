@@ -0,0 +1,130 @@
+/**
+ * @file tg_engine.h
+ * @brief ThumbGrid input engine — the per-poll IME state machine
+ *
+ * Everything sceImeDialogGetStatus decides from one pad sample lives
+ * here: edge detection, cell selection, grace period, L2 shift, L3
+ * accent, X-hold selection, action dispatch, kana/Hangul composition,
+ * backspace and cursor repeat and word completion. The
+ * engine does no I/O and never reads a clock; the caller passes the
+ * sample and the time, then acts on the returned TG_FX_* flags.
+ * ime_hook.c drives it from the real pad, tools/replay from a trace.
+ */
+
+#ifndef TG_ENGINE_H
+#define TG_ENGINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cell_select.h"
+#include "ime_custom.h"
+#include "input.h"
+#include "tg_composer.h"
+#include "tg_dict.h"
+#include "tg_layout.h"
+#include "tg_learn.h"
+#include "thumbgrid.h"
+
+/* ─── Timing and thresholds ───────────────────────────────────────── */
+
+#define TG_ENGINE_GRACE_US        300000  /* ignore actions after init */
+#define TG_ENGINE_BS_DELAY_US     400000  /* backspace hold before repeat */
+#define TG_ENGINE_BS_REPEAT_US     60000  /* backspace repeat interval */
+#define TG_ENGINE_CURSOR_REPEAT_US 60000  /* D-pad Left/Right repeat interval */
+#define TG_ENGINE_WORD_ACCEL_US  1200000  /* held this long, repeats go by words */
+#define TG_ENGINE_WORD_REPEAT_US  150000  /* word-step repeat interval */
+#define TG_ENGINE_L2_ENGAGE           60  /* analog L2 shift on at >= */
+#define TG_ENGINE_L2_RELEASE          40  /* analog L2 shift off below */
+#define TG_ENGINE_SUGGEST_MAX          3  /* word completions offered */
+
+/* ─── Input and effects ───────────────────────────────────────────── */
+
+/* The part of OrbisPadData the engine reads */
+typedef struct TgPadInput {
+    uint32_t buttons;           /* PAD_BUTTON_* */
+    uint8_t  lx, ly;            /* left stick, 128 = center */
+    uint8_t  rx, ry;            /* right stick */
+    uint8_t  l2, r2;            /* analog triggers */
+} TgPadInput;
+
+#define TG_FX_GRACE     0x01    /* inside the grace period; nothing dispatched */
+#define TG_FX_EVENT     0x02    /* new button edge or cell change */
+#define TG_FX_TEXT      0x04    /* text, cursor or selection may have changed */
+#define TG_FX_GRID      0x08    /* cell, page, accent, shift or position changed */
+#define TG_FX_FINISHED  0x10    /* session left the active state (submit/cancel) */
+
+/* ─── Engine state ────────────────────────────────────────────────── */
+
+typedef struct ThumbGridEngine {
+    ImeSession     session;
+    ThumbGridState grid;
+    InputState     input;
+    TgCellSelect   cellsel;         /* left stick -> cell, calibrated in grace */
+    uint64_t       start_us;        /* tg_engine_init time, for the grace period */
+    uint64_t       step_us;         /* time of the sample being stepped */
+
+    /* Screen size for right-stick position clamping (set by the renderer) */
+    uint32_t       screen_w;
+    uint32_t       screen_h;
+
+    /* Backspace hold-to-repeat */
+    bool           bs_held;
+    uint64_t       bs_start_us;
+    uint64_t       bs_last_repeat_us;
+
+    /* D-pad Left/Right hold-to-repeat: -1 left, 1 right, 0 none */
+    int8_t         cursor_dir;
+    uint64_t       cursor_start_us;
+    uint64_t       cursor_last_repeat_us;
+
+    /* X (cross) hold for text selection */
+    bool           x_held;
+    bool           x_dpad_used;     /* D-pad was pressed during X hold */
+    uint32_t       x_anchor;        /* cursor pos when X was pressed */
+
+    /* L2 analog trigger for shift hold */
+    uint8_t        l2_prev;
+    bool           l2_shift_active; /* temporary shift currently applied */
+    int32_t        l2_saved_page;   /* page to revert to on release, -1 = none */
+    bool           paste_chain;     /* last action was a paste in this L2 hold */
+
+    /* L3 (left stick click) edge for the accent layer cycle */
+    bool           l3_prev;
+
+    /* Kana/Hangul span being composed on a composer page */
+    TgComposer     composer;
+
+    /* Word completion (R3 accepts the first); dict and learn outlive
+     * sessions, learn is the current user's store and learns on submit.
+     * A password or no-learning dialog stores nothing and offers nothing. */
+    const TgDict  *dict;
+    TgLearnStore  *learn;
+    bool           no_learn;
+    uint32_t       suggestion_count;
+    uint32_t       suggest_prefix_len;  /* chars of the word already typed */
+    char           suggestions[TG_ENGINE_SUGGEST_MAX][TG_DICT_WORD_MAX];
+
+    /* Character and stick-travel log for layout scoring; outlives sessions */
+    TgUsageStore  *usage;
+    TgUsageCursor  usage_cursor;
+} ThumbGridEngine;
+
+/* ─── API ─────────────────────────────────────────────────────────── */
+
+/**
+ * Start a session: text session, grid, title and all hold state.
+ * option is OrbisImeDialogParam.option (ORBIS_IME_OPTION_*).
+ * Returns the ime_session_init result; the engine is unusable on error.
+ */
+int32_t  tg_engine_init(ThumbGridEngine *e, int32_t panel_type,
+                        uint32_t option, uint32_t max_length,
+                        uint16_t *caller_buffer, const uint16_t *prefill,
+                        const uint16_t *title,
+                        uint64_t now_us);
+
+/** Advance by one poll. Returns TG_FX_* flags. */
+uint32_t tg_engine_step(ThumbGridEngine *e, const TgPadInput *pad,
+                        uint64_t now_us);
+
+#endif /* TG_ENGINE_H */
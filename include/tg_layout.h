@@ -0,0 +1,107 @@
+/**
+ * @file tg_layout.h
+ * @brief Letter-page layout files and on-device usage logging
+ *
+ * A layout file rearranges the 32 outer slots of the letter pages (the
+ * center cell's functions never move). It is plain text, one line per
+ * outer cell in order 0-3, 5-8, four characters per line in button
+ * order triangle, circle, cross, square; '#' starts a comment:
+ *
+ *   abcd
+ *   efgh
+ *   ...
+ *   !?'-
+ *
+ * It must hold exactly the characters of page 0 ("abc"), and page 0's
+ * shift page ("ABC") follows it in uppercase. tools/layoutopt generates and
+ * scores layouts; the plugin loads TG_LAYOUT_PATH at each session.
+ *
+ * The usage store counts which character follows which, and how long
+ * the stick took between cells, so layouts can be scored against how
+ * players actually type. It is a flat struct mapped shared from
+ * TG_USAGE_PATH and updated in place, like the learned-word store.
+ */
+
+#ifndef TG_LAYOUT_H
+#define TG_LAYOUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "thumbgrid.h"
+
+#define TG_LAYOUT_PATH     "/user/data/thumbgrid_layout.txt"
+#define TG_LAYOUT_FILE_MAX 1024         /* bytes read from a layout file */
+#define TG_LAYOUT_SLOTS    ((TG_CELLS - 1) * TG_BUTTONS)
+
+#define TG_USAGE_PATH      "/user/data/thumbgrid_usage.bin"
+#define TG_USAGE_MAGIC     0x53554754u  /* "TGUS" */
+#define TG_USAGE_VERSION   1
+#define TG_USAGE_CLASSES   96           /* ASCII 0x20-0x7F, letters lowercased */
+#define TG_USAGE_GAP_MAX_US 1000000     /* longer pauses are not stick travel */
+
+/* ─── Slots ───────────────────────────────────────────────────────── */
+
+/* Slot s is button s % 4 of outer cell s / 4, skipping the center */
+static inline int32_t tg_layout_slot_cell(uint32_t slot) {
+    int32_t c = (int32_t)(slot / TG_BUTTONS);
+    return c < TG_CENTER_CELL ? c : c + 1;
+}
+
+static inline int32_t tg_layout_slot_button(uint32_t slot) {
+    return (int32_t)(slot % TG_BUTTONS);
+}
+
+/**
+ * Parse layout text into @p slots. Checks the shape only; which
+ * characters are allowed is up to the caller. Returns IME_OK or
+ * IME_ERROR_INVALID_PARAM.
+ */
+int32_t tg_layout_parse(const char *text, size_t len, char slots[TG_LAYOUT_SLOTS]);
+
+/* ─── Usage store ─────────────────────────────────────────────────── */
+
+typedef struct TgUsageHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t classes;           /* TG_USAGE_CLASSES */
+    uint32_t presses;           /* characters recorded */
+    uint32_t reserved[5];
+} TgUsageHeader;
+
+typedef struct TgUsageStore {
+    TgUsageHeader hdr;
+    uint32_t      pairs[TG_USAGE_CLASSES][TG_USAGE_CLASSES];  /* [previous][typed] */
+    uint32_t      moves[TG_CELLS][TG_CELLS];      /* timed presses, [from][to] cell */
+    uint64_t      move_us[TG_CELLS][TG_CELLS];    /* their summed time */
+} TgUsageStore;
+
+_Static_assert(sizeof(TgUsageHeader) == 32, "TgUsageHeader layout");
+
+/* The previous press of the current session */
+typedef struct TgUsageCursor {
+    bool     valid;
+    uint8_t  cls;
+    int32_t  cell;
+    uint64_t at_us;
+} TgUsageCursor;
+
+/** Character class of @p c, or -1 for characters the store does not count. */
+static inline int32_t tg_usage_class(uint16_t c) {
+    if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+    return (c >= 0x20 && c < 0x20 + TG_USAGE_CLASSES) ? (int32_t)(c - 0x20) : -1;
+}
+
+/** Adopt a mapped store, clearing it if the header does not match. */
+int32_t tg_usage_attach(TgUsageStore *u);
+
+/**
+ * Record a character typed from @p cell at @p now_us. Anything without
+ * a class (editing functions) ends the chain, so the next press is not
+ * paired with the one before it.
+ */
+void    tg_usage_press(TgUsageStore *u, TgUsageCursor *cur, int32_t cell,
+                       uint16_t ch, uint64_t now_us);
+
+#endif /* TG_LAYOUT_H */
@@ -0,0 +1,93 @@
+/**
+ * @file tg_learn.h
+ * @brief Per-user learned word frequencies for completion ranking
+ *
+ * Every submitted text teaches the store its words (unigrams) and the
+ * word pairs it contains (bigrams). Counts live in a count-min sketch
+ * of fixed size, so memory never grows with vocabulary; a small word
+ * table remembers the learned spellings so words missing from the
+ * dictionary, such as player and clan names, can be offered too.
+ *
+ * The whole store is one flat struct, mapped shared from
+ * TG_LEARN_PATH_FMT (one file per user) and updated in place. Loading
+ * is a header check; the kernel writes dirty pages back in the
+ * background, so a submit never waits on storage.
+ *
+ * Ranking: a word the player has used outranks one they have not; then
+ * come the pair count with the previous word, the word's own count and
+ * its dictionary frequency. Counts halve every TG_LEARN_DECAY_SUBMITS
+ * submits so recent habits win over old ones.
+ */
+
+#ifndef TG_LEARN_H
+#define TG_LEARN_H
+
+#include <stdint.h>
+
+#include "gap_buffer.h"
+#include "tg_dict.h"
+
+#define TG_LEARN_PATH_FMT  "/user/data/thumbgrid_learn_%08x.bin"
+#define TG_LEARN_MAGIC     0x4E4C4754u  /* "TGLN" */
+#define TG_LEARN_VERSION   1
+
+#define TG_LEARN_DEPTH        4         /* sketch rows (independent hashes) */
+#define TG_LEARN_WIDTH     4096         /* counters per row, power of two */
+#define TG_LEARN_WORDS      512         /* learned spellings kept */
+#define TG_LEARN_DECAY_SUBMITS 256
+
+/* Candidates pooled from the dictionary before re-ranking */
+#define TG_LEARN_POOL         8
+
+/* ─── File format ─────────────────────────────────────────────────── */
+
+typedef struct TgLearnHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t depth;             /* TG_LEARN_DEPTH */
+    uint32_t width;             /* TG_LEARN_WIDTH */
+    uint32_t word_slots;        /* TG_LEARN_WORDS */
+    uint32_t submits;           /* since the last decay */
+    uint32_t reserved[3];
+} TgLearnHeader;
+
+typedef struct TgLearnWord {
+    char     text[TG_DICT_WORD_MAX];    /* lowercase, NUL-terminated; "" = free */
+    uint32_t hash;
+    uint32_t reserved;
+} TgLearnWord;
+
+typedef struct TgLearnStore {
+    TgLearnHeader hdr;
+    uint16_t      counts[TG_LEARN_DEPTH][TG_LEARN_WIDTH];
+    TgLearnWord   words[TG_LEARN_WORDS];
+} TgLearnStore;
+
+_Static_assert(sizeof(TgLearnHeader) == 32, "TgLearnHeader layout");
+_Static_assert(sizeof(TgLearnWord) == 32, "TgLearnWord layout");
+_Static_assert((TG_LEARN_WIDTH & (TG_LEARN_WIDTH - 1)) == 0,
+               "TG_LEARN_WIDTH must be a power of two");
+
+/* ─── API (tg_learn.c) ────────────────────────────────────────────── */
+
+/**
+ * Adopt a mapped store. A store with a foreign header (new file, old
+ * version, different sizes) is cleared and stamped. Returns IME_OK or
+ * IME_ERROR_INVALID_PARAM.
+ */
+int32_t  tg_learn_attach(TgLearnStore *l);
+
+/** Learn every word and adjacent word pair of a submitted text. */
+void     tg_learn_commit(TgLearnStore *l, const GapBuffer *text);
+
+/**
+ * Top @p max completions of the lowercase @p prefix, given the previous
+ * word @p prev (lowercase, may be empty), merging @p dict (may be NULL)
+ * with learned words. Words equal to the prefix are skipped.
+ */
+uint32_t tg_learn_complete(const TgLearnStore *l, const TgDict *dict,
+                           const char *prev, uint32_t prev_len,
+                           const char *prefix, uint32_t len,
+                           char out[][TG_DICT_WORD_MAX], uint32_t max);
+
+#endif /* TG_LEARN_H */
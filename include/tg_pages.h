@@ -0,0 +1,199 @@
+/**
+ * @file tg_pages.h
+ * @brief Character pages: binary page-file format and key actions
+ *
+ * A page set is a list of 3x3 pages with one key per face button in
+ * each cell. A key either types up to TG_KEY_UNITS UTF-16 units or
+ * performs an editing action (TgKeyOp), and may carry a label shown in
+ * place of its text. Each page names the page L2 shifts to and the page
+ * L1/R1 switches to, so a set has as many pages as it needs. A page may
+ * also route its keys through a composer (tg_composer.h), so its Latin
+ * letters spell kana or its jamo build Hangul syllables.
+ *
+ * Sets are compiled offline by tools/pagec from a text description and
+ * mapped read-only from TG_PAGES_PATH. The file is the runtime form:
+ * once tg_pages_attach() has checked the header and checksum, the page
+ * array is used in place with no parsing or copying. The built-in pages
+ * in thumbgrid.c are the same structs.
+ *
+ * File layout (little-endian):
+ *   TgPagesHeader
+ *   ThumbGridPage[header.page_count]
+ *
+ * Shared with the shell overlay, which gets the selected page's keys
+ * over IPC and labels them with tg_key_utf8().
+ */
+
+#ifndef TG_PAGES_H
+#define TG_PAGES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TG_CELLS       9
+#define TG_BUTTONS     4   /* triangle, circle, cross, square */
+#define TG_MAX_PAGES   8
+
+#define TG_PAGES_PATH     "/user/data/thumbgrid_pages.bin"
+#define TG_PAGES_MAGIC    0x47505447u  /* "TGPG" */
+#define TG_PAGES_VERSION  1
+
+#define TG_PAGE_NAME_MAX  8    /* UTF-8 bytes with the NUL */
+#define TG_KEY_UNITS      4    /* UTF-16 units one key types */
+#define TG_KEY_LABEL_MAX  14   /* UTF-8 bytes with the NUL */
+
+/* ─── Key actions ─────────────────────────────────────────────────── */
+
+/* What a key does besides typing */
+typedef enum TgKeyOp {
+    TG_OP_TEXT   = 0x00,        /* type the key's text */
+    TG_OP_BKSP   = 0x02,
+    TG_OP_SPACE  = 0x03,
+    TG_OP_ACCENT = 0x04,
+    TG_OP_SELALL = 0x05,
+    TG_OP_EXIT   = 0x06,
+    TG_OP_CUT    = 0x07,
+    TG_OP_COPY   = 0x08,
+    TG_OP_PASTE  = 0x09,
+    TG_OP_CAPS   = 0x0A,
+} TgKeyOp;
+
+static inline bool tg_op_is_action(uint8_t op) {
+    return op >= TG_OP_BKSP && op <= TG_OP_CAPS;
+}
+
+/* Label of an action key that has none of its own (UTF-8) */
+static inline const char *tg_op_label(uint8_t op) {
+    switch (op) {
+    case TG_OP_BKSP:   return "Del";
+    case TG_OP_SPACE:  return "Space";
+    case TG_OP_ACCENT: return "\xc2\xb4";      /* U+00B4 acute accent */
+    case TG_OP_SELALL: return "Select";
+    case TG_OP_EXIT:   return "Exit";
+    case TG_OP_CUT:    return "Cut";
+    case TG_OP_COPY:   return "Copy";
+    case TG_OP_PASTE:  return "Paste";
+    case TG_OP_CAPS:   return "CAPS";
+    default:           return "?";
+    }
+}
+
+/* How a page's one-unit keys are typed */
+typedef enum TgComposerMode {
+    TG_COMPOSER_NONE = 0,       /* as they are */
+    TG_COMPOSER_HIRAGANA,       /* romaji spelling hiragana */
+    TG_COMPOSER_KATAKANA,       /* romaji spelling katakana */
+    TG_COMPOSER_HANGUL,         /* compatibility jamo building syllables */
+    TG_COMPOSER_MODE_COUNT,
+} TgComposerMode;
+
+/* ─── File format ─────────────────────────────────────────────────── */
+
+typedef struct TgKey {
+    uint16_t text[TG_KEY_UNITS];        /* UTF-16, zero padded */
+    uint8_t  len;                       /* units in text; 0 for actions */
+    uint8_t  op;                        /* TgKeyOp */
+    char     label[TG_KEY_LABEL_MAX];   /* "" shows the text or tg_op_label */
+} TgKey;
+
+typedef struct ThumbGridPage {
+    char    name[TG_PAGE_NAME_MAX];     /* "abc", "ABC", "123" */
+    uint8_t shift;                      /* page shown while L2 is held */
+    uint8_t next;                       /* page L1/R1 switches to */
+    uint8_t compose;                    /* TgComposerMode */
+    uint8_t reserved[5];
+    TgKey   keys[TG_CELLS][TG_BUTTONS]; /* [cell][button] */
+} ThumbGridPage;
+
+typedef struct TgPagesHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t page_size;         /* sizeof(ThumbGridPage) */
+    uint32_t page_count;
+    uint32_t checksum;          /* tg_pages_checksum() of the pages */
+    uint32_t reserved[4];
+} TgPagesHeader;
+
+_Static_assert(sizeof(TgKey) == 24, "TgKey layout");
+_Static_assert(sizeof(ThumbGridPage) == 16 + TG_CELLS * TG_BUTTONS * 24, "ThumbGridPage layout");
+_Static_assert(sizeof(TgPagesHeader) == 32, "TgPagesHeader layout");
+
+/* FNV-1a over the page array */
+static inline uint32_t tg_pages_checksum(const void *data, size_t size) {
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < size; i++) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+/*
+ * Encode @p n UTF-16 units as UTF-8 into @p out, @p cap bytes with the
+ * NUL, stopping before a character that does not fit. Unpaired
+ * surrogates become U+FFFD. Returns the bytes written.
+ */
+static inline uint32_t tg_utf16_to_utf8(const uint16_t *src, uint32_t n,
+                                        char *out, uint32_t cap) {
+    uint32_t o = 0;
+    if (cap == 0) return 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t cp = src[i];
+        if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < n &&
+            src[i + 1] >= 0xDC00 && src[i + 1] <= 0xDFFF)
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (src[++i] - 0xDC00);
+        else if (cp >= 0xD800 && cp <= 0xDFFF)
+            cp = 0xFFFD;
+
+        uint32_t len = cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+        if (o + len > cap - 1) break;
+        if (len == 1) {
+            out[o++] = (char)cp;
+        } else if (len == 2) {
+            out[o++] = (char)(0xC0 | cp >> 6);
+            out[o++] = (char)(0x80 | (cp & 0x3F));
+        } else if (len == 3) {
+            out[o++] = (char)(0xE0 | cp >> 12);
+            out[o++] = (char)(0x80 | ((cp >> 6) & 0x3F));
+            out[o++] = (char)(0x80 | (cp & 0x3F));
+        } else {
+            out[o++] = (char)(0xF0 | cp >> 18);
+            out[o++] = (char)(0x80 | ((cp >> 12) & 0x3F));
+            out[o++] = (char)(0x80 | ((cp >> 6) & 0x3F));
+            out[o++] = (char)(0x80 | (cp & 0x3F));
+        }
+    }
+    out[o] = '\0';
+    return o;
+}
+
+#define TG_KEY_UTF8_MAX   16   /* tg_key_utf8() output with the NUL */
+
+/* What a key shows, as UTF-8: its label, its action's label, or its text */
+static inline void tg_key_utf8(const TgKey *k, char out[TG_KEY_UTF8_MAX]) {
+    const char *src = k->label[0] ? k->label : k->op != TG_OP_TEXT ? tg_op_label(k->op) : NULL;
+    if (src) {
+        uint32_t n = 0;
+        while (src[n] && n < TG_KEY_UTF8_MAX - 1) { out[n] = src[n]; n++; }
+        out[n] = '\0';
+        return;
+    }
+    tg_utf16_to_utf8(k->text, k->len < TG_KEY_UNITS ? k->len : TG_KEY_UNITS,
+                     out, TG_KEY_UTF8_MAX);
+}
+
+/* ─── Attach (tg_pages.c) ─────────────────────────────────────────── */
+
+typedef struct TgPageSet {
+    const ThumbGridPage *pages;
+    uint32_t             count;
+} TgPageSet;
+
+/**
+ * Validate a mapped page file and point @p s at its pages. Page links,
+ * composer modes, actions and lengths are checked here so lookups can
+ * trust them.
+ * Returns IME_OK or IME_ERROR_INVALID_PARAM.
+ */
+int32_t tg_pages_attach(TgPageSet *s, const void *data, size_t size);
+
+#endif /* TG_PAGES_H */
@@ -6,7 +6,7 @@
  * Center cell (4): Triangle=Space, Circle=Exit IME, Cross=Select All, Square=Backspace.
  * R2=submit, L2=shift hold, L1/R1=letters/symbols toggle, D-pad=text cursor.
  * L2+center: Triangle=Paste, Circle=Caps Lock, Cross=Cut, Square=Copy.
- * L3=accent toggle.
+ * L3=next accent layer (acute, grave, circumflex, ... then off).
  */
 
 #ifndef THUMBGRID_H
@@ -15,14 +15,15 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-/* Forward declaration */
+#include "tg_pages.h"
+#include "tg_compose.h"
+
+/* Forward declarations */
 struct ImeSession;
+struct TgComposer;
 
 /* ─── Constants ──────────────────────────────────────────────────── */
 
-#define TG_CELLS       9
-#define TG_BUTTONS     4   /* triangle, circle, cross, square */
-#define TG_MAX_PAGES   3
 #define TG_CENTER_CELL 4
 
 /* Button indices for character lookup */
@@ -31,52 +32,38 @@ struct ImeSession;
 #define TG_BTN_CROSS     2
 #define TG_BTN_SQUARE    3
 
-/* Special function markers (stored as chars, never displayed) */
-#define TG_SPECIAL_BKSP    '\x02'
-#define TG_SPECIAL_SPACE   '\x03'
-#define TG_SPECIAL_ACCENT  '\x04'
-#define TG_SPECIAL_SELALL  '\x05'
-#define TG_SPECIAL_EXIT    '\x06'
-#define TG_SPECIAL_CUT     '\x07'
-#define TG_SPECIAL_COPY    '\x08'
-#define TG_SPECIAL_PASTE   '\x09'
-#define TG_SPECIAL_CAPS    '\x0A'
-
 /* ─── Structures ─────────────────────────────────────────────────── */
 
-typedef struct ThumbGridPage {
-    const char *name;                           /* "abc", "ABC", "123" */
-    char        chars[TG_CELLS][TG_BUTTONS];  /* [cell][button] = character */
-} ThumbGridPage;
+/* ThumbGridPage and TgKey are the page-file structs (tg_pages.h) */
 
 #define TG_TITLE_MAX  48
 
 typedef struct ThumbGridState {
     int32_t        selected_cell;   /* 0-8, from analog stick */
-    int32_t        current_page;    /* 0-2 */
+    int32_t        current_page;    /* index into pages */
     int32_t        page_count;
-    const ThumbGridPage *pages;           /* pointer to static page array */
+    const ThumbGridPage *pages;           /* built-in, mapped or re-laid-out pages */
     int32_t        offset_x;        /* widget position offset from default center */
     int32_t        offset_y;
-    bool           accent_mode;    /* true = vowels produce accented variants */
+    uint8_t        accent_layer;   /* TgDiacritic letters compose with; NONE = off */
     uint16_t       title[TG_TITLE_MAX];  /* label shown above text bar (UTF-16) */
 } ThumbGridState;
 
 /* ─── Functions ──────────────────────────────────────────────────── */
 
 void    thumbgrid_init(ThumbGridState *state);
-void    thumbgrid_select_cell(ThumbGridState *state, uint8_t stick_x, uint8_t stick_y);
-char    thumbgrid_get_char(const ThumbGridState *state, int button_index);
-bool    thumbgrid_is_special(const ThumbGridState *state, int button_index);
+void    thumbgrid_set_pages(const TgPageSet *set);
+int32_t thumbgrid_apply_layout(const char *slots);
+const TgKey *thumbgrid_get_key(const ThumbGridState *state, int button_index);
 void    thumbgrid_shift_toggle(ThumbGridState *state);
 void    thumbgrid_toggle_symbols(ThumbGridState *state);
-void    thumbgrid_toggle_accent(ThumbGridState *state);
-uint16_t thumbgrid_accent_lookup(char base);
+void    thumbgrid_cycle_accent(ThumbGridState *state);
+uint16_t thumbgrid_compose(const ThumbGridState *state, const TgKey *key);
 void    thumbgrid_update_position(ThumbGridState *state, uint8_t rstick_x, uint8_t rstick_y,
                             uint32_t screen_w, uint32_t screen_h);
 
 void    thumbgrid_draw(const ThumbGridState *state, const struct ImeSession *session,
-                 uint32_t *fb, uint32_t pitch,
+                 const struct TgComposer *composer, uint32_t *fb, uint32_t pitch,
                  uint32_t screen_w, uint32_t screen_h);
 
 #endif /* THUMBGRID_H */
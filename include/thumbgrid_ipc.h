@@ -6,38 +6,69 @@
  * Game-side writes, shell-side reads. Lock-free via sequence counter:
  *   Writer: seq++ (odd=writing), write data, seq++ (even=ready)
  *   Reader: read seq, read data, read seq again; valid if both equal and even.
+ *
+ * File layout (4KB pages):
+ *   TG_IPC_STATE_OFFSET  ThumbGridSharedState
+ *   TG_IPC_STATS_OFFSET  TgStatsPage — per-phase latency histograms
+ *   TG_IPC_TRACE_OFFSET  TgTracePage — per-input latency records
+ *   TG_IPC_CLIP_OFFSET   TgClipStore — clipboard history (TG_IPC_CLIP_PAGES)
+ *
+ * The file is never truncated: the first three pages are reset by each
+ * game at its first dialog, the clipboard is kept across games.
  */
 
 #ifndef THUMBGRID_IPC_H
 #define THUMBGRID_IPC_H
 
 #include <stdint.h>
+#include <string.h>
+
+#include "tg_pages.h"
 
 #define TG_IPC_PATH       "/data/thumbgrid_ipc.bin"
-#define TG_IPC_FILE_SIZE  4096   /* page-aligned, larger than struct */
+#define TG_IPC_PAGE_SIZE     4096
+#define TG_IPC_STATE_OFFSET  0
+#define TG_IPC_STATS_OFFSET  (1 * TG_IPC_PAGE_SIZE)
+#define TG_IPC_TRACE_OFFSET  (2 * TG_IPC_PAGE_SIZE)
+#define TG_IPC_CLIP_OFFSET   (3 * TG_IPC_PAGE_SIZE)
+#define TG_IPC_CLIP_PAGES    9
+#define TG_IPC_FILE_SIZE     (TG_IPC_CLIP_OFFSET + TG_IPC_CLIP_PAGES * TG_IPC_PAGE_SIZE)
 
-#define TG_IPC_MAX_OUTPUT  256
+#define TG_IPC_WINDOW     128   /* text units shipped around the cursor */
+#define TG_IPC_WINDOW_MARGIN 16 /* context kept past the cursor before scrolling */
 #define TG_IPC_TITLE_MAX    48
 #define TG_IPC_PAGE_NAME_MAX 8
+#define TG_IPC_SUGGEST_MAX   3
+#define TG_IPC_SUGGEST_LEN  24
 
 typedef struct ThumbGridSharedState {
     uint32_t sequence;              /* lock-free: odd=writing, even=ready */
     uint32_t ime_active;            /* 0=hidden, 1=visible */
     int32_t  selected_cell;         /* 0-8 */
-    int32_t  current_page;          /* 0-2 */
-    uint32_t accent_mode;           /* 0 or 1 */
-    uint16_t output[TG_IPC_MAX_OUTPUT]; /* UTF-16 text buffer */
-    uint32_t output_length;
+    int32_t  current_page;          /* index into the page set */
+    uint32_t accent_layer;          /* TgDiacritic; TG_DIA_NONE = accents off */
+    /* The text may be far longer than the page holds, so only a window
+     * around the cursor is shipped: output[0] is text index window_start.
+     * Lengths, cursor and selection are indices into the whole text. */
+    uint16_t output[TG_IPC_WINDOW]; /* UTF-16 text window */
+    uint32_t window_start;
+    uint32_t window_length;         /* units in output */
+    uint32_t output_length;         /* whole text */
     uint32_t text_cursor;
     uint32_t selected_all;          /* 0 or 1 */
     uint32_t sel_start;             /* selection start index (==sel_end means no selection) */
     uint32_t sel_end;               /* selection end index */
+    uint32_t compose_start;         /* kana/Hangul span being composed */
+    uint32_t compose_length;        /* 0 = none */
     uint16_t title[TG_IPC_TITLE_MAX];   /* title bar text (UTF-16) */
-    char     page_name[TG_IPC_PAGE_NAME_MAX]; /* "abc", "ABC", "123" */
-    char     cells[9][4];           /* character labels per cell [cell][button] */
+    char     page_name[TG_IPC_PAGE_NAME_MAX]; /* "abc", "ABC", "123" (UTF-8) */
+    TgKey    cells[TG_CELLS][TG_BUTTONS]; /* current page's keys [cell][button] */
     int32_t  offset_x;              /* widget position offset */
     int32_t  offset_y;
     uint32_t shift_active;          /* L2 shift held: 0 or 1 */
+    uint32_t input_seq;             /* latency trace id of the input shown (0 = none) */
+    uint32_t suggestion_count;      /* word completions, best first; R3 takes [0] */
+    char     suggestions[TG_IPC_SUGGEST_MAX][TG_IPC_SUGGEST_LEN];
 } ThumbGridSharedState;
 
 /* --- Sequence counter helpers --- */
@@ -72,4 +103,294 @@ static inline int thumbgrid_ipc_read(volatile ThumbGridSharedState *src,
     return (seq1 == seq2) ? 1 : 0;
 }
 
+/* --- Latency statistics page --- */
+
+/*
+ * Log-bucketed (HDR-style) histograms of nanosecond durations: values
+ * below 4 get exact buckets, above that each power of two is split
+ * into 4 sub-buckets (<= 25% relative error) up to 2^30 ns (~1.07s);
+ * anything longer lands in the last bucket (max_ns keeps the value).
+ *
+ * Each phase has exactly one writer thread, which only ever increments,
+ * so no locking is needed; readers may see a histogram mid-update but
+ * never a torn 32-bit count.
+ */
+
+#define TG_STATS_MAGIC       0x54415453u  /* "STAT" */
+#define TG_STATS_VERSION     2
+#define TG_HIST_SUB_BITS     2
+#define TG_HIST_SUB          (1u << TG_HIST_SUB_BITS)
+#define TG_HIST_BUCKETS      120          /* 30 powers x 4 sub-buckets */
+#define TG_HIST_RANGE_NS     (1ull << 30)
+
+typedef enum TgPhase {
+    TG_PHASE_PAD_READ = 0,      /* scePadRead (buffered samples) */
+    TG_PHASE_ENGINE_STEP,       /* tg_engine_step: edges, cell, actions */
+    TG_PHASE_IPC_SYNC,          /* ipc_sync_state */
+    TG_PHASE_FLIP_DRAW,         /* draw callback in hooked_submit_flip */
+    TG_PHASE_SHELL_UPDATE,      /* shell update_widgets (written by shell) */
+    TG_PHASE_INPUT_TO_FLIP,     /* input edge -> first game flip after publish */
+    TG_PHASE_INPUT_TO_SHELL,    /* input edge -> PUI widgets updated (shell) */
+    TG_PHASE_COUNT
+} TgPhase;
+
+typedef struct TgLatencyHist {
+    uint32_t count;
+    uint32_t max_ns;
+    uint64_t sum_ns;
+    uint32_t buckets[TG_HIST_BUCKETS];
+} TgLatencyHist;
+
+typedef struct TgStatsPage {
+    uint32_t magic;             /* TG_STATS_MAGIC once initialized */
+    uint32_t version;
+    uint32_t phase_count;       /* TG_PHASE_COUNT */
+    uint32_t bucket_count;      /* TG_HIST_BUCKETS */
+    TgLatencyHist phase[TG_PHASE_COUNT];
+} TgStatsPage;
+
+_Static_assert(sizeof(ThumbGridSharedState) <= TG_IPC_PAGE_SIZE,
+               "shared state must fit in its page");
+_Static_assert(sizeof(TgStatsPage) <= TG_IPC_PAGE_SIZE,
+               "stats page must fit in its page");
+
+static inline const char *tg_phase_name(int phase) {
+    static const char *const names[TG_PHASE_COUNT] = {
+        "pad_read", "engine_step", "ipc_sync", "flip_draw", "shell_update",
+        "input_to_flip", "input_to_shell",
+    };
+    return (phase >= 0 && phase < TG_PHASE_COUNT) ? names[phase] : "?";
+}
+
+static inline uint32_t tg_hist_bucket(uint64_t ns) {
+    if (ns < TG_HIST_SUB) return (uint32_t)ns;
+    if (ns >= TG_HIST_RANGE_NS) return TG_HIST_BUCKETS - 1;
+    uint32_t p = 31u - (uint32_t)__builtin_clz((uint32_t)ns);
+    uint32_t sub = ((uint32_t)ns >> (p - TG_HIST_SUB_BITS)) & (TG_HIST_SUB - 1);
+    return (p - 1) * TG_HIST_SUB + sub;
+}
+
+/* Largest value that lands in bucket @p idx */
+static inline uint64_t tg_hist_bucket_upper(uint32_t idx) {
+    if (idx < TG_HIST_SUB) return idx;
+    uint32_t p   = idx / TG_HIST_SUB + 1;
+    uint32_t sub = idx % TG_HIST_SUB;
+    uint64_t lo  = (uint64_t)(TG_HIST_SUB + sub) << (p - TG_HIST_SUB_BITS);
+    return lo + (1ull << (p - TG_HIST_SUB_BITS)) - 1;
+}
+
+static inline void tg_hist_record(volatile TgLatencyHist *h, uint64_t ns) {
+    h->buckets[tg_hist_bucket(ns)]++;
+    h->sum_ns += ns;
+    if (ns > h->max_ns) h->max_ns = ns > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)ns;
+    h->count++;
+}
+
+/**
+ * Value at quantile @p per_10k (5000 = p50, 9900 = p99, 9990 = p99.9),
+ * reported as the upper bound of the bucket that contains it.
+ * Returns 0 for an empty histogram.
+ */
+static inline uint64_t tg_hist_percentile(const volatile TgLatencyHist *h,
+                                          uint32_t per_10k)
+{
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < TG_HIST_BUCKETS; i++) total += h->buckets[i];
+    if (total == 0) return 0;
+
+    uint64_t rank = (total * per_10k + 9999) / 10000;
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < TG_HIST_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            uint64_t upper = tg_hist_bucket_upper(i);
+            return upper < h->max_ns ? upper : h->max_ns;
+        }
+    }
+    return h->max_ns;
+}
+
+static inline void tg_stats_init(volatile TgStatsPage *st) {
+    memset((void *)st, 0, sizeof(*st));
+    st->version      = TG_STATS_VERSION;
+    st->phase_count  = TG_PHASE_COUNT;
+    st->bucket_count = TG_HIST_BUCKETS;
+    __asm__ volatile ("mfence" ::: "memory");
+    st->magic        = TG_STATS_MAGIC;
+}
+
+static inline int tg_stats_valid(const volatile TgStatsPage *st) {
+    return st->magic == TG_STATS_MAGIC &&
+           st->version == TG_STATS_VERSION &&
+           st->phase_count == TG_PHASE_COUNT &&
+           st->bucket_count == TG_HIST_BUCKETS;
+}
+
+/* --- Input-to-photon trace page --- */
+
+/*
+ * Every input event (button edge or cell change) gets a nonzero id and
+ * a record in a 64-entry ring, indexed by id. Each stage stamps its own
+ * TSC value (the TSC is shared across processes) the first time it
+ * sees that id:
+ *   INPUT     edge detected in hooked_ime_dialog_get_status
+ *   DISPATCH  ImeSession/grid mutation for that poll done
+ *   IPC       state carrying the id published by ipc_sync_state
+ *   FLIP      next hooked_submit_flip after publish
+ *   SHELL     shell poll_thread applied it via update_widgets
+ * Each stage has one writer; a stamp is dropped if the record has
+ * already been recycled for a newer id.
+ */
+
+#define TG_TRACE_MAGIC    0x43415254u  /* "TRAC" */
+#define TG_TRACE_VERSION  1
+#define TG_TRACE_RECORDS  64
+
+typedef enum TgLatStage {
+    TG_LAT_INPUT = 0,
+    TG_LAT_DISPATCH,
+    TG_LAT_IPC,
+    TG_LAT_FLIP,
+    TG_LAT_SHELL,
+    TG_LAT_STAGES
+} TgLatStage;
+
+typedef struct TgLatRecord {
+    uint32_t seq;               /* input id, 0 = unused */
+    uint32_t reserved;
+    uint64_t tsc[TG_LAT_STAGES];
+} TgLatRecord;
+
+typedef struct TgTracePage {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t published_seq;     /* last id written to shared state */
+    uint32_t reserved;
+    uint64_t tsc_freq;          /* ticks per second, for readers */
+    TgLatRecord rec[TG_TRACE_RECORDS];
+} TgTracePage;
+
+_Static_assert(sizeof(TgTracePage) <= TG_IPC_PAGE_SIZE,
+               "trace page must fit in its page");
+
+static inline volatile TgLatRecord *tg_trace_rec(volatile TgTracePage *tp,
+                                                 uint32_t seq)
+{
+    return &tp->rec[seq % TG_TRACE_RECORDS];
+}
+
+static inline void tg_trace_init(volatile TgTracePage *tp, uint64_t tsc_freq) {
+    memset((void *)tp, 0, sizeof(*tp));
+    tp->version  = TG_TRACE_VERSION;
+    tp->tsc_freq = tsc_freq;
+    __asm__ volatile ("mfence" ::: "memory");
+    tp->magic    = TG_TRACE_MAGIC;
+}
+
+/* --- Clipboard history --- */
+
+/*
+ * Copied text, kept in the mapping rather than the session so it can be
+ * pasted in a later dialog or another game. The file is on disk, so the
+ * history must not outlive the boot: the shell overlay, loaded once per
+ * boot, wipes and recreates the store when it first maps the file and
+ * keeps it mapped until shutdown. A game only recreates it if it finds
+ * none, or one left mid-write.
+ *
+ * Entries are runs in a ring of units, newest last, both indexed by
+ * running counts. An entry is gone once TG_CLIP_ENTRIES newer ones were
+ * pushed or the ring wrapped over its start. There is one writer at a
+ * time (the game with the dialog open); readers copy an entry out and
+ * retry if the sequence counter moved, as with ThumbGridSharedState.
+ */
+
+#define TG_CLIP_MAGIC     0x50494C43u  /* "CLIP" */
+#define TG_CLIP_VERSION   1
+#define TG_CLIP_ENTRIES   16           /* power of two */
+#define TG_CLIP_UNITS     16384        /* power of two */
+
+typedef struct TgClipEntry {
+    uint32_t start;             /* first unit, as a running count */
+    uint32_t length;
+} TgClipEntry;
+
+typedef struct TgClipStore {
+    uint32_t    magic;          /* TG_CLIP_MAGIC once initialized */
+    uint32_t    version;
+    uint32_t    sequence;       /* odd while an entry is being pushed */
+    uint32_t    count;          /* entries ever pushed */
+    uint32_t    unit_head;      /* units ever written */
+    uint32_t    reserved[3];
+    TgClipEntry entry[TG_CLIP_ENTRIES];
+    uint16_t    units[TG_CLIP_UNITS];
+} TgClipStore;
+
+_Static_assert(sizeof(TgClipStore) <= TG_IPC_CLIP_PAGES * TG_IPC_PAGE_SIZE,
+               "clipboard store must fit in its pages");
+_Static_assert((TG_CLIP_ENTRIES & (TG_CLIP_ENTRIES - 1)) == 0, "TG_CLIP_ENTRIES");
+_Static_assert((TG_CLIP_UNITS & (TG_CLIP_UNITS - 1)) == 0, "TG_CLIP_UNITS");
+
+/* Create an empty store, wiping any text an old one held */
+static inline void tg_clip_init(volatile TgClipStore *c) {
+    c->magic = 0;
+    __asm__ volatile ("mfence" ::: "memory");
+    c->version   = TG_CLIP_VERSION;
+    c->sequence  = 0;
+    c->count     = 0;
+    c->unit_head = 0;
+    for (uint32_t i = 0; i < TG_CLIP_ENTRIES; i++) {
+        c->entry[i].start  = 0;
+        c->entry[i].length = 0;
+    }
+    for (uint32_t i = 0; i < TG_CLIP_UNITS; i++) c->units[i] = 0;
+    __asm__ volatile ("mfence" ::: "memory");
+    c->magic     = TG_CLIP_MAGIC;
+}
+
+static inline int tg_clip_valid(const volatile TgClipStore *c) {
+    return c->magic == TG_CLIP_MAGIC && c->version == TG_CLIP_VERSION;
+}
+
+static inline void tg_clip_write_begin(volatile TgClipStore *c) {
+    c->sequence++;   /* odd = push in progress */
+    __asm__ volatile ("mfence" ::: "memory");
+}
+
+static inline void tg_clip_write_end(volatile TgClipStore *c) {
+    __asm__ volatile ("mfence" ::: "memory");
+    c->sequence++;
+}
+
+/* Sequence to hand to tg_clip_read_end(); odd means try again later */
+static inline uint32_t tg_clip_read_begin(const volatile TgClipStore *c) {
+    uint32_t seq = c->sequence;
+    __asm__ volatile ("lfence" ::: "memory");
+    return seq;
+}
+
+/* True if nothing was pushed since tg_clip_read_begin() returned @p seq */
+static inline int tg_clip_read_end(const volatile TgClipStore *c, uint32_t seq) {
+    __asm__ volatile ("lfence" ::: "memory");
+    return !(seq & 1) && c->sequence == seq;
+}
+
+/**
+ * Entry @p age back from the newest (0 = newest) in a snapshot of
+ * @p count and @p unit_head. Returns 0 if it has been overwritten or
+ * never existed.
+ */
+static inline int tg_clip_entry(const volatile TgClipStore *c, uint32_t count,
+                                uint32_t unit_head, uint32_t age,
+                                TgClipEntry *out)
+{
+    if (age >= count || age >= TG_CLIP_ENTRIES) return 0;
+    const volatile TgClipEntry *e = &c->entry[(count - 1 - age) & (TG_CLIP_ENTRIES - 1)];
+    out->start  = e->start;
+    out->length = e->length;
+    return out->length <= TG_CLIP_UNITS &&
+           unit_head - out->start <= TG_CLIP_UNITS &&
+           unit_head - out->start >= out->length;
+}
+
 #endif /* THUMBGRID_IPC_H */
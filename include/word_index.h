@@ -0,0 +1,51 @@
+/**
+ * @file word_index.h
+ * @brief Word-start index over the session text, for word-wise editing
+ *
+ * One bit per text unit, set where a word begins: a word unit at the
+ * start of the text or after a non-word unit. Edits shift the bits above
+ * the edit a 64-bit word at a time and recheck only the units around it,
+ * so keeping the index costs O(length / 64) per edit, never a rescan of
+ * the text. Finding the word start before or after a position scans the
+ * bits 64 at a time.
+ *
+ * Word units are letters, digits, apostrophes, underscores and anything
+ * from U+00C0 up, except the multiplication and division signs.
+ */
+
+#ifndef WORD_INDEX_H
+#define WORD_INDEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gap_buffer.h"
+
+#define WORD_INDEX_WORDS  (GAP_MAX_UNITS / 64)
+
+typedef struct WordIndex {
+    uint64_t starts[WORD_INDEX_WORDS];
+} WordIndex;
+
+static inline bool word_index_is_word(uint16_t c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '\'' || c == '_' ||
+           (c >= 0xC0 && c != 0xD7 && c != 0xF7);
+}
+
+/** Index the whole of @p g from scratch. */
+void     word_index_rebuild(WordIndex *w, const GapBuffer *g);
+
+/** Update for @p n units just inserted at @p pos of @p g. */
+void     word_index_insert(WordIndex *w, const GapBuffer *g, uint32_t pos, uint32_t n);
+
+/** Update for @p n units just deleted at @p pos of @p g. */
+void     word_index_delete(WordIndex *w, const GapBuffer *g, uint32_t pos, uint32_t n);
+
+/** Start of the word at or before @p pos - 1, or 0. */
+uint32_t word_index_before(const WordIndex *w, uint32_t pos);
+
+/** Start of the first word after @p pos, or @p length. */
+uint32_t word_index_after(const WordIndex *w, uint32_t pos, uint32_t length);
+
+#endif /* WORD_INDEX_H */
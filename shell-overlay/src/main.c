@@ -69,9 +69,18 @@ extern MonoProperty *mono_class_get_properties(MonoClass *klass, void **iter);
 extern const char   *mono_property_get_name(MonoProperty *prop);
 
 #include "thumbgrid_ipc.h"
+#include "tg_pages.h"
+#include "tg_compose.h"
+#include "log_ring.h"
+#include "profile.h"
 
 /* ─── File-based logging ────────────────────────────────────────── */
 
+/*
+ * LOG* calls are queued on the shared async log ring (log_ring.h) and
+ * written here by its flusher thread, one write + fsync per batch.
+ */
+
 #define SOVL_LOG_PATH "/user/data/sovl_log.txt"
 
 static int g_log_fd = -1;
@@ -83,22 +92,22 @@ static void sovl_log_open(void) {
                               0666);
 }
 
-static void sovl_log_write(const char *fmt, ...) {
-    char buf[512];
-    va_list args;
-    va_start(args, fmt);
-    int len = vsnprintf(buf, sizeof(buf), fmt, args);
-    va_end(args);
-    if (len > 0 && g_log_fd >= 0) {
+static void sovl_log_sink(const char *buf, size_t len, void *ctx) {
+    (void)ctx;
+    if (g_log_fd >= 0) {
         sceKernelWrite(g_log_fd, buf, len);
         sceKernelFsync(g_log_fd);
     }
 }
 
-#define LOG(fmt, ...)  sovl_log_write("[SOVL] " fmt "\n", ##__VA_ARGS__)
-#define LOGI(fmt, ...) sovl_log_write("[SOVL] OK: " fmt "\n", ##__VA_ARGS__)
-#define LOGW(fmt, ...) sovl_log_write("[SOVL] WARN: " fmt "\n", ##__VA_ARGS__)
-#define LOGE(fmt, ...) sovl_log_write("[SOVL] ERR: " fmt "\n", ##__VA_ARGS__)
+#define LOG(fmt, ...)  \
+    LOG_RING_AT(TG_LOG_LVL_INFO,  "[SOVL] " fmt "\n", ##__VA_ARGS__)
+#define LOGI(fmt, ...) \
+    LOG_RING_AT(TG_LOG_LVL_INFO,  "[SOVL] OK: " fmt "\n", ##__VA_ARGS__)
+#define LOGW(fmt, ...) \
+    LOG_RING_AT(TG_LOG_LVL_WARN,  "[SOVL] WARN: " fmt "\n", ##__VA_ARGS__)
+#define LOGE(fmt, ...) \
+    LOG_RING_AT(TG_LOG_LVL_ERROR, "[SOVL] ERR: " fmt "\n", ##__VA_ARGS__)
 
 /* ─── PS4 page size for mprotect ──────────────────────────────── */
 
@@ -167,6 +176,97 @@ static const char *LM_NS_CANDIDATES[] = {
     NULL
 };
 
+/* Sandbox-relative PUI assembly paths, tried when the plain names fail */
+static const char *PUI_SANDBOX_PATHS[] = {
+    "/%s/common/lib/Sce.PlayStation.PUI.dll",
+    "/%s/common/lib/Sce.PlayStation.HighLevel.UI2.dll",
+    "/%s/psm/Application/Sce.PlayStation.PUI.dll",
+    "/%s/psm/Application/Sce.PlayStation.HighLevel.UI2.dll",
+    NULL
+};
+
+static const char *MAIN_THREAD_CLASSES[] = {
+    "UISystem", "Application", "UIContext", NULL
+};
+
+static const char *MAIN_THREAD_METHODS[] = {
+    "CheckRunningOnMainThread",
+    "checkRunningOnMainThread",
+    "IsMainThread",
+    NULL
+};
+
+static const char *LM_CLASS_NAMES[] = { "LayerManager", "SceneManager", NULL };
+
+static const char *FIND_SCENE_METHODS[] = {
+    "FindContainerSceneByPath", "FindScene", "GetScene", NULL
+};
+
+static const char *SCENE_NAMES[] = {
+    "Game", "game", "Overlay", "overlay",
+    "System", "system", "Dialog", "dialog", NULL
+};
+
+static const char *BG_PROP_NAMES[] = {
+    "BackgroundColor", "Background", "BackColor", "BgColor", NULL
+};
+
+static const char *TC_PROP_NAMES[] = {
+    "TextColor", "ForegroundColor", "ForeColor", "Color", "FontColor", NULL
+};
+
+/* NOT "Font" — that's a Font object, not a float */
+static const char *FS_PROP_NAMES[] = { "FontSize", "TextSize", "Size", NULL };
+
+static const char *VISIBLE_PROP_NAMES[] = { "Visible", "IsVisible", NULL };
+static const char *ALPHA_PROP_NAMES[]   = { "Alpha", "Opacity", NULL };
+
+/* ─── Resolution cache ────────────────────────────────────────── */
+
+/*
+ * Winning candidates from a previous boot, stored as indices into the
+ * tables above and keyed by firmware version (an update can rename
+ * assemblies or properties). Each cached entry is still probed once on
+ * use; if that probe fails the full search runs for that step only and
+ * the file is rewritten with the new winner.
+ */
+#define SOVL_CACHE_PATH     "/user/data/sovl_cache.bin"
+#define SOVL_CACHE_MAGIC    0x43564F53u  /* "SOVC" */
+#define SOVL_CACHE_VERSION  1
+#define SOVL_IDX_NONE       0xFF
+
+typedef struct SovlResolveCache {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;            /* sizeof(SovlResolveCache) */
+    uint32_t fw_version;
+    uint8_t  pui_asm;         /* PUI_ASM_NAMES */
+    uint8_t  pui_sandbox;     /* PUI_SANDBOX_PATHS (NONE if a plain name won) */
+    uint8_t  app_asm;         /* APP_ASM_NAMES */
+    uint8_t  pui_ns;          /* NS_CANDIDATES */
+    uint8_t  patch_image;     /* 0 = PUI image, 1 = app image */
+    uint8_t  patch_ns;        /* NS_CANDIDATES (app image only) */
+    uint8_t  patch_class;     /* MAIN_THREAD_CLASSES */
+    uint8_t  patch_method;    /* MAIN_THREAD_METHODS */
+    uint8_t  lm_image;        /* 0 = app image, 1 = PUI image */
+    uint8_t  lm_ns;           /* LM_NS_CANDIDATES */
+    uint8_t  lm_class;        /* LM_CLASS_NAMES */
+    uint8_t  lm_find;         /* FIND_SCENE_METHODS */
+    uint8_t  scene;           /* SCENE_NAMES */
+    uint8_t  bg_prop;         /* BG_PROP_NAMES */
+    uint8_t  bg_on_widget;    /* 1 = found on Widget after Panel missed */
+    uint8_t  tc_prop;         /* TC_PROP_NAMES */
+    uint8_t  fs_prop;         /* FS_PROP_NAMES */
+    uint8_t  visible_prop;    /* VISIBLE_PROP_NAMES */
+    uint8_t  alpha_prop;      /* ALPHA_PROP_NAMES */
+    uint8_t  reserved[1];
+    uint32_t checksum;        /* FNV-1a over all preceding bytes */
+} SovlResolveCache;
+
+static SovlResolveCache g_cache;
+static bool             g_cache_hit   = false;  /* valid file for this FW */
+static bool             g_cache_dirty = false;  /* needs rewrite after init */
+
 /* ─── Layout Constants (1920x1080) ───────────────────────────── */
 
 #define BORDER_W          2.0f    /* White border thickness */
@@ -205,18 +305,6 @@ static const char *LM_NS_CANDIDATES[] = {
 #define DEFAULT_X      ((int)((1920.0f - GRID_PANEL_W) / 2.0f))
 #define DEFAULT_Y      ((int)(1080.0f * 2.0f / 3.0f - GRID_PANEL_H / 2.0f))
 
-/* ─── Special character constants (must match thumbgrid.h) ───── */
-
-#define TG_SPECIAL_BKSP    '\x02'
-#define TG_SPECIAL_SPACE   '\x03'
-#define TG_SPECIAL_ACCENT  '\x04'
-#define TG_SPECIAL_SELALL  '\x05'
-#define TG_SPECIAL_EXIT    '\x06'
-#define TG_SPECIAL_CUT     '\x07'
-#define TG_SPECIAL_COPY    '\x08'
-#define TG_SPECIAL_PASTE   '\x09'
-#define TG_SPECIAL_CAPS    '\x0A'
-
 /* ─── Global state ────────────────────────────────────────────── */
 
 static MonoDomain   *g_domain    = NULL;
@@ -236,6 +324,7 @@ static MonoObject *g_title_label     = NULL;
 static MonoObject *g_text_border     = NULL;  /* White border around text field */
 static MonoObject *g_text_bg         = NULL;  /* Dark text field background */
 static MonoObject *g_text_highlight  = NULL;  /* Blue selection highlight behind text */
+static MonoObject *g_text_compose    = NULL;  /* Underline of the span being composed */
 static MonoObject *g_text_label      = NULL;
 static MonoObject *g_status_label    = NULL;
 static MonoObject *g_done_panel      = NULL;  /* Cyan "Done" button */
@@ -286,60 +375,211 @@ typedef struct {
 static volatile ThumbGridSharedState *g_ipc_map = NULL;
 static int                      g_ipc_fd  = -1;
 static ThumbGridSharedState           g_cached_state;
+static bool                     g_clip_wiped = false;  /* this boot's history created */
 static volatile bool            g_running = false;
 static volatile bool            g_initialized = false;
 
-/* ─── Helper: try to open assembly by multiple names ──────────── */
+/* ─── Resolution cache I/O ────────────────────────────────────── */
 
-static MonoAssembly *try_open_assembly(MonoDomain *domain,
-                                        const char **names,
-                                        const char *label)
-{
-    for (int i = 0; names[i]; i++) {
-        MonoAssembly *a = mono_domain_assembly_open(domain, names[i]);
-        if (a) return a;
+static uint8_t cand_count(const char **names) {
+    uint8_t n = 0;
+    while (names[n]) n++;
+    return n;
+}
+
+static uint32_t cache_checksum(const SovlResolveCache *c) {
+    const uint8_t *p = (const uint8_t *)c;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < offsetof(SovlResolveCache, checksum); i++) {
+        h = (h ^ p[i]) * 16777619u;
     }
-    return NULL;
+    return h;
 }
 
-static MonoAssembly *try_open_assembly_sandbox(MonoDomain *domain,
-                                                const char *label)
-{
-    const char *sandbox = sceKernelGetFsSandboxRandomWord();
-    if (!sandbox || sandbox[0] == '\0') return NULL;
+static uint32_t sovl_fw_version(void) {
+    OrbisKernelSwVersion sw;
+    memset(&sw, 0, sizeof(sw));
+    sw.Size = sizeof(sw);
+    if (sceKernelGetSystemSwVersion(&sw) != 0) return 0;
+    return sw.Version;
+}
 
-    static const char *path_fmts[] = {
-        "/%s/common/lib/Sce.PlayStation.PUI.dll",
-        "/%s/common/lib/Sce.PlayStation.HighLevel.UI2.dll",
-        "/%s/psm/Application/Sce.PlayStation.PUI.dll",
-        "/%s/psm/Application/Sce.PlayStation.HighLevel.UI2.dll",
-        NULL
-    };
+static void cache_reset(uint32_t fw) {
+    memset(&g_cache, SOVL_IDX_NONE, sizeof(g_cache));
+    g_cache.magic      = SOVL_CACHE_MAGIC;
+    g_cache.version    = SOVL_CACHE_VERSION;
+    g_cache.size       = sizeof(SovlResolveCache);
+    g_cache.fw_version = fw;
+    g_cache.checksum   = 0;
+}
 
-    char path[256];
-    for (int i = 0; path_fmts[i]; i++) {
-        snprintf(path, sizeof(path), path_fmts[i], sandbox);
-        MonoAssembly *a = mono_domain_assembly_open(domain, path);
-        if (a) return a;
+/* Every index must be in range for its table, or NONE */
+static bool cache_indices_valid(const SovlResolveCache *c) {
+    #define IDX_OK(idx, tbl) ((idx) == SOVL_IDX_NONE || (idx) < cand_count(tbl))
+    return IDX_OK(c->pui_asm, PUI_ASM_NAMES) &&
+           IDX_OK(c->pui_sandbox, PUI_SANDBOX_PATHS) &&
+           IDX_OK(c->app_asm, APP_ASM_NAMES) &&
+           IDX_OK(c->pui_ns, NS_CANDIDATES) &&
+           (c->patch_image <= 1 || c->patch_image == SOVL_IDX_NONE) &&
+           IDX_OK(c->patch_ns, NS_CANDIDATES) &&
+           IDX_OK(c->patch_class, MAIN_THREAD_CLASSES) &&
+           IDX_OK(c->patch_method, MAIN_THREAD_METHODS) &&
+           (c->lm_image <= 1 || c->lm_image == SOVL_IDX_NONE) &&
+           IDX_OK(c->lm_ns, LM_NS_CANDIDATES) &&
+           IDX_OK(c->lm_class, LM_CLASS_NAMES) &&
+           IDX_OK(c->lm_find, FIND_SCENE_METHODS) &&
+           IDX_OK(c->scene, SCENE_NAMES) &&
+           IDX_OK(c->bg_prop, BG_PROP_NAMES) &&
+           IDX_OK(c->tc_prop, TC_PROP_NAMES) &&
+           IDX_OK(c->fs_prop, FS_PROP_NAMES) &&
+           IDX_OK(c->visible_prop, VISIBLE_PROP_NAMES) &&
+           IDX_OK(c->alpha_prop, ALPHA_PROP_NAMES);
+    #undef IDX_OK
+}
+
+/**
+ * Load the cache for the running firmware. On any mismatch the cache is
+ * reset to "nothing known" and marked dirty so init rewrites it.
+ */
+static void cache_load(void) {
+    uint32_t fw = sovl_fw_version();
+    SovlResolveCache c;
+    memset(&c, 0, sizeof(c));
+
+    int fd = sceKernelOpen(SOVL_CACHE_PATH, 0x0000 /* O_RDONLY */, 0);
+    if (fd >= 0) {
+        int64_t n = sceKernelRead(fd, &c, sizeof(c));
+        sceKernelClose(fd);
+        if (n == (int64_t)sizeof(c) &&
+            c.magic == SOVL_CACHE_MAGIC &&
+            c.version == SOVL_CACHE_VERSION &&
+            c.size == sizeof(SovlResolveCache) &&
+            c.fw_version == fw &&
+            c.checksum == cache_checksum(&c) &&
+            cache_indices_valid(&c)) {
+            g_cache = c;
+            g_cache_hit = true;
+            g_cache_dirty = false;
+            LOG("Cache: hit (fw=0x%08X)", fw);
+            return;
+        }
     }
+
+    cache_reset(fw);
+    g_cache_hit = false;
+    g_cache_dirty = true;
+    LOG("Cache: miss (fw=0x%08X fd=%d), full discovery", fw, fd);
+}
+
+static void cache_store(void) {
+    if (!g_cache_dirty) return;
+    g_cache.checksum = cache_checksum(&g_cache);
+    int fd = sceKernelOpen(SOVL_CACHE_PATH,
+                           0x0601,  /* O_WRONLY|O_CREAT|O_TRUNC */
+                           0666);
+    if (fd < 0) {
+        LOGW("Cache: cannot write %s (0x%08X)", SOVL_CACHE_PATH, fd);
+        return;
+    }
+    sceKernelWrite(fd, &g_cache, sizeof(g_cache));
+    sceKernelClose(fd);
+    g_cache_dirty = false;
+    LOG("Cache: stored");
+}
+
+static void cache_set(uint8_t *slot, uint8_t value) {
+    if (*slot != value) {
+        *slot = value;
+        g_cache_dirty = true;
+    }
+}
+
+/* ─── Helper: cached candidate probing ────────────────────────── */
+
+typedef void *(*probe_fn)(void *ctx, const char *name);
+
+/**
+ * Return the first candidate for which probe() succeeds, trying the
+ * cached index first. The winning index (or NONE) is written back to
+ * *slot, so a warm boot costs one probe per site.
+ */
+static void *probe_cached(const char **names, uint8_t *slot,
+                          probe_fn probe, void *ctx)
+{
+    uint8_t n = cand_count(names);
+    if (*slot < n) {
+        void *r = probe(ctx, names[*slot]);
+        if (r) return r;
+    }
+    for (uint8_t i = 0; i < n; i++) {
+        if (i == *slot) continue;
+        void *r = probe(ctx, names[i]);
+        if (r) {
+            cache_set(slot, i);
+            return r;
+        }
+    }
+    cache_set(slot, SOVL_IDX_NONE);
     return NULL;
 }
 
+static void *probe_assembly(void *ctx, const char *name) {
+    return mono_domain_assembly_open((MonoDomain *)ctx, name);
+}
+
+static void *probe_assembly_sandbox(void *ctx, const char *fmt) {
+    char path[256];
+    snprintf(path, sizeof(path), fmt, (const char *)ctx);
+    return mono_domain_assembly_open(g_domain, path);
+}
+
+typedef struct ClassProbe {
+    MonoImage  *image;
+    const char *class_name;
+} ClassProbe;
+
+static void *probe_class_ns(void *ctx, const char *ns) {
+    ClassProbe *cp = (ClassProbe *)ctx;
+    return mono_class_from_name(cp->image, ns, cp->class_name);
+}
+
+static void *probe_property(void *ctx, const char *name) {
+    return mono_class_get_property_from_name((MonoClass *)ctx, name);
+}
+
+static void *probe_method1(void *ctx, const char *name) {
+    return mono_class_get_method_from_name((MonoClass *)ctx, name, 1);
+}
+
+/* ─── Helper: open the PUI / app assemblies ───────────────────── */
+
+static MonoAssembly *open_pui_assembly(MonoDomain *domain) {
+    const char *sandbox = sceKernelGetFsSandboxRandomWord();
+    bool have_sandbox = sandbox && sandbox[0] != '\0';
+    bool sandbox_first = have_sandbox && g_cache.pui_sandbox != SOVL_IDX_NONE;
+    MonoAssembly *a = NULL;
+
+    if (!sandbox_first)
+        a = probe_cached(PUI_ASM_NAMES, &g_cache.pui_asm, probe_assembly, domain);
+    if (!a && have_sandbox)
+        a = probe_cached(PUI_SANDBOX_PATHS, &g_cache.pui_sandbox,
+                         probe_assembly_sandbox, (void *)sandbox);
+    else if (a)
+        cache_set(&g_cache.pui_sandbox, SOVL_IDX_NONE);
+    if (!a && sandbox_first)
+        a = probe_cached(PUI_ASM_NAMES, &g_cache.pui_asm, probe_assembly, domain);
+    return a;
+}
+
 /* ─── Helper: find a class across namespace candidates ────────── */
 
 static MonoClass *find_class_multi_ns(MonoImage *image,
                                        const char **namespaces,
                                        const char *class_name,
-                                       const char **out_ns)
+                                       uint8_t *slot)
 {
-    for (int i = 0; namespaces[i]; i++) {
-        MonoClass *cls = mono_class_from_name(image, namespaces[i], class_name);
-        if (cls) {
-            if (out_ns) *out_ns = namespaces[i];
-            return cls;
-        }
-    }
-    return NULL;
+    ClassProbe cp = { image, class_name };
+    return probe_cached(namespaces, slot, probe_class_ns, &cp);
 }
 
 /* ─── Helper: method search ───────────────────────────────────── */
@@ -457,121 +697,144 @@ static void set_label_valign(MonoObject *label, int32_t align) {
 static void set_text_prop_u16(MonoObject *obj, const uint16_t *text,
                                uint32_t len) {
     if (!g_set_text || !obj) return;
-    /* Build ASCII string with accent approximation for PUI */
+    /* PUI labels take UTF-8, so accented letters show as themselves */
     char buf[512];
-    uint32_t n = len;
-    if (n > sizeof(buf) - 1) n = sizeof(buf) - 1;
-    for (uint32_t i = 0; i < n; i++) {
-        uint16_t ch = text[i];
-        if (ch < 128) {
-            buf[i] = (char)ch;
-        } else {
-            /* Map common accented Latin to base letter */
-            switch (ch) {
-            case 0x00E1: case 0x00E0: case 0x00E2: case 0x00E3: case 0x00E4: buf[i] = 'a'; break;
-            case 0x00C1: case 0x00C0: case 0x00C2: case 0x00C3: case 0x00C4: buf[i] = 'A'; break;
-            case 0x00E9: case 0x00E8: case 0x00EA: case 0x00EB: buf[i] = 'e'; break;
-            case 0x00C9: case 0x00C8: case 0x00CA: case 0x00CB: buf[i] = 'E'; break;
-            case 0x00ED: case 0x00EC: case 0x00EE: case 0x00EF: buf[i] = 'i'; break;
-            case 0x00CD: case 0x00CC: case 0x00CE: case 0x00CF: buf[i] = 'I'; break;
-            case 0x00F3: case 0x00F2: case 0x00F4: case 0x00F5: case 0x00F6: buf[i] = 'o'; break;
-            case 0x00D3: case 0x00D2: case 0x00D4: case 0x00D5: case 0x00D6: buf[i] = 'O'; break;
-            case 0x00FA: case 0x00F9: case 0x00FB: case 0x00FC: buf[i] = 'u'; break;
-            case 0x00DA: case 0x00D9: case 0x00DB: case 0x00DC: buf[i] = 'U'; break;
-            case 0x00F1: buf[i] = 'n'; break;
-            case 0x00D1: buf[i] = 'N'; break;
-            default: buf[i] = '?'; break;
-            }
-        }
-    }
-    buf[n] = '\0';
+    tg_utf16_to_utf8(text, len, buf, sizeof(buf));
     set_text_prop(obj, buf);
 }
 
 /* ─── Stage 5: Patch CheckRunningOnMainThread ─────────────────── */
 
-static bool patch_main_thread_check(MonoImage *image, const char *ns) {
-    static const char *class_names[] = {
-        "UISystem", "Application", "UIContext", NULL
-    };
-    static const char *method_names[] = {
-        "CheckRunningOnMainThread",
-        "checkRunningOnMainThread",
-        "IsMainThread",
-        NULL
-    };
+static bool patch_method_ret(MonoMethod *method) {
+    void *native = mono_aot_get_method(g_domain, method);
+    if (!native) native = mono_compile_method(method);
+    if (!native) return false;
+
+    void *page = PAGE_ALIGN(native);
+    sceKernelMprotect(page, PS4_PAGE_SIZE,
+                      PROT_READ | PROT_WRITE | PROT_EXEC);
+    *(volatile uint8_t *)native = 0xC3;
+    sceKernelMprotect(page, PS4_PAGE_SIZE, PROT_READ | PROT_EXEC);
+    return true;
+}
 
-    for (int ci = 0; class_names[ci]; ci++) {
-        MonoClass *cls = mono_class_from_name(image, ns, class_names[ci]);
+static bool patch_main_thread_in(MonoImage *image, const char *ns) {
+    for (uint8_t ci = 0; MAIN_THREAD_CLASSES[ci]; ci++) {
+        MonoClass *cls = mono_class_from_name(image, ns, MAIN_THREAD_CLASSES[ci]);
         if (!cls) continue;
 
-        for (int mi = 0; method_names[mi]; mi++) {
+        for (uint8_t mi = 0; MAIN_THREAD_METHODS[mi]; mi++) {
             MonoMethod *method = mono_class_get_method_from_name(
-                cls, method_names[mi], -1);
+                cls, MAIN_THREAD_METHODS[mi], -1);
             if (!method) continue;
+            if (!patch_method_ret(method)) continue;
+            cache_set(&g_cache.patch_class, ci);
+            cache_set(&g_cache.patch_method, mi);
+            return true;
+        }
+    }
+    return false;
+}
 
-            void *native = mono_aot_get_method(g_domain, method);
-            if (!native) native = mono_compile_method(method);
-            if (!native) continue;
+/* Try the cached image/ns/class/method combination with a single lookup */
+static bool patch_main_thread_cached(void) {
+    if (g_cache.patch_image == SOVL_IDX_NONE ||
+        g_cache.patch_class == SOVL_IDX_NONE ||
+        g_cache.patch_method == SOVL_IDX_NONE) return false;
 
-            void *page = PAGE_ALIGN(native);
-            sceKernelMprotect(page, PS4_PAGE_SIZE,
-                              PROT_READ | PROT_WRITE | PROT_EXEC);
-            *(volatile uint8_t *)native = 0xC3;
-            sceKernelMprotect(page, PS4_PAGE_SIZE, PROT_READ | PROT_EXEC);
-            return true;
+    MonoImage *image = g_cache.patch_image ? g_app_image : g_pui_image;
+    const char *ns = g_cache.patch_image
+        ? (g_cache.patch_ns != SOVL_IDX_NONE ? NS_CANDIDATES[g_cache.patch_ns] : NULL)
+        : g_pui_ns;
+    if (!image || !ns) return false;
+
+    MonoClass *cls = mono_class_from_name(
+        image, ns, MAIN_THREAD_CLASSES[g_cache.patch_class]);
+    if (!cls) return false;
+    MonoMethod *method = mono_class_get_method_from_name(
+        cls, MAIN_THREAD_METHODS[g_cache.patch_method], -1);
+    return method && patch_method_ret(method);
+}
+
+static bool patch_main_thread_check(void) {
+    if (patch_main_thread_cached()) return true;
+
+    if (patch_main_thread_in(g_pui_image, g_pui_ns)) {
+        cache_set(&g_cache.patch_image, 0);
+        cache_set(&g_cache.patch_ns, SOVL_IDX_NONE);
+        return true;
+    }
+    if (g_app_image) {
+        for (uint8_t i = 0; NS_CANDIDATES[i]; i++) {
+            if (patch_main_thread_in(g_app_image, NS_CANDIDATES[i])) {
+                cache_set(&g_cache.patch_image, 1);
+                cache_set(&g_cache.patch_ns, i);
+                return true;
+            }
         }
     }
+    cache_set(&g_cache.patch_image, SOVL_IDX_NONE);
     return false;
 }
 
 /* ─── Scene finding ───────────────────────────────────────────── */
 
-static MonoObject *find_game_scene(void) {
-    MonoClass *lm_cls = NULL;
-    MonoImage *images[] = { g_app_image, g_pui_image, NULL };
-    const char *found_in = NULL;
-
-    static const char *mgr_names[] = { "LayerManager", "SceneManager", NULL };
-    for (int mi = 0; mgr_names[mi] && !lm_cls; mi++) {
-        for (int img_i = 0; images[img_i]; img_i++) {
-            lm_cls = find_class_multi_ns(images[img_i], LM_NS_CANDIDATES,
-                                          mgr_names[mi], NULL);
-            if (lm_cls) {
-                found_in = mgr_names[mi];
-                break;
+static MonoClass *find_layer_manager(void) {
+    MonoImage *images[] = { g_app_image, g_pui_image };
+
+    /* Cached image/namespace/class: one lookup */
+    if (g_cache.lm_image <= 1 && g_cache.lm_ns != SOVL_IDX_NONE &&
+        g_cache.lm_class != SOVL_IDX_NONE && images[g_cache.lm_image]) {
+        MonoClass *cls = mono_class_from_name(images[g_cache.lm_image],
+                                              LM_NS_CANDIDATES[g_cache.lm_ns],
+                                              LM_CLASS_NAMES[g_cache.lm_class]);
+        if (cls) return cls;
+    }
+
+    for (uint8_t mi = 0; LM_CLASS_NAMES[mi]; mi++) {
+        for (uint8_t img_i = 0; img_i < 2; img_i++) {
+            if (!images[img_i]) continue;
+            MonoClass *cls = find_class_multi_ns(images[img_i], LM_NS_CANDIDATES,
+                                                 LM_CLASS_NAMES[mi],
+                                                 &g_cache.lm_ns);
+            if (cls) {
+                cache_set(&g_cache.lm_image, img_i);
+                cache_set(&g_cache.lm_class, mi);
+                return cls;
             }
         }
     }
+    cache_set(&g_cache.lm_image, SOVL_IDX_NONE);
+    cache_set(&g_cache.lm_class, SOVL_IDX_NONE);
+    return NULL;
+}
 
+static void *probe_scene(void *ctx, const char *name) {
+    return invoke_static_string((MonoMethod *)ctx, name);
+}
+
+static MonoObject *find_game_scene(void) {
+    MonoClass *lm_cls = find_layer_manager();
     if (!lm_cls) {
         LOG("S6: no LayerMgr found");
         return NULL;
     }
 
+    const char *found_in = LM_CLASS_NAMES[g_cache.lm_class];
     LOG("S6: found %s (%d methods)", found_in, count_methods(lm_cls));
 
-    MonoMethod *find_scene = mono_class_get_method_from_name(
-        lm_cls, "FindContainerSceneByPath", 1);
-    if (!find_scene)
-        find_scene = mono_class_get_method_from_name(lm_cls, "FindScene", 1);
-    if (!find_scene)
-        find_scene = mono_class_get_method_from_name(lm_cls, "GetScene", 1);
+    MonoMethod *find_scene = probe_cached(FIND_SCENE_METHODS, &g_cache.lm_find,
+                                          probe_method1, lm_cls);
     if (!find_scene) {
         LOG("S6: no Find method on %s", found_in);
         return NULL;
     }
 
-    static const char *scene_names[] = {
-        "Game", "game", "Overlay", "overlay",
-        "System", "system", "Dialog", "dialog", NULL
-    };
-    for (int i = 0; scene_names[i]; i++) {
-        MonoObject *scene = invoke_static_string(find_scene, scene_names[i]);
-        if (scene) {
-            LOG("S6: scene '%s' found", scene_names[i]);
-            return scene;
-        }
+    MonoObject *scene = probe_cached(SCENE_NAMES, &g_cache.scene,
+                                     probe_scene, find_scene);
+    if (scene) {
+        LOG("S6: scene '%s' found", SCENE_NAMES[g_cache.scene]);
+        return scene;
     }
 
     LOG("S6: no scene found");
@@ -580,103 +843,62 @@ static MonoObject *find_game_scene(void) {
 
 /* ─── Phase 1: Property Discovery ─────────────────────────────── */
 
+static void log_class_properties(MonoClass *cls, const char *label,
+                                 const char *prefix)
+{
+    if (!cls) return;
+    LOG("%s properties:", label);
+    void *iter = NULL;
+    MonoProperty *prop;
+    while ((prop = mono_class_get_properties(cls, &iter)) != NULL) {
+        const char *name = mono_property_get_name(prop);
+        if (name) LOG("  %s.%s", prefix, name);
+    }
+}
+
+/* Resolve a cached property name to its setter; returns the name or NULL */
+static const char *resolve_setter(MonoClass *cls, const char **names,
+                                  uint8_t *slot, MonoMethod **out_set)
+{
+    if (!cls) return NULL;
+    MonoProperty *p = probe_cached(names, slot, probe_property, cls);
+    if (!p) return NULL;
+    *out_set = mono_property_get_set_method(p);
+    return names[*slot];
+}
+
 /**
  * Enumerate properties on Widget/Label/Panel to discover how to set
- * background color, text color, font size, etc.
+ * background color, text color, font size, etc. The full enumeration
+ * is only logged on a cold cache; warm boots go straight to the
+ * cached property names.
  */
 static void discover_properties(void) {
-    LOG("=== Property Discovery ===");
-
-    /* Discover Widget properties */
-    if (g_cls_widget) {
-        LOG("Widget properties:");
-        void *iter = NULL;
-        MonoProperty *prop;
-        while ((prop = mono_class_get_properties(g_cls_widget, &iter)) != NULL) {
-            const char *name = mono_property_get_name(prop);
-            if (name) LOG("  W.%s", name);
-        }
-    }
-
-    /* Discover Label properties */
-    if (g_cls_label) {
-        LOG("Label properties:");
-        void *iter = NULL;
-        MonoProperty *prop;
-        while ((prop = mono_class_get_properties(g_cls_label, &iter)) != NULL) {
-            const char *name = mono_property_get_name(prop);
-            if (name) LOG("  L.%s", name);
-        }
-    }
-
-    /* Discover Panel properties */
-    if (g_cls_panel) {
-        LOG("Panel properties:");
-        void *iter = NULL;
-        MonoProperty *prop;
-        while ((prop = mono_class_get_properties(g_cls_panel, &iter)) != NULL) {
-            const char *name = mono_property_get_name(prop);
-            if (name) LOG("  P.%s", name);
-        }
-    }
-
-    /* Cache property setters for common properties */
-    /* Try various names for background color */
-    static const char *bg_names[] = {
-        "BackgroundColor", "Background", "BackColor", "BgColor", NULL
-    };
-    for (int i = 0; bg_names[i] && !g_prop_bg_color; i++) {
-        MonoClass *try_cls = g_cls_panel ? g_cls_panel : g_cls_widget;
-        if (!try_cls) continue;
-        MonoProperty *p = mono_class_get_property_from_name(try_cls, bg_names[i]);
-        if (p) {
-            g_prop_bg_color = bg_names[i];
-            g_set_bg_color = mono_property_get_set_method(p);
-            LOG("Found bg color: %s", bg_names[i]);
-        }
-    }
-    /* Also check Widget hierarchy */
-    if (!g_prop_bg_color && g_cls_widget) {
-        for (int i = 0; bg_names[i]; i++) {
-            MonoProperty *p = mono_class_get_property_from_name(g_cls_widget, bg_names[i]);
-            if (p) {
-                g_prop_bg_color = bg_names[i];
-                g_set_bg_color = mono_property_get_set_method(p);
-                LOG("Found bg color on Widget: %s", bg_names[i]);
-                break;
-            }
-        }
-    }
-
-    /* Try various names for text color */
-    static const char *tc_names[] = {
-        "TextColor", "ForegroundColor", "ForeColor", "Color", "FontColor", NULL
-    };
-    if (g_cls_label) {
-        for (int i = 0; tc_names[i] && !g_prop_text_color; i++) {
-            MonoProperty *p = mono_class_get_property_from_name(g_cls_label, tc_names[i]);
-            if (p) {
-                g_prop_text_color = tc_names[i];
-                g_set_text_color = mono_property_get_set_method(p);
-                LOG("Found text color: %s", tc_names[i]);
-            }
-        }
-    }
-
-    /* Try various names for font size (NOT "Font" — that's a Font object, not a float) */
-    static const char *fs_names[] = {
-        "FontSize", "TextSize", "Size", NULL
-    };
-    if (g_cls_label) {
-        for (int i = 0; fs_names[i] && !g_prop_font_size; i++) {
-            MonoProperty *p = mono_class_get_property_from_name(g_cls_label, fs_names[i]);
-            if (p) {
-                g_prop_font_size = fs_names[i];
-                g_set_font_size = mono_property_get_set_method(p);
-                LOG("Found font size: %s", fs_names[i]);
-            }
-        }
-    }
+    if (!g_cache_hit) {
+        LOG("=== Property Discovery ===");
+        log_class_properties(g_cls_widget, "Widget", "W");
+        log_class_properties(g_cls_label,  "Label",  "L");
+        log_class_properties(g_cls_panel,  "Panel",  "P");
+    }
+
+    /* Background color: Panel (or Widget if no Panel), then Widget */
+    MonoClass *bg_cls = g_cls_panel ? g_cls_panel : g_cls_widget;
+    if (g_cache.bg_on_widget == 1 && g_cls_widget) bg_cls = g_cls_widget;
+    g_prop_bg_color = resolve_setter(bg_cls, BG_PROP_NAMES,
+                                     &g_cache.bg_prop, &g_set_bg_color);
+    if (!g_prop_bg_color && bg_cls != g_cls_widget) {
+        bg_cls = g_cls_widget;
+        g_prop_bg_color = resolve_setter(bg_cls, BG_PROP_NAMES,
+                                         &g_cache.bg_prop, &g_set_bg_color);
+    }
+    cache_set(&g_cache.bg_on_widget,
+              (g_prop_bg_color && bg_cls == g_cls_widget &&
+               g_cls_panel && bg_cls != g_cls_panel) ? 1 : 0);
+
+    g_prop_text_color = resolve_setter(g_cls_label, TC_PROP_NAMES,
+                                       &g_cache.tc_prop, &g_set_text_color);
+    g_prop_font_size  = resolve_setter(g_cls_label, FS_PROP_NAMES,
+                                       &g_cache.fs_prop, &g_set_font_size);
 
     /* Cache standard setters */
     if (g_cls_label) {
@@ -699,18 +921,10 @@ static void discover_properties(void) {
         }
         p = mono_class_get_property_from_name(w_cls, "Height");
         if (p) g_set_height = mono_property_get_set_method(p);
-        p = mono_class_get_property_from_name(w_cls, "Visible");
-        if (p) g_set_visible = mono_property_get_set_method(p);
-        else {
-            p = mono_class_get_property_from_name(w_cls, "IsVisible");
-            if (p) g_set_visible = mono_property_get_set_method(p);
-        }
-        p = mono_class_get_property_from_name(w_cls, "Alpha");
-        if (p) g_set_alpha = mono_property_get_set_method(p);
-        else {
-            p = mono_class_get_property_from_name(w_cls, "Opacity");
-            if (p) g_set_alpha = mono_property_get_set_method(p);
-        }
+        resolve_setter(w_cls, VISIBLE_PROP_NAMES,
+                       &g_cache.visible_prop, &g_set_visible);
+        resolve_setter(w_cls, ALPHA_PROP_NAMES,
+                       &g_cache.alpha_prop, &g_set_alpha);
     }
 
     LOG("Setter cache: text=%p x=%p y=%p w=%p h=%p vis=%p alpha=%p",
@@ -722,6 +936,8 @@ static void discover_properties(void) {
         (void*)g_set_text_color, g_prop_text_color ? g_prop_text_color : "none",
         (void*)g_set_font_size, g_prop_font_size ? g_prop_font_size : "none");
 
+    if (g_cache_hit) return;
+
     /* Try to find UIColor class to confirm it exists */
     static const char *color_names[] = { "UIColor", "Color", NULL };
     static const char *color_ns[] = {
@@ -890,68 +1106,20 @@ static bool add_child(MonoObject *parent, MonoObject *child) {
 
 /* ─── Build widget tree ───────────────────────────────────────── */
 
-static const char *special_label(char c) {
-    switch (c) {
-    case TG_SPECIAL_BKSP:   return "Del";
-    case TG_SPECIAL_SPACE:  return "Space";
-    case TG_SPECIAL_ACCENT: return "\xc2\xb4";  /* ´ U+00B4 acute accent */
-    case TG_SPECIAL_SELALL: return "Select";
-    case TG_SPECIAL_EXIT:   return "Exit";
-    case TG_SPECIAL_CUT:    return "Cut";
-    case TG_SPECIAL_COPY:   return "Copy";
-    case TG_SPECIAL_PASTE:  return "Paste";
-    case TG_SPECIAL_CAPS:   return "CAPS";
-    default: return "?";
-    }
-}
-
-static bool is_special_char(char c) {
-    return (c == TG_SPECIAL_BKSP || c == TG_SPECIAL_SPACE ||
-            c == TG_SPECIAL_ACCENT || c == TG_SPECIAL_SELALL ||
-            c == TG_SPECIAL_EXIT || c == TG_SPECIAL_CUT ||
-            c == TG_SPECIAL_COPY || c == TG_SPECIAL_PASTE ||
-            c == TG_SPECIAL_CAPS);
-}
-
 /**
- * Format a single button label.
- * When accent mode is on, accentable letters show their accented UTF-8 form.
+ * Format a single button label (UTF-8) into buf[TG_KEY_UTF8_MAX].
+ * Letters the accent layer composes show their composed form, as the
+ * game side types them (thumbgrid_compose).
  */
-static void format_btn_label(char ch, char *buf, int bufsize, bool accent) {
-    if (is_special_char(ch)) {
-        const char *sl = special_label(ch);
-        snprintf(buf, bufsize, "%s", sl);
-    } else if (accent && ch >= 32 && ch < 127) {
-        /* Map accentable chars to UTF-8 accented forms */
-        const char *acc = NULL;
-        switch (ch) {
-        case 'a': acc = "\xc3\xa1"; break; /* á */
-        case 'e': acc = "\xc3\xa9"; break; /* é */
-        case 'i': acc = "\xc3\xad"; break; /* í */
-        case 'o': acc = "\xc3\xb3"; break; /* ó */
-        case 'u': acc = "\xc3\xba"; break; /* ú */
-        case 'n': acc = "\xc3\xb1"; break; /* ñ */
-        case 'A': acc = "\xc3\x81"; break; /* Á */
-        case 'E': acc = "\xc3\x89"; break; /* É */
-        case 'I': acc = "\xc3\x8d"; break; /* Í */
-        case 'O': acc = "\xc3\x93"; break; /* Ó */
-        case 'U': acc = "\xc3\x9a"; break; /* Ú */
-        case 'N': acc = "\xc3\x91"; break; /* Ñ */
-        default: break;
+static void format_btn_label(const TgKey *k, char *buf, uint8_t accent_layer) {
+    if (k->op == TG_OP_TEXT && k->len == 1 && !k->label[0]) {
+        uint16_t composed = tg_compose(k->text[0], accent_layer);
+        if (composed) {
+            tg_utf16_to_utf8(&composed, 1, buf, TG_KEY_UTF8_MAX);
+            return;
         }
-        if (acc) {
-            snprintf(buf, bufsize, "%s", acc);
-        } else {
-            buf[0] = ch;
-            buf[1] = '\0';
-        }
-    } else if (ch >= 32 && ch < 127) {
-        buf[0] = ch;
-        buf[1] = '\0';
-    } else {
-        buf[0] = '?';
-        buf[1] = '\0';
     }
+    tg_key_utf8(k, buf);
 }
 
 static bool build_widget_tree(MonoObject *root) {
@@ -1042,6 +1210,18 @@ static bool build_widget_tree(MonoObject *root) {
         set_widget_visible(g_text_highlight, false);
         add_child(g_grid_panel, g_text_highlight);
     }
+    /* Kana/Hangul composition underline (initially hidden) */
+    g_text_compose = create_panel();
+    if (g_text_compose) {
+        set_widget_pos(g_text_compose,
+                       content_left + TEXT_BORDER_W + 6.0f,
+                       cur_y + TEXT_BORDER_W + TEXT_BAR_H - 6.0f,
+                       0.0f, 2.0f);
+        set_panel_bg(g_text_compose,
+                     0.95f, 0.75f, 0.20f, 1.0f);    /* Amber underline */
+        set_widget_visible(g_text_compose, false);
+        add_child(g_grid_panel, g_text_compose);
+    }
     /* Text label on top */
     g_text_label = create_label("");
     if (g_text_label) {
@@ -1247,6 +1427,13 @@ static bool ipc_reader_open(void) {
 
 opened:;
 
+    /* A file from an older game-side build ends before the clipboard pages */
+    if (sceKernelLseek(g_ipc_fd, 0, 2 /* SEEK_END */) < TG_IPC_FILE_SIZE) {
+        char zero = 0;
+        sceKernelLseek(g_ipc_fd, TG_IPC_FILE_SIZE - 1, 0 /* SEEK_SET */);
+        sceKernelWrite(g_ipc_fd, &zero, 1);
+    }
+
     void *addr = NULL;
     int rc = sceKernelMmap(0, TG_IPC_FILE_SIZE,
                            PROT_READ | PROT_WRITE,
@@ -1269,12 +1456,31 @@ opened:;
     stale->sequence = 0;
     stale->ime_active = 0;
 
+    /* Shell writes the shell_update histogram and the SHELL trace stamps */
+    PROF_ATTACH_STATS((volatile TgStatsPage *)((uint8_t *)addr + TG_IPC_STATS_OFFSET));
+    PROF_ATTACH_TRACE((volatile TgTracePage *)((uint8_t *)addr + TG_IPC_TRACE_OFFSET));
+
+    /* The clipboard history lasts one boot: wipe what a previous boot
+     * left on disk at the first mapping, then leave it to the games,
+     * which push to it and paste from it */
+    volatile TgClipStore *clip =
+        (volatile TgClipStore *)((uint8_t *)addr + TG_IPC_CLIP_OFFSET);
+    if (!g_clip_wiped || !tg_clip_valid(clip)) {
+        tg_clip_init(clip);
+        g_clip_wiped = true;
+        LOG("IPC reader: clipboard history created");
+    } else {
+        LOG("IPC reader: clipboard history kept (%u copies)", clip->count);
+    }
+
     LOG("IPC reader: mapped at %p (cleared stale state, seq reset)", addr);
     return true;
 }
 
 static void ipc_reader_close(void) {
     if (g_ipc_map) {
+        PROF_ATTACH_STATS(NULL);
+        PROF_ATTACH_TRACE(NULL);
         sceKernelMunmap((void *)g_ipc_map, TG_IPC_FILE_SIZE);
         g_ipc_map = NULL;
     }
@@ -1284,6 +1490,48 @@ static void ipc_reader_close(void) {
     }
 }
 
+/* ─── Latency stats report ────────────────────────────────────── */
+
+#if TG_PROFILE >= TG_PROFILE_COUNTERS
+/* Log p50/p99/p99.9 for every phase that has samples */
+static void log_latency_stats(void) {
+    if (!g_ipc_map) return;
+    const volatile TgStatsPage *st = (const volatile TgStatsPage *)
+        ((const volatile uint8_t *)g_ipc_map + TG_IPC_STATS_OFFSET);
+    if (!tg_stats_valid(st)) return;
+
+    for (int i = 0; i < TG_PHASE_COUNT; i++) {
+        const volatile TgLatencyHist *h = &st->phase[i];
+        if (h->count == 0) continue;
+        LOG("Lat %-12s n=%u p50=%luns p99=%luns p999=%luns max=%uns",
+            tg_phase_name(i), h->count,
+            (unsigned long)tg_hist_percentile(h, 5000),
+            (unsigned long)tg_hist_percentile(h, 9900),
+            (unsigned long)tg_hist_percentile(h, 9990),
+            h->max_ns);
+    }
+
+    /* Stage breakdown of the newest fully traced input */
+    const volatile TgTracePage *tp = (const volatile TgTracePage *)
+        ((const volatile uint8_t *)g_ipc_map + TG_IPC_TRACE_OFFSET);
+    if (tp->magic != TG_TRACE_MAGIC || tp->tsc_freq == 0) return;
+    uint32_t seq = tp->published_seq;
+    for (uint32_t back = 0; back < TG_TRACE_RECORDS && seq > back; back++) {
+        const volatile TgLatRecord *r =
+            &tp->rec[(seq - back) % TG_TRACE_RECORDS];
+        if (r->seq != seq - back || !r->tsc[TG_LAT_SHELL]) continue;
+        uint64_t t0 = r->tsc[TG_LAT_INPUT];
+        #define LAT_US(st) (r->tsc[st] ? \
+            (unsigned long)((r->tsc[st] - t0) * 1000000ull / tp->tsc_freq) : 0ul)
+        LOG("Lat trace #%u: dispatch=%luus ipc=%luus flip=%luus shell=%luus",
+            r->seq, LAT_US(TG_LAT_DISPATCH), LAT_US(TG_LAT_IPC),
+            LAT_US(TG_LAT_FLIP), LAT_US(TG_LAT_SHELL));
+        #undef LAT_US
+        break;
+    }
+}
+#endif
+
 /* ─── Update widgets from IPC state ──────────────────────────── */
 
 static void update_widgets(const ThumbGridSharedState *state) {
@@ -1296,6 +1544,7 @@ static void update_widgets(const ThumbGridSharedState *state) {
         set_widget_visible(g_grid_panel, false);
         if (g_border_panel) set_widget_visible(g_border_panel, false);
         LOG("Grid hidden");
+        PROF_TRACE_DUMP(TG_TRACE_JSON_SHELL, PROF_PID_SHELL);
     }
 
     if (!state->ime_active) {
@@ -1360,28 +1609,46 @@ static void update_widgets(const ThumbGridSharedState *state) {
     /* Update text display */
     if (g_text_label &&
         (state->output_length != g_cached_state.output_length ||
+         state->window_start != g_cached_state.window_start ||
+         state->window_length != g_cached_state.window_length ||
          state->text_cursor != g_cached_state.text_cursor ||
          state->selected_all != g_cached_state.selected_all ||
          state->sel_start != g_cached_state.sel_start ||
          state->sel_end != g_cached_state.sel_end ||
+         state->compose_start != g_cached_state.compose_start ||
+         state->compose_length != g_cached_state.compose_length ||
          memcmp(state->output, g_cached_state.output,
-                state->output_length * sizeof(uint16_t)) != 0)) {
+                state->window_length * sizeof(uint16_t)) != 0)) {
 
-        uint32_t tlen = state->output_length;
-        if (tlen > 200) tlen = 200;
+        /* Only the window around the cursor is shipped; make indices
+         * relative to it and mark text cut off at either side */
+        uint32_t base = state->window_start;
+        uint32_t tlen = state->window_length;
+        if (tlen > TG_IPC_WINDOW) tlen = TG_IPC_WINDOW;
+        bool more_before = base > 0;
+        bool more_after  = base + tlen < state->output_length;
+        uint32_t cursor  = state->text_cursor > base ? state->text_cursor - base : 0;
 
         /* Determine selection range */
         uint32_t ss = state->sel_start;
         uint32_t se = state->sel_end;
         bool has_sel = (ss != se) || state->selected_all;
-        if (state->selected_all) { ss = 0; se = tlen; }
         if (ss > se) { uint32_t t = ss; ss = se; se = t; }
+        ss = (ss > base) ? ss - base : 0;
+        se = (se > base) ? se - base : 0;
+        if (ss > tlen) ss = tlen;
+        if (se > tlen) se = tlen;
+        if (state->selected_all) { ss = 0; se = tlen; }
 
         /* Build display: UTF-8 text with cursor indicator */
         char buf[700];
         int pos = 0;
+        if (more_before) {
+            memcpy(&buf[pos], "\xE2\x80\xA6", 3);    /* U+2026 ellipsis */
+            pos += 3;
+        }
         for (uint32_t i = 0; i < tlen && pos < 680; i++) {
-            if (i == state->text_cursor && !has_sel)
+            if (i == cursor && !has_sel)
                 buf[pos++] = '|';
             uint16_t ch = state->output[i];
             if (ch >= 32 && ch < 128) {
@@ -1397,8 +1664,12 @@ static void update_widgets(const ThumbGridSharedState *state) {
                 buf[pos++] = '?';
             }
         }
-        if (state->text_cursor >= tlen && !has_sel)
+        if (cursor >= tlen && !has_sel)
             buf[pos++] = '|';
+        if (more_after) {
+            memcpy(&buf[pos], "\xE2\x80\xA6", 3);
+            pos += 3;
+        }
         buf[pos] = '\0';
         set_text_prop(g_text_label, buf);
 
@@ -1432,7 +1703,7 @@ static void update_widgets(const ThumbGridSharedState *state) {
                 float text_x = PAD_OUTER + TEXT_BORDER_W + 6.0f;
                 float text_y = PAD_OUTER + TITLE_BAR_H + TITLE_GAP
                              + TEXT_BORDER_W + 2.0f;
-                float hx = text_x + (float)ss * g_avg_char_w;
+                float hx = text_x + (float)(ss + (more_before ? 1 : 0)) * g_avg_char_w;
                 float hw = (float)(se - ss) * g_avg_char_w;
                 set_widget_pos(g_text_highlight,
                                hx, text_y, hw, TEXT_BAR_H - 4.0f);
@@ -1441,6 +1712,26 @@ static void update_widgets(const ThumbGridSharedState *state) {
                 set_widget_visible(g_text_highlight, false);
             }
         }
+
+        /* Underline the composition span the same way */
+        if (g_text_compose) {
+            uint32_t cs = state->compose_start > base ? state->compose_start - base : 0;
+            uint32_t ce = state->compose_start + state->compose_length;
+            ce = ce > base ? ce - base : 0;
+            if (cs > tlen) cs = tlen;
+            if (ce > tlen) ce = tlen;
+            if (state->compose_length > 0 && ce > cs) {
+                float text_x = PAD_OUTER + TEXT_BORDER_W + 6.0f;
+                float line_y = PAD_OUTER + TITLE_BAR_H + TITLE_GAP
+                             + TEXT_BORDER_W + TEXT_BAR_H - 6.0f;
+                float hx = text_x + (float)(cs + (more_before ? 1 : 0)) * g_avg_char_w;
+                float hw = (float)(ce - cs) * g_avg_char_w;
+                set_widget_pos(g_text_compose, hx, line_y, hw, 2.0f);
+                set_widget_visible(g_text_compose, true);
+            } else {
+                set_widget_visible(g_text_compose, false);
+            }
+        }
     }
 
     /* Update L2 button highlight when shift state changes */
@@ -1456,10 +1747,16 @@ static void update_widgets(const ThumbGridSharedState *state) {
         }
     }
 
-    /* Update L3 button highlight when accent mode changes */
-    if (state->accent_mode != g_cached_state.accent_mode) {
+    /* Update L3 button highlight and mark when the accent layer changes */
+    if (state->accent_layer != g_cached_state.accent_layer) {
+        if (g_l3_label) {
+            char l3[16];
+            snprintf(l3, sizeof(l3), "L3 %s", state->accent_layer != TG_DIA_NONE
+                     ? tg_dia_mark((uint8_t)state->accent_layer) : "\xC3\xA1");
+            set_text_prop(g_l3_label, l3);
+        }
         if (g_l3_panel) {
-            if (state->accent_mode) {
+            if (state->accent_layer != TG_DIA_NONE) {
                 set_panel_bg(g_l3_panel,
                              COL_DONE_R, COL_DONE_G, COL_DONE_B, COL_DONE_A);
             } else {
@@ -1469,17 +1766,17 @@ static void update_widgets(const ThumbGridSharedState *state) {
         }
     }
 
-    /* Update cell button labels if page changed, cell content changed, accent or shift toggled */
+    /* Update cell button labels if page changed, cell content changed, accent layer or shift changed */
     if (state->current_page != g_cached_state.current_page ||
-        state->accent_mode != g_cached_state.accent_mode ||
+        state->accent_layer != g_cached_state.accent_layer ||
         state->shift_active != g_cached_state.shift_active ||
         memcmp(state->cells, g_cached_state.cells, sizeof(state->cells)) != 0) {
         for (int cell = 0; cell < 9; cell++) {
             for (int btn = 0; btn < 4; btn++) {
                 if (g_cell_btn_labels[cell][btn]) {
-                    char buf[8];
-                    format_btn_label(state->cells[cell][btn], buf, sizeof(buf),
-                                     state->accent_mode != 0);
+                    char buf[TG_KEY_UTF8_MAX];
+                    format_btn_label(&state->cells[cell][btn], buf,
+                                     (uint8_t)state->accent_layer);
                     set_text_prop(g_cell_btn_labels[cell][btn], buf);
                 }
             }
@@ -1503,13 +1800,22 @@ static void update_widgets(const ThumbGridSharedState *state) {
         }
     }
 
-    /* Update status bar — page name */
+    /* Update status bar — page name, then word completions for R3 */
     if (state->current_page != g_cached_state.current_page ||
         memcmp(state->page_name, g_cached_state.page_name,
-               TG_IPC_PAGE_NAME_MAX) != 0) {
+               TG_IPC_PAGE_NAME_MAX) != 0 ||
+        state->suggestion_count != g_cached_state.suggestion_count ||
+        memcmp(state->suggestions, g_cached_state.suggestions,
+               sizeof(state->suggestions)) != 0) {
         if (g_status_label) {
-            char buf[16];
-            snprintf(buf, sizeof(buf), "[%s]", state->page_name);
+            char buf[16 + TG_IPC_SUGGEST_MAX * (TG_IPC_SUGGEST_LEN + 8)];
+            int n = snprintf(buf, sizeof(buf), "[%s]", state->page_name);
+            uint32_t count = state->suggestion_count;
+            if (count > TG_IPC_SUGGEST_MAX) count = TG_IPC_SUGGEST_MAX;
+            for (uint32_t i = 0; i < count && n > 0 && n < (int)sizeof(buf); i++) {
+                n += snprintf(buf + n, sizeof(buf) - n, i ? "  %.*s" : "  R3 %.*s",
+                              TG_IPC_SUGGEST_LEN, state->suggestions[i]);
+            }
             set_text_prop(g_status_label, buf);
         }
     }
@@ -1560,6 +1866,8 @@ static void *poll_thread(void *arg) {
             }
         }
 
+        PROF_BEGIN(PROF_SHELL_POLL);
+
         /* Read IPC state */
         ThumbGridSharedState snap;
         if (thumbgrid_ipc_read(g_ipc_map, &snap)) {
@@ -1586,17 +1894,28 @@ static void *poll_thread(void *arg) {
                 last_seq_change_us = 0;
             }
 
+            PROF_BEGIN(PROF_SHELL_UPDATE);
+            PROF_PHASE_BEGIN(TG_PHASE_SHELL_UPDATE);
             update_widgets(&snap);
+            PROF_PHASE_END(TG_PHASE_SHELL_UPDATE);
+            PROF_END(PROF_SHELL_UPDATE);
+            PROF_LAT_STAMP(snap.input_seq, TG_LAT_SHELL);
         } else {
             read_fail++;
         }
 
+        PROF_END(PROF_SHELL_POLL);
+        PROF_TICK();
+
         poll_count++;
         /* Diagnostic log every ~5s (150 iterations at 30Hz) */
         if ((poll_count % 150) == 0) {
             LOG("Poll: %u ok=%u fail=%u seq=%u active=%u",
                 poll_count, read_ok, read_fail,
                 g_ipc_map->sequence, g_ipc_map->ime_active);
+#if TG_PROFILE >= TG_PROFILE_COUNTERS
+            log_latency_stats();
+#endif
         }
 
         sceKernelUsleep(33000); /* ~30Hz */
@@ -1619,21 +1938,22 @@ static int shell_overlay_init(void) {
     LOG("S2: Mono attached domain=%p", (void*)g_domain);
 
     /* S3: Find PUI assembly */
-    MonoAssembly *pui_asm = try_open_assembly(g_domain, PUI_ASM_NAMES, "PUI");
-    if (!pui_asm) pui_asm = try_open_assembly_sandbox(g_domain, "PUI");
+    MonoAssembly *pui_asm = open_pui_assembly(g_domain);
     if (!pui_asm) { LOG("S3: FAIL no PUI asm"); return -3; }
 
     g_pui_image = mono_assembly_get_image(pui_asm);
     if (!g_pui_image) { LOG("S3: FAIL no PUI image"); return -4; }
 
-    MonoAssembly *app_asm = try_open_assembly(g_domain, APP_ASM_NAMES, "app");
+    MonoAssembly *app_asm = probe_cached(APP_ASM_NAMES, &g_cache.app_asm,
+                                         probe_assembly, g_domain);
     g_app_image = app_asm ? mono_assembly_get_image(app_asm) : NULL;
     LOG("S3: PUI=%p app=%p", (void*)g_pui_image, (void*)g_app_image);
 
     /* S4: Find classes and determine namespace */
     g_cls_label = find_class_multi_ns(
-        g_pui_image, NS_CANDIDATES, "Label", &g_pui_ns);
+        g_pui_image, NS_CANDIDATES, "Label", &g_cache.pui_ns);
     if (!g_cls_label) { LOG("S4: FAIL no Label class"); return -5; }
+    g_pui_ns = NS_CANDIDATES[g_cache.pui_ns];
 
     g_cls_widget = mono_class_from_name(g_pui_image, g_pui_ns, "Widget");
     g_cls_panel  = mono_class_from_name(g_pui_image, g_pui_ns, "Panel");
@@ -1641,11 +1961,7 @@ static int shell_overlay_init(void) {
         (void*)g_cls_widget, (void*)g_cls_label, (void*)g_cls_panel);
 
     /* S5: Patch main thread check */
-    bool patched = patch_main_thread_check(g_pui_image, g_pui_ns);
-    if (!patched && g_app_image) {
-        for (int i = 0; NS_CANDIDATES[i] && !patched; i++)
-            patched = patch_main_thread_check(g_app_image, NS_CANDIDATES[i]);
-    }
+    bool patched = patch_main_thread_check();
     LOG("S5: thread check patch=%s", patched ? "YES" : "NO");
 
     /* Phase 1: Property Discovery */
@@ -1678,10 +1994,12 @@ static int shell_overlay_init(void) {
     LOG("S7: root=%s.%s (%d methods)",
         root_cls->name_space, root_cls->name, count_methods(root_cls));
 
-    /* Dump available methods for debugging */
-    dump_methods_log(root_cls, "S7 root methods");
-    if (root_cls->parent) {
-        dump_methods_log(root_cls->parent, "S7 parent methods");
+    /* Dump available methods for debugging (cold cache only) */
+    if (!g_cache_hit) {
+        dump_methods_log(root_cls, "S7 root methods");
+        if (root_cls->parent) {
+            dump_methods_log(root_cls->parent, "S7 parent methods");
+        }
     }
 
     /* S7: Build full widget tree */
@@ -1691,6 +2009,7 @@ static int shell_overlay_init(void) {
     }
 
     g_initialized = true;
+    cache_store();
 
     /* Start polling thread for IPC */
     g_running = true;
@@ -1710,7 +2029,10 @@ static int shell_overlay_init(void) {
 
 static void *init_thread(void *arg) {
     (void)arg;
-    sceKernelUsleep(1000000);  /* 1s settle delay */
+    cache_load();
+    /* Let ShellUI finish starting. A warm cache only says which names
+     * resolved last boot, not that Mono and the scene are up yet. */
+    sceKernelUsleep(1000000);
     int ret = shell_overlay_init();
     LOG("Init done rc=%d", ret);
     return NULL;
@@ -1723,6 +2045,7 @@ int module_start(size_t argc, const void *args) {
     (void)args;
 
     sovl_log_open();
+    log_ring_init(sovl_log_sink, NULL);
     LOG("PRX loaded into SceShellUI (fd=%d)", g_log_fd);
 
     OrbisPthread thread;
@@ -1770,6 +2093,8 @@ int module_stop(size_t argc, const void *args) {
 
     g_initialized = false;
     LOG("Cleanup complete");
+    PROF_SUMMARY("unload");
+    log_ring_shutdown();
     if (g_log_fd >= 0) { sceKernelClose(g_log_fd); g_log_fd = -1; }
     return 0;
 }
@@ -0,0 +1,172 @@
+/**
+ * @file cell_select.c
+ * @brief Left stick → grid cell (see cell_select.h)
+ */
+
+#include <string.h>
+
+#include "plugin_common.h"
+#include "cell_select.h"
+#include "thumbgrid.h"
+
+/* ─── Radial sectors ──────────────────────────────────────────────── */
+
+/* Sector directions in Q8 (stick Y grows downwards), counter-clockwise from E */
+static const int16_t k_sector_dir[8][2] = {
+    {  256,    0 }, {  181, -181 }, {    0, -256 }, { -181, -181 },
+    { -256,    0 }, { -181,  181 }, {    0,  256 }, {  181,  181 },
+};
+static const int8_t k_sector_cell[8] = { 5, 2, 1, 0, 3, 6, 7, 8 };
+static const int8_t k_cell_sector[TG_CELLS] = { 3, 2, 1, 4, -1, 0, 5, 6, 7 };
+
+/*
+ * Near a sector boundary the dot-product gap between the two sectors is
+ * about 2*sin(22.5°) = 0.765 per stick unit of sideways travel; in Q8
+ * that is 196 per unit of hysteresis.
+ */
+#define RADIAL_HYST_Q8  196
+
+/* ─── Tables ──────────────────────────────────────────────────────── */
+
+/* Square mode: band transitions for one axis around its rest position */
+static void build_bands(uint8_t lut[3][256], int center, int dz, int h) {
+    int lo = center - dz;       /* below: band 0 */
+    int hi = center + dz;       /* above: band 2 */
+
+    for (int v = 0; v < 256; v++) {
+        uint8_t natural = (v < lo) ? 0 : (v > hi) ? 2 : 1;
+        lut[0][v] = (v < lo + h)                ? 0 : natural;
+        lut[1][v] = (v >= lo - h && v <= hi + h) ? 1 : natural;
+        lut[2][v] = (v > hi - h)                ? 2 : natural;
+    }
+}
+
+static void rebuild(TgCellSelect *cs) {
+    if (cs->cfg.mode != TG_CELLSEL_SQUARE) return;
+    build_bands(cs->band_x, cs->center_x, cs->dead_zone, cs->cfg.hysteresis);
+    build_bands(cs->band_y, cs->center_y, cs->dead_zone, cs->cfg.hysteresis);
+}
+
+/* ─── Init ────────────────────────────────────────────────────────── */
+
+void cell_select_init(TgCellSelect *cs, const TgCellSelConfig *cfg) {
+    if (!cs) return;
+    memset(cs, 0, sizeof(*cs));
+
+    if (cfg) {
+        cs->cfg = *cfg;
+    } else {
+        cs->cfg.mode         = TG_CELLSEL_MODE;
+        cs->cfg.dead_zone    = TG_CELLSEL_DEAD_ZONE;
+        cs->cfg.hysteresis   = TG_CELLSEL_HYSTERESIS;
+        cs->cfg.filter_shift = TG_CELLSEL_FILTER_SHIFT;
+    }
+    if (cs->cfg.dead_zone > TG_CELLSEL_DEAD_ZONE_MAX)
+        cs->cfg.dead_zone = TG_CELLSEL_DEAD_ZONE_MAX;
+
+    cs->cell      = TG_CENTER_CELL;
+    cs->center_x  = 128;
+    cs->center_y  = 128;
+    cs->dead_zone = cs->cfg.dead_zone;
+    cs->filt_x    = 128 << 8;
+    cs->filt_y    = 128 << 8;
+    cs->cal_min_x = cs->cal_min_y = 255;
+    rebuild(cs);
+}
+
+/* ─── Update ──────────────────────────────────────────────────────── */
+
+static int32_t radial_cell(const TgCellSelect *cs, int vx, int vy) {
+    int dx = vx - cs->center_x;
+    int dy = vy - cs->center_y;
+    int r  = cs->dead_zone + (cs->cell == TG_CENTER_CELL ? cs->cfg.hysteresis : 0);
+    if (dx * dx + dy * dy <= r * r) return TG_CENTER_CELL;
+
+    int32_t dot[8];
+    int best = 0;
+    for (int k = 0; k < 8; k++) {
+        dot[k] = dx * k_sector_dir[k][0] + dy * k_sector_dir[k][1];
+        best = dot[k] > dot[best] ? k : best;
+    }
+
+    int cur = k_cell_sector[cs->cell];
+    if (cur >= 0 && dot[best] - dot[cur] <= cs->cfg.hysteresis * RADIAL_HYST_Q8)
+        best = cur;
+    return k_sector_cell[best];
+}
+
+int32_t cell_select_update(TgCellSelect *cs, uint8_t stick_x, uint8_t stick_y,
+                           uint64_t now_us, bool snap) {
+    if (!cs) return TG_CENTER_CELL;
+
+    /*
+     * One-pole low-pass in Q8, one step per TG_CELLSEL_FILTER_STEP_US
+     * elapsed so samples drained in a burst do not count as time. Off
+     * (shift 0) or on a press, the raw sample is used as is.
+     */
+    int32_t raw_x = (int32_t)stick_x << 8;
+    int32_t raw_y = (int32_t)stick_y << 8;
+    uint64_t steps = (now_us - cs->filt_us) / TG_CELLSEL_FILTER_STEP_US;
+    if (cs->cfg.filter_shift == 0 || snap || steps >= TG_CELLSEL_FILTER_STEPS_MAX) {
+        cs->filt_x  = raw_x;
+        cs->filt_y  = raw_y;
+        cs->filt_us = now_us;
+    } else {
+        for (uint64_t i = 0; i < steps; i++) {
+            cs->filt_x += (raw_x - cs->filt_x) >> cs->cfg.filter_shift;
+            cs->filt_y += (raw_y - cs->filt_y) >> cs->cfg.filter_shift;
+        }
+        cs->filt_us += steps * TG_CELLSEL_FILTER_STEP_US;
+    }
+    int vx = (cs->filt_x + 128) >> 8;
+    int vy = (cs->filt_y + 128) >> 8;
+
+    if (cs->cfg.mode == TG_CELLSEL_RADIAL) {
+        cs->cell = radial_cell(cs, vx, vy);
+    } else {
+        int col = cs->band_x[cs->cell % 3][vx];
+        int row = cs->band_y[cs->cell / 3][vy];
+        cs->cell = row * 3 + col;
+    }
+    return cs->cell;
+}
+
+/* ─── Calibration ─────────────────────────────────────────────────── */
+
+void cell_select_calibrate(TgCellSelect *cs, uint8_t stick_x, uint8_t stick_y) {
+    if (!cs || cs->cal_done) return;
+
+    /* Anything further out is the player moving the stick, not rest */
+    if (stick_x < 128 - TG_CELLSEL_CAL_RANGE || stick_x > 128 + TG_CELLSEL_CAL_RANGE ||
+        stick_y < 128 - TG_CELLSEL_CAL_RANGE || stick_y > 128 + TG_CELLSEL_CAL_RANGE)
+        return;
+
+    cs->cal_n++;
+    cs->cal_sum_x += stick_x;
+    cs->cal_sum_y += stick_y;
+    if (stick_x < cs->cal_min_x) cs->cal_min_x = stick_x;
+    if (stick_x > cs->cal_max_x) cs->cal_max_x = stick_x;
+    if (stick_y < cs->cal_min_y) cs->cal_min_y = stick_y;
+    if (stick_y > cs->cal_max_y) cs->cal_max_y = stick_y;
+}
+
+void cell_select_calibrate_end(TgCellSelect *cs) {
+    if (!cs || cs->cal_done) return;
+    cs->cal_done = true;
+    if (cs->cal_n < TG_CELLSEL_CAL_MIN) return;
+
+    cs->center_x = (uint8_t)((cs->cal_sum_x + cs->cal_n / 2) / cs->cal_n);
+    cs->center_y = (uint8_t)((cs->cal_sum_y + cs->cal_n / 2) / cs->cal_n);
+
+    /* Keep the neutral zone at least twice the resting jitter */
+    int span = cs->cal_max_x - cs->cal_min_x;
+    if (cs->cal_max_y - cs->cal_min_y > span) span = cs->cal_max_y - cs->cal_min_y;
+    int dz = cs->cfg.dead_zone;
+    if (span * 2 > dz) dz = span * 2;
+    if (dz > TG_CELLSEL_DEAD_ZONE_MAX) dz = TG_CELLSEL_DEAD_ZONE_MAX;
+    cs->dead_zone = (uint8_t)dz;
+
+    rebuild(cs);
+    LOG_DEBUG("cellsel: rest (%u,%u) dead zone %u from %u samples",
+              cs->center_x, cs->center_y, cs->dead_zone, cs->cal_n);
+}
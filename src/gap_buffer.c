@@ -0,0 +1,175 @@
+/**
+ * @file gap_buffer.c
+ * @brief Chunked UTF-16 gap buffer (see gap_buffer.h)
+ */
+
+#include <string.h>
+
+#include "gap_buffer.h"
+
+#define CHUNK_MASK (GAP_CHUNK_UNITS - 1)
+
+/* ─── Chunked storage ─────────────────────────────────────────────── */
+
+static inline uint32_t min_u32(uint32_t a, uint32_t b) {
+    return a < b ? a : b;
+}
+
+static inline uint16_t *unit_ptr(const GapBuffer *g, uint32_t p) {
+    return &g->chunk[p >> GAP_CHUNK_SHIFT][p & CHUNK_MASK];
+}
+
+/* Units from p to the end of its chunk */
+static inline uint32_t room_after(uint32_t p) {
+    return GAP_CHUNK_UNITS - (p & CHUNK_MASK);
+}
+
+/* Units from the start of the chunk holding p - 1 up to p (p > 0) */
+static inline uint32_t room_before(uint32_t p) {
+    return ((p - 1) & CHUNK_MASK) + 1;
+}
+
+/* Move n units from position src to dst; the ranges may overlap */
+static void span_move(GapBuffer *g, uint32_t dst, uint32_t src, uint32_t n) {
+    if (dst < src) {
+        while (n > 0) {
+            uint32_t k = min_u32(n, min_u32(room_after(src), room_after(dst)));
+            memmove(unit_ptr(g, dst), unit_ptr(g, src), k * sizeof(uint16_t));
+            dst += k;
+            src += k;
+            n   -= k;
+        }
+    } else if (dst > src) {
+        /* From the top down so nothing is overwritten before it moves */
+        dst += n;
+        src += n;
+        while (n > 0) {
+            uint32_t k = min_u32(n, min_u32(room_before(src), room_before(dst)));
+            dst -= k;
+            src -= k;
+            n   -= k;
+            memmove(unit_ptr(g, dst), unit_ptr(g, src), k * sizeof(uint16_t));
+        }
+    }
+}
+
+static void span_write(GapBuffer *g, uint32_t p, const uint16_t *src, uint32_t n) {
+    while (n > 0) {
+        uint32_t k = min_u32(n, room_after(p));
+        memcpy(unit_ptr(g, p), src, k * sizeof(uint16_t));
+        p   += k;
+        src += k;
+        n   -= k;
+    }
+}
+
+static void span_read(const GapBuffer *g, uint32_t p, uint16_t *dst, uint32_t n) {
+    while (n > 0) {
+        uint32_t k = min_u32(n, room_after(p));
+        memcpy(dst, unit_ptr(g, p), k * sizeof(uint16_t));
+        p   += k;
+        dst += k;
+        n   -= k;
+    }
+}
+
+/* Widen the gap to at least n units with chunks from the pool */
+static bool grow(GapBuffer *g, uint32_t n) {
+    uint32_t gap = g->gap_end - g->gap_start;
+    if (n <= gap) return true;
+
+    uint32_t add = (n - gap + CHUNK_MASK) >> GAP_CHUNK_SHIFT;
+    if (!g->pool || g->chunk_count + add > GAP_MAX_CHUNKS || g->pool->free_count < add)
+        return false;
+    for (uint32_t i = 0; i < add; i++)
+        g->chunk[g->chunk_count++] = g->pool->free[--g->pool->free_count];
+
+    /* Slide the text after the gap up to the new end */
+    uint32_t old_capacity = g->capacity;
+    uint32_t added        = add << GAP_CHUNK_SHIFT;
+    g->capacity += added;
+    span_move(g, g->gap_end + added, g->gap_end, old_capacity - g->gap_end);
+    g->gap_end += added;
+    return true;
+}
+
+/* ─── Pool ────────────────────────────────────────────────────────── */
+
+void gap_pool_init(GapPool *p, uint16_t (*arena)[GAP_CHUNK_UNITS], uint32_t count) {
+    if (count > GAP_POOL_MAX) count = GAP_POOL_MAX;
+    for (uint32_t i = 0; i < count; i++) p->free[i] = arena[i];
+    p->free_count = count;
+}
+
+/* ─── Buffer ──────────────────────────────────────────────────────── */
+
+void gap_buffer_init(GapBuffer *g, GapPool *pool, uint32_t limit) {
+    memset(g, 0, sizeof(*g));
+    g->pool  = pool;
+    g->limit = min_u32(limit, GAP_MAX_UNITS);
+}
+
+void gap_buffer_clear(GapBuffer *g) {
+    while (g->chunk_count > 0)
+        g->pool->free[g->pool->free_count++] = g->chunk[--g->chunk_count];
+    g->capacity  = 0;
+    g->gap_start = 0;
+    g->gap_end   = 0;
+}
+
+/* Move the gap so it starts at logical index pos (<= length) */
+static void gap_move(GapBuffer *g, uint32_t pos) {
+    if (pos < g->gap_start) {
+        uint32_t n = g->gap_start - pos;
+        span_move(g, g->gap_end - n, pos, n);
+        g->gap_start -= n;
+        g->gap_end   -= n;
+    } else if (pos > g->gap_start) {
+        uint32_t n = pos - g->gap_start;
+        span_move(g, g->gap_start, g->gap_end, n);
+        g->gap_start += n;
+        g->gap_end   += n;
+    }
+}
+
+bool gap_buffer_insert(GapBuffer *g, uint32_t pos, const uint16_t *src, uint32_t n) {
+    uint32_t len = gap_buffer_length(g);
+    if (n > g->limit - len) return false;
+    if (!grow(g, n)) return false;
+    if (pos > len) pos = len;
+
+    gap_move(g, pos);
+    span_write(g, g->gap_start, src, n);
+    g->gap_start += n;
+    return true;
+}
+
+void gap_buffer_delete(GapBuffer *g, uint32_t pos, uint32_t n) {
+    uint32_t len = gap_buffer_length(g);
+    if (pos >= len) return;
+    if (n > len - pos) n = len - pos;
+
+    /* Deleting just before the gap (backspace) needs no move */
+    if (pos + n == g->gap_start) {
+        g->gap_start -= n;
+        return;
+    }
+    gap_move(g, pos);
+    g->gap_end += n;
+}
+
+uint32_t gap_buffer_copy(const GapBuffer *g, uint32_t pos, uint32_t n, uint16_t *dst) {
+    uint32_t len = gap_buffer_length(g);
+    if (pos >= len) return 0;
+    if (n > len - pos) n = len - pos;
+
+    uint32_t copied = 0;
+    if (pos < g->gap_start) {
+        copied = min_u32(g->gap_start - pos, n);
+        span_read(g, pos, dst, copied);
+        pos += copied;
+    }
+    if (copied < n)
+        span_read(g, pos + (g->gap_end - g->gap_start), dst + copied, n - copied);
+    return n;
+}
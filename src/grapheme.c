@@ -0,0 +1,141 @@
+/**
+ * @file grapheme.c
+ * @brief Grapheme cluster boundaries (see grapheme.h)
+ *
+ * Implements the extended grapheme cluster rules GB3-GB13 of UAX #29.
+ * The only look-behind the rules need is over Extend* for GB11 and over
+ * a run of regional indicators for GB12/13, so a boundary test touches a
+ * few units around the position, not the text before it.
+ */
+
+#include <stddef.h>
+
+#include "grapheme.h"
+
+/* Text to test: the session buffer, or a plain array (grapheme_fit) */
+typedef struct Units {
+    const GapBuffer *g;
+    const uint16_t  *a;
+    uint32_t         len;
+} Units;
+
+static inline uint16_t unit(const Units *u, uint32_t i) {
+    return u->g ? gap_buffer_at(u->g, i) : u->a[i];
+}
+
+static inline bool is_high(uint16_t c) { return c >= 0xD800 && c <= 0xDBFF; }
+static inline bool is_low(uint16_t c)  { return c >= 0xDC00 && c <= 0xDFFF; }
+
+/* Property of a unit that is not part of a pair: lone surrogates are controls */
+static inline uint8_t unit_prop(uint16_t c) {
+    return (c >= 0xD800 && c <= 0xDFFF) ? GRAPHEME_CONTROL : grapheme_prop(c);
+}
+
+/* Property of the code point starting at i */
+static uint8_t prop_at(const Units *u, uint32_t i) {
+    uint16_t c = unit(u, i);
+    if (is_high(c) && i + 1 < u->len) {
+        uint16_t d = unit(u, i + 1);
+        if (is_low(d)) return grapheme_prop(0x10000 + ((uint32_t)(c - 0xD800) << 10) + (d - 0xDC00));
+    }
+    return unit_prop(c);
+}
+
+/* Property of the code point ending at i (> 0); *start gets its first unit */
+static uint8_t prop_before(const Units *u, uint32_t i, uint32_t *start) {
+    uint16_t d = unit(u, i - 1);
+    if (is_low(d) && i >= 2) {
+        uint16_t c = unit(u, i - 2);
+        if (is_high(c)) {
+            *start = i - 2;
+            return grapheme_prop(0x10000 + ((uint32_t)(c - 0xD800) << 10) + (d - 0xDC00));
+        }
+    }
+    *start = i - 1;
+    return unit_prop(d);
+}
+
+static bool boundary(const Units *u, uint32_t pos) {
+    if (pos == 0 || pos >= u->len) return true;
+    if (is_low(unit(u, pos)) && is_high(unit(u, pos - 1))) return false;
+
+    uint32_t ls;
+    uint8_t lp = prop_before(u, pos, &ls), rp = prop_at(u, pos);
+    uint8_t l = lp & GRAPHEME_PROP_MASK, r = rp & GRAPHEME_PROP_MASK;
+
+    if (l == GRAPHEME_CR && r == GRAPHEME_LF) return false;                     /* GB3 */
+    if (l == GRAPHEME_CR || l == GRAPHEME_LF || l == GRAPHEME_CONTROL) return true;  /* GB4 */
+    if (r == GRAPHEME_CR || r == GRAPHEME_LF || r == GRAPHEME_CONTROL) return true;  /* GB5 */
+
+    switch (l) {                                                                /* GB6-8 */
+    case GRAPHEME_L:
+        if (r == GRAPHEME_L || r == GRAPHEME_V || r == GRAPHEME_LV || r == GRAPHEME_LVT)
+            return false;
+        break;
+    case GRAPHEME_LV:
+    case GRAPHEME_V:
+        if (r == GRAPHEME_V || r == GRAPHEME_T) return false;
+        break;
+    case GRAPHEME_LVT:
+    case GRAPHEME_T:
+        if (r == GRAPHEME_T) return false;
+        break;
+    default:
+        break;
+    }
+
+    if (r == GRAPHEME_EXTEND || r == GRAPHEME_ZWJ) return false;                /* GB9 */
+    if (r == GRAPHEME_SPACING_MARK) return false;                               /* GB9a */
+    if (l == GRAPHEME_PREPEND) return false;                                    /* GB9b */
+
+    /* GB11: ExtPict Extend* ZWJ x ExtPict */
+    if (l == GRAPHEME_ZWJ && (rp & GRAPHEME_PICTO)) {
+        uint32_t i = ls;
+        while (i > 0) {
+            uint8_t p = prop_before(u, i, &i);
+            if ((p & GRAPHEME_PROP_MASK) != GRAPHEME_EXTEND) return !(p & GRAPHEME_PICTO);
+        }
+        return true;
+    }
+
+    /* GB12/13: regional indicators pair up from the start of their run */
+    if (l == GRAPHEME_RI && r == GRAPHEME_RI) {
+        uint32_t run = 1, i = ls;
+        while (i > 0 && (prop_before(u, i, &i) & GRAPHEME_PROP_MASK) == GRAPHEME_RI) run++;
+        return (run & 1) == 0;
+    }
+
+    return true;                                                                /* GB999 */
+}
+
+/* ─── Public API ──────────────────────────────────────────────────── */
+
+bool grapheme_is_boundary(const GapBuffer *g, uint32_t pos) {
+    Units u = { g, NULL, gap_buffer_length(g) };
+    return boundary(&u, pos);
+}
+
+uint32_t grapheme_before(const GapBuffer *g, uint32_t pos) {
+    Units u = { g, NULL, gap_buffer_length(g) };
+    if (pos > u.len) pos = u.len;
+    if (pos == 0) return 0;
+    uint32_t p = pos - 1;
+    while (p > 0 && !boundary(&u, p)) p--;
+    return p;
+}
+
+uint32_t grapheme_after(const GapBuffer *g, uint32_t pos) {
+    Units u = { g, NULL, gap_buffer_length(g) };
+    if (pos >= u.len) return u.len;
+    uint32_t p = pos + 1;
+    while (p < u.len && !boundary(&u, p)) p++;
+    return p;
+}
+
+uint32_t grapheme_fit(const uint16_t *src, uint32_t n, uint32_t max) {
+    if (n <= max) return n;
+    Units u = { NULL, src, n };
+    uint32_t p = max;
+    while (p > 0 && !boundary(&u, p)) p--;
+    return p;
+}
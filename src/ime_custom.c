@@ -7,7 +7,20 @@
 
 #include "plugin_common.h"
 #include "ime_custom.h"
+#include "grapheme.h"
 #include "ime_hook.h" /* for OrbisImePanelType */
+#include "thumbgrid_ipc.h"
+
+/* Chunks for the session text and clipboard */
+static uint16_t g_text_arena[2 * GAP_MAX_CHUNKS][GAP_CHUNK_UNITS];
+static GapPool  g_text_pool;
+
+_Static_assert(2 * GAP_MAX_CHUNKS <= GAP_POOL_MAX, "text pool too small");
+
+/* Clipboard history in the IPC mapping, NULL if it is not mapped */
+static volatile TgClipStore *g_clip_store = NULL;
+
+#define CLIP_MASK (TG_CLIP_UNITS - 1)
 
 /* ─── Helpers ─────────────────────────────────────────────────────── */
 
@@ -46,6 +59,54 @@ static uint32_t wrap_index(int64_t index, uint32_t length) {
     return (uint32_t)wrapped;
 }
 
+/*
+ * Every edit goes through text_inserted() / text_delete() (clear_text()
+ * for everything), which keep the undo journal and word index in step
+ * with the gap buffer.
+ */
+
+/* Record n units just inserted into the text at pos */
+static void text_inserted(ImeSession *session, uint32_t pos, uint32_t n, bool joined) {
+    ime_journal_insert(&session->journal, &session->text, pos, n, joined);
+    word_index_insert(&session->words, &session->text, pos, n);
+    session->output_length += n;
+}
+
+/* Delete n units of the text at pos (within the text) */
+static void text_delete(ImeSession *session, uint32_t pos, uint32_t n) {
+    ime_journal_delete(&session->journal, &session->text, pos, n, false);
+    gap_buffer_delete(&session->text, pos, n);
+    word_index_delete(&session->words, &session->text, pos, n);
+    session->output_length -= n;
+}
+
+/* Delete the whole text and any selection */
+static void clear_text(ImeSession *session) {
+    ime_journal_delete(&session->journal, &session->text, 0,
+        session->output_length, false);
+    gap_buffer_clear(&session->text);
+    memset(&session->words, 0, sizeof(session->words));
+    session->output_length = 0;
+    session->text_cursor = 0;
+    session->selected_all = false;
+    session->sel_start = session->sel_end = 0;
+}
+
+/* Copy n units at pos of src in at dst_pos of dst; returns the count that fit */
+static uint32_t text_transfer(GapBuffer *dst, uint32_t dst_pos,
+                              const GapBuffer *src, uint32_t pos, uint32_t n) {
+    uint16_t bounce[64];
+    uint32_t done = 0;
+    while (done < n) {
+        uint32_t k = n - done;
+        if (k > ARRAY_SIZE(bounce)) k = ARRAY_SIZE(bounce);
+        k = gap_buffer_copy(src, pos + done, k, bounce);
+        if (k == 0 || !gap_buffer_insert(dst, dst_pos + done, bounce, k)) break;
+        done += k;
+    }
+    return done;
+}
+
 /* ─── Session Lifecycle ───────────────────────────────────────────── */
 
 int32_t ime_session_init(
@@ -58,6 +119,10 @@ int32_t ime_session_init(
     if (!session) {
         return IME_ERROR_INVALID_PARAM;
     }
+    if (max_length > IME_MAX_OUTPUT_LENGTH) {
+        LOG_WARN("IME session: max length %u clamped to %u",
+            max_length, IME_MAX_OUTPUT_LENGTH);
+    }
     if (max_length == 0 || max_length > IME_MAX_OUTPUT_LENGTH) {
         max_length = CLAMP(max_length, 1, IME_MAX_OUTPUT_LENGTH);
     }
@@ -69,6 +134,9 @@ int32_t ime_session_init(
     session->max_output_length = max_length;
     session->charset = charset_for_panel(panel_type, &session->charset_length);
     session->cursor_index = 0;
+    gap_pool_init(&g_text_pool, g_text_arena, ARRAY_SIZE(g_text_arena));
+    gap_buffer_init(&session->text, &g_text_pool, max_length);
+    gap_buffer_init(&session->clipboard, &g_text_pool, max_length);
 
     session->cycle_config = (ImeCycleConfig){
         .initial_delay_ms   = 400,
@@ -78,8 +146,11 @@ int32_t ime_session_init(
     };
 
     if (prefill) {
-        uint32_t prefill_len = safe_u16_strlen(prefill, max_length);
-        safe_u16_copy(session->output, prefill, max_length);
+        /* Read past the limit so a cluster cut by it is dropped whole */
+        uint32_t prefill_len = safe_u16_strlen(prefill, max_length + 1);
+        prefill_len = grapheme_fit(prefill, prefill_len, max_length);
+        gap_buffer_insert(&session->text, 0, prefill, prefill_len);
+        word_index_rebuild(&session->words, &session->text);
         session->output_length = prefill_len;
         session->text_cursor   = prefill_len;
     }
@@ -114,29 +185,27 @@ bool ime_session_confirm_char(ImeSession *session) {
     }
 
     char c = session->charset[session->cursor_index];
-    session->output[session->output_length] = (uint16_t)c;
-    session->output_length++;
-    session->output[session->output_length] = 0;
+    uint16_t unit = (uint16_t)c;
+    gap_buffer_insert(&session->text, session->output_length, &unit, 1);
+    text_inserted(session, session->output_length, 1, false);
     session->cursor_index = 0;
 
     LOG_DEBUG("Confirmed '%c', len=%u", c, session->output_length);
     return true;
 }
 
-/* Helper: delete any active selection (select-all or partial) before input */
-static void clear_if_selected(ImeSession *session) {
+/* Helper: delete any active selection (select-all or partial) before
+ * input. Returns true if text was deleted, so the input joins it in one
+ * undo step. */
+static bool clear_if_selected(ImeSession *session) {
+    uint32_t len = session->output_length;
     if (session->selected_all) {
-        session->output_length = 0;
-        session->text_cursor = 0;
-        session->output[0] = 0;
-        session->selected_all = false;
-        session->sel_start = session->sel_end = 0;
-        return;
-    }
-    /* Delete partial selection if active */
-    if (session->sel_start != session->sel_end) {
+        clear_text(session);
+    } else if (session->sel_start != session->sel_end) {
+        /* Delete partial selection if active */
         ime_session_delete_selection(session);
     }
+    return session->output_length != len;
 }
 
 bool ime_session_add_char(ImeSession *session, char c) {
@@ -144,30 +213,74 @@ bool ime_session_add_char(ImeSession *session, char c) {
 }
 
 bool ime_session_add_char16(ImeSession *session, uint16_t c) {
-    if (!session || session->state != IME_STATE_ACTIVE) {
+    return ime_session_add_text(session, &c, 1);
+}
+
+/*
+ * Type @p n units as one edit, replacing any selection. Near the length
+ * limit only the clusters that fit are inserted.
+ */
+bool ime_session_add_text(ImeSession *session, const uint16_t *text, uint32_t n) {
+    if (!session || session->state != IME_STATE_ACTIVE || !text || n == 0) {
         return false;
     }
 
     /* If any text is selected, delete it first */
-    clear_if_selected(session);
+    bool replaced = clear_if_selected(session);
 
     if (session->output_length >= session->max_output_length) {
         return false;
     }
+    n = grapheme_fit(text, n, session->max_output_length - session->output_length);
+    if (n == 0) return false;
 
-    /* Insert at text_cursor, shift chars right */
+    /* Insert at text_cursor; O(1) while typing at one spot */
     uint32_t pos = session->text_cursor;
     if (pos > session->output_length) pos = session->output_length;
 
-    for (uint32_t i = session->output_length; i > pos; i--) {
-        session->output[i] = session->output[i - 1];
+    gap_buffer_insert(&session->text, pos, text, n);
+    text_inserted(session, pos, n, replaced);
+    session->text_cursor = pos + n;
+
+    LOG_DEBUG("Added %u units at %u, len=%u", n, pos, session->output_length);
+    return true;
+}
+
+/*
+ * Replace the @p del units before the cursor with @p n units as one
+ * edit: how a composer rewrites the tail of its span. With nothing to
+ * delete, any selection is replaced as by typing. All or nothing: false
+ * if the result would pass the length limit.
+ */
+bool ime_session_replace_before(ImeSession *session, uint32_t del,
+                                const uint16_t *text, uint32_t n) {
+    if (!session || session->state != IME_STATE_ACTIVE || (n > 0 && !text)) {
+        return false;
     }
-    session->output[pos] = c;
-    session->output_length++;
-    session->text_cursor = pos + 1;
-    session->output[session->output_length] = 0;
 
-    LOG_DEBUG("Added char at %u, len=%u", pos, session->output_length);
+    bool replaced = false;
+    if (del == 0) {
+        replaced = clear_if_selected(session);
+    } else if (session->selected_all || session->sel_start != session->sel_end) {
+        return false;
+    }
+
+    uint32_t pos = session->text_cursor;
+    if (pos > session->output_length) pos = session->output_length;
+    if (del > pos || session->output_length - del + n > session->max_output_length) {
+        return false;
+    }
+
+    if (del > 0) {
+        pos -= del;
+        text_delete(session, pos, del);
+        replaced = true;
+    }
+    if (n > 0) {
+        gap_buffer_insert(&session->text, pos, text, n);
+        text_inserted(session, pos, n, replaced);
+    }
+    session->text_cursor = pos + n;
     return true;
 }
 
@@ -178,11 +291,7 @@ bool ime_session_backspace(ImeSession *session) {
 
     /* If all text is selected, clear everything */
     if (session->selected_all) {
-        session->output_length = 0;
-        session->text_cursor = 0;
-        session->output[0] = 0;
-        session->selected_all = false;
-        session->sel_start = session->sel_end = 0;
+        clear_text(session);
         return true;
     }
 
@@ -196,14 +305,36 @@ bool ime_session_backspace(ImeSession *session) {
         return false;
     }
 
-    /* Delete char at text_cursor - 1, shift chars left */
-    uint32_t pos = session->text_cursor - 1;
-    for (uint32_t i = pos; i < session->output_length - 1; i++) {
-        session->output[i] = session->output[i + 1];
+    /* Delete the cluster before text_cursor */
+    uint32_t end = session->text_cursor;
+    if (end > session->output_length) end = session->output_length;
+    uint32_t pos = grapheme_before(&session->text, end);
+    text_delete(session, pos, end - pos);
+    session->text_cursor = pos;
+    return true;
+}
+
+bool ime_session_delete_word(ImeSession *session) {
+    if (!session || session->state != IME_STATE_ACTIVE) {
+        return false;
+    }
+
+    /* A selection goes as with backspace */
+    if (session->selected_all || session->sel_start != session->sel_end) {
+        return ime_session_backspace(session);
+    }
+
+    uint32_t end = session->text_cursor;
+    if (end > session->output_length) end = session->output_length;
+    if (end == 0) {
+        return false;
     }
-    session->output_length--;
+
+    /* Back to the start of the word before the cursor, with the spaces after it */
+    uint32_t pos = ime_session_word_before(session, end);
+    text_delete(session, pos, end - pos);
     session->text_cursor = pos;
-    session->output[session->output_length] = 0;
+    LOG_DEBUG("Deleted word: %u chars at %u", end - pos, pos);
     return true;
 }
 
@@ -212,31 +343,74 @@ bool ime_session_backspace(ImeSession *session) {
 void ime_session_cursor_left(ImeSession *session) {
     if (!session || session->state != IME_STATE_ACTIVE) return;
     session->selected_all = false;
-    if (session->text_cursor > 0) {
-        session->text_cursor--;
-    }
+    ime_journal_seal(&session->journal);
+    session->text_cursor = ime_session_cluster_before(session, session->text_cursor);
 }
 
 void ime_session_cursor_right(ImeSession *session) {
     if (!session || session->state != IME_STATE_ACTIVE) return;
     session->selected_all = false;
-    if (session->text_cursor < session->output_length) {
-        session->text_cursor++;
-    }
+    ime_journal_seal(&session->journal);
+    session->text_cursor = ime_session_cluster_after(session, session->text_cursor);
 }
 
 void ime_session_cursor_home(ImeSession *session) {
     if (!session || session->state != IME_STATE_ACTIVE) return;
     session->selected_all = false;
+    ime_journal_seal(&session->journal);
     session->text_cursor = 0;
 }
 
 void ime_session_cursor_end(ImeSession *session) {
     if (!session || session->state != IME_STATE_ACTIVE) return;
     session->selected_all = false;
+    ime_journal_seal(&session->journal);
     session->text_cursor = session->output_length;
 }
 
+uint32_t ime_session_cluster_before(const ImeSession *session, uint32_t pos) {
+    return grapheme_before(&session->text, pos);
+}
+
+uint32_t ime_session_cluster_after(const ImeSession *session, uint32_t pos) {
+    return grapheme_after(&session->text, pos);
+}
+
+/* Word starts are by unit; one inside a cluster moves to the cluster's edge */
+static uint32_t snap_back(const ImeSession *session, uint32_t pos) {
+    return grapheme_is_boundary(&session->text, pos) ? pos
+         : grapheme_before(&session->text, pos);
+}
+
+static uint32_t snap_forward(const ImeSession *session, uint32_t pos) {
+    return grapheme_is_boundary(&session->text, pos) ? pos
+         : grapheme_after(&session->text, pos);
+}
+
+uint32_t ime_session_word_before(const ImeSession *session, uint32_t pos) {
+    if (pos > session->output_length) pos = session->output_length;
+    return snap_back(session, word_index_before(&session->words, pos));
+}
+
+uint32_t ime_session_word_after(const ImeSession *session, uint32_t pos) {
+    return snap_forward(session,
+        word_index_after(&session->words, pos, session->output_length));
+}
+
+void ime_session_word_left(ImeSession *session) {
+    if (!session || session->state != IME_STATE_ACTIVE) return;
+    session->selected_all = false;
+    ime_journal_seal(&session->journal);
+    session->text_cursor = ime_session_word_before(session, session->text_cursor);
+}
+
+void ime_session_word_right(ImeSession *session) {
+    if (!session || session->state != IME_STATE_ACTIVE) return;
+    session->selected_all = false;
+    ime_journal_seal(&session->journal);
+    session->text_cursor = ime_session_word_after(session, session->text_cursor);
+}
+
 /* ─── Selection ───────────────────────────────────────────────────── */
 
 void ime_session_set_selection(ImeSession *session, uint32_t start, uint32_t end) {
@@ -244,9 +418,10 @@ void ime_session_set_selection(ImeSession *session, uint32_t start, uint32_t end
     if (start > session->output_length) start = session->output_length;
     if (end > session->output_length) end = session->output_length;
     if (start > end) { uint32_t t = start; start = end; end = t; }
-    session->sel_start = start;
-    session->sel_end = end;
+    session->sel_start = snap_back(session, start);
+    session->sel_end = snap_forward(session, end);
     session->selected_all = false;
+    ime_journal_seal(&session->journal);
 }
 
 void ime_session_clear_selection(ImeSession *session) {
@@ -265,11 +440,7 @@ void ime_session_delete_selection(ImeSession *session) {
     if (e > session->output_length) e = session->output_length;
     if (s > session->output_length) return;
     uint32_t del_len = e - s;
-    for (uint32_t i = s; i + del_len < session->output_length; i++) {
-        session->output[i] = session->output[i + del_len];
-    }
-    session->output_length -= del_len;
-    session->output[session->output_length] = 0;
+    text_delete(session, s, del_len);
     session->text_cursor = s;
     session->sel_start = 0;
     session->sel_end = 0;
@@ -292,7 +463,7 @@ void ime_session_submit(ImeSession *session) {
         return;
     }
     if (session->caller_buffer) {
-        safe_u16_copy(session->caller_buffer, session->output,
+        ime_session_get_text(session, session->caller_buffer,
             session->max_output_length);
     }
     session->state = IME_STATE_CONFIRMING;
@@ -309,6 +480,73 @@ void ime_session_cancel(ImeSession *session) {
 
 /* ─── Clipboard Operations ───────────────────────────────────────── */
 
+void ime_clipboard_attach(volatile struct TgClipStore *store) {
+    g_clip_store = store;
+}
+
+/* Add the first n units of src to the history, unless they are its newest entry */
+static void clip_push(const GapBuffer *src, uint32_t n) {
+    volatile TgClipStore *c = g_clip_store;
+    if (!c || n == 0 || n > TG_CLIP_UNITS) return;
+
+    TgClipEntry last;
+    if (tg_clip_entry(c, c->count, c->unit_head, 0, &last) && last.length == n) {
+        uint32_t i = 0;
+        while (i < n && c->units[(last.start + i) & CLIP_MASK] == gap_buffer_at(src, i)) i++;
+        if (i == n) return;
+    }
+
+    uint32_t start = c->unit_head;
+    tg_clip_write_begin(c);
+    for (uint32_t done = 0; done < n; ) {
+        uint32_t at = (start + done) & CLIP_MASK;
+        uint32_t k  = TG_CLIP_UNITS - at;
+        if (k > n - done) k = n - done;
+        gap_buffer_copy(src, done, k, (uint16_t *)&c->units[at]);
+        done += k;
+    }
+    volatile TgClipEntry *e = &c->entry[c->count & (TG_CLIP_ENTRIES - 1)];
+    e->start     = start;
+    e->length    = n;
+    c->unit_head = start + n;
+    c->count++;
+    tg_clip_write_end(c);
+}
+
+/* Load history entry age (0 = newest) into the session clipboard */
+static bool clip_fetch(ImeSession *session, uint32_t age) {
+    const volatile TgClipStore *c = g_clip_store;
+    if (!c) return false;
+
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint32_t seq = tg_clip_read_begin(c);
+        if (seq & 1) continue;
+        TgClipEntry e;
+        if (!tg_clip_entry(c, c->count, c->unit_head, age, &e)) return false;
+
+        /* Anything past the session limit could never be pasted */
+        gap_buffer_clear(&session->clipboard);
+        for (uint32_t done = 0; done < e.length; ) {
+            uint32_t at = (e.start + done) & CLIP_MASK;
+            uint32_t k  = TG_CLIP_UNITS - at;
+            if (k > e.length - done) k = e.length - done;
+            if (!gap_buffer_insert(&session->clipboard, done,
+                                   (const uint16_t *)&c->units[at], k)) {
+                k = session->clipboard.limit - done;
+                gap_buffer_insert(&session->clipboard, done,
+                                  (const uint16_t *)&c->units[at], k);
+                break;
+            }
+            done += k;
+        }
+        if (tg_clip_read_end(c, seq)) {
+            session->clipboard_length = gap_buffer_length(&session->clipboard);
+            return true;
+        }
+    }
+    return false;
+}
+
 void ime_session_copy(ImeSession *session) {
     if (!session || session->state != IME_STATE_ACTIVE) return;
 
@@ -324,10 +562,10 @@ void ime_session_copy(ImeSession *session) {
         return;  /* nothing selected */
     }
 
-    uint32_t len = e - s;
-    if (len > IME_MAX_OUTPUT_LENGTH) len = IME_MAX_OUTPUT_LENGTH;
-    memcpy(session->clipboard, &session->output[s], len * sizeof(uint16_t));
+    gap_buffer_clear(&session->clipboard);
+    uint32_t len = text_transfer(&session->clipboard, 0, &session->text, s, e - s);
     session->clipboard_length = len;
+    clip_push(&session->clipboard, len);
     LOG_DEBUG("Clipboard copy: %u chars", len);
 }
 
@@ -337,11 +575,7 @@ void ime_session_cut(ImeSession *session) {
     ime_session_copy(session);
     if (session->clipboard_length > 0) {
         if (session->selected_all) {
-            session->output_length = 0;
-            session->text_cursor = 0;
-            session->output[0] = 0;
-            session->selected_all = false;
-            session->sel_start = session->sel_end = 0;
+            clear_text(session);
         } else {
             ime_session_delete_selection(session);
         }
@@ -349,44 +583,108 @@ void ime_session_cut(ImeSession *session) {
     LOG_DEBUG("Clipboard cut: %u chars in clipboard", session->clipboard_length);
 }
 
-void ime_session_paste(ImeSession *session) {
-    if (!session || session->state != IME_STATE_ACTIVE) return;
+/* Paste what is in the session clipboard, history entry age */
+static void paste_clipboard(ImeSession *session, uint32_t age) {
+    session->paste_valid = false;
     if (session->clipboard_length == 0) return;
 
     /* Delete any selection first */
-    if (session->selected_all) {
-        session->output_length = 0;
-        session->text_cursor = 0;
-        session->output[0] = 0;
-        session->selected_all = false;
-        session->sel_start = session->sel_end = 0;
-    } else if (session->sel_start != session->sel_end) {
-        ime_session_delete_selection(session);
-    }
+    bool replaced = clear_if_selected(session);
 
     uint32_t avail = session->max_output_length - session->output_length;
     uint32_t paste_len = session->clipboard_length;
-    if (paste_len > avail) paste_len = avail;
+    if (paste_len > avail) {
+        /* Only whole clusters of the clipboard */
+        paste_len = grapheme_is_boundary(&session->clipboard, avail) ? avail
+                  : grapheme_before(&session->clipboard, avail);
+    }
     if (paste_len == 0) return;
 
     uint32_t pos = session->text_cursor;
     if (pos > session->output_length) pos = session->output_length;
 
-    /* Shift existing chars right */
-    for (uint32_t i = session->output_length; i > pos; i--) {
-        session->output[i + paste_len - 1] = session->output[i - 1];
-    }
-    /* Insert clipboard */
-    memcpy(&session->output[pos], session->clipboard, paste_len * sizeof(uint16_t));
-    session->output_length += paste_len;
+    paste_len = text_transfer(&session->text, pos, &session->clipboard, 0, paste_len);
+    text_inserted(session, pos, paste_len, replaced);
     session->text_cursor = pos + paste_len;
-    session->output[session->output_length] = 0;
 
+    session->paste_valid = true;
+    session->paste_start = pos;
+    session->paste_end   = pos + paste_len;
+    session->paste_age   = age;
+    session->paste_op    = session->journal.first + session->journal.count;
     LOG_DEBUG("Clipboard paste: %u chars at pos %u", paste_len, pos);
 }
 
+void ime_session_paste(ImeSession *session) {
+    if (!session || session->state != IME_STATE_ACTIVE) return;
+
+    /* The newest copy from any dialog; without history, this session's */
+    clip_fetch(session, 0);
+    paste_clipboard(session, 0);
+}
+
+void ime_session_paste_older(ImeSession *session) {
+    if (!session || session->state != IME_STATE_ACTIVE) return;
+
+    /* A plain paste without history, or once the last paste was edited or left */
+    const ImeJournal *j = &session->journal;
+    if (!g_clip_store || !session->paste_valid || session->selected_all ||
+        session->sel_start != session->sel_end ||
+        session->text_cursor != session->paste_end ||
+        session->paste_op != j->first + j->count || j->applied != j->count) {
+        ime_session_paste(session);
+        return;
+    }
+
+    /* Step back through the history, round to the newest at its end */
+    uint32_t age = session->paste_age + 1;
+    if (!clip_fetch(session, age)) {
+        age = 0;
+        if (!clip_fetch(session, age)) return;
+    }
+    if (age == session->paste_age) return;
+
+    ime_session_set_selection(session, session->paste_start, session->paste_end);
+    paste_clipboard(session, age);
+}
+
+/* ─── Undo / Redo ────────────────────────────────────────────────── */
+
+/* Undo is rare next to typing, so the word index is simply rebuilt */
+static void after_replay(ImeSession *session, uint32_t cursor) {
+    word_index_rebuild(&session->words, &session->text);
+    session->output_length = gap_buffer_length(&session->text);
+    session->text_cursor = cursor;
+    ime_session_clear_selection(session);
+}
+
+bool ime_session_undo(ImeSession *session) {
+    if (!session || session->state != IME_STATE_ACTIVE) return false;
+    uint32_t cursor;
+    if (!ime_journal_undo(&session->journal, &session->text, &cursor)) return false;
+    after_replay(session, cursor);
+    LOG_DEBUG("Undo: len=%u cursor=%u", session->output_length, cursor);
+    return true;
+}
+
+bool ime_session_redo(ImeSession *session) {
+    if (!session || session->state != IME_STATE_ACTIVE) return false;
+    uint32_t cursor;
+    if (!ime_journal_redo(&session->journal, &session->text, &cursor)) return false;
+    after_replay(session, cursor);
+    LOG_DEBUG("Redo: len=%u cursor=%u", session->output_length, cursor);
+    return true;
+}
+
 /* ─── Display Helpers ─────────────────────────────────────────────── */
 
+uint32_t ime_session_get_text(const ImeSession *session, uint16_t *dst, uint32_t dst_len) {
+    if (!session || !dst || dst_len == 0) return 0;
+    uint32_t n = gap_buffer_copy(&session->text, 0, dst_len - 1, dst);
+    dst[n] = 0;
+    return n;
+}
+
 char ime_session_current_char(const ImeSession *session) {
     if (!session || session->state != IME_STATE_ACTIVE) {
         return 0;
@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <string.h>
 
 #include "plugin_common.h"
@@ -17,8 +18,11 @@
 #include "ime_custom.h"
 #include "input.h"
 #include "thumbgrid.h"
+#include "tg_engine.h"
 #include "overlay.h"
 #include "thumbgrid_ipc.h"
+#include "profile.h"
+#include "pad_record.h"
 
 #include <Detour.h>
 #include <GoldHEN.h>
@@ -30,72 +34,73 @@
 
 #define IME_DEFAULT_MAX_LENGTH  256
 
-/* Startup grace period — ignore input for first 300ms after init */
-#define IME_GRACE_PERIOD_US  300000
+/* Buffered samples drained per poll (the pad keeps about this many) */
+#define IME_PAD_BATCH           32
+
+/* A pad clock lag this far above the best seen means the clocks slipped */
+#define IME_PAD_CLOCK_SLIP_US   1000000
 
 /* Notification fallback throttle */
 #define IME_NOTIFY_INTERVAL_US  200000  /* 200ms between updates */
 #define IME_NOTIFY_REQ_ID       0x4349  /* "CI" - fixed reqId for replacement */
 
+#if TG_INPUT_THREAD_HZ > 0
+#define IME_INPUT_PERIOD_US     (1000000 / TG_INPUT_THREAD_HZ)
+#endif
+
 /* ─── Static State ────────────────────────────────────────────────── */
 
-static ImeHookState g_hook_state;
-static ImeSession   g_session;
-static ThumbGridState     g_tgrid;
-static bool         g_custom_active = false;
+static ImeHookState    g_hook_state;
+static ThumbGridEngine g_engine;    /* session, grid and input state */
+static bool            g_custom_active = false;
 
 /* Pad management */
 static int32_t    g_pad_handle  = -1;
 static bool       g_owns_pad    = false;
 static int32_t    g_user_id     = -1;
-static InputState g_input_state;
 
-/* Startup grace period */
-static uint64_t g_session_start_us = 0;
+/* scePadRead batch (one poll at a time) and the newest sample seen */
+static OrbisPadData g_pad_batch[IME_PAD_BATCH];
+static OrbisPadData g_pad_last;
+
+/*
+ * When each batch sample was taken, in sceKernelGetProcessTime() time.
+ * Pad timestamps run on their own clock; the offset is the smallest lag
+ * (process time at the read minus the newest timestamp) of the session.
+ */
+static uint64_t     g_pad_time[IME_PAD_BATCH];
+static int64_t      g_pad_clock_offset;
+static bool         g_pad_clock_valid = false;
+static uint64_t     g_pad_time_last;    /* time of the last sample stepped */
 
 /* Notification fallback state */
 static uint64_t g_last_notify_time_us = 0;
 static uint32_t g_last_display_hash   = 0;
 
-/* Cached screen dimensions (set by draw callback) */
-static uint32_t g_overlay_screen_w = 1920;
-static uint32_t g_overlay_screen_h = 1080;
-
-/* Backspace hold-to-repeat state */
-static bool     g_bs_held          = false;
-static uint64_t g_bs_start_us      = 0;
-static uint64_t g_bs_last_repeat_us = 0;
-
-/* X (cross) hold state for text selection */
-static bool     g_x_held           = false;
-static bool     g_x_dpad_used      = false;  /* D-pad was pressed during X hold */
-static uint32_t g_x_anchor         = 0;      /* cursor pos when X was pressed */
-
-/* L2 analog trigger state for shift hold */
-static uint8_t  g_l2_prev_analog   = 0;
-static bool     g_l2_shift_active  = false;  /* temporary shift currently applied */
-static int32_t  g_l2_saved_page    = -1;     /* page to revert to on release */
-
-/* L3 (left stick click) edge detection for accent toggle */
-static bool     g_l3_prev          = false;
+/*
+ * Input thread (TG_INPUT_THREAD_HZ > 0). While it runs it owns the pad
+ * read and the engine step; g_engine_mutex serialises it against the
+ * game's hook calls, which then only report the session state.
+ */
+#if TG_INPUT_THREAD_HZ > 0
+static OrbisPthreadMutex g_engine_mutex;
+static bool              g_engine_mutex_ok = false;
+static OrbisPthread      g_input_thread;
+static atomic_bool       g_input_running;
+static bool              g_input_joinable = false;
+
+#define ENGINE_LOCK()   do { if (g_engine_mutex_ok) scePthreadMutexLock(&g_engine_mutex); } while (0)
+#define ENGINE_UNLOCK() do { if (g_engine_mutex_ok) scePthreadMutexUnlock(&g_engine_mutex); } while (0)
+#else
+#define ENGINE_LOCK()   do { } while (0)
+#define ENGINE_UNLOCK() do { } while (0)
+#endif
 
 /* ─── IPC Shared Memory ──────────────────────────────────────────── */
 
 static volatile ThumbGridSharedState *g_ipc_map  = NULL;
 static int                      g_ipc_fd   = -1;
-
-#define BS_INITIAL_DELAY_US   400000   /* 400ms before first repeat */
-#define BS_REPEAT_INTERVAL_US  60000   /* 60ms between repeats */
-
-/* ─── Performance Instrumentation ─────────────────────────────────── */
-static uint64_t g_perf_last_log_us    = 0;
-static uint32_t g_perf_poll_count     = 0;     /* calls to GetStatus per interval */
-static uint64_t g_perf_poll_total_us  = 0;     /* total time in GetStatus */
-static uint64_t g_perf_poll_max_us    = 0;     /* worst-case GetStatus */
-static uint64_t g_perf_render_total_us = 0;    /* time in overlay_force_draw */
-static uint64_t g_perf_render_max_us  = 0;
-static uint64_t g_perf_input_total_us = 0;     /* time in input processing */
-#define PERF_LOG_INTERVAL_US  1000000  /* log every 1 second */
+static uint32_t                 g_ipc_window = 0;   /* text window start */
 
 /* ─── GoldHEN Detour Hooks ────────────────────────────────────────── */
 
@@ -118,6 +123,9 @@ static Detour g_hook_ime_term;
 #ifndef PROT_WRITE
 #define PROT_WRITE  0x02
 #endif
+#ifndef MAP_PRIVATE
+#define MAP_PRIVATE 0x0002
+#endif
 
 static const char *g_ipc_path_used = NULL;
 
@@ -134,8 +142,9 @@ static bool ipc_open(void) {
     };
 
     for (int i = 0; ipc_paths[i]; i++) {
+        /* Not truncated: the clipboard history outlives each game */
         g_ipc_fd = sceKernelOpen(ipc_paths[i],
-                                  0x0602, /* O_RDWR | O_CREAT | O_TRUNC */
+                                  0x0202, /* O_RDWR | O_CREAT */
                                   0666);
         if (g_ipc_fd >= 0) {
             g_ipc_path_used = ipc_paths[i];
@@ -149,10 +158,12 @@ static bool ipc_open(void) {
         return false;
     }
 
-    /* Extend file to TG_IPC_FILE_SIZE */
-    char zero = 0;
-    sceKernelLseek(g_ipc_fd, TG_IPC_FILE_SIZE - 1, 0 /* SEEK_SET */);
-    sceKernelWrite(g_ipc_fd, &zero, 1);
+    /* Extend file to TG_IPC_FILE_SIZE (new, or left by an older build) */
+    if (sceKernelLseek(g_ipc_fd, 0, 2 /* SEEK_END */) < TG_IPC_FILE_SIZE) {
+        char zero = 0;
+        sceKernelLseek(g_ipc_fd, TG_IPC_FILE_SIZE - 1, 0 /* SEEK_SET */);
+        sceKernelWrite(g_ipc_fd, &zero, 1);
+    }
     sceKernelLseek(g_ipc_fd, 0, 0);
 
     /* mmap shared */
@@ -169,6 +180,27 @@ static bool ipc_open(void) {
 
     g_ipc_map = (volatile ThumbGridSharedState *)addr;
     memset((void *)g_ipc_map, 0, sizeof(ThumbGridSharedState));
+
+    /* Latency histograms live in the second page; reset per game launch */
+    volatile TgStatsPage *stats =
+        (volatile TgStatsPage *)((uint8_t *)addr + TG_IPC_STATS_OFFSET);
+    tg_stats_init(stats);
+    PROF_ATTACH_STATS(stats);
+
+    volatile TgTracePage *trace =
+        (volatile TgTracePage *)((uint8_t *)addr + TG_IPC_TRACE_OFFSET);
+    tg_trace_init(trace, sceKernelGetTscFrequency());
+    PROF_ATTACH_TRACE(trace);
+
+    /* Clipboard history: kept unless missing or left mid-push by a crash */
+    volatile TgClipStore *clip =
+        (volatile TgClipStore *)((uint8_t *)addr + TG_IPC_CLIP_OFFSET);
+    if (!tg_clip_valid(clip) || (clip->sequence & 1)) {
+        tg_clip_init(clip);
+        LOG_INFO("IPC: clipboard history reset");
+    }
+    ime_clipboard_attach(clip);
+
     LOG_INFO("IPC: mapped at %p (fd=%d)", addr, g_ipc_fd);
     return true;
 }
@@ -180,6 +212,9 @@ static void ipc_close(void) {
         ((ThumbGridSharedState *)g_ipc_map)->ime_active = 0;
         thumbgrid_ipc_write_end(g_ipc_map);
 
+        PROF_ATTACH_STATS(NULL);
+        PROF_ATTACH_TRACE(NULL);
+        ime_clipboard_attach(NULL);
         sceKernelMunmap((void *)g_ipc_map, TG_IPC_FILE_SIZE);
         g_ipc_map = NULL;
     }
@@ -189,9 +224,24 @@ static void ipc_close(void) {
     }
 }
 
+/*
+ * Start of the text window shipped over IPC. It scrolls only when the
+ * cursor comes within TG_IPC_WINDOW_MARGIN of an edge, and never past
+ * the ends of the text.
+ */
+static uint32_t ipc_window_start(uint32_t start, uint32_t cursor, uint32_t length) {
+    if (cursor < start + TG_IPC_WINDOW_MARGIN)
+        start = cursor > TG_IPC_WINDOW_MARGIN ? cursor - TG_IPC_WINDOW_MARGIN : 0;
+    else if (cursor + TG_IPC_WINDOW_MARGIN > start + TG_IPC_WINDOW)
+        start = cursor + TG_IPC_WINDOW_MARGIN - TG_IPC_WINDOW;
+
+    uint32_t last = length > TG_IPC_WINDOW ? length - TG_IPC_WINDOW : 0;
+    return start < last ? start : last;
+}
+
 static void ipc_sync_state(void) {
     if (!g_ipc_map) return;
-    if (!g_custom_active || g_session.state != IME_STATE_ACTIVE) {
+    if (!g_custom_active || g_engine.session.state != IME_STATE_ACTIVE) {
         /* Just mark inactive */
         if (g_ipc_map->ime_active) {
             thumbgrid_ipc_write_begin(g_ipc_map);
@@ -206,44 +256,271 @@ static void ipc_sync_state(void) {
     thumbgrid_ipc_write_begin(g_ipc_map);
 
     m->ime_active    = 1;
-    m->selected_cell = g_tgrid.selected_cell;
-    m->current_page  = g_tgrid.current_page;
-    m->accent_mode   = g_tgrid.accent_mode ? 1 : 0;
-    m->output_length = g_session.output_length;
-    m->text_cursor   = g_session.text_cursor;
-    m->selected_all  = g_session.selected_all ? 1 : 0;
-    m->sel_start     = g_session.sel_start;
-    m->sel_end       = g_session.sel_end;
-    m->offset_x      = g_tgrid.offset_x;
-    m->offset_y      = g_tgrid.offset_y;
-
-    /* Copy output buffer */
-    uint32_t copy_len = g_session.output_length;
-    if (copy_len > TG_IPC_MAX_OUTPUT) copy_len = TG_IPC_MAX_OUTPUT;
-    memcpy(m->output, g_session.output, copy_len * sizeof(uint16_t));
+    m->selected_cell = g_engine.grid.selected_cell;
+    m->current_page  = g_engine.grid.current_page;
+    m->accent_layer  = g_engine.grid.accent_layer;
+    m->output_length = g_engine.session.output_length;
+    m->text_cursor   = g_engine.session.text_cursor;
+    m->selected_all  = g_engine.session.selected_all ? 1 : 0;
+    m->sel_start     = g_engine.session.sel_start;
+    m->sel_end       = g_engine.session.sel_end;
+    m->compose_start  = g_engine.composer.start;
+    m->compose_length = g_engine.composer.length;
+    m->offset_x      = g_engine.grid.offset_x;
+    m->offset_y      = g_engine.grid.offset_y;
+
+    /* Copy the text window, straight from both sides of the gap */
+    g_ipc_window = ipc_window_start(g_ipc_window, g_engine.session.text_cursor,
+                                    g_engine.session.output_length);
+    /* Never open the window on the second half of a surrogate pair */
+    if (g_ipc_window > 0 &&
+        (gap_buffer_at(&g_engine.session.text, g_ipc_window) & 0xFC00) == 0xDC00)
+        g_ipc_window--;
+    m->window_start  = g_ipc_window;
+    m->window_length = gap_buffer_copy(&g_engine.session.text, g_ipc_window,
+                                       TG_IPC_WINDOW, m->output);
 
     /* Copy title (UTF-16) */
-    memcpy(m->title, g_tgrid.title, TG_IPC_TITLE_MAX * sizeof(uint16_t));
+    memcpy(m->title, g_engine.grid.title, TG_IPC_TITLE_MAX * sizeof(uint16_t));
 
     /* Copy page name */
-    const ThumbGridPage *page = &g_tgrid.pages[g_tgrid.current_page];
+    const ThumbGridPage *page = &g_engine.grid.pages[g_engine.grid.current_page];
     strncpy(m->page_name, page->name, TG_IPC_PAGE_NAME_MAX - 1);
     m->page_name[TG_IPC_PAGE_NAME_MAX - 1] = '\0';
 
-    /* Copy cell characters */
-    memcpy(m->cells, page->chars, sizeof(m->cells));
+    /* Copy the page's keys */
+    memcpy(m->cells, page->keys, sizeof(m->cells));
+
+    /* Word completions */
+    m->suggestion_count = g_engine.suggestion_count;
+    memcpy(m->suggestions, g_engine.suggestions, sizeof(m->suggestions));
 
     /* L2+center override: show Cut/Copy/Paste/Caps on center cell */
-    if (g_l2_shift_active) {
-        m->cells[TG_CENTER_CELL][TG_BTN_TRIANGLE] = TG_SPECIAL_PASTE;
-        m->cells[TG_CENTER_CELL][TG_BTN_CIRCLE]   = TG_SPECIAL_CAPS;
-        m->cells[TG_CENTER_CELL][TG_BTN_CROSS]    = TG_SPECIAL_CUT;
-        m->cells[TG_CENTER_CELL][TG_BTN_SQUARE]   = TG_SPECIAL_COPY;
+    if (g_engine.l2_shift_active) {
+        m->cells[TG_CENTER_CELL][TG_BTN_TRIANGLE] = (TgKey){ .op = TG_OP_PASTE };
+        m->cells[TG_CENTER_CELL][TG_BTN_CIRCLE]   = (TgKey){ .op = TG_OP_CAPS };
+        m->cells[TG_CENTER_CELL][TG_BTN_CROSS]    = (TgKey){ .op = TG_OP_CUT };
+        m->cells[TG_CENTER_CELL][TG_BTN_SQUARE]   = (TgKey){ .op = TG_OP_COPY };
     }
 
-    m->shift_active = g_l2_shift_active ? 1 : 0;
+    m->shift_active = g_engine.l2_shift_active ? 1 : 0;
+    m->input_seq    = g_engine.session.input_seq;
 
     thumbgrid_ipc_write_end(g_ipc_map);
+
+    PROF_LAT_STAMP(g_engine.session.input_seq, TG_LAT_IPC);
+    PROF_LAT_PUBLISH(g_engine.session.input_seq);
+}
+
+/* ─── Word Completion Dictionary ──────────────────────────────────── */
+
+_Static_assert(sizeof(((ThumbGridSharedState *)0)->suggestions) ==
+               sizeof(((ThumbGridEngine *)0)->suggestions),
+               "IPC suggestions must mirror the engine's");
+
+static TgDict  g_dict;
+static void   *g_dict_map  = NULL;
+static size_t  g_dict_size = 0;
+
+/*
+ * Map TG_DICT_PATH read-only on first use. A missing file just leaves
+ * completion off; it is looked for again at the next session, so a
+ * dictionary copied over FTP works without a reboot.
+ */
+static void dict_open(void) {
+    if (!g_dict_map) {
+        int fd = sceKernelOpen(TG_DICT_PATH, 0x0000 /* O_RDONLY */, 0);
+        if (fd < 0) {
+            LOG_DEBUG("dict: %s not found, completion off", TG_DICT_PATH);
+        } else {
+            int64_t size = sceKernelLseek(fd, 0, 2 /* SEEK_END */);
+            void *addr = NULL;
+            int rc = size > 0
+                ? sceKernelMmap(0, (size_t)size, PROT_READ, MAP_PRIVATE, fd, 0, &addr)
+                : -1;
+            sceKernelClose(fd);     /* the mapping stays valid */
+
+            if (rc < 0 || addr == MAP_FAILED || !addr) {
+                LOG_WARN("dict: mmap failed: 0x%08X", rc);
+            } else if (tg_dict_attach(&g_dict, addr, (size_t)size) != IME_OK) {
+                sceKernelMunmap(addr, (size_t)size);
+            } else {
+                g_dict_map  = addr;
+                g_dict_size = (size_t)size;
+                LOG_INFO("dict: %u words, %u nodes from %s",
+                         g_dict.word_count, g_dict.node_count, TG_DICT_PATH);
+            }
+        }
+    }
+    g_engine.dict = g_dict_map ? &g_dict : NULL;
+}
+
+static void dict_close(void) {
+    if (g_dict_map) {
+        sceKernelMunmap(g_dict_map, g_dict_size);
+        g_dict_map  = NULL;
+        g_dict_size = 0;
+    }
+    g_engine.dict = NULL;
+}
+
+/* ─── Page File ───────────────────────────────────────────────────── */
+
+_Static_assert(TG_PAGE_NAME_MAX == TG_IPC_PAGE_NAME_MAX,
+               "IPC page names must hold the page file's");
+
+static TgPageSet g_pages;
+static void     *g_pages_map  = NULL;
+static size_t    g_pages_size = 0;
+
+/*
+ * Map TG_PAGES_PATH read-only on first use and start sessions from its
+ * pages; without a valid file the built-in pages are used, and the file
+ * is looked for again at the next session.
+ */
+static void pages_open(void) {
+    if (!g_pages_map) {
+        int fd = sceKernelOpen(TG_PAGES_PATH, 0x0000 /* O_RDONLY */, 0);
+        if (fd < 0) {
+            LOG_DEBUG("pages: %s not found, using the built-in pages", TG_PAGES_PATH);
+        } else {
+            int64_t size = sceKernelLseek(fd, 0, 2 /* SEEK_END */);
+            void *addr = NULL;
+            int rc = size > 0
+                ? sceKernelMmap(0, (size_t)size, PROT_READ, MAP_PRIVATE, fd, 0, &addr)
+                : -1;
+            sceKernelClose(fd);     /* the mapping stays valid */
+
+            if (rc < 0 || addr == MAP_FAILED || !addr) {
+                LOG_WARN("pages: mmap failed: 0x%08X", rc);
+            } else if (tg_pages_attach(&g_pages, addr, (size_t)size) != IME_OK) {
+                LOG_WARN("pages: %s rejected, using the built-in pages", TG_PAGES_PATH);
+                sceKernelMunmap(addr, (size_t)size);
+            } else {
+                g_pages_map  = addr;
+                g_pages_size = (size_t)size;
+                LOG_INFO("pages: %u pages from %s", g_pages.count, TG_PAGES_PATH);
+            }
+        }
+    }
+    thumbgrid_set_pages(g_pages_map ? &g_pages : NULL);
+}
+
+static void pages_close(void) {
+    thumbgrid_set_pages(NULL);
+    if (g_pages_map) {
+        sceKernelMunmap(g_pages_map, g_pages_size);
+        g_pages_map  = NULL;
+        g_pages_size = 0;
+    }
+}
+
+/* ─── Learned Word Store ──────────────────────────────────────────── */
+
+static TgLearnStore *g_learn_map  = NULL;
+static int32_t       g_learn_user = -1;
+
+/*
+ * Map a persistent store file shared read-write, creating and sizing it
+ * on first use. Commits write straight into the page cache and the
+ * kernel flushes them, so nothing is written from the poll path.
+ */
+static void *store_map(const char *path, size_t size) {
+    int fd = sceKernelOpen(path, 0x0202 /* O_RDWR | O_CREAT */, 0666);
+    if (fd < 0) {
+        LOG_WARN("store: open %s failed: 0x%08X", path, fd);
+        return NULL;
+    }
+
+    /* Extend a new file; an existing one keeps its contents */
+    char zero = 0;
+    if (sceKernelLseek(fd, 0, 2 /* SEEK_END */) < (int64_t)size) {
+        sceKernelLseek(fd, (int64_t)size - 1, 0 /* SEEK_SET */);
+        sceKernelWrite(fd, &zero, 1);
+    }
+    void *addr = NULL;
+    int rc = sceKernelMmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0, &addr);
+    sceKernelClose(fd);     /* the mapping stays valid */
+
+    if (rc < 0 || addr == MAP_FAILED || !addr) {
+        LOG_WARN("store: mmap %s failed: 0x%08X", path, rc);
+        return NULL;
+    }
+    LOG_INFO("store: %s mapped", path);
+    return addr;
+}
+
+/* Map the user's store; switching users remaps, failure turns learning off */
+static void learn_open(int32_t user_id) {
+    if (g_learn_map && g_learn_user != user_id) {
+        sceKernelMunmap(g_learn_map, sizeof(TgLearnStore));
+        g_learn_map = NULL;
+    }
+    if (!g_learn_map) {
+        char path[64];
+        snprintf(path, sizeof(path), TG_LEARN_PATH_FMT, (uint32_t)user_id);
+        g_learn_map = store_map(path, sizeof(TgLearnStore));
+        if (g_learn_map) {
+            g_learn_user = user_id;
+            tg_learn_attach(g_learn_map);
+        }
+    }
+    g_engine.learn = g_learn_map;
+}
+
+static void learn_close(void) {
+    if (g_learn_map) {
+        sceKernelMunmap(g_learn_map, sizeof(TgLearnStore));
+        g_learn_map  = NULL;
+        g_learn_user = -1;
+    }
+    g_engine.learn = NULL;
+}
+
+/* ─── Layout and Usage Log ────────────────────────────────────────── */
+
+static TgUsageStore *g_usage_map = NULL;
+
+/*
+ * Apply TG_LAYOUT_PATH to the letter pages, or the built-in layout when
+ * the file is missing or invalid. Read at every session so a layout
+ * copied over FTP takes effect at the next text field.
+ */
+static void layout_load(void) {
+    static char text[TG_LAYOUT_FILE_MAX];
+    char slots[TG_LAYOUT_SLOTS];
+
+    int fd = sceKernelOpen(TG_LAYOUT_PATH, 0x0000 /* O_RDONLY */, 0);
+    if (fd < 0) {
+        thumbgrid_apply_layout(NULL);
+        return;
+    }
+    int64_t len = sceKernelRead(fd, text, sizeof(text));
+    sceKernelClose(fd);
+
+    if (len < 0 || tg_layout_parse(text, (size_t)len, slots) != IME_OK ||
+        thumbgrid_apply_layout(slots) != IME_OK) {
+        LOG_WARN("layout: %s rejected, using the built-in layout", TG_LAYOUT_PATH);
+        thumbgrid_apply_layout(NULL);
+        return;
+    }
+    LOG_DEBUG("layout: %s applied", TG_LAYOUT_PATH);
+}
+
+static void usage_open(void) {
+    if (!g_usage_map) {
+        g_usage_map = store_map(TG_USAGE_PATH, sizeof(TgUsageStore));
+        if (g_usage_map) tg_usage_attach(g_usage_map);
+    }
+    g_engine.usage = g_usage_map;
+}
+
+static void usage_close(void) {
+    if (g_usage_map) {
+        sceKernelMunmap(g_usage_map, sizeof(TgUsageStore));
+        g_usage_map = NULL;
+    }
+    g_engine.usage = NULL;
 }
 
 /* ─── Helper: Resolve User ID ─────────────────────────────────────── */
@@ -288,6 +565,49 @@ static bool ime_hook_open_pad(int32_t user_id) {
     return false;
 }
 
+/**
+ * Drain the pad's sample buffer into g_pad_batch, oldest first, so a
+ * press and release between two polls are both seen, and give each its
+ * own time in g_pad_time. With nothing new the newest sample is repeated
+ * at @p now_us: grace and backspace repeat are timed and must still
+ * advance. Returns the sample count or a pad error.
+ */
+static int32_t ime_hook_read_pad(uint64_t now_us) {
+    if (g_pad_handle < 0) return -1;
+
+    int32_t n = scePadRead(g_pad_handle, g_pad_batch, IME_PAD_BATCH);
+    if (n < 0) return n;
+    if (n == 0) {
+        g_pad_batch[0] = g_pad_last;
+        g_pad_time[0]  = now_us;
+        return 1;
+    }
+
+    /* Firmware order is not documented; sort by timestamp if reversed */
+    if (n > 1 && g_pad_batch[0].timestamp > g_pad_batch[n - 1].timestamp) {
+        for (int32_t i = 0, j = n - 1; i < j; i++, j--) {
+            OrbisPadData t = g_pad_batch[i];
+            g_pad_batch[i] = g_pad_batch[j];
+            g_pad_batch[j] = t;
+        }
+    }
+    g_pad_last = g_pad_batch[n - 1];
+
+    int64_t lag = (int64_t)(now_us - g_pad_last.timestamp);
+    if (!g_pad_clock_valid || lag < g_pad_clock_offset ||
+        lag - g_pad_clock_offset > IME_PAD_CLOCK_SLIP_US) {
+        g_pad_clock_offset = lag;
+        g_pad_clock_valid  = true;
+    }
+    for (int32_t i = 0; i < n; i++) {
+        uint64_t t = g_pad_batch[i].timestamp + (uint64_t)g_pad_clock_offset;
+        if (g_pad_batch[i].timestamp == 0 || t > now_us) t = now_us;
+        if (t < g_pad_time_last) t = g_pad_time_last;   /* never step back */
+        g_pad_time[i] = t;
+    }
+    return n;
+}
+
 static void ime_hook_close_pad(void) {
     if (g_pad_handle >= 0 && g_owns_pad) {
         scePadClose(g_pad_handle);
@@ -302,15 +622,16 @@ static void ime_hook_close_pad(void) {
 static void thumbgrid_draw_callback(uint32_t *fb, uint32_t pitch,
                                uint32_t width, uint32_t height)
 {
-    if (!g_custom_active || g_session.state != IME_STATE_ACTIVE) {
+    if (!g_custom_active || g_engine.session.state != IME_STATE_ACTIVE) {
         return;
     }
 
     /* Cache screen dimensions for position clamping in poll loop */
-    g_overlay_screen_w = width;
-    g_overlay_screen_h = height;
+    g_engine.screen_w = width;
+    g_engine.screen_h = height;
 
-    thumbgrid_draw(&g_tgrid, &g_session, fb, pitch, width, height);
+    thumbgrid_draw(&g_engine.grid, &g_engine.session, &g_engine.composer,
+                   fb, pitch, width, height);
 }
 
 /* ─── Notification Fallback Display ───────────────────────────────── */
@@ -320,40 +641,28 @@ static void thumbgrid_draw_callback(uint32_t *fb, uint32_t pitch,
  * is unavailable. Shows current cell characters, text buffer, and page.
  */
 static void notify_fallback_display(uint64_t now_us) {
-    if (g_session.state != IME_STATE_ACTIVE) return;
+    if (g_engine.session.state != IME_STATE_ACTIVE) return;
 
     /* Throttle updates */
     if (now_us - g_last_notify_time_us < IME_NOTIFY_INTERVAL_US) return;
 
     /* Build compact display of current cell's characters */
-    const ThumbGridPage *page = &g_tgrid.pages[g_tgrid.current_page];
-    int cell = g_tgrid.selected_cell;
-    char c_tri = page->chars[cell][TG_BTN_TRIANGLE];
-    char c_cir = page->chars[cell][TG_BTN_CIRCLE];
-    char c_crs = page->chars[cell][TG_BTN_CROSS];
-    char c_sqr = page->chars[cell][TG_BTN_SQUARE];
-
-    /* Special function labels for center cell */
-    char tri_buf[4], cir_buf[4], crs_buf[4], sqr_buf[4];
-
-    #define CHAR_OR_LABEL(c, buf) do { \
-        if ((c) == TG_SPECIAL_BKSP) { buf[0]='B'; buf[1]='S'; buf[2]=0; } \
-        else if ((c) == TG_SPECIAL_SPACE) { buf[0]='S'; buf[1]='P'; buf[2]=0; } \
-        else { buf[0]=(c); buf[1]=0; } \
-    } while(0)
-
-    CHAR_OR_LABEL(c_tri, tri_buf);
-    CHAR_OR_LABEL(c_cir, cir_buf);
-    CHAR_OR_LABEL(c_crs, crs_buf);
-    CHAR_OR_LABEL(c_sqr, sqr_buf);
-    #undef CHAR_OR_LABEL
+    const ThumbGridPage *page = &g_engine.grid.pages[g_engine.grid.current_page];
+    int cell = g_engine.grid.selected_cell;
+    const TgKey *keys = page->keys[cell];
+    char tri_buf[TG_KEY_UTF8_MAX], cir_buf[TG_KEY_UTF8_MAX];
+    char crs_buf[TG_KEY_UTF8_MAX], sqr_buf[TG_KEY_UTF8_MAX];
+    tg_key_utf8(&keys[TG_BTN_TRIANGLE], tri_buf);
+    tg_key_utf8(&keys[TG_BTN_CIRCLE], cir_buf);
+    tg_key_utf8(&keys[TG_BTN_CROSS], crs_buf);
+    tg_key_utf8(&keys[TG_BTN_SQUARE], sqr_buf);
 
     /* Convert text buffer */
     char text_buf[48];
-    uint32_t tlen = g_session.output_length;
+    uint32_t tlen = g_engine.session.output_length;
     if (tlen > 40) tlen = 40;
     for (uint32_t i = 0; i < tlen; i++) {
-        uint16_t ch = g_session.output[i];
+        uint16_t ch = ime_session_char_at(&g_engine.session, i);
         text_buf[i] = (ch < 128) ? (char)ch : '?';
     }
     text_buf[tlen] = '_';
@@ -361,8 +670,8 @@ static void notify_fallback_display(uint64_t now_us) {
 
     /* Simple hash to avoid redundant updates */
     uint32_t hash = (uint32_t)cell ^ (tlen << 8) ^
-                    ((uint32_t)g_tgrid.current_page << 16) ^
-                    ((uint32_t)c_tri << 24);
+                    ((uint32_t)g_engine.grid.current_page << 16) ^
+                    ((uint32_t)(keys[TG_BTN_TRIANGLE].text[0] | keys[TG_BTN_TRIANGLE].op) << 24);
     if (hash == g_last_display_hash) return;
     g_last_display_hash = hash;
     g_last_notify_time_us = now_us;
@@ -390,47 +699,142 @@ static void notify_fallback_display(uint64_t now_us) {
     sceKernelSendNotificationRequest(0, &req, sizeof(req), 0);
 }
 
-/* ─── ThumbGrid Action Dispatch ────────────────────────────────────── */
-
-static void dispatch_face_button(int button_index) {
-    char ch = thumbgrid_get_char(&g_tgrid, button_index);
-    if (ch == 0) return;
+/* ─── Input Poll ──────────────────────────────────────────────────── */
 
-    if (thumbgrid_is_special(&g_tgrid, button_index)) {
-        /* Center cell special functions */
-        switch (ch) {
-        case TG_SPECIAL_BKSP:
-            ime_session_backspace(&g_session);
-            break;
-        case TG_SPECIAL_SPACE:
-            ime_session_add_char(&g_session, ' ');
-            break;
-        case TG_SPECIAL_ACCENT:
-            thumbgrid_toggle_accent(&g_tgrid);
-            LOG_DEBUG("ThumbGrid: accent mode %s", g_tgrid.accent_mode ? "ON" : "OFF");
-            break;
-        case TG_SPECIAL_SELALL:
-            ime_session_select_all(&g_session);
-            LOG_DEBUG("ThumbGrid: select all");
-            break;
-        case TG_SPECIAL_EXIT:
-            ime_session_cancel(&g_session);
-            LOG_INFO("ThumbGrid: exit via center cell");
-            break;
+/**
+ * One input poll of an active session: read the pad, step the engine
+ * and publish the result to IPC. Runs on the game's GetStatus thread,
+ * or on the input thread when TG_INPUT_THREAD_HZ > 0.
+ */
+static OrbisImeDialogStatus ime_poll(void) {
+    /* 1. Get timestamp */
+    uint64_t now_us = sceKernelGetProcessTime();
+    PROF_BEGIN(PROF_IME_POLL);
+    PROF_BEGIN(PROF_IME_INPUT);
+
+    /* 2. Read controller: every sample buffered since the last poll */
+    PROF_PHASE_BEGIN(TG_PHASE_PAD_READ);
+    int32_t n_samples = ime_hook_read_pad(now_us);
+    PROF_PHASE_END(TG_PHASE_PAD_READ);
+    int32_t pad_rc = 0;
+    if (n_samples < 0) {
+        if (g_pad_handle >= 0) {
+            LOG_DEBUG("scePadRead failed: 0x%08X", n_samples);
         }
-    } else {
-        /* Normal character — apply accent if active */
-        if (g_tgrid.accent_mode) {
-            uint16_t accented = thumbgrid_accent_lookup(ch);
-            if (accented) {
-                ime_session_add_char16(&g_session, accented);
-                return;
-            }
+        /* Step once on an empty sample so edges and timers stay current */
+        pad_rc = n_samples;
+        memset(&g_pad_batch[0], 0, sizeof(g_pad_batch[0]));
+        g_pad_time[0] = now_us;
+        n_samples = 1;
+    }
+    PROF_END(PROF_IME_INPUT);
+
+    /* 3. Advance the engine once per sample, at the time it was taken:
+     * edges, cell, shift, selection, actions. Effects accumulate over
+     * the batch. */
+    PROF_BEGIN(PROF_IME_STEP);
+    PROF_PHASE_BEGIN(TG_PHASE_ENGINE_STEP);
+    uint32_t fx = 0;
+    for (int32_t i = 0; i < n_samples; i++) {
+        const OrbisPadData *pd = &g_pad_batch[i];
+        uint64_t t_us = g_pad_time[i];
+        g_pad_time_last = t_us;
+        PAD_REC_SAMPLE(t_us - g_engine.start_us, pad_rc, pd);
+        TgPadInput pad = {
+            .buttons = pd->buttons,
+            .lx = pd->leftStick.x,  .ly = pd->leftStick.y,
+            .rx = pd->rightStick.x, .ry = pd->rightStick.y,
+            .l2 = pd->analogButtons.l2, .r2 = pd->analogButtons.r2,
+        };
+        fx |= tg_engine_step(&g_engine, &pad, t_us);
+        if (fx & TG_FX_FINISHED) break;
+    }
+    PROF_PHASE_END(TG_PHASE_ENGINE_STEP);
+    PROF_END(PROF_IME_STEP);
+
+    /* 3a. New input event: start a latency trace stamped before the step */
+    uint32_t event_seq = 0;
+    if (fx & TG_FX_EVENT) {
+        event_seq = PROF_LAT_BEGIN_AT_PHASE(TG_PHASE_ENGINE_STEP);
+        if (event_seq) g_engine.session.input_seq = event_seq;
+    }
+
+    if (fx & TG_FX_GRACE) {
+        /* Show fallback display during grace period too */
+        if (!overlay_is_active()) {
+            notify_fallback_display(now_us);
         }
-        ime_session_add_char(&g_session, ch);
+        return ORBIS_IME_DIALOG_STATUS_RUNNING;
+    }
+    if (fx & TG_FX_FINISHED) {
+        return ORBIS_IME_DIALOG_STATUS_FINISHED;
+    }
+    PROF_LAT_STAMP(event_seq, TG_LAT_DISPATCH);
+
+    /* 4. Sync state to IPC shared memory for shell overlay. This runs
+     * every poll: the sequence bump doubles as the shell's heartbeat. */
+    PROF_BEGIN(PROF_IME_IPC_SYNC);
+    PROF_PHASE_BEGIN(TG_PHASE_IPC_SYNC);
+    ipc_sync_state();
+    PROF_PHASE_END(TG_PHASE_IPC_SYNC);
+    PROF_END(PROF_IME_IPC_SYNC);
+
+    PROF_END(PROF_IME_POLL);
+    PROF_TICK();
+
+    return ORBIS_IME_DIALOG_STATUS_RUNNING;
+}
+
+#if TG_INPUT_THREAD_HZ > 0
+static void *input_thread_main(void *arg) {
+    (void)arg;
+    while (atomic_load(&g_input_running)) {
+        ENGINE_LOCK();
+        bool active = g_custom_active &&
+                      g_engine.session.state == IME_STATE_ACTIVE;
+        if (active) ime_poll();
+        ENGINE_UNLOCK();
+        if (!active) break;   /* GetStatus reports the end from here on */
+        sceKernelUsleep(IME_INPUT_PERIOD_US);
     }
+    return NULL;
 }
 
+static void input_thread_stop(void);
+
+static void input_thread_start(void) {
+    if (!g_engine_mutex_ok) return;
+    if (g_input_joinable) input_thread_stop();  /* never drop a joinable handle */
+    atomic_store(&g_input_running, true);
+    int rc = scePthreadCreate(&g_input_thread, NULL, input_thread_main,
+                              NULL, "tg_ime_input");
+    if (rc != 0) {
+        /* Not fatal: GetStatus polls the pad itself as without the thread */
+        LOG_WARN("Input thread failed: 0x%08X, polling from GetStatus", rc);
+        atomic_store(&g_input_running, false);
+        return;
+    }
+    g_input_joinable = true;
+    LOG_INFO("Input thread started at %d Hz", TG_INPUT_THREAD_HZ);
+}
+
+/* Call without g_engine_mutex held */
+static void input_thread_stop(void) {
+    atomic_store(&g_input_running, false);
+    if (g_input_joinable) {
+        scePthreadJoin(g_input_thread, NULL);
+        g_input_joinable = false;
+    }
+}
+#define INPUT_THREAD_START()  input_thread_start()
+#define INPUT_THREAD_STOP()   input_thread_stop()
+#define INPUT_THREAD_OWNS_POLL() g_input_joinable
+#else
+#define INPUT_THREAD_START()  do { } while (0)
+#define INPUT_THREAD_STOP()   do { } while (0)
+#define INPUT_THREAD_OWNS_POLL() false
+#endif
+
 /* ─── Hooked Functions ────────────────────────────────────────────── */
 
 static int32_t hooked_ime_dialog_init(const OrbisImeDialogParam *param,
@@ -456,16 +860,32 @@ static int32_t hooked_ime_dialog_init(const OrbisImeDialogParam *param,
         max_len = IME_DEFAULT_MAX_LENGTH;
     }
 
+    /*
+     * A dialog re-opened without Term may still have its input thread
+     * running: join it before the stores and engine are replaced, and
+     * hold the engine lock across the re-init anyway.
+     */
+    INPUT_THREAD_STOP();
+    ENGINE_LOCK();
+
     /* Resolve user ID */
     g_user_id = ime_hook_get_user_id(param->user_id);
     LOG_DEBUG("  resolved user_id: %d", g_user_id);
 
-    /* Initialize the IME session */
-    int32_t rc = ime_session_init(&g_session, param->type,
-        max_len, param->input_text_buffer, param->input_text_buffer);
+    /* Initialize session, grid and input state; starts the grace period */
+    dict_open();
+    learn_open(g_user_id);
+    usage_open();
+    pages_open();
+    layout_load();
+    g_ipc_window = 0;
+    int32_t rc = tg_engine_init(&g_engine, param->type, param->option, max_len,
+        param->input_text_buffer, param->input_text_buffer, param->title,
+        sceKernelGetProcessTime());
     if (rc != IME_OK) {
-        LOG_ERROR("ime_session_init failed: %d, falling back to system IME", rc);
+        LOG_ERROR("tg_engine_init failed: %d, falling back to system IME", rc);
         g_custom_active = false;
+        ENGINE_UNLOCK();
         if (g_hook_state.original_init) {
             return g_hook_state.original_init(param, param_extended);
         }
@@ -476,54 +896,37 @@ static int32_t hooked_ime_dialog_init(const OrbisImeDialogParam *param,
     if (!ime_hook_open_pad(g_user_id)) {
         LOG_ERROR("Failed to open pad, falling back to system IME");
         g_custom_active = false;
-        g_session.state = IME_STATE_INACTIVE;
+        g_engine.session.state = IME_STATE_INACTIVE;
+        ENGINE_UNLOCK();
         if (g_hook_state.original_init) {
             return g_hook_state.original_init(param, param_extended);
         }
         return IME_ERROR_GENERIC;
     }
 
-    /* Initialize ThumbGrid grid state */
-    thumbgrid_init(&g_tgrid);
+    /* Until the first buffered sample arrives, assume centred sticks */
+    memset(&g_pad_last, 0, sizeof(g_pad_last));
+    g_pad_last.leftStick.x  = 128;
+    g_pad_last.leftStick.y  = 128;
+    g_pad_last.rightStick.x = 128;
+    g_pad_last.rightStick.y = 128;
+
+    /* Samples buffered before the session step at its start */
+    g_pad_clock_valid = false;
+    g_pad_time_last   = g_engine.start_us;
 
     /* Open IPC shared memory for shell overlay */
     ipc_open();
 
-    /* Capture title from IME param (keep as UTF-16) */
-    g_tgrid.title[0] = 0;
-    if (param->title) {
-        const uint16_t *t = param->title;
-        uint32_t i = 0;
-        while (t[i] != 0 && i < TG_TITLE_MAX - 1) {
-            g_tgrid.title[i] = t[i];
-            i++;
-        }
-        g_tgrid.title[i] = 0;
-        LOG_DEBUG("  title: (UTF-16, %u chars)", i);
-    }
-
-    /* Reset input state and start grace period */
-    memset(&g_input_state, 0, sizeof(g_input_state));
-    g_input_state.stick_x  = 128;  /* center */
-    g_input_state.stick_y  = 128;
-    g_input_state.rstick_x = 128;
-    g_input_state.rstick_y = 128;
-    g_session_start_us    = sceKernelGetProcessTime();
     g_last_notify_time_us = 0;
     g_last_display_hash   = 0;
 
     g_custom_active = true;
-
-    /* Reset repeat state */
-    g_bs_held = false;
-
-    /* Reset X hold and L2 analog state */
-    g_x_held = false;
-    g_x_dpad_used = false;
-    g_l2_prev_analog = 0;
-    g_l2_shift_active = false;
-    g_l2_saved_page = -1;
-    g_l3_prev = false;
+    /* A password dialog's trace would replay the password */
+    if (!g_engine.no_learn)
+        PAD_REC_BEGIN(param->type, max_len, param->input_text_buffer);
+    ENGINE_UNLOCK();
+    INPUT_THREAD_START();
 
     /* Framebuffer overlay disabled — PUI shell overlay handles rendering */
     /* overlay_set_draw_callback(thumbgrid_draw_callback); */
@@ -543,292 +946,21 @@ static OrbisImeDialogStatus hooked_ime_dialog_get_status(void) {
         return g_hook_state.original_get_status();
     }
 
-    /* Map terminal states immediately */
-    if (g_session.state == IME_STATE_CONFIRMING ||
-        g_session.state == IME_STATE_CANCELLED) {
-        return ORBIS_IME_DIALOG_STATUS_FINISHED;
-    }
-    if (g_session.state == IME_STATE_INACTIVE) {
-        return ORBIS_IME_DIALOG_STATUS_NONE;
-    }
-
-    /* === Active state: process input === */
-
-    /* 1. Get timestamp */
-    uint64_t now_us = sceKernelGetProcessTime();
-    uint64_t poll_entry_us = now_us;  /* PERF: entry time */
-
-    /* 2. Read controller */
-    OrbisPadData pad_data;
-    memset(&pad_data, 0, sizeof(pad_data));
-
-    if (g_pad_handle >= 0) {
-        int32_t rc = scePadReadState(g_pad_handle, &pad_data);
-        if (rc != 0) {
-            LOG_DEBUG("scePadReadState failed: 0x%08X", rc);
-        }
-    }
-
-    /* 3. Update input edge detection (always, to keep state current) */
-    input_update(&g_input_state, pad_data.buttons,
-                 pad_data.leftStick.x, pad_data.leftStick.y,
-                 pad_data.rightStick.x, pad_data.rightStick.y, now_us);
-
-    /* 4. Update cell selection from left analog stick */
-    thumbgrid_select_cell(&g_tgrid, g_input_state.stick_x, g_input_state.stick_y);
-
-    /* 4b. Update widget position from right analog stick */
-    thumbgrid_update_position(&g_tgrid, g_input_state.rstick_x, g_input_state.rstick_y,
-                         g_overlay_screen_w, g_overlay_screen_h);
-
-    uint64_t input_done_us = sceKernelGetProcessTime();  /* PERF */
-    g_perf_input_total_us += (input_done_us - poll_entry_us);
-
-    /*
-     * 5. Grace period: ignore all actions for the first 300ms.
-     * The player is likely still holding whatever button opened the
-     * text field. We keep reading the pad (step 3) so edge detection
-     * stays accurate, but don't act on anything until the grace
-     * period expires.
-     */
-    if (now_us - g_session_start_us < IME_GRACE_PERIOD_US) {
-        /* Keep L2/L3 tracking in sync during grace so we don't
-         * get a false trigger on the first post-grace frame */
-        g_l2_prev_analog = pad_data.analogButtons.l2;
-        g_l3_prev = (pad_data.buttons & PAD_BUTTON_L3) != 0;
-        /* Show fallback display during grace period too */
-        if (!overlay_is_active()) {
-            notify_fallback_display(now_us);
-        }
-        return ORBIS_IME_DIALOG_STATUS_RUNNING;
-    }
-
-    /* 6. L2 analog trigger: hold for shift */
-    {
-        uint8_t l2 = pad_data.analogButtons.l2;
-
-        /* L2 just crossed engage threshold → apply temporary shift */
-        if (l2 >= 60 && !g_l2_shift_active && g_l2_prev_analog < 60) {
-            g_l2_saved_page = g_tgrid.current_page;
-            /* Toggle between page 0 (lower) and 1 (upper) */
-            if (g_tgrid.current_page == 0)      g_tgrid.current_page = 1;
-            else if (g_tgrid.current_page == 1)  g_tgrid.current_page = 0;
-            g_l2_shift_active = true;
-        }
-
-        /* L2 released → revert temporary shift */
-        if (l2 < 40 && g_l2_prev_analog >= 40) {
-            if (g_l2_shift_active && g_l2_saved_page >= 0) {
-                g_tgrid.current_page = g_l2_saved_page;
-            }
-            g_l2_shift_active = false;
-            g_l2_saved_page = -1;
-        }
-
-        g_l2_prev_analog = l2;
-    }
-
-    /* 6a. L3 (left stick click): accent toggle */
-    {
-        bool l3_now = (pad_data.buttons & PAD_BUTTON_L3) != 0;
-        if (l3_now && !g_l3_prev) {
-            thumbgrid_toggle_accent(&g_tgrid);
-            LOG_DEBUG("ThumbGrid: L3 accent mode %s", g_tgrid.accent_mode ? "ON" : "OFF");
-        }
-        g_l3_prev = l3_now;
-    }
-
-    /* 6b. L2+center override: Cut/Copy/Paste/Caps on center cell while shift held */
-    bool l2_center_override = (g_l2_shift_active && g_tgrid.selected_cell == TG_CENTER_CELL);
-
-    /* 6c. X (cross) hold state machine for text selection */
-    {
-        bool x_pressed = input_just_pressed(&g_input_state, PAD_BUTTON_CROSS);
-        bool x_held_now = input_is_held(&g_input_state, PAD_BUTTON_CROSS);
-        bool x_released = (g_input_state.buttons_released & PAD_BUTTON_CROSS) != 0;
-
-        if (x_pressed) {
-            g_x_held = true;
-            g_x_dpad_used = false;
-            g_x_anchor = g_session.text_cursor;
-        }
-
-        if (x_released && g_x_held) {
-            if (!g_x_dpad_used) {
-                if (l2_center_override) {
-                    /* L2+center X → Cut */
-                    ime_session_cut(&g_session);
-                    LOG_DEBUG("ThumbGrid: L2+center X = cut");
-                } else {
-                    /* X tapped without D-pad → input character */
-                    dispatch_face_button(TG_BTN_CROSS);
-                }
-            }
-            g_x_held = false;
-            /* Keep selection active if D-pad was used */
-        }
-
-        (void)x_held_now; /* used implicitly via g_x_held */
-    }
-
-    /* 7. Get action from button edges */
-    ImeAction action = input_get_action(&g_input_state);
-
-    /* 7a. Dispatch action */
-    switch (action) {
-    case IME_ACTION_CANCEL:
-        ime_session_cancel(&g_session);
-        LOG_INFO("ThumbGrid: cancelled");
-        return ORBIS_IME_DIALOG_STATUS_FINISHED;
-
-    case IME_ACTION_SUBMIT:
-        ime_session_submit(&g_session);
-        LOG_INFO("ThumbGrid: R2 submit (%u chars)", g_session.output_length);
-        return ORBIS_IME_DIALOG_STATUS_FINISHED;
-
-    case IME_ACTION_FACE_TRIANGLE:
-        if (l2_center_override) {
-            ime_session_paste(&g_session);
-            LOG_DEBUG("ThumbGrid: L2+center Triangle = paste");
-        } else {
-            dispatch_face_button(TG_BTN_TRIANGLE);
-        }
-        break;
-
-    case IME_ACTION_FACE_CIRCLE:
-        if (l2_center_override) {
-            /* Caps lock toggle: make current page permanent */
-            g_l2_shift_active = false;
-            g_l2_saved_page = -1;  /* don't revert on L2 release */
-            LOG_DEBUG("ThumbGrid: L2+center Circle = caps lock -> page %d", g_tgrid.current_page);
-        } else {
-            dispatch_face_button(TG_BTN_CIRCLE);
-        }
-        break;
-
-    case IME_ACTION_FACE_SQUARE:
-        if (l2_center_override) {
-            ime_session_copy(&g_session);
-            LOG_DEBUG("ThumbGrid: L2+center Square = copy");
-        } else {
-            dispatch_face_button(TG_BTN_SQUARE);
-        }
-        break;
-
-    case IME_ACTION_CURSOR_HOME:
-        if (g_x_held) {
-            /* X held + D-pad up: select from anchor to start */
-            g_x_dpad_used = true;
-            g_session.text_cursor = 0;
-            ime_session_set_selection(&g_session, g_x_anchor, 0);
-        } else {
-            ime_session_clear_selection(&g_session);
-            ime_session_cursor_home(&g_session);
-        }
-        break;
-
-    case IME_ACTION_CURSOR_END:
-        if (g_x_held) {
-            /* X held + D-pad down: select from anchor to end */
-            g_x_dpad_used = true;
-            g_session.text_cursor = g_session.output_length;
-            ime_session_set_selection(&g_session, g_x_anchor,
-                                      g_session.output_length);
-        } else {
-            ime_session_clear_selection(&g_session);
-            ime_session_cursor_end(&g_session);
-        }
-        break;
-
-    case IME_ACTION_CURSOR_LEFT:
-        if (g_x_held) {
-            g_x_dpad_used = true;
-            if (g_session.text_cursor > 0) g_session.text_cursor--;
-            ime_session_set_selection(&g_session, g_x_anchor,
-                                      g_session.text_cursor);
-        } else {
-            ime_session_clear_selection(&g_session);
-            ime_session_cursor_left(&g_session);
-        }
-        break;
-
-    case IME_ACTION_CURSOR_RIGHT:
-        if (g_x_held) {
-            g_x_dpad_used = true;
-            if (g_session.text_cursor < g_session.output_length)
-                g_session.text_cursor++;
-            ime_session_set_selection(&g_session, g_x_anchor,
-                                      g_session.text_cursor);
-        } else {
-            ime_session_clear_selection(&g_session);
-            ime_session_cursor_right(&g_session);
-        }
-        break;
-
-    case IME_ACTION_PAGE_NEXT:
-    case IME_ACTION_PAGE_PREV:
-        thumbgrid_toggle_symbols(&g_tgrid);
-        LOG_DEBUG("ThumbGrid: L1/R1 symbols -> page %d", g_tgrid.current_page);
-        break;
-
-    case IME_ACTION_NONE:
-    default:
-        break;
-    }
-
-    /* 7b. Backspace hold-to-repeat */
-    {
-        bool sq_held = input_is_held(&g_input_state, PAD_BUTTON_SQUARE);
-        char sq_char = thumbgrid_get_char(&g_tgrid, TG_BTN_SQUARE);
-        bool is_bs = (sq_char == TG_SPECIAL_BKSP);
-
-        if (sq_held && is_bs) {
-            if (!g_bs_held) {
-                g_bs_held = true;
-                g_bs_start_us = now_us;
-                g_bs_last_repeat_us = now_us;
-            } else if (now_us - g_bs_start_us >= BS_INITIAL_DELAY_US) {
-                if (now_us - g_bs_last_repeat_us >= BS_REPEAT_INTERVAL_US) {
-                    ime_session_backspace(&g_session);
-                    g_bs_last_repeat_us = now_us;
-                }
-            }
-        } else {
-            g_bs_held = false;
-        }
-    }
-
-    /* 7c. Sync state to IPC shared memory for shell overlay */
-    ipc_sync_state();
-
-    /* PERF: Accumulate poll stats and log once per second */
-    {
-        uint64_t poll_exit_us = sceKernelGetProcessTime();
-        uint64_t poll_us = poll_exit_us - poll_entry_us;
-        g_perf_poll_count++;
-        g_perf_poll_total_us += poll_us;
-        if (poll_us > g_perf_poll_max_us) g_perf_poll_max_us = poll_us;
-
-        if (poll_exit_us - g_perf_last_log_us >= PERF_LOG_INTERVAL_US) {
-            printf("[CIME] PERF: polls/s=%u  avg=%luus  max=%luus | "
-                   "render avg=%luus max=%luus | input avg=%luus\n",
-                g_perf_poll_count,
-                (unsigned long)(g_perf_poll_count ? g_perf_poll_total_us / g_perf_poll_count : 0),
-                (unsigned long)g_perf_poll_max_us,
-                (unsigned long)(g_perf_poll_count ? g_perf_render_total_us / g_perf_poll_count : 0),
-                (unsigned long)g_perf_render_max_us,
-                (unsigned long)(g_perf_poll_count ? g_perf_input_total_us / g_perf_poll_count : 0));
-            g_perf_last_log_us     = poll_exit_us;
-            g_perf_poll_count      = 0;
-            g_perf_poll_total_us   = 0;
-            g_perf_poll_max_us     = 0;
-            g_perf_render_total_us = 0;
-            g_perf_render_max_us   = 0;
-            g_perf_input_total_us  = 0;
-        }
+    ENGINE_LOCK();
+    OrbisImeDialogStatus status;
+    if (g_engine.session.state == IME_STATE_CONFIRMING ||
+        g_engine.session.state == IME_STATE_CANCELLED) {
+        status = ORBIS_IME_DIALOG_STATUS_FINISHED;
+    } else if (g_engine.session.state == IME_STATE_INACTIVE) {
+        status = ORBIS_IME_DIALOG_STATUS_NONE;
+    } else if (INPUT_THREAD_OWNS_POLL()) {
+        /* The input thread reads the pad; just report where it is */
+        status = ORBIS_IME_DIALOG_STATUS_RUNNING;
+    } else {
+        status = ime_poll();
     }
-
-    return ORBIS_IME_DIALOG_STATUS_RUNNING;
+    ENGINE_UNLOCK();
+    return status;
 }
 
 static int32_t hooked_ime_dialog_get_result(OrbisImeDialogResult *result) {
@@ -850,15 +982,15 @@ static int32_t hooked_ime_dialog_get_result(OrbisImeDialogResult *result) {
 
     memset(result, 0, sizeof(OrbisImeDialogResult));
 
-    if (g_session.state == IME_STATE_CONFIRMING) {
+    if (g_engine.session.state == IME_STATE_CONFIRMING) {
         result->end_status = ORBIS_IME_DIALOG_END_STATUS_OK;
         LOG_DEBUG("GetResult: OK (text already in caller buffer)");
-    } else if (g_session.state == IME_STATE_CANCELLED) {
+    } else if (g_engine.session.state == IME_STATE_CANCELLED) {
         result->end_status = ORBIS_IME_DIALOG_END_STATUS_USER_CANCELED;
         LOG_DEBUG("GetResult: USER_CANCELED");
     } else {
         result->end_status = ORBIS_IME_DIALOG_END_STATUS_ABORTED;
-        LOG_WARN("GetResult: unexpected state %d", g_session.state);
+        LOG_WARN("GetResult: unexpected state %d", g_engine.session.state);
     }
 
     return IME_OK;
@@ -868,6 +1000,8 @@ static int32_t hooked_ime_dialog_term(void) {
     LOG_DEBUG("sceImeDialogTerm called");
 
     if (g_custom_active) {
+        INPUT_THREAD_STOP();
+
         /* Disable overlay rendering */
         overlay_set_draw_callback(NULL);
 
@@ -879,12 +1013,15 @@ static int32_t hooked_ime_dialog_term(void) {
         }
 
         ime_hook_close_pad();
+        PAD_REC_END();
         g_custom_active = false;
-        g_session.state = IME_STATE_INACTIVE;
-        memset(&g_input_state, 0, sizeof(g_input_state));
+        g_engine.session.state = IME_STATE_INACTIVE;
+        memset(&g_engine.input, 0, sizeof(g_engine.input));
         g_last_notify_time_us = 0;
         g_last_display_hash   = 0;
         LOG_INFO("ThumbGrid IME session terminated");
+        PROF_SUMMARY("session");
+        PROF_TRACE_DUMP(TG_TRACE_JSON_GAME, PROF_PID_GAME);
         return IME_OK;
     }
 
@@ -905,8 +1042,16 @@ int32_t ime_hook_install(void) {
     LOG_INFO("Installing IME dialog hooks...");
 
     memset(&g_hook_state, 0, sizeof(g_hook_state));
-    memset(&g_session, 0, sizeof(g_session));
-    memset(&g_input_state, 0, sizeof(g_input_state));
+    memset(&g_engine, 0, sizeof(g_engine));
+
+#if TG_INPUT_THREAD_HZ > 0
+    if (!g_engine_mutex_ok) {
+        int mrc = scePthreadMutexInit(&g_engine_mutex, NULL, "tg_ime_engine");
+        g_engine_mutex_ok = (mrc == 0);
+        if (!g_engine_mutex_ok)
+            LOG_WARN("Engine mutex init failed: 0x%08X, no input thread", mrc);
+    }
+#endif
 
     /*
      * Load the IME Dialog module and resolve function addresses.
@@ -990,13 +1135,19 @@ int32_t ime_hook_remove(void) {
 
     /* Clean up any active session */
     if (g_custom_active) {
+        INPUT_THREAD_STOP();
         overlay_set_draw_callback(NULL);
         ime_hook_close_pad();
+        PAD_REC_END();
         g_custom_active = false;
     }
 
-    /* Close IPC shared memory */
+    /* Close IPC shared memory and the word stores */
     ipc_close();
+    dict_close();
+    learn_close();
+    usage_close();
+    pages_close();
 
     if (g_hook_state.hooks_installed) {
         if (g_hook_state.original_init) {
@@ -1018,9 +1169,16 @@ int32_t ime_hook_remove(void) {
     }
 
     memset(&g_hook_state, 0, sizeof(g_hook_state));
-    memset(&g_input_state, 0, sizeof(g_input_state));
+    memset(&g_engine.input, 0, sizeof(g_engine.input));
     g_custom_active = false;
-    g_session.state = IME_STATE_INACTIVE;
+    g_engine.session.state = IME_STATE_INACTIVE;
+
+#if TG_INPUT_THREAD_HZ > 0
+    if (g_engine_mutex_ok) {
+        scePthreadMutexDestroy(&g_engine_mutex);
+        g_engine_mutex_ok = false;
+    }
+#endif
 
     LOG_INFO("All hooks removed");
     return IME_OK;
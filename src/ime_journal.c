@@ -0,0 +1,223 @@
+/**
+ * @file ime_journal.c
+ * @brief Undo/redo journal of text edits (see ime_journal.h)
+ */
+
+#include <string.h>
+
+#include "ime_journal.h"
+
+#define OPS_MASK   (IME_JOURNAL_OPS - 1)
+#define UNITS_MASK (IME_JOURNAL_UNITS - 1)
+
+static inline ImeJournalOp *op_at(ImeJournal *j, uint32_t i) {
+    return &j->ops[(j->first + i) & OPS_MASK];
+}
+
+void ime_journal_reset(ImeJournal *j) {
+    j->first     = 0;
+    j->applied   = 0;
+    j->count     = 0;
+    j->unit_head = 0;
+    j->sealed    = false;
+}
+
+/* ─── Recording ───────────────────────────────────────────────────── */
+
+/* Units of payload still referenced */
+static uint32_t units_used(ImeJournal *j) {
+    return j->count ? j->unit_head - op_at(j, 0)->text : 0;
+}
+
+static void drop_oldest(ImeJournal *j) {
+    j->first++;
+    j->count--;
+    if (j->applied) j->applied--;
+    /* Its partner is gone; what is left must undo on its own */
+    if (j->count) op_at(j, 0)->joined = 0;
+}
+
+/*
+ * Make room for an op with n units of payload: forget what was undone,
+ * then the oldest ops. Returns false, with the journal cleared, if n
+ * units can never fit.
+ */
+static bool make_room(ImeJournal *j, uint32_t n, uint32_t ops) {
+    if (j->count > j->applied) {
+        j->count  = j->applied;
+        j->sealed = true;
+        if (j->count) {
+            const ImeJournalOp *last = op_at(j, j->count - 1);
+            j->unit_head = last->text + last->len;
+        }
+    }
+    if (n > IME_JOURNAL_UNITS) {
+        ime_journal_reset(j);
+        return false;
+    }
+    while (j->count && (j->count + ops > IME_JOURNAL_OPS ||
+                        units_used(j) + n > IME_JOURNAL_UNITS))
+        drop_oldest(j);
+    return true;
+}
+
+/* Append n units of the text at pos to the payload */
+static void put_text(ImeJournal *j, const GapBuffer *g, uint32_t pos, uint32_t n) {
+    while (n > 0) {
+        uint32_t at = j->unit_head & UNITS_MASK;
+        uint32_t k  = IME_JOURNAL_UNITS - at;
+        if (k > n) k = n;
+        gap_buffer_copy(g, pos, k, &j->units[at]);
+        j->unit_head += k;
+        pos += k;
+        n   -= k;
+    }
+}
+
+/* Turn a forward payload backward, in place */
+static void reverse_text(ImeJournal *j, const ImeJournalOp *op) {
+    for (uint32_t a = op->text, b = op->text + op->len - 1; a < b; a++, b--) {
+        uint16_t t = j->units[a & UNITS_MASK];
+        j->units[a & UNITS_MASK] = j->units[b & UNITS_MASK];
+        j->units[b & UNITS_MASK] = t;
+    }
+}
+
+/* The newest op, if the next edit may extend it */
+static ImeJournalOp *open_op(ImeJournal *j, ImeJournalKind kind) {
+    if (j->sealed || j->count == 0 || j->count != j->applied) return NULL;
+    ImeJournalOp *op = op_at(j, j->count - 1);
+    if (op->kind != kind || op->len >= IME_JOURNAL_COALESCE_MAX) return NULL;
+    return op;
+}
+
+static ImeJournalOp *push_op(ImeJournal *j, ImeJournalKind kind,
+                             uint32_t pos, uint32_t n, bool joined) {
+    ImeJournalOp *op = op_at(j, j->count);
+    op->pos      = pos;
+    op->len      = n;
+    op->text     = j->unit_head;
+    op->kind     = (uint8_t)kind;
+    op->joined   = (joined && j->count) ? 1 : 0;
+    op->reversed = 0;
+    op->reserved = 0;
+    j->count++;
+    j->applied = j->count;
+    j->sealed  = false;
+    return op;
+}
+
+void ime_journal_insert(ImeJournal *j, const GapBuffer *g, uint32_t pos,
+                        uint32_t n, bool joined) {
+    if (n == 0) return;
+
+    /* A typed character extending the word being typed */
+    ImeJournalOp *op = (n == 1 && !joined) ? open_op(j, IME_JOURNAL_INSERT) : NULL;
+    if (op && pos == op->pos + op->len) {
+        uint16_t last = j->units[(op->text + op->len - 1) & UNITS_MASK];
+        if (!(last == ' ' && gap_buffer_at(g, pos) != ' ') && make_room(j, 1, 0)) {
+            put_text(j, g, pos, 1);
+            op->len++;
+            return;
+        }
+    }
+
+    if (!make_room(j, n, 1)) return;
+    push_op(j, IME_JOURNAL_INSERT, pos, n, joined);
+    put_text(j, g, pos, n);
+}
+
+void ime_journal_delete(ImeJournal *j, const GapBuffer *g, uint32_t pos,
+                        uint32_t n, bool joined) {
+    if (n == 0) return;
+
+    /*
+     * A backspace (one cluster) just before the last one: prepend, with
+     * the payload stored backward so it only ever grows at the end
+     */
+    ImeJournalOp *op = (n <= IME_JOURNAL_COALESCE_MAX && !joined)
+                     ? open_op(j, IME_JOURNAL_DELETE) : NULL;
+    if (op && pos + n == op->pos && make_room(j, n, 0)) {
+        if (!op->reversed) reverse_text(j, op);
+        for (uint32_t i = n; i > 0; i--)
+            put_text(j, g, pos + i - 1, 1);
+        op->pos -= n;
+        op->len += n;
+        op->reversed = 1;
+        return;
+    }
+
+    if (!make_room(j, n, 1)) return;
+    push_op(j, IME_JOURNAL_DELETE, pos, n, joined);
+    put_text(j, g, pos, n);
+}
+
+/* ─── Replay ──────────────────────────────────────────────────────── */
+
+/* Put an op's payload back into the text at its position */
+static void restore(const ImeJournal *j, const ImeJournalOp *op, GapBuffer *g) {
+    if (!op->reversed) {
+        for (uint32_t done = 0; done < op->len; ) {
+            uint32_t at = (op->text + done) & UNITS_MASK;
+            uint32_t k  = IME_JOURNAL_UNITS - at;
+            if (k > op->len - done) k = op->len - done;
+            gap_buffer_insert(g, op->pos + done, &j->units[at], k);
+            done += k;
+        }
+        return;
+    }
+
+    /* Backward payload: each chunk, reversed, goes in front of the last */
+    uint16_t bounce[64];
+    const uint32_t bounce_len = sizeof(bounce) / sizeof(bounce[0]);
+    for (uint32_t done = 0; done < op->len; ) {
+        uint32_t k = op->len - done;
+        if (k > bounce_len) k = bounce_len;
+        for (uint32_t i = 0; i < k; i++)
+            bounce[k - 1 - i] = j->units[(op->text + done + i) & UNITS_MASK];
+        gap_buffer_insert(g, op->pos, bounce, k);
+        done += k;
+    }
+}
+
+static void revert_op(const ImeJournal *j, const ImeJournalOp *op, GapBuffer *g,
+                      uint32_t *cursor) {
+    if (op->kind == IME_JOURNAL_INSERT) {
+        gap_buffer_delete(g, op->pos, op->len);
+        *cursor = op->pos;
+    } else {
+        restore(j, op, g);
+        *cursor = op->pos + op->len;
+    }
+}
+
+static void apply_op(const ImeJournal *j, const ImeJournalOp *op, GapBuffer *g,
+                     uint32_t *cursor) {
+    if (op->kind == IME_JOURNAL_INSERT) {
+        restore(j, op, g);
+        *cursor = op->pos + op->len;
+    } else {
+        gap_buffer_delete(g, op->pos, op->len);
+        *cursor = op->pos;
+    }
+}
+
+bool ime_journal_undo(ImeJournal *j, GapBuffer *g, uint32_t *cursor) {
+    if (j->applied == 0) return false;
+    const ImeJournalOp *op;
+    do {
+        op = op_at(j, --j->applied);
+        revert_op(j, op, g, cursor);
+    } while (op->joined && j->applied > 0);
+    j->sealed = true;
+    return true;
+}
+
+bool ime_journal_redo(ImeJournal *j, GapBuffer *g, uint32_t *cursor) {
+    if (j->applied == j->count) return false;
+    do {
+        apply_op(j, op_at(j, j->applied++), g, cursor);
+    } while (j->applied < j->count && op_at(j, j->applied)->joined);
+    j->sealed = true;
+    return true;
+}
@@ -24,47 +24,45 @@ void input_update(InputState *state, uint32_t raw_buttons,
     state->rstick_y         = rstick_y;
 }
 
-ImeAction input_get_action(const InputState *state) {
-    if (!state) {
-        return IME_ACTION_NONE;
-    }
-    /* Priority: Cancel > Submit > Face buttons > Cursor > Page
-     * NOTE: L2 (shift/caps) handled via analog trigger in ime_hook.c
-     * NOTE: X (cross) handled via hold-state machine in ime_hook.c */
-    if (state->buttons_pressed & PAD_BUTTON_OPTIONS) {
-        return IME_ACTION_CANCEL;
-    }
-    if (state->buttons_pressed & PAD_BUTTON_R2) {
-        return IME_ACTION_SUBMIT;
-    }
-    if (state->buttons_pressed & PAD_BUTTON_TRIANGLE) {
-        return IME_ACTION_FACE_TRIANGLE;
-    }
-    if (state->buttons_pressed & PAD_BUTTON_CIRCLE) {
-        return IME_ACTION_FACE_CIRCLE;
-    }
-    if (state->buttons_pressed & PAD_BUTTON_SQUARE) {
-        return IME_ACTION_FACE_SQUARE;
-    }
-    if (state->buttons_pressed & PAD_BUTTON_UP) {
-        return IME_ACTION_CURSOR_HOME;
-    }
-    if (state->buttons_pressed & PAD_BUTTON_DOWN) {
-        return IME_ACTION_CURSOR_END;
-    }
-    if (state->buttons_pressed & PAD_BUTTON_LEFT) {
-        return IME_ACTION_CURSOR_LEFT;
-    }
-    if (state->buttons_pressed & PAD_BUTTON_RIGHT) {
-        return IME_ACTION_CURSOR_RIGHT;
-    }
-    if (state->buttons_pressed & PAD_BUTTON_R1) {
-        return IME_ACTION_PAGE_NEXT;
+/*
+ * Button edge -> action, in dispatch order: chorded edits first, then
+ * Submit, then Cancel, so text typed in the same frame as R2 lands
+ * before the session ends.
+ * NOTE: L2 (shift/caps) handled via analog trigger in tg_engine.c
+ * NOTE: X (cross) handled via hold-state machine in tg_engine.c
+ */
+static const struct {
+    uint32_t  button;
+    ImeAction action;
+} k_action_map[INPUT_MAX_EVENTS] = {
+    { PAD_BUTTON_TRIANGLE, IME_ACTION_FACE_TRIANGLE },
+    { PAD_BUTTON_CIRCLE,   IME_ACTION_FACE_CIRCLE   },
+    { PAD_BUTTON_SQUARE,   IME_ACTION_FACE_SQUARE   },
+    { PAD_BUTTON_UP,       IME_ACTION_CURSOR_HOME   },
+    { PAD_BUTTON_DOWN,     IME_ACTION_CURSOR_END    },
+    { PAD_BUTTON_LEFT,     IME_ACTION_CURSOR_LEFT   },
+    { PAD_BUTTON_RIGHT,    IME_ACTION_CURSOR_RIGHT  },
+    { PAD_BUTTON_R1,       IME_ACTION_PAGE_NEXT     },
+    { PAD_BUTTON_L1,       IME_ACTION_PAGE_PREV     },
+    { PAD_BUTTON_R3,       IME_ACTION_ACCEPT_WORD   },
+    { PAD_BUTTON_R2,       IME_ACTION_SUBMIT        },
+    { PAD_BUTTON_OPTIONS,  IME_ACTION_CANCEL        },
+};
+
+uint32_t input_get_actions(const InputState *state, InputEvent *out,
+                           uint32_t max_events) {
+    if (!state || !out || state->buttons_pressed == 0) {
+        return 0;
     }
-    if (state->buttons_pressed & PAD_BUTTON_L1) {
-        return IME_ACTION_PAGE_PREV;
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < INPUT_MAX_EVENTS && n < max_events; i++) {
+        if (state->buttons_pressed & k_action_map[i].button) {
+            out[n].action       = k_action_map[i].action;
+            out[n].timestamp_us = state->timestamp_us;
+            n++;
+        }
     }
-    return IME_ACTION_NONE;
+    return n;
 }
 
 bool input_just_pressed(const InputState *state, uint32_t button) {
@@ -0,0 +1,534 @@
+/**
+ * @file log_ring.c
+ * @brief Asynchronous per-thread log rings with a background flusher
+ *
+ * Each logging thread claims one single-producer/single-consumer ring
+ * the first time it logs. log_ring_emit() walks the format string once
+ * and copies the raw argument values (and %s contents) into the next
+ * slot; no formatting, locking or I/O happens on the caller's thread.
+ * The flusher formats records in order per thread and passes them to
+ * the sink in batches.
+ *
+ * A thread's ring is given back when the thread exits, by the
+ * destructor of a thread-specific key, or earlier in
+ * log_ring_thread_exit(). head and tail carry over to the next owner,
+ * so records the thread left queued are still flushed in order.
+ */
+
+#include "log_ring.h"
+
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <orbis/libkernel.h>
+
+/* ─── Record / ring layout ────────────────────────────────────────── */
+
+typedef struct LogRecord {
+    const char *fmt;
+    uint16_t    arg_len;
+    uint8_t     truncated;    /* arguments did not fit in args[] */
+    uint8_t     args[LOG_RING_ARG_BYTES];
+} LogRecord;
+
+typedef struct LogRing {
+    atomic_uintptr_t owner;   /* OrbisPthread of the producer, 0 = free */
+    atomic_uint      head;    /* next slot to write (producer) */
+    atomic_uint      tail;    /* next slot to read (flusher) */
+    LogRecord        slots[LOG_RING_SLOTS];
+} LogRing;
+
+_Static_assert((LOG_RING_SLOTS & (LOG_RING_SLOTS - 1)) == 0,
+               "LOG_RING_SLOTS must be a power of 2");
+
+#define LOG_LINE_MAX   512
+#define LOG_BATCH_MAX  4096
+
+static LogRing           g_rings[LOG_RING_THREADS];
+static atomic_uint       g_dropped = 0;
+static OrbisPthreadKey   g_ring_key;
+static atomic_bool       g_ring_key_ok = false;
+static uint32_t          g_dropped_reported = 0;
+
+static LogSinkFn         g_sink     = NULL;
+static void             *g_sink_ctx = NULL;
+static OrbisPthreadMutex g_drain_mutex;
+static OrbisPthread      g_flusher;
+static atomic_bool       g_running  = false;
+static bool              g_inited   = false;
+
+static char              g_batch[LOG_BATCH_MAX];
+static size_t            g_batch_len = 0;
+
+/* ─── Format spec parsing (shared by encoder and decoder) ─────────── */
+
+typedef enum {
+    ARG_NONE = 0,   /* %% or unsupported */
+    ARG_SINT,
+    ARG_UINT,
+    ARG_CHAR,
+    ARG_DOUBLE,
+    ARG_PTR,
+    ARG_STR,
+    ARG_COUNT,      /* %n: consumed, never written */
+} ArgClass;
+
+typedef enum {
+    LEN_NONE = 0, LEN_HH, LEN_H, LEN_L, LEN_LL, LEN_Z, LEN_J, LEN_T, LEN_LD,
+} LenMod;
+
+typedef struct FmtSpec {
+    const char *body;         /* first char after '%' */
+    const char *conv;         /* conversion character */
+    LenMod      len;
+    ArgClass    cls;
+    uint8_t     stars;        /* '*' width/precision count (0-2) */
+} FmtSpec;
+
+static bool is_len_char(char c) {
+    return c == 'h' || c == 'l' || c == 'L' || c == 'z' ||
+           c == 'j' || c == 't' || c == 'q';
+}
+
+/* Parse the spec starting at p ('%'). Returns the char after it. */
+static const char *parse_spec(const char *p, FmtSpec *s) {
+    memset(s, 0, sizeof(*s));
+    s->body = ++p;
+
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') p++;
+    if (*p == '*') { s->stars++; p++; }
+    while (*p >= '0' && *p <= '9') p++;
+    if (*p == '.') {
+        p++;
+        if (*p == '*') { s->stars++; p++; }
+        while (*p >= '0' && *p <= '9') p++;
+    }
+
+    if (p[0] == 'h' && p[1] == 'h')      { s->len = LEN_HH; p += 2; }
+    else if (p[0] == 'l' && p[1] == 'l') { s->len = LEN_LL; p += 2; }
+    else if (*p == 'h') { s->len = LEN_H;  p++; }
+    else if (*p == 'l') { s->len = LEN_L;  p++; }
+    else if (*p == 'z') { s->len = LEN_Z;  p++; }
+    else if (*p == 'j') { s->len = LEN_J;  p++; }
+    else if (*p == 't') { s->len = LEN_T;  p++; }
+    else if (*p == 'L' || *p == 'q') { s->len = LEN_LD; p++; }
+
+    s->conv = p;
+    switch (*p) {
+    case 'd': case 'i':                     s->cls = ARG_SINT;   break;
+    case 'u': case 'o': case 'x': case 'X': s->cls = ARG_UINT;   break;
+    case 'c':                               s->cls = ARG_CHAR;   break;
+    case 'f': case 'F': case 'e': case 'E':
+    case 'g': case 'G': case 'a': case 'A': s->cls = ARG_DOUBLE; break;
+    case 'p':                               s->cls = ARG_PTR;    break;
+    case 's':                               s->cls = ARG_STR;    break;
+    case 'n':                               s->cls = ARG_COUNT;  break;
+    default:                                s->cls = ARG_NONE;   break;
+    }
+    return *p ? p + 1 : p;
+}
+
+/* ─── Encoder (caller thread) ─────────────────────────────────────── */
+
+static size_t bounded_strlen(const char *s, size_t max) {
+    size_t n = 0;
+    while (n < max && s[n]) n++;
+    return n;
+}
+
+static bool put_bytes(LogRecord *r, const void *src, size_t n) {
+    if (r->arg_len + n > LOG_RING_ARG_BYTES) {
+        r->truncated = 1;
+        return false;
+    }
+    memcpy(r->args + r->arg_len, src, n);
+    r->arg_len += (uint16_t)n;
+    return true;
+}
+
+static bool put_str(LogRecord *r, const char *str) {
+    if (!str) str = "(null)";
+    size_t room = LOG_RING_ARG_BYTES - r->arg_len;
+    if (room == 0) { r->truncated = 1; return false; }
+    size_t n = bounded_strlen(str, room - 1);
+    memcpy(r->args + r->arg_len, str, n);
+    r->args[r->arg_len + n] = '\0';
+    r->arg_len += (uint16_t)(n + 1);
+    return true;
+}
+
+static void encode_args(LogRecord *r, const char *fmt, va_list ap) {
+    const char *p = fmt;
+    while (*p) {
+        if (*p != '%') { p++; continue; }
+        if (p[1] == '%') { p += 2; continue; }
+
+        FmtSpec s;
+        p = parse_spec(p, &s);
+
+        for (uint8_t i = 0; i < s.stars; i++) {
+            int32_t v = va_arg(ap, int);
+            if (!put_bytes(r, &v, sizeof(v))) return;
+        }
+
+        bool ok = true;
+        switch (s.cls) {
+        case ARG_SINT: {
+            int64_t v;
+            switch (s.len) {
+            case LEN_L:  v = va_arg(ap, long);      break;
+            case LEN_LL: v = va_arg(ap, long long); break;
+            case LEN_Z:  v = (int64_t)va_arg(ap, size_t);    break;
+            case LEN_J:  v = va_arg(ap, intmax_t);  break;
+            case LEN_T:  v = va_arg(ap, ptrdiff_t); break;
+            case LEN_HH: v = (signed char)va_arg(ap, int); break;
+            case LEN_H:  v = (short)va_arg(ap, int);       break;
+            default:     v = va_arg(ap, int);       break;
+            }
+            ok = put_bytes(r, &v, sizeof(v));
+            break;
+        }
+        case ARG_UINT: {
+            uint64_t v;
+            switch (s.len) {
+            case LEN_L:  v = va_arg(ap, unsigned long);      break;
+            case LEN_LL: v = va_arg(ap, unsigned long long); break;
+            case LEN_Z:  v = va_arg(ap, size_t);             break;
+            case LEN_J:  v = va_arg(ap, uintmax_t);          break;
+            case LEN_T:  v = (uint64_t)va_arg(ap, ptrdiff_t); break;
+            case LEN_HH: v = (unsigned char)va_arg(ap, unsigned int);  break;
+            case LEN_H:  v = (unsigned short)va_arg(ap, unsigned int); break;
+            default:     v = va_arg(ap, unsigned int);       break;
+            }
+            ok = put_bytes(r, &v, sizeof(v));
+            break;
+        }
+        case ARG_CHAR: {
+            int32_t v = va_arg(ap, int);
+            ok = put_bytes(r, &v, sizeof(v));
+            break;
+        }
+        case ARG_DOUBLE: {
+            double v = (s.len == LEN_LD) ? (double)va_arg(ap, long double)
+                                         : va_arg(ap, double);
+            ok = put_bytes(r, &v, sizeof(v));
+            break;
+        }
+        case ARG_PTR: {
+            uint64_t v = (uint64_t)(uintptr_t)va_arg(ap, void *);
+            ok = put_bytes(r, &v, sizeof(v));
+            break;
+        }
+        case ARG_STR:
+            ok = put_str(r, va_arg(ap, const char *));
+            break;
+        case ARG_COUNT:
+            (void)va_arg(ap, void *);
+            break;
+        case ARG_NONE:
+            return;  /* unknown conversion: stop, decoder does the same */
+        }
+        if (!ok) return;
+    }
+}
+
+/* Key destructor: runs as the owning thread exits */
+static void ring_release(void *p) {
+    LogRing *ring = p;
+    /* Release: the next owner's claim sees this thread's last head */
+    uintptr_t expected = (uintptr_t)scePthreadSelf();
+    atomic_compare_exchange_strong_explicit(&ring->owner, &expected, 0,
+                                            memory_order_release,
+                                            memory_order_relaxed);
+}
+
+static LogRing *ring_for_self(void) {
+    bool keyed = atomic_load_explicit(&g_ring_key_ok, memory_order_acquire);
+    if (keyed) {
+        LogRing *ring = scePthreadGetspecific(g_ring_key);
+        if (ring) return ring;
+    }
+
+    /* Claimed before the key existed, or not yet */
+    uintptr_t self = (uintptr_t)scePthreadSelf();
+    LogRing *ring = NULL;
+    for (int i = 0; i < LOG_RING_THREADS && !ring; i++) {
+        if (atomic_load_explicit(&g_rings[i].owner, memory_order_relaxed) == self)
+            ring = &g_rings[i];
+    }
+    for (int i = 0; i < LOG_RING_THREADS && !ring; i++) {
+        uintptr_t expected = 0;
+        if (atomic_compare_exchange_strong(&g_rings[i].owner, &expected, self))
+            ring = &g_rings[i];
+    }
+    if (ring && keyed) scePthreadSetspecific(g_ring_key, ring);
+    return ring;
+}
+
+void log_ring_thread_exit(void) {
+    if (atomic_load_explicit(&g_ring_key_ok, memory_order_acquire))
+        scePthreadSetspecific(g_ring_key, NULL);
+    for (int i = 0; i < LOG_RING_THREADS; i++)
+        ring_release(&g_rings[i]);
+}
+
+void log_ring_emit(const char *fmt, ...) {
+    LogRing *ring = ring_for_self();
+    if (!ring) {
+        atomic_fetch_add_explicit(&g_dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= LOG_RING_SLOTS) {
+        atomic_fetch_add_explicit(&g_dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    LogRecord *r = &ring->slots[head & (LOG_RING_SLOTS - 1)];
+    r->fmt       = fmt;
+    r->arg_len   = 0;
+    r->truncated = 0;
+
+    va_list ap;
+    va_start(ap, fmt);
+    encode_args(r, fmt, ap);
+    va_end(ap);
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+uint32_t log_ring_dropped(void) {
+    return atomic_load_explicit(&g_dropped, memory_order_relaxed);
+}
+
+/* ─── Decoder (flusher thread) ────────────────────────────────────── */
+
+typedef struct ArgReader {
+    const LogRecord *r;
+    uint16_t         pos;
+} ArgReader;
+
+static bool get_bytes(ArgReader *ar, void *dst, size_t n) {
+    if (ar->pos + n > ar->r->arg_len) return false;
+    memcpy(dst, ar->r->args + ar->pos, n);
+    ar->pos += (uint16_t)n;
+    return true;
+}
+
+/* Append to line[*len] without overflowing; keeps the buffer NUL-terminated */
+static void line_append(char *line, size_t *len, const char *src, size_t n) {
+    size_t room = LOG_LINE_MAX - 1 - *len;
+    if (n > room) n = room;
+    memcpy(line + *len, src, n);
+    *len += n;
+    line[*len] = '\0';
+}
+
+static void line_add_formatted(size_t *len, int n) {
+    if (n < 0) return;
+    *len += (size_t)n;
+    if (*len > LOG_LINE_MAX - 1) *len = LOG_LINE_MAX - 1;
+}
+
+static size_t decode_record(const LogRecord *r, char *line) {
+    ArgReader ar = { r, 0 };
+    size_t len = 0;
+    line[0] = '\0';
+
+    const char *p = r->fmt;
+    while (*p) {
+        if (*p != '%') {
+            const char *lit = p;
+            while (*p && *p != '%') p++;
+            line_append(line, &len, lit, (size_t)(p - lit));
+            continue;
+        }
+        if (p[1] == '%') {
+            line_append(line, &len, "%", 1);
+            p += 2;
+            continue;
+        }
+
+        FmtSpec s;
+        const char *next = parse_spec(p, &s);
+        if (s.cls == ARG_NONE) {
+            line_append(line, &len, p, strlen(p));
+            break;
+        }
+
+        /* Rebuild the spec with '*' resolved and a normalized length */
+        char spec[48];
+        size_t sl = 0;
+        spec[sl++] = '%';
+        bool short_read = false;
+        for (const char *c = s.body; c < s.conv && sl < sizeof(spec) - 12; c++) {
+            if (*c == '*') {
+                int32_t v;
+                if (!get_bytes(&ar, &v, sizeof(v))) { short_read = true; break; }
+                sl += (size_t)snprintf(spec + sl, sizeof(spec) - sl, "%d", (int)v);
+            } else if (!is_len_char(*c)) {
+                spec[sl++] = *c;
+            }
+        }
+        if (s.cls == ARG_SINT || s.cls == ARG_UINT) {
+            spec[sl++] = 'l';
+            spec[sl++] = 'l';
+        }
+        spec[sl++] = *s.conv;
+        spec[sl]   = '\0';
+
+        char  *out  = line + len;
+        size_t room = LOG_LINE_MAX - len;
+        int    n    = 0;
+        if (!short_read) {
+            switch (s.cls) {
+            case ARG_SINT: {
+                int64_t v;
+                if (!get_bytes(&ar, &v, sizeof(v))) { short_read = true; break; }
+                n = snprintf(out, room, spec, (long long)v);
+                break;
+            }
+            case ARG_UINT: {
+                uint64_t v;
+                if (!get_bytes(&ar, &v, sizeof(v))) { short_read = true; break; }
+                n = snprintf(out, room, spec, (unsigned long long)v);
+                break;
+            }
+            case ARG_CHAR: {
+                int32_t v;
+                if (!get_bytes(&ar, &v, sizeof(v))) { short_read = true; break; }
+                n = snprintf(out, room, spec, (int)v);
+                break;
+            }
+            case ARG_DOUBLE: {
+                double v;
+                if (!get_bytes(&ar, &v, sizeof(v))) { short_read = true; break; }
+                n = snprintf(out, room, spec, v);
+                break;
+            }
+            case ARG_PTR: {
+                uint64_t v;
+                if (!get_bytes(&ar, &v, sizeof(v))) { short_read = true; break; }
+                n = snprintf(out, room, spec, (void *)(uintptr_t)v);
+                break;
+            }
+            case ARG_STR: {
+                if (ar.pos >= r->arg_len) { short_read = true; break; }
+                const char *str = (const char *)r->args + ar.pos;
+                ar.pos += (uint16_t)(bounded_strlen(str, r->arg_len - ar.pos) + 1);
+                n = snprintf(out, room, spec, str);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        if (short_read) {
+            line_append(line, &len, "<trunc>\n", 8);
+            break;
+        }
+        line_add_formatted(&len, n);
+        p = next;
+    }
+    return len;
+}
+
+/* ─── Flush ───────────────────────────────────────────────────────── */
+
+static void batch_emit(void) {
+    if (g_batch_len > 0 && g_sink) {
+        g_sink(g_batch, g_batch_len, g_sink_ctx);
+    }
+    g_batch_len = 0;
+}
+
+static void batch_add(const char *line, size_t len) {
+    if (g_batch_len + len > LOG_BATCH_MAX) batch_emit();
+    memcpy(g_batch + g_batch_len, line, len);
+    g_batch_len += len;
+}
+
+void log_ring_flush(void) {
+    if (!g_inited) return;
+    scePthreadMutexLock(&g_drain_mutex);
+
+    char line[LOG_LINE_MAX];
+    for (int i = 0; i < LOG_RING_THREADS; i++) {
+        /* Drained whether or not it is owned: a released ring may hold
+         * its last thread's records */
+        LogRing *ring = &g_rings[i];
+        uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        while (tail != head) {
+            const LogRecord *r = &ring->slots[tail & (LOG_RING_SLOTS - 1)];
+            size_t len = decode_record(r, line);
+            batch_add(line, len);
+            tail++;
+            atomic_store_explicit(&ring->tail, tail, memory_order_release);
+        }
+    }
+
+    uint32_t dropped = log_ring_dropped();
+    if (dropped != g_dropped_reported) {
+        int n = snprintf(line, sizeof(line), "[LOG] %u records dropped\n",
+                         dropped - g_dropped_reported);
+        if (n > 0) batch_add(line, (size_t)n);
+        g_dropped_reported = dropped;
+    }
+
+    batch_emit();
+    scePthreadMutexUnlock(&g_drain_mutex);
+}
+
+static void *flusher_main(void *arg) {
+    (void)arg;
+    while (atomic_load(&g_running)) {
+        sceKernelUsleep(LOG_RING_FLUSH_US);
+        log_ring_flush();
+    }
+    return NULL;
+}
+
+/* ─── Lifecycle ───────────────────────────────────────────────────── */
+
+int log_ring_init(LogSinkFn sink, void *ctx) {
+    if (g_inited) return 0;
+
+    g_sink     = sink;
+    g_sink_ctx = ctx;
+
+    int rc = scePthreadMutexInit(&g_drain_mutex, NULL, "tg_log_drain");
+    if (rc != 0) return rc;
+    g_inited = true;
+
+    /* Without the key, rings go back only through log_ring_thread_exit() */
+    if (scePthreadKeyCreate(&g_ring_key, ring_release) == 0)
+        atomic_store(&g_ring_key_ok, true);
+
+    atomic_store(&g_running, true);
+    rc = scePthreadCreate(&g_flusher, NULL, flusher_main, NULL, "tg_log_flush");
+    if (rc != 0) {
+        /* No flusher: records are still written by explicit flushes */
+        atomic_store(&g_running, false);
+        return rc;
+    }
+    return 0;
+}
+
+void log_ring_shutdown(void) {
+    if (!g_inited) return;
+    if (atomic_exchange(&g_running, false)) {
+        scePthreadJoin(g_flusher, NULL);
+    }
+    log_ring_flush();
+    scePthreadMutexDestroy(&g_drain_mutex);
+    /* The destructor is in this module; no thread may run it once unloaded */
+    if (atomic_exchange(&g_ring_key_ok, false))
+        scePthreadKeyDelete(g_ring_key);
+    g_inited = false;
+}
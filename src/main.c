@@ -40,12 +40,22 @@ void notify(const char *fmt, ...) {
     sceKernelSendNotificationRequest(0, &req, sizeof(req), 0);
 }
 
+/* ─── Log Sink ────────────────────────────────────────────────────── */
+
+/* Called from the log flusher thread with a batch of complete lines */
+static void klog_sink(const char *buf, size_t len, void *ctx) {
+    (void)ctx;
+    printf("%.*s", (int)len, buf);
+}
+
 /* ─── Plugin Entry ────────────────────────────────────────────────── */
 
 int module_start(size_t argc, const void *args) {
     (void)argc;
     (void)args;
 
+    log_ring_init(klog_sink, NULL);
+
     LOG_INFO("=== %s v%d.%d.%d starting ===",
         PLUGIN_NAME,
         (PLUGIN_VER >> 16) & 0xFF,
@@ -56,6 +66,7 @@ int module_start(size_t argc, const void *args) {
     if (rc != IME_OK) {
         LOG_ERROR("Failed to load required modules (rc=%d)", rc);
         notify("%s: module load FAILED (%d)", PLUGIN_NAME, rc);
+        log_ring_shutdown();
         return rc;
     }
 
@@ -63,6 +74,7 @@ int module_start(size_t argc, const void *args) {
     if (rc != IME_OK) {
         LOG_ERROR("Failed to install IME hooks (rc=%d)", rc);
         notify("%s: hook install FAILED (%d)", PLUGIN_NAME, rc);
+        log_ring_shutdown();
         return rc;
     }
 
@@ -110,6 +122,7 @@ int module_stop(size_t argc, const void *args) {
     }
 
     LOG_INFO("=== %s stopped ===", PLUGIN_NAME);
+    log_ring_shutdown();
     return IME_OK;
 }
 
@@ -13,6 +13,7 @@
 #include "plugin_common.h"
 #include "overlay.h"
 #include "font8x8.h"
+#include "profile.h"
 
 #include <Detour.h>
 #include <GoldHEN.h>
@@ -65,16 +66,7 @@ static uint64_t g_last_flip_us = 0;
  * because GPU is done with it and game won't touch it until recycled. */
 static int32_t g_last_flipped_idx = -1;
 
-/* ─── Performance Instrumentation ─────────────────────────────────── */
-static uint64_t g_flip_perf_last_log_us   = 0;
-static uint32_t g_flip_perf_count         = 0;
-static uint64_t g_flip_perf_draw_total_us = 0;
-static uint64_t g_flip_perf_draw_max_us   = 0;
-static uint64_t g_fd_perf_last_log_us     = 0;
-static uint32_t g_fd_perf_call_count      = 0;
-static uint32_t g_fd_perf_buf_total       = 0;
-static uint64_t g_fd_perf_total_us        = 0;
-static uint64_t g_fd_perf_max_us          = 0;
+/* ─── Force-Draw State ────────────────────────────────────────────── */
 
 /* When true, overlay_draw_rect_alpha behaves as opaque (alpha=255).
  * Set during force_draw to prevent alpha compounding on re-draws. */
@@ -173,6 +165,8 @@ static int32_t hooked_submit_flip(
     int32_t handle, int32_t bufferIndex,
     uint32_t flipMode, int64_t flipArg)
 {
+    PROF_BEGIN(PROF_FLIP);
+
     /* Track first flip for logging only (no popup) */
     if (!g_overlay.first_flip_logged) {
         g_overlay.first_flip_logged = true;
@@ -190,36 +184,19 @@ static int32_t hooked_submit_flip(
      * results — drawing after submitFlip is invisible (buffer is handed
      * off to the display subsystem). */
     overlay_draw_cb_t cb = g_draw_callback;
-    uint64_t flip_draw_us = 0;
+    PROF_LAT_FLIP();
     if (cb && g_overlay.width > 0 &&
         bufferIndex >= 0 && bufferIndex < ABS_MAX_BUFFERS &&
         g_overlay.buffers[bufferIndex])
     {
-        uint64_t t0 = sceKernelGetProcessTime();  /* PERF */
+        PROF_BEGIN(PROF_FLIP_DRAW);
+        PROF_PHASE_BEGIN(TG_PHASE_FLIP_DRAW);
         uint32_t *fb = (uint32_t *)g_overlay.buffers[bufferIndex];
         cb(fb, g_overlay.pitch, g_overlay.width, g_overlay.height);
-        flip_draw_us = sceKernelGetProcessTime() - t0;  /* PERF */
-    }
-
-    /* PERF: accumulate flip draw stats, log once per second */
-    {
-        g_flip_perf_count++;
-        g_flip_perf_draw_total_us += flip_draw_us;
-        if (flip_draw_us > g_flip_perf_draw_max_us) g_flip_perf_draw_max_us = flip_draw_us;
-
-        uint64_t now = sceKernelGetProcessTime();
-        if (now - g_flip_perf_last_log_us >= 1000000) {
-            printf("[CIME] FLIP: flips/s=%u  draw_avg=%luus  draw_max=%luus  buf=%d\n",
-                g_flip_perf_count,
-                (unsigned long)(g_flip_perf_count ? g_flip_perf_draw_total_us / g_flip_perf_count : 0),
-                (unsigned long)g_flip_perf_draw_max_us,
-                bufferIndex);
-            g_flip_perf_last_log_us   = now;
-            g_flip_perf_count         = 0;
-            g_flip_perf_draw_total_us = 0;
-            g_flip_perf_draw_max_us   = 0;
-        }
+        PROF_PHASE_END(TG_PHASE_FLIP_DRAW);
+        PROF_END(PROF_FLIP_DRAW);
     }
+    PROF_TICK();
 
     /* Track which buffer was just flipped — the poll loop can safely
      * reinforce this buffer since the GPU has moved to the next one. */
@@ -228,7 +205,9 @@ static int32_t hooked_submit_flip(
     if (!g_orig_submit_flip) {
         return -1;
     }
-    return g_orig_submit_flip(handle, bufferIndex, flipMode, flipArg);
+    int32_t rc = g_orig_submit_flip(handle, bufferIndex, flipMode, flipArg);
+    PROF_END(PROF_FLIP);
+    return rc;
 }
 
 /* ─── Tiled Pixel Write ──────────────────────────────────────────── */
@@ -803,8 +782,7 @@ bool overlay_is_flipping(void) {
 void overlay_force_draw(overlay_draw_cb_t cb) {
     if (!cb || g_overlay.width == 0 || g_overlay.buffer_count == 0) return;
 
-    uint64_t fd_start = sceKernelGetProcessTime();  /* PERF */
-    uint32_t buf_drawn = 0;
+    PROF_BEGIN(PROF_FORCE_DRAW);
 
     /* Enable opaque mode — prevents alpha compounding when
      * re-drawing to buffers the game hasn't re-rendered. */
@@ -814,33 +792,12 @@ void overlay_force_draw(overlay_draw_cb_t cb) {
         if (g_overlay.buffers[i]) {
             uint32_t *fb = (uint32_t *)g_overlay.buffers[i];
             cb(fb, g_overlay.pitch, g_overlay.width, g_overlay.height);
-            buf_drawn++;
         }
     }
 
     g_force_opaque = false;
 
-    /* PERF: accumulate force_draw stats */
-    uint64_t fd_us = sceKernelGetProcessTime() - fd_start;
-    g_fd_perf_call_count++;
-    g_fd_perf_buf_total += buf_drawn;
-    g_fd_perf_total_us += fd_us;
-    if (fd_us > g_fd_perf_max_us) g_fd_perf_max_us = fd_us;
-
-    uint64_t now = sceKernelGetProcessTime();
-    if (now - g_fd_perf_last_log_us >= 1000000) {
-        printf("[CIME] FDRAW: calls/s=%u  bufs/call=%u  avg=%luus  max=%luus  total_buf=%u\n",
-            g_fd_perf_call_count,
-            g_fd_perf_call_count ? g_fd_perf_buf_total / g_fd_perf_call_count : 0,
-            (unsigned long)(g_fd_perf_call_count ? g_fd_perf_total_us / g_fd_perf_call_count : 0),
-            (unsigned long)g_fd_perf_max_us,
-            g_fd_perf_buf_total);
-        g_fd_perf_last_log_us  = now;
-        g_fd_perf_call_count   = 0;
-        g_fd_perf_buf_total    = 0;
-        g_fd_perf_total_us     = 0;
-        g_fd_perf_max_us       = 0;
-    }
+    PROF_END(PROF_FORCE_DRAW);
 }
 
 /* Rotation index for single-buffer drawing */
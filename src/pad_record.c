@@ -0,0 +1,96 @@
+/**
+ * @file pad_record.c
+ * @brief Pad trace recorder for offline replay (see pad_record.h)
+ *
+ * Samples are buffered and written a block at a time from the IME poll
+ * thread, so a record build costs one 4KB write every ~4 seconds of
+ * typing. The file is replaced at every sceImeDialogInit.
+ */
+
+#include "plugin_common.h"
+#include "pad_record.h"
+#include "ime_custom.h"
+
+#include <orbis/libkernel.h>
+
+#if TG_PAD_RECORD
+
+#define PADREC_BLOCK  256   /* samples per write */
+
+static int            g_rec_fd = -1;
+static uint32_t       g_rec_fill = 0;
+static uint32_t       g_rec_total = 0;
+static TgPadRecSample g_rec_buf[PADREC_BLOCK];
+
+static void rec_flush(void) {
+    if (g_rec_fd < 0 || g_rec_fill == 0) return;
+    int64_t n = sceKernelWrite(g_rec_fd, g_rec_buf,
+                               g_rec_fill * sizeof(TgPadRecSample));
+    if (n < 0) {
+        LOG_WARN("padrec: write failed: 0x%08X, recording stopped", (int)n);
+        sceKernelClose(g_rec_fd);
+        g_rec_fd = -1;
+    }
+    g_rec_fill = 0;
+}
+
+void pad_record_begin(int32_t panel_type, uint32_t max_text_length,
+                      const uint16_t *prefill) {
+    if (g_rec_fd >= 0) pad_record_end();
+
+    g_rec_fd = sceKernelOpen(TG_PADREC_PATH,
+                             0x0601, /* O_WRONLY | O_CREAT | O_TRUNC */
+                             0666);
+    if (g_rec_fd < 0) {
+        LOG_WARN("padrec: cannot open %s: 0x%08X", TG_PADREC_PATH, g_rec_fd);
+        return;
+    }
+
+    uint32_t plen = safe_u16_strlen(prefill, IME_MAX_OUTPUT_LENGTH);
+    TgPadRecHeader hdr = {
+        .magic           = TG_PADREC_MAGIC,
+        .version         = TG_PADREC_VERSION,
+        .sample_size     = sizeof(TgPadRecSample),
+        .panel_type      = panel_type,
+        .max_text_length = max_text_length,
+        .prefill_len     = (uint16_t)plen,
+    };
+    sceKernelWrite(g_rec_fd, &hdr, sizeof(hdr));
+    if (plen) sceKernelWrite(g_rec_fd, prefill, plen * sizeof(uint16_t));
+
+    g_rec_fill  = 0;
+    g_rec_total = 0;
+    LOG_INFO("padrec: recording to %s", TG_PADREC_PATH);
+}
+
+void pad_record_sample(uint64_t t_us, int32_t read_rc,
+                       const OrbisPadData *pad) {
+    if (g_rec_fd < 0) return;
+
+    TgPadRecSample *s = &g_rec_buf[g_rec_fill++];
+    s->t_us     = (uint32_t)t_us;
+    s->buttons  = pad->buttons;
+    s->lx       = pad->leftStick.x;
+    s->ly       = pad->leftStick.y;
+    s->rx       = pad->rightStick.x;
+    s->ry       = pad->rightStick.y;
+    s->l2       = pad->analogButtons.l2;
+    s->r2       = pad->analogButtons.r2;
+    s->flags    = (read_rc == 0) ? TG_PADREC_READ_OK : 0;
+    s->reserved = 0;
+    g_rec_total++;
+
+    if (g_rec_fill == PADREC_BLOCK) rec_flush();
+}
+
+void pad_record_end(void) {
+    if (g_rec_fd < 0) return;
+    rec_flush();
+    if (g_rec_fd >= 0) {
+        sceKernelClose(g_rec_fd);
+        g_rec_fd = -1;
+    }
+    LOG_INFO("padrec: %u samples written", g_rec_total);
+}
+
+#endif /* TG_PAD_RECORD */
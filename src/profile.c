@@ -0,0 +1,362 @@
+/**
+ * @file profile.c
+ * @brief Probe storage and reporting for profile.h (shared by both PRXes)
+ *
+ * Only libkernel time/thread/file calls are used, so the host tools can
+ * link this file against their shims and export the same traces.
+ */
+
+#include "profile.h"
+#include "log_ring.h"
+
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <orbis/libkernel.h>
+
+#if TG_PROFILE != TG_PROFILE_OFF
+
+/*
+ * A probe may fire on several threads (the draw probes run on the flip
+ * thread and on the force-draw path), and reports come from whichever
+ * thread polls. Updates are atomic adds; a report claims the delta since
+ * the last one with a compare-exchange, so two reports never count the
+ * same calls twice.
+ */
+typedef struct ProfStat {
+    atomic_uint      count;
+    _Atomic uint64_t total_us;
+    _Atomic uint64_t max_us;          /* since last report */
+    atomic_uint      last_count;      /* values at last report, for deltas */
+    _Atomic uint64_t last_total_us;
+} ProfStat;
+
+static const char *const g_probe_names[PROF_PROBE_COUNT] = {
+    [PROF_IME_POLL]      = "ime_poll",
+    [PROF_IME_INPUT]     = "ime_input",
+    [PROF_IME_STEP]      = "ime_step",
+    [PROF_IME_PREDICT]   = "ime_predict",
+    [PROF_IME_IPC_SYNC]  = "ime_ipc_sync",
+    [PROF_FLIP]          = "flip",
+    [PROF_FLIP_DRAW]     = "flip_draw",
+    [PROF_FORCE_DRAW]    = "force_draw",
+    [PROF_DRAW_BACKDROP] = "draw_backdrop",
+    [PROF_DRAW_TEXTBAR]  = "draw_textbar",
+    [PROF_DRAW_GRID]     = "draw_grid",
+    [PROF_DRAW_STATUS]   = "draw_status",
+    [PROF_SHELL_POLL]    = "shell_poll",
+    [PROF_SHELL_UPDATE]  = "shell_update",
+};
+
+static ProfStat         g_prof[PROF_PROBE_COUNT];
+static _Atomic uint64_t g_prof_last_report_us = 0;
+
+void prof_count(ProfProbe id) {
+    atomic_fetch_add_explicit(&g_prof[id].count, 1, memory_order_relaxed);
+}
+
+#if TG_PROFILE >= TG_PROFILE_TRACE
+static void span_push(ProfProbe id, uint64_t start_us, uint64_t dur_us);
+#endif
+
+void prof_record(ProfProbe id, uint64_t start_us, uint64_t end_us) {
+    uint64_t elapsed_us = end_us - start_us;
+    ProfStat *s = &g_prof[id];
+    atomic_fetch_add_explicit(&s->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s->total_us, elapsed_us, memory_order_relaxed);
+    uint64_t max = atomic_load_explicit(&s->max_us, memory_order_relaxed);
+    while (elapsed_us > max &&
+           !atomic_compare_exchange_weak_explicit(&s->max_us, &max, elapsed_us,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+#if TG_PROFILE >= TG_PROFILE_TRACE
+    span_push(id, start_us, elapsed_us);
+#endif
+}
+
+/* Move *last up to now and return the difference; 0 if another report got there first */
+static uint32_t claim_count(atomic_uint *last, uint32_t now) {
+    unsigned int seen = atomic_load_explicit(last, memory_order_relaxed);
+    do {
+        if ((int32_t)(now - seen) <= 0) return 0;
+    } while (!atomic_compare_exchange_weak_explicit(last, &seen, now,
+                                                    memory_order_relaxed,
+                                                    memory_order_relaxed));
+    return now - seen;
+}
+
+#if TG_PROFILE >= TG_PROFILE_TRACE
+static uint64_t claim_total(_Atomic uint64_t *last, uint64_t now) {
+    uint64_t seen = atomic_load_explicit(last, memory_order_relaxed);
+    do {
+        if ((int64_t)(now - seen) <= 0) return 0;
+    } while (!atomic_compare_exchange_weak_explicit(last, &seen, now,
+                                                    memory_order_relaxed,
+                                                    memory_order_relaxed));
+    return now - seen;
+}
+#endif
+
+/* Log every probe that fired since the previous report */
+void prof_report(const char *tag) {
+    for (int i = 0; i < PROF_PROBE_COUNT; i++) {
+        ProfStat *s = &g_prof[i];
+        uint32_t n = claim_count(&s->last_count,
+                                 atomic_load_explicit(&s->count, memory_order_relaxed));
+        if (n == 0) continue;
+#if TG_PROFILE >= TG_PROFILE_TRACE
+        uint64_t total = claim_total(&s->last_total_us,
+                                     atomic_load_explicit(&s->total_us, memory_order_relaxed));
+        uint64_t max   = atomic_exchange_explicit(&s->max_us, 0, memory_order_relaxed);
+        LOG_RING_AT(TG_LOG_LVL_INFO,
+                    "[PROF] %s %-14s n=%u avg=%luus max=%luus\n",
+                    tag, g_probe_names[i], n,
+                    (unsigned long)(total / n), (unsigned long)max);
+#else
+        LOG_RING_AT(TG_LOG_LVL_INFO, "[PROF] %s %-14s n=%u\n",
+                    tag, g_probe_names[i], n);
+#endif
+    }
+}
+
+/* ─── Phase histograms ────────────────────────────────────────────── */
+
+static volatile TgStatsPage *g_prof_stats = NULL;
+static uint64_t              g_tsc_freq   = 0;
+
+uint64_t prof_tsc(void) {
+    return sceKernelReadTsc();
+}
+
+/*
+ * Spans are timed with the TSC rather than the process time, which the
+ * replay shim holds still for a whole poll. Split so ticks * 1e6 cannot
+ * overflow however long the console has been up.
+ */
+uint64_t prof_now_us(void) {
+    if (!g_tsc_freq) g_tsc_freq = sceKernelGetTscFrequency();
+    uint64_t t = sceKernelReadTsc();
+    return t / g_tsc_freq * 1000000ull + t % g_tsc_freq * 1000000ull / g_tsc_freq;
+}
+
+void prof_attach_stats(volatile TgStatsPage *stats) {
+    if (!g_tsc_freq) g_tsc_freq = sceKernelGetTscFrequency();
+    g_prof_stats = stats;
+}
+
+void prof_phase_record(TgPhase phase, uint64_t tsc_ticks) {
+    volatile TgStatsPage *st = g_prof_stats;
+    /* The shell maps the page before the game has initialized it */
+    if (!st || !g_tsc_freq || st->magic != TG_STATS_MAGIC) return;
+    tg_hist_record(&st->phase[phase], tsc_ticks * 1000000000ull / g_tsc_freq);
+}
+
+/* ─── Input-to-photon trace ───────────────────────────────────────── */
+
+static volatile TgTracePage *g_prof_trace    = NULL;
+static uint32_t              g_lat_next_seq  = 0;  /* game IME thread only */
+static uint32_t              g_lat_flip_seen = 0;  /* flip thread only */
+
+static volatile TgTracePage *trace_page(void) {
+    volatile TgTracePage *tp = g_prof_trace;
+    return (tp && tp->magic == TG_TRACE_MAGIC) ? tp : NULL;
+}
+
+void prof_attach_trace(volatile TgTracePage *trace) {
+    if (!g_tsc_freq) g_tsc_freq = sceKernelGetTscFrequency();
+    g_prof_trace = trace;
+}
+
+uint32_t prof_lat_begin(uint64_t tsc) {
+    volatile TgTracePage *tp = trace_page();
+    if (!tp) return 0;
+
+    uint32_t seq = ++g_lat_next_seq;
+    if (seq == 0) seq = ++g_lat_next_seq;
+
+    /* Invalidate the slot first so late stamps for the old id miss */
+    volatile TgLatRecord *r = tg_trace_rec(tp, seq);
+    r->seq = 0;
+    __asm__ volatile ("mfence" ::: "memory");
+    for (int i = 0; i < TG_LAT_STAGES; i++) r->tsc[i] = 0;
+    r->tsc[TG_LAT_INPUT] = tsc;
+    __asm__ volatile ("mfence" ::: "memory");
+    r->seq = seq;
+    return seq;
+}
+
+void prof_lat_stamp(uint32_t seq, TgLatStage stage, uint64_t tsc) {
+    volatile TgTracePage *tp = trace_page();
+    if (!tp || seq == 0) return;
+
+    volatile TgLatRecord *r = tg_trace_rec(tp, seq);
+    if (r->seq != seq || r->tsc[stage] != 0) return;
+    r->tsc[stage] = tsc;
+
+    uint64_t t0 = r->tsc[TG_LAT_INPUT];
+    if (stage == TG_LAT_FLIP)
+        prof_phase_record(TG_PHASE_INPUT_TO_FLIP, tsc - t0);
+    else if (stage == TG_LAT_SHELL)
+        prof_phase_record(TG_PHASE_INPUT_TO_SHELL, tsc - t0);
+}
+
+void prof_lat_publish(uint32_t seq) {
+    volatile TgTracePage *tp = trace_page();
+    if (tp && seq) tp->published_seq = seq;
+}
+
+/* Stamp the newest published input on the first flip that follows it */
+void prof_lat_flip(uint64_t tsc) {
+    volatile TgTracePage *tp = trace_page();
+    if (!tp) return;
+    uint32_t seq = tp->published_seq;
+    if (seq == 0 || seq == g_lat_flip_seen) return;
+    g_lat_flip_seen = seq;
+    prof_lat_stamp(seq, TG_LAT_FLIP, tsc);
+}
+
+/* Any thread may tick; the one that moves the report time on reports */
+void prof_report_periodic(void) {
+    uint64_t now  = prof_now_us();
+    uint64_t last = atomic_load_explicit(&g_prof_last_report_us, memory_order_relaxed);
+    if (now < last || now - last < PROF_REPORT_INTERVAL_US) return;
+    if (!atomic_compare_exchange_strong_explicit(&g_prof_last_report_us, &last, now,
+                                                 memory_order_relaxed,
+                                                 memory_order_relaxed))
+        return;
+    prof_report("1s");
+}
+
+/* ─── Span ring / Chrome trace export ─────────────────────────────── */
+
+#if TG_PROFILE >= TG_PROFILE_TRACE
+
+#define PROF_MAX_TIDS  16
+
+typedef struct ProfSpan {
+    uint64_t    start_us;
+    uint32_t    dur_us;
+    uint16_t    probe;
+    uint16_t    tid;          /* compact thread index, 1-based */
+    atomic_uint seq;          /* ring index + 1 once written, 0 while writing */
+} ProfSpan;
+
+_Static_assert((PROF_SPAN_RING & (PROF_SPAN_RING - 1)) == 0,
+               "PROF_SPAN_RING must be a power of 2");
+
+static ProfSpan         g_spans[PROF_SPAN_RING];
+static atomic_uint      g_span_head = 0;
+static atomic_uintptr_t g_tids[PROF_MAX_TIDS];
+
+static uint16_t tid_for_self(void) {
+    uintptr_t self = (uintptr_t)scePthreadSelf();
+    for (int i = 0; i < PROF_MAX_TIDS; i++) {
+        if (atomic_load_explicit(&g_tids[i], memory_order_relaxed) == self)
+            return (uint16_t)(i + 1);
+    }
+    for (int i = 0; i < PROF_MAX_TIDS; i++) {
+        uintptr_t expected = 0;
+        if (atomic_compare_exchange_strong(&g_tids[i], &expected, self))
+            return (uint16_t)(i + 1);
+    }
+    return 0;
+}
+
+/*
+ * Any thread may push; each claims its own slot. Oldest spans are
+ * overwritten. seq brackets the write so the dump can tell a finished
+ * span from one in progress or already reused.
+ */
+static void span_push(ProfProbe id, uint64_t start_us, uint64_t dur_us) {
+    uint32_t idx = atomic_fetch_add_explicit(&g_span_head, 1, memory_order_relaxed);
+    ProfSpan *sp = &g_spans[idx & (PROF_SPAN_RING - 1)];
+    atomic_store_explicit(&sp->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    sp->start_us = start_us;
+    sp->dur_us   = dur_us > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)dur_us;
+    sp->probe    = (uint16_t)id;
+    sp->tid      = tid_for_self();
+    atomic_store_explicit(&sp->seq, idx + 1, memory_order_release);
+}
+
+/* Copy ring entry i if it is complete and still holds that entry */
+static bool span_read(uint32_t i, ProfSpan *out) {
+    const ProfSpan *sp = &g_spans[i & (PROF_SPAN_RING - 1)];
+    if (atomic_load_explicit(&sp->seq, memory_order_acquire) != i + 1) return false;
+    out->start_us = sp->start_us;
+    out->dur_us   = sp->dur_us;
+    out->probe    = sp->probe;
+    out->tid      = sp->tid;
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&sp->seq, memory_order_relaxed) == i + 1;
+}
+
+typedef struct TraceWriter {
+    int    fd;
+    size_t len;
+    char   buf[4096];
+} TraceWriter;
+
+static void tw_flush(TraceWriter *w) {
+    if (w->len) sceKernelWrite(w->fd, w->buf, w->len);
+    w->len = 0;
+}
+
+static void tw_printf(TraceWriter *w, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static void tw_printf(TraceWriter *w, const char *fmt, ...) {
+    if (sizeof(w->buf) - w->len < 256) tw_flush(w);
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(w->buf + w->len, sizeof(w->buf) - w->len, fmt, ap);
+    va_end(ap);
+    if (n > 0) {
+        w->len += (size_t)n;
+        if (w->len > sizeof(w->buf)) w->len = sizeof(w->buf);
+    }
+}
+
+/**
+ * Write the retained spans as a Chrome trace ("X" complete events,
+ * microsecond timestamps) loadable in chrome://tracing or Perfetto.
+ * Spans other threads are writing or overwriting meanwhile are left out.
+ */
+int prof_trace_dump(const char *path, int pid) {
+    static TraceWriter w;   /* 4KB; keep it off small PRX thread stacks */
+    w.fd = sceKernelOpen(path, 0x0601 /* O_WRONLY|O_CREAT|O_TRUNC */, 0666);
+    if (w.fd < 0) return w.fd;
+    w.len = 0;
+
+    uint32_t head  = atomic_load_explicit(&g_span_head, memory_order_acquire);
+    uint32_t count = head < PROF_SPAN_RING ? head : PROF_SPAN_RING;
+
+    tw_printf(&w, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    tw_printf(&w, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+                  "\"args\":{\"name\":\"%s\"}}",
+              pid, pid == PROF_PID_SHELL ? "shell_overlay" : "thumbgrid_ime");
+
+    uint32_t written = 0;
+    for (uint32_t i = head - count; i != head; i++) {
+        ProfSpan sp;
+        if (!span_read(i, &sp) || sp.probe >= PROF_PROBE_COUNT) continue;
+        tw_printf(&w, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%llu,"
+                      "\"dur\":%u,\"pid\":%d,\"tid\":%u}",
+                  g_probe_names[sp.probe], (unsigned long long)sp.start_us,
+                  sp.dur_us, pid, sp.tid);
+        written++;
+    }
+    tw_printf(&w, "\n]}\n");
+    tw_flush(&w);
+    sceKernelClose(w.fd);
+
+    LOG_RING_AT(TG_LOG_LVL_INFO, "[PROF] trace: %u spans -> %s\n", written, path);
+    return (int)written;
+}
+
+#endif /* TG_PROFILE >= TG_PROFILE_TRACE */
+
+#endif /* TG_PROFILE != TG_PROFILE_OFF */
@@ -0,0 +1,56 @@
+/**
+ * @file tg_compose.c
+ * @brief Diacritic layer names (see tg_compose.h)
+ *
+ * The composition tables themselves are generated into
+ * tg_compose_table.c; lookups are inline in the header.
+ */
+
+#include "tg_compose.h"
+
+static const char *const k_names[TG_DIA_COUNT] = {
+    [TG_DIA_NONE]         = "",
+    [TG_DIA_ACUTE]        = "acute",
+    [TG_DIA_GRAVE]        = "grave",
+    [TG_DIA_CIRCUMFLEX]   = "circ",
+    [TG_DIA_DIAERESIS]    = "uml",
+    [TG_DIA_TILDE]        = "tilde",
+    [TG_DIA_CEDILLA]      = "cedil",
+    [TG_DIA_RING]         = "ring",
+    [TG_DIA_CARON]        = "caron",
+    [TG_DIA_MACRON]       = "macron",
+    [TG_DIA_BREVE]        = "breve",
+    [TG_DIA_OGONEK]       = "ogonek",
+    [TG_DIA_DOT]          = "dot",
+    [TG_DIA_DOUBLE_ACUTE] = "dblac",
+    [TG_DIA_STROKE]       = "stroke",
+    [TG_DIA_OTHER]        = "other",
+};
+
+/* Spacing forms of the marks; the two letter layers show an example */
+static const char *const k_marks[TG_DIA_COUNT] = {
+    [TG_DIA_NONE]         = "",
+    [TG_DIA_ACUTE]        = "\xc2\xb4",         /* U+00B4 */
+    [TG_DIA_GRAVE]        = "`",
+    [TG_DIA_CIRCUMFLEX]   = "^",
+    [TG_DIA_DIAERESIS]    = "\xc2\xa8",         /* U+00A8 */
+    [TG_DIA_TILDE]        = "~",
+    [TG_DIA_CEDILLA]      = "\xc2\xb8",         /* U+00B8 */
+    [TG_DIA_RING]         = "\xcb\x9a",         /* U+02DA */
+    [TG_DIA_CARON]        = "\xcb\x87",         /* U+02C7 */
+    [TG_DIA_MACRON]       = "\xc2\xaf",         /* U+00AF */
+    [TG_DIA_BREVE]        = "\xcb\x98",         /* U+02D8 */
+    [TG_DIA_OGONEK]       = "\xcb\x9b",         /* U+02DB */
+    [TG_DIA_DOT]          = "\xcb\x99",         /* U+02D9 */
+    [TG_DIA_DOUBLE_ACUTE] = "\xcb\x9d",         /* U+02DD */
+    [TG_DIA_STROKE]       = "\xc3\xb8",         /* U+00F8 */
+    [TG_DIA_OTHER]        = "\xc3\xa6",         /* U+00E6 */
+};
+
+const char *tg_dia_name(uint8_t dia) {
+    return dia < TG_DIA_COUNT ? k_names[dia] : "";
+}
+
+const char *tg_dia_mark(uint8_t dia) {
+    return dia < TG_DIA_COUNT ? k_marks[dia] : "";
+}
@@ -0,0 +1,53 @@
+/**
+ * @file tg_compose_table.c
+ * @brief Accent composition tables (see tg_compose.h)
+ *
+ * Generated by tools/composegen from UnicodeData.txt.
+ * Do not edit; regenerate instead.
+ */
+
+#include "tg_compose.h"
+
+_Static_assert(TG_COMPOSE_BUCKETS == 64 && TG_COMPOSE_SLOT_BITS == 8,
+               "regenerate the composition table");
+
+const uint16_t tg_compose_decomp[TG_COMPOSE_COUNT] = {
+    /* U+00C0 */ 0x0241, 0x0141, 0x0341, 0x0541, 0x0441, 0x0741, 0x0F41, 0x0643, 0x0245, 0x0145, 0x0345, 0x0445, 0x0249, 0x0149, 0x0349, 0x0449,
+    /* U+00D0 */ 0x0F44, 0x054E, 0x024F, 0x014F, 0x034F, 0x054F, 0x044F, 0x0000, 0x0E4F, 0x0255, 0x0155, 0x0355, 0x0455, 0x0159, 0x0F54, 0x0F73,
+    /* U+00E0 */ 0x0261, 0x0161, 0x0361, 0x0561, 0x0461, 0x0761, 0x0F61, 0x0663, 0x0265, 0x0165, 0x0365, 0x0465, 0x0269, 0x0169, 0x0369, 0x0469,
+    /* U+00F0 */ 0x0F64, 0x056E, 0x026F, 0x016F, 0x036F, 0x056F, 0x046F, 0x0000, 0x0E6F, 0x0275, 0x0175, 0x0375, 0x0475, 0x0179, 0x0F74, 0x0479,
+    /* U+0100 */ 0x0941, 0x0961, 0x0A41, 0x0A61, 0x0B41, 0x0B61, 0x0143, 0x0163, 0x0343, 0x0363, 0x0C43, 0x0C63, 0x0843, 0x0863, 0x0844, 0x0864,
+    /* U+0110 */ 0x0E44, 0x0E64, 0x0945, 0x0965, 0x0A45, 0x0A65, 0x0C45, 0x0C65, 0x0B45, 0x0B65, 0x0845, 0x0865, 0x0347, 0x0367, 0x0A47, 0x0A67,
+    /* U+0120 */ 0x0C47, 0x0C67, 0x0647, 0x0667, 0x0348, 0x0368, 0x0E48, 0x0E68, 0x0549, 0x0569, 0x0949, 0x0969, 0x0A49, 0x0A69, 0x0B49, 0x0B69,
+    /* U+0130 */ 0x0C49, 0x0F69, 0x0F4A, 0x0F6A, 0x034A, 0x036A, 0x064B, 0x066B, 0x0F6B, 0x014C, 0x016C, 0x064C, 0x066C, 0x084C, 0x086C, 0x0F4C,
+    /* U+0140 */ 0x0F6C, 0x0E4C, 0x0E6C, 0x014E, 0x016E, 0x064E, 0x066E, 0x084E, 0x086E, 0x0000, 0x0F4E, 0x0F6E, 0x094F, 0x096F, 0x0A4F, 0x0A6F,
+    /* U+0150 */ 0x0D4F, 0x0D6F, 0x0F4F, 0x0F6F, 0x0152, 0x0172, 0x0652, 0x0672, 0x0852, 0x0872, 0x0153, 0x0173, 0x0353, 0x0373, 0x0653, 0x0673,
+    /* U+0160 */ 0x0853, 0x0873, 0x0654, 0x0674, 0x0854, 0x0874, 0x0E54, 0x0E74, 0x0555, 0x0575, 0x0955, 0x0975, 0x0A55, 0x0A75, 0x0755, 0x0775,
+    /* U+0170 */ 0x0D55, 0x0D75, 0x0B55, 0x0B75, 0x0357, 0x0377, 0x0359, 0x0379, 0x0459, 0x015A, 0x017A, 0x0C5A, 0x0C7A, 0x085A, 0x087A, 0x0F66,
+};
+
+const uint8_t tg_compose_disp[TG_COMPOSE_BUCKETS] = {
+    0, 0, 0, 5, 1, 16, 4, 1, 4, 6, 2, 3, 2, 0, 4, 7,
+    0, 4, 1, 16, 7, 9, 4, 0, 3, 1, 3, 0, 7, 3, 2, 3,
+    3, 1, 1, 2, 1, 0, 16, 7, 4, 2, 6, 4, 6, 0, 0, 9,
+    1, 21, 5, 3, 7, 0, 0, 0, 23, 6, 3, 0, 9, 8, 2, 0,
+};
+
+const uint8_t tg_compose_slot[TG_COMPOSE_SLOTS] = {
+    12, 190, 128, 177, 171, 36, 81, 11, 123, 139, 68, 10, 84, 65, 255, 121,
+    152, 255, 8, 255, 29, 18, 167, 102, 142, 255, 255, 57, 89, 255, 44, 76,
+    255, 7, 138, 179, 78, 70, 38, 159, 37, 183, 9, 15, 116, 255, 255, 64,
+    255, 17, 255, 255, 255, 255, 49, 109, 132, 27, 85, 255, 114, 166, 60, 47,
+    82, 151, 73, 255, 187, 255, 255, 115, 255, 53, 33, 255, 255, 182, 157, 255,
+    255, 186, 21, 24, 42, 1, 154, 50, 255, 125, 90, 255, 86, 130, 54, 96,
+    77, 122, 175, 101, 255, 75, 5, 255, 255, 100, 106, 135, 161, 255, 108, 127,
+    145, 255, 158, 255, 59, 25, 147, 69, 255, 91, 4, 72, 79, 168, 255, 92,
+    61, 144, 255, 170, 3, 6, 255, 255, 107, 255, 62, 255, 104, 41, 14, 0,
+    255, 51, 255, 191, 255, 80, 156, 83, 255, 169, 32, 98, 133, 255, 140, 131,
+    255, 97, 255, 255, 255, 255, 178, 28, 141, 40, 165, 124, 181, 43, 58, 136,
+    255, 39, 164, 31, 48, 74, 103, 16, 255, 52, 2, 255, 174, 255, 110, 87,
+    180, 255, 67, 255, 149, 19, 30, 26, 184, 255, 126, 255, 35, 129, 188, 176,
+    120, 119, 99, 163, 255, 45, 173, 189, 255, 255, 94, 71, 155, 255, 162, 134,
+    46, 255, 185, 146, 34, 172, 255, 93, 63, 113, 118, 148, 153, 143, 88, 20,
+    255, 13, 22, 56, 150, 117, 66, 160, 255, 105, 255, 255, 255, 112, 95, 111,
+};
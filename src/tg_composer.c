@@ -0,0 +1,351 @@
+/**
+ * @file tg_composer.c
+ * @brief Kana and Hangul composition over the session text (see tg_composer.h)
+ *
+ * Every path reads a bounded number of text units and table entries and
+ * makes one ime_session_replace_before() call; the state is only
+ * updated once that edit has gone in.
+ */
+
+#include <string.h>
+
+#include "plugin_common.h"
+#include "tg_composer.h"
+
+/* ─── Span ────────────────────────────────────────────────────────── */
+
+void tg_composer_reset(TgComposer *c) {
+    if (!c) return;
+    memset(c, 0, sizeof(*c));
+}
+
+/* The span still ends at the cursor with nothing selected */
+static bool span_intact(const TgComposer *c, const ImeSession *s) {
+    return s->state == IME_STATE_ACTIVE && !s->selected_all &&
+           s->sel_start == s->sel_end && c->start + c->length == s->text_cursor &&
+           s->text_cursor <= s->output_length;
+}
+
+/* Replace the last @p del units of the span with @p n units */
+static bool span_replace(TgComposer *c, ImeSession *s, uint32_t del,
+                         const uint16_t *out, uint32_t n) {
+    if (!ime_session_replace_before(s, del, out, n)) return false;
+    c->length = c->length - del + n;
+    c->start  = s->text_cursor - c->length;
+    return true;
+}
+
+/* ─── Romaji ──────────────────────────────────────────────────────── */
+
+#define KANA_SMALL_TSU  0x3063
+#define KATAKANA_SHIFT  0x60    /* U+3041..U+3096 -> U+30A1..U+30F6 */
+
+static uint16_t kana_for(uint16_t hiragana, uint8_t mode) {
+    if (mode == TG_COMPOSER_KATAKANA && hiragana >= 0x3041 && hiragana <= 0x3096)
+        return (uint16_t)(hiragana + KATAKANA_SHIFT);
+    return hiragana;
+}
+
+static uint16_t to_lower(uint16_t c) {
+    return c >= 'A' && c <= 'Z' ? (uint16_t)(c + ('a' - 'A')) : c;
+}
+
+static bool is_vowel(uint16_t c) {
+    return c == 'a' || c == 'i' || c == 'u' || c == 'e' || c == 'o';
+}
+
+/* Append a node's kana to out; returns the units written */
+static uint32_t put_kana(const TgKanaNode *node, uint8_t mode, uint16_t *out) {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < 2 && node->kana[i]; i++) out[n++] = kana_for(node->kana[i], mode);
+    return n;
+}
+
+static bool romaji_feed(TgComposer *c, ImeSession *s, uint16_t unit) {
+    int32_t in = tg_kana_input(unit);
+    if (in < 0) return false;
+
+    uint16_t out[4];
+    uint32_t n = 0, del = 0;
+    uint32_t node = c->node, pending = c->pending;
+    uint16_t lower = to_lower(unit);
+
+    int32_t next = tg_kana_child(node, in);
+    if (next < 0 && pending > 0) {
+        /* The pending letters go no further: n becomes ん, a doubled
+         * consonant (or the t of tch) っ, anything else stays as typed */
+        const TgKanaNode *at = &tg_kana_nodes[node];
+        uint16_t last = to_lower(ime_session_char_at(s, s->text_cursor - 1));
+        if (at->kana[0]) {
+            del = pending;
+            n = put_kana(at, c->mode, out);
+        } else if (pending == 1 && !is_vowel(lower) &&
+                   (last == lower || (last == 't' && lower == 'c'))) {
+            del = 1;
+            out[n++] = kana_for(KANA_SMALL_TSU, c->mode);
+        }
+        node = 0;
+        pending = 0;
+        next = tg_kana_child(0, in);
+    }
+
+    if (next < 0) {
+        /* Starts no spelling: it stays in the span as typed */
+        out[n++] = unit;
+        node = 0;
+        pending = 0;
+    } else if (tg_kana_nodes[next].kana[0] && tg_kana_nodes[next].next == 0) {
+        /* A whole spelling: its letters become kana */
+        del += pending;
+        n += put_kana(&tg_kana_nodes[next], c->mode, out + n);
+        node = 0;
+        pending = 0;
+    } else {
+        out[n++] = unit;
+        node = (uint32_t)next;
+        pending++;
+    }
+
+    if (span_replace(c, s, del, out, n)) {
+        c->node    = (uint16_t)node;
+        c->pending = (uint8_t)pending;
+    }
+    return true;
+}
+
+/* Walk the trie again over the pending letters before the cursor */
+static uint32_t romaji_node(const ImeSession *s, uint32_t pending) {
+    int32_t node = 0;
+    for (uint32_t i = pending; i > 0 && node >= 0; i--)
+        node = tg_kana_child((uint32_t)node,
+                             tg_kana_input(ime_session_char_at(s, s->text_cursor - i)));
+    return node > 0 ? (uint32_t)node : 0;
+}
+
+/* ─── Hangul ──────────────────────────────────────────────────────── */
+
+#define JAMO_FIRST      0x3131  /* compatibility jamo ㄱ */
+#define JAMO_VOWEL      0x314F  /* ㅏ, vowel index 0 */
+#define JAMO_LAST       0x3163  /* ㅣ */
+#define SYLLABLE_BASE   0xAC00
+#define NO_INITIAL      0xFF
+
+/* Compatibility consonants ㄱ..ㅎ: initial index, final index (0 = none) */
+static const uint8_t k_cons_initial[JAMO_VOWEL - JAMO_FIRST] = {
+    0, 1, NO_INITIAL, 2, NO_INITIAL, NO_INITIAL, 3, 4, 5, NO_INITIAL,
+    NO_INITIAL, NO_INITIAL, NO_INITIAL, NO_INITIAL, NO_INITIAL, NO_INITIAL,
+    6, 7, 8, NO_INITIAL, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+};
+static const uint8_t k_cons_final[JAMO_VOWEL - JAMO_FIRST] = {
+    1, 2, 3, 4, 5, 6, 7, 0, 8, 9, 10, 11, 12, 13, 14, 15,
+    16, 17, 0, 18, 19, 20, 21, 22, 0, 23, 24, 25, 26, 27,
+};
+
+static const uint16_t k_initial_jamo[19] = {
+    0x3131, 0x3132, 0x3134, 0x3137, 0x3138, 0x3139, 0x3141, 0x3142, 0x3143, 0x3145,
+    0x3146, 0x3147, 0x3148, 0x3149, 0x314A, 0x314B, 0x314C, 0x314D, 0x314E,
+};
+static const uint16_t k_final_jamo[28] = {
+    0,      0x3131, 0x3132, 0x3133, 0x3134, 0x3135, 0x3136, 0x3137, 0x3139, 0x313A,
+    0x313B, 0x313C, 0x313D, 0x313E, 0x313F, 0x3140, 0x3141, 0x3142, 0x3144, 0x3145,
+    0x3146, 0x3147, 0x3148, 0x314A, 0x314B, 0x314C, 0x314D, 0x314E,
+};
+
+/* Two vowels or two finals typed in a row that make one */
+typedef struct JamoPair {
+    uint8_t first, second, both;
+} JamoPair;
+
+static const JamoPair k_vowel_pairs[] = {
+    { 8, 0, 9 },   { 8, 1, 10 },  { 8, 20, 11 },        /* ㅘ ㅙ ㅚ */
+    { 13, 4, 14 }, { 13, 5, 15 }, { 13, 20, 16 },       /* ㅝ ㅞ ㅟ */
+    { 18, 20, 19 },                                     /* ㅢ */
+};
+static const JamoPair k_final_pairs[] = {
+    { 1, 19, 3 },   { 4, 22, 5 },   { 4, 27, 6 },       /* ㄳ ㄵ ㄶ */
+    { 8, 1, 9 },    { 8, 16, 10 },  { 8, 17, 11 },      /* ㄺ ㄻ ㄼ */
+    { 8, 19, 12 },  { 8, 25, 13 },  { 8, 26, 14 },      /* ㄽ ㄾ ㄿ */
+    { 8, 27, 15 },  { 17, 19, 18 },                     /* ㅀ ㅄ */
+};
+
+static uint8_t pair_of(const JamoPair *pairs, uint32_t count, uint8_t a, uint8_t b) {
+    for (uint32_t i = 0; i < count; i++)
+        if (pairs[i].first == a && pairs[i].second == b) return pairs[i].both;
+    return 0;
+}
+
+/* A syllable being built: initial, vowel and final indices */
+typedef struct Syllable {
+    int8_t   l, v;              /* -1 = none */
+    uint8_t  t;                 /* 0 = none */
+    uint16_t lone;              /* a jamo that takes nothing more (ㄳ typed as is) */
+} Syllable;
+
+static const Syllable k_empty = { -1, -1, 0, 0 };
+
+/* Add jamo @p j to @p y; false if it starts the next syllable instead */
+static bool hangul_add(Syllable *y, uint16_t j) {
+    if (y->lone) return false;
+
+    if (j >= JAMO_VOWEL) {
+        uint8_t v = (uint8_t)(j - JAMO_VOWEL);
+        if (y->v < 0) {
+            y->v = (int8_t)v;
+            return true;
+        }
+        if (y->t) return false;
+        uint8_t both = pair_of(k_vowel_pairs, ARRAY_SIZE(k_vowel_pairs), (uint8_t)y->v, v);
+        if (!both) return false;
+        y->v = (int8_t)both;
+        return true;
+    }
+
+    uint32_t ci = j - JAMO_FIRST;
+    if (y->l < 0 && y->v < 0) {
+        if (k_cons_initial[ci] == NO_INITIAL) y->lone = j;
+        else y->l = (int8_t)k_cons_initial[ci];
+        return true;
+    }
+    if (y->l < 0 || y->v < 0 || !k_cons_final[ci]) return false;
+    if (!y->t) {
+        y->t = k_cons_final[ci];
+        return true;
+    }
+    uint8_t both = pair_of(k_final_pairs, ARRAY_SIZE(k_final_pairs), y->t, k_cons_final[ci]);
+    if (!both) return false;
+    y->t = both;
+    return true;
+}
+
+static uint16_t hangul_char(const Syllable *y) {
+    if (y->lone) return y->lone;
+    if (y->l >= 0 && y->v >= 0)
+        return (uint16_t)(SYLLABLE_BASE + ((uint32_t)y->l * 21 + (uint32_t)y->v) * 28 + y->t);
+    if (y->l >= 0) return k_initial_jamo[y->l];
+    return (uint16_t)(JAMO_VOWEL + y->v);
+}
+
+static Syllable hangul_replay(const uint16_t *jamo, uint32_t count) {
+    Syllable y = k_empty;
+    for (uint32_t i = 0; i < count; i++) hangul_add(&y, jamo[i]);
+    return y;
+}
+
+static bool hangul_feed(TgComposer *c, ImeSession *s, uint16_t j) {
+    if (j < JAMO_FIRST || j > JAMO_LAST) return false;
+
+    Syllable y = hangul_replay(c->jamo, c->jamo_count);
+    Syllable next = y;
+    uint16_t out[2], jamo[TG_HANGUL_KEYS_MAX];
+    uint32_t n, del, count;
+
+    if (c->jamo_count > 0 && c->jamo_count < TG_HANGUL_KEYS_MAX && hangul_add(&next, j)) {
+        /* Still this syllable */
+        out[0] = hangul_char(&next);
+        n = 1;
+        del = 1;
+        memcpy(jamo, c->jamo, c->jamo_count * sizeof(uint16_t));
+        jamo[c->jamo_count] = j;
+        count = c->jamo_count + 1u;
+    } else if (j >= JAMO_VOWEL && y.l >= 0 && y.v >= 0 && y.t) {
+        /* A vowel after a final takes it (or its second half) along */
+        uint8_t keep = 0, moved = y.t;
+        for (uint32_t i = 0; i < ARRAY_SIZE(k_final_pairs); i++) {
+            if (k_final_pairs[i].both == y.t) {
+                keep  = k_final_pairs[i].first;
+                moved = k_final_pairs[i].second;
+            }
+        }
+        Syllable prev = y;
+        prev.t = keep;
+        jamo[0] = k_final_jamo[moved];
+        jamo[1] = j;
+        count = 2;
+        next = hangul_replay(jamo, count);
+        out[0] = hangul_char(&prev);
+        out[1] = hangul_char(&next);
+        n = 2;
+        del = 1;
+    } else {
+        /* The syllable is done; this jamo starts the next */
+        jamo[0] = j;
+        count = 1;
+        next = hangul_replay(jamo, count);
+        out[0] = hangul_char(&next);
+        n = 1;
+        del = 0;
+    }
+
+    if (del == 0) c->length = 0;        /* the finished syllable is committed */
+    if (span_replace(c, s, del, out, n)) {
+        /* The span is only the syllable being built */
+        c->start  = s->text_cursor - 1;
+        c->length = 1;
+        memcpy(c->jamo, jamo, count * sizeof(uint16_t));
+        c->jamo_count = (uint8_t)count;
+    } else if (del == 0) {
+        tg_composer_reset(c);
+    }
+    return true;
+}
+
+/* ─── API ─────────────────────────────────────────────────────────── */
+
+bool tg_composer_feed(TgComposer *c, ImeSession *s, uint8_t mode, uint16_t unit) {
+    if (!c || !s) return false;
+    if (tg_composer_active(c) && (!span_intact(c, s) || c->mode != mode))
+        tg_composer_commit(c, s);
+    if (!tg_composer_active(c)) {
+        tg_composer_reset(c);
+        c->mode  = mode;
+        c->start = s->text_cursor;
+    }
+
+    bool took = false;
+    switch (mode) {
+    case TG_COMPOSER_HIRAGANA:
+    case TG_COMPOSER_KATAKANA: took = romaji_feed(c, s, unit); break;
+    case TG_COMPOSER_HANGUL:   took = hangul_feed(c, s, unit); break;
+    default: break;
+    }
+    if (!took) tg_composer_commit(c, s);
+    return took;
+}
+
+bool tg_composer_backspace(TgComposer *c, ImeSession *s) {
+    if (!c || !s || !tg_composer_active(c)) return false;
+    if (!span_intact(c, s)) {
+        tg_composer_reset(c);
+        return false;
+    }
+
+    if (c->mode == TG_COMPOSER_HANGUL) {
+        uint32_t count = c->jamo_count ? c->jamo_count - 1u : 0;
+        if (count == 0) {
+            if (span_replace(c, s, 1, NULL, 0)) tg_composer_reset(c);
+            return true;
+        }
+        Syllable y = hangul_replay(c->jamo, count);
+        uint16_t ch = hangul_char(&y);
+        if (span_replace(c, s, 1, &ch, 1)) c->jamo_count = (uint8_t)count;
+        return true;
+    }
+
+    /* Romaji: a pending letter, else the last unit of the span */
+    if (!span_replace(c, s, 1, NULL, 0)) return true;
+    if (c->pending > 0) c->pending--;
+    c->node = (uint16_t)romaji_node(s, c->pending);
+    if (c->length == 0) tg_composer_reset(c);
+    return true;
+}
+
+void tg_composer_commit(TgComposer *c, ImeSession *s) {
+    if (!c || !tg_composer_active(c)) return;
+    if (s && span_intact(c, s) && c->pending > 0 && tg_kana_nodes[c->node].kana[0]) {
+        uint16_t out[2];
+        uint32_t n = put_kana(&tg_kana_nodes[c->node], c->mode, out);
+        span_replace(c, s, c->pending, out, n);
+    }
+    LOG_DEBUG("Composer: committed %u units at %u", c->length, c->start);
+    tg_composer_reset(c);
+}
@@ -0,0 +1,152 @@
+/**
+ * @file tg_dict.c
+ * @brief Word-completion dictionary queries (see tg_dict.h)
+ *
+ * Pure lookups on a mapped file; no I/O or allocation. Queries run on the
+ * IME poll thread, one at a time.
+ */
+
+#include <string.h>
+
+#include "plugin_common.h"
+#include "tg_dict.h"
+
+/* Best-first frontier; the weakest entry is dropped when it fills up */
+#define DICT_QUEUE_MAX  128
+
+typedef struct DictCand {
+    uint32_t node;
+    uint8_t  score;             /* subtree best, or the word's own freq */
+    uint8_t  is_word;
+    uint8_t  len;
+    char     text[TG_DICT_WORD_MAX];
+} DictCand;
+
+static DictCand g_queue[DICT_QUEUE_MAX];
+static uint32_t g_queue_len;
+
+/* ─── Attach ──────────────────────────────────────────────────────── */
+
+int32_t tg_dict_attach(TgDict *d, const void *data, size_t size) {
+    if (!d || !data || size < sizeof(TgDictHeader)) return IME_ERROR_INVALID_PARAM;
+    memset(d, 0, sizeof(*d));
+
+    const TgDictHeader *h = (const TgDictHeader *)data;
+    if (h->magic != TG_DICT_MAGIC || h->version != TG_DICT_VERSION ||
+        h->node_size != sizeof(TgDictNode)) {
+        LOG_WARN("dict: bad header (magic 0x%08X version %u)", h->magic, h->version);
+        return IME_ERROR_INVALID_PARAM;
+    }
+    if (h->node_count == 0 || h->root >= h->node_count ||
+        (uint64_t)h->node_count * sizeof(TgDictNode) > size - sizeof(TgDictHeader)) {
+        LOG_WARN("dict: truncated (%u nodes, %u bytes)", h->node_count, (uint32_t)size);
+        return IME_ERROR_INVALID_PARAM;
+    }
+
+    const TgDictNode *nodes = (const TgDictNode *)(h + 1);
+    for (uint32_t i = 0; i < h->node_count; i++) {
+        if ((uint64_t)nodes[i].first_child + nodes[i].child_count > h->node_count) {
+            LOG_WARN("dict: node %u children out of range", i);
+            return IME_ERROR_INVALID_PARAM;
+        }
+    }
+
+    d->nodes      = nodes;
+    d->node_count = h->node_count;
+    d->word_count = h->word_count;
+    d->root       = h->root;
+    return IME_OK;
+}
+
+/* ─── Query ───────────────────────────────────────────────────────── */
+
+static const TgDictNode *find_child(const TgDict *d, const TgDictNode *n, char ch) {
+    const TgDictNode *c = &d->nodes[n->first_child];
+    for (uint32_t i = 0; i < n->child_count; i++) {
+        if (c[i].ch == (uint8_t)ch) return &c[i];
+        if (c[i].ch > (uint8_t)ch) break;   /* sorted */
+    }
+    return NULL;
+}
+
+static void queue_push(uint32_t node, uint8_t score, uint8_t is_word,
+                       const char *text, uint8_t len) {
+    DictCand *slot;
+    if (g_queue_len < DICT_QUEUE_MAX) {
+        slot = &g_queue[g_queue_len++];
+    } else {
+        uint32_t weakest = 0;
+        for (uint32_t i = 1; i < g_queue_len; i++)
+            if (g_queue[i].score < g_queue[weakest].score) weakest = i;
+        if (g_queue[weakest].score >= score) return;
+        slot = &g_queue[weakest];
+    }
+    slot->node    = node;
+    slot->score   = score;
+    slot->is_word = is_word;
+    slot->len     = len;
+    memcpy(slot->text, text, len);
+}
+
+static DictCand *queue_pop(void) {
+    if (g_queue_len == 0) return NULL;
+    uint32_t top = 0;
+    for (uint32_t i = 1; i < g_queue_len; i++)
+        if (g_queue[i].score > g_queue[top].score) top = i;
+
+    /* Swap the winner to the end so the caller can read it in place */
+    DictCand t = g_queue[top];
+    g_queue[top] = g_queue[--g_queue_len];
+    g_queue[g_queue_len] = t;
+    return &g_queue[g_queue_len];
+}
+
+uint32_t tg_dict_complete(const TgDict *d, const char *prefix, uint32_t len,
+                          char out[][TG_DICT_WORD_MAX], uint32_t max) {
+    if (!d || !d->nodes || !prefix || max == 0 || len >= TG_DICT_WORD_MAX - 1)
+        return 0;
+
+    const TgDictNode *n = &d->nodes[d->root];
+    for (uint32_t i = 0; i < len && n; i++)
+        n = find_child(d, n, prefix[i]);
+    if (!n || n->best == 0) return 0;
+
+    g_queue_len = 0;
+    queue_push((uint32_t)(n - d->nodes), n->best, 0, prefix, (uint8_t)len);
+
+    uint32_t found = 0;
+    DictCand *c;
+    while (found < max && (c = queue_pop()) != NULL) {
+        /* Copy out: pushes below may reuse the slot */
+        DictCand cur = *c;
+        if (cur.is_word) {
+            if (cur.len == len) continue;   /* the prefix itself */
+            memcpy(out[found], cur.text, cur.len);
+            out[found][cur.len] = '\0';
+            found++;
+            continue;
+        }
+
+        const TgDictNode *node = &d->nodes[cur.node];
+        if (node->freq)
+            queue_push(cur.node, node->freq, 1, cur.text, cur.len);
+        if (cur.len + 1 >= TG_DICT_WORD_MAX) continue;
+
+        const TgDictNode *child = &d->nodes[node->first_child];
+        for (uint32_t i = 0; i < node->child_count; i++) {
+            if (child[i].best == 0) continue;
+            cur.text[cur.len] = (char)child[i].ch;
+            queue_push(node->first_child + i, child[i].best, 0,
+                       cur.text, (uint8_t)(cur.len + 1));
+        }
+    }
+    return found;
+}
+
+uint8_t tg_dict_freq(const TgDict *d, const char *word, uint32_t len) {
+    if (!d || !d->nodes || !word) return 0;
+    const TgDictNode *n = &d->nodes[d->root];
+    for (uint32_t i = 0; i < len && n; i++)
+        n = find_child(d, n, word[i]);
+    return n ? n->freq : 0;
+}
@@ -0,0 +1,570 @@
+/**
+ * @file tg_engine.c
+ * @brief ThumbGrid input engine — pad sample + time in, TG_FX_* effects out
+ */
+
+#include <string.h>
+
+#include "ime_hook.h"
+#include "plugin_common.h"
+#include "profile.h"
+#include "tg_engine.h"
+
+/* Screen size assumed until the renderer reports one */
+#define TG_ENGINE_DEFAULT_W  1920
+#define TG_ENGINE_DEFAULT_H  1080
+
+/* ─── Init ────────────────────────────────────────────────────────── */
+
+int32_t tg_engine_init(ThumbGridEngine *e, int32_t panel_type,
+                       uint32_t option, uint32_t max_length,
+                       uint16_t *caller_buffer, const uint16_t *prefill,
+                       const uint16_t *title, uint64_t now_us) {
+    if (!e) return IME_ERROR_INVALID_PARAM;
+
+    /* The screen size and word stores outlive sessions; the rest is reset */
+    uint32_t screen_w = e->screen_w ? e->screen_w : TG_ENGINE_DEFAULT_W;
+    uint32_t screen_h = e->screen_h ? e->screen_h : TG_ENGINE_DEFAULT_H;
+    const TgDict *dict = e->dict;
+    TgLearnStore *learn = e->learn;
+    TgUsageStore *usage = e->usage;
+    memset(e, 0, sizeof(*e));
+    e->screen_w = screen_w;
+    e->screen_h = screen_h;
+    e->dict     = dict;
+    e->learn    = learn;
+    e->usage    = usage;
+    e->no_learn = (option & (ORBIS_IME_OPTION_PASSWORD | ORBIS_IME_OPTION_NO_LEARNING)) != 0;
+
+    int32_t rc = ime_session_init(&e->session, panel_type, max_length,
+                                  caller_buffer, prefill);
+    if (rc != IME_OK) return rc;
+
+    thumbgrid_init(&e->grid);
+    cell_select_init(&e->cellsel, NULL);
+    if (title) {
+        uint32_t i = 0;
+        while (title[i] != 0 && i < TG_TITLE_MAX - 1) {
+            e->grid.title[i] = title[i];
+            i++;
+        }
+        e->grid.title[i] = 0;
+    }
+
+    e->input.stick_x  = 128;  /* center */
+    e->input.stick_y  = 128;
+    e->input.rstick_x = 128;
+    e->input.rstick_y = 128;
+
+    e->start_us      = now_us;
+    e->l2_saved_page = -1;
+    return IME_OK;
+}
+
+/* ─── Word completion ─────────────────────────────────────────────── */
+
+static bool is_word_char(uint16_t c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '\'';
+}
+
+static char to_lower(uint16_t c) {
+    return (char)(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+}
+
+/*
+ * Look up completions for the word left of the cursor. The typed
+ * prefix's case carries over: "He" offers "Hello", "HE" offers "HELLO".
+ */
+static void update_suggestions(ThumbGridEngine *e) {
+    const ImeSession *s = &e->session;
+    e->suggestion_count   = 0;
+    e->suggest_prefix_len = 0;
+    if ((!e->dict && !e->learn) || e->no_learn || s->selected_all ||
+        s->sel_start != s->sel_end)
+        return;
+
+    /* Mid-word: nothing to complete */
+    uint32_t cur = s->text_cursor;
+    if (cur < s->output_length && is_word_char(ime_session_char_at(s, cur))) return;
+
+    uint32_t len = 0;
+    while (len < cur && is_word_char(ime_session_char_at(s, cur - 1 - len))) len++;
+    if (len == 0 || len >= TG_DICT_WORD_MAX - 1) return;
+
+    char prefix[TG_DICT_WORD_MAX];
+    uint32_t upper = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        uint16_t c = ime_session_char_at(s, cur - len + i);
+        if (c >= 'A' && c <= 'Z') upper++;
+        prefix[i] = to_lower(c);
+    }
+
+    /* The previous word, if only spaces separate it, for pair counts */
+    char prev[TG_DICT_WORD_MAX];
+    uint32_t prev_len = 0;
+    uint32_t p = cur - len;
+    while (p > 0 && ime_session_char_at(s, p - 1) == ' ') p--;
+    if (p < cur - len) {
+        uint32_t n = 0;
+        while (n < p && is_word_char(ime_session_char_at(s, p - 1 - n))) n++;
+        if (n < TG_DICT_WORD_MAX) {
+            for (uint32_t i = 0; i < n; i++) prev[i] = to_lower(ime_session_char_at(s, p - n + i));
+            prev_len = n;
+        }
+    }
+
+    PROF_BEGIN(PROF_IME_PREDICT);
+    uint32_t n = tg_learn_complete(e->learn, e->dict, prev, prev_len, prefix, len,
+                                   e->suggestions, TG_ENGINE_SUGGEST_MAX);
+    PROF_END(PROF_IME_PREDICT);
+
+    bool first_upper = ime_session_char_at(s, cur - len) >= 'A' && ime_session_char_at(s, cur - len) <= 'Z';
+    bool all_upper   = len >= 2 && upper == len;
+    for (uint32_t k = 0; k < n && first_upper; k++) {
+        char *w = e->suggestions[k];
+        for (uint32_t i = 0; w[i] && (i == 0 || all_upper); i++)
+            if (w[i] >= 'a' && w[i] <= 'z') w[i] -= 'a' - 'A';
+    }
+    e->suggestion_count   = n;
+    e->suggest_prefix_len = len;
+}
+
+/* Complete the current word with the first suggestion, then a space */
+static uint32_t accept_suggestion(ThumbGridEngine *e) {
+    if (e->suggestion_count == 0) return 0;
+    const char *w = e->suggestions[0];
+    for (uint32_t i = e->suggest_prefix_len; w[i]; i++)
+        ime_session_add_char(&e->session, w[i]);
+    ime_session_add_char(&e->session, ' ');
+    LOG_DEBUG("ThumbGrid: R3 accepted \"%s\"", w);
+    return TG_FX_TEXT;
+}
+
+/* ─── Composition ─────────────────────────────────────────────────── */
+
+static uint8_t page_composer(const ThumbGridEngine *e) {
+    const ThumbGridState *g = &e->grid;
+    if (!g->pages || g->current_page < 0 || g->current_page >= g->page_count)
+        return TG_COMPOSER_NONE;
+    return g->pages[g->current_page].compose;
+}
+
+/* End the span before an edit or move the composer does not make */
+static void commit_composition(ThumbGridEngine *e) {
+    tg_composer_commit(&e->composer, &e->session);
+}
+
+/* ─── Dispatch ────────────────────────────────────────────────────── */
+
+/* Type the selected cell's key for a face button. Returns TG_FX_*. */
+static uint32_t dispatch_face_button(ThumbGridEngine *e, int button_index) {
+    const TgKey *k = thumbgrid_get_key(&e->grid, button_index);
+    if (!k || (k->op == TG_OP_TEXT && k->len == 0)) return 0;
+
+    /* Usage log for layout scoring; editing functions and strings break the chain */
+    if (!e->no_learn)
+        tg_usage_press(e->usage, &e->usage_cursor, e->grid.selected_cell,
+                       k->op == TG_OP_SPACE ? ' ' : k->len == 1 ? k->text[0] : 0,
+                       e->step_us);
+
+    /* On a composer page, its one-unit keys go to the composer */
+    uint8_t mode = page_composer(e);
+    if (k->op == TG_OP_TEXT && k->len == 1 && mode != TG_COMPOSER_NONE &&
+        tg_composer_feed(&e->composer, &e->session, mode, k->text[0]))
+        return TG_FX_TEXT;
+
+    switch (k->op) {
+    case TG_OP_TEXT:
+        commit_composition(e);
+        break;
+    case TG_OP_BKSP:
+        if (!tg_composer_backspace(&e->composer, &e->session))
+            ime_session_backspace(&e->session);
+        return TG_FX_TEXT;
+    case TG_OP_SPACE:
+        /* Space ends a kana span; Hangul is spaced between words */
+        if (tg_composer_active(&e->composer) &&
+            e->composer.mode != TG_COMPOSER_HANGUL) {
+            commit_composition(e);
+            return TG_FX_TEXT;
+        }
+        commit_composition(e);
+        ime_session_add_char(&e->session, ' ');
+        return TG_FX_TEXT;
+    case TG_OP_ACCENT:
+        thumbgrid_cycle_accent(&e->grid);
+        LOG_DEBUG("ThumbGrid: accent layer %s",
+                  e->grid.accent_layer ? tg_dia_name(e->grid.accent_layer) : "off");
+        return 0;
+    case TG_OP_SELALL:
+        commit_composition(e);
+        ime_session_select_all(&e->session);
+        LOG_DEBUG("ThumbGrid: select all");
+        return TG_FX_TEXT;
+    case TG_OP_EXIT:
+        ime_session_cancel(&e->session);
+        LOG_INFO("ThumbGrid: exit via center cell");
+        return 0;
+    case TG_OP_CUT:
+        commit_composition(e);
+        ime_session_cut(&e->session);
+        return TG_FX_TEXT;
+    case TG_OP_COPY:
+        commit_composition(e);
+        ime_session_copy(&e->session);
+        return 0;
+    case TG_OP_PASTE:
+        commit_composition(e);
+        ime_session_paste(&e->session);
+        return TG_FX_TEXT;
+    case TG_OP_CAPS:
+        thumbgrid_shift_toggle(&e->grid);
+        return 0;
+    default:
+        return 0;
+    }
+
+    /* Typed text — composed with the accent layer if it has this letter */
+    uint16_t composed = thumbgrid_compose(&e->grid, k);
+    if (composed) {
+        ime_session_add_char16(&e->session, composed);
+        return TG_FX_TEXT;
+    }
+    ime_session_add_text(&e->session, k->text, k->len);
+    return TG_FX_TEXT;
+}
+
+/*
+ * Move the cursor by D-pad, Left/Right a word at a time if by_word; with
+ * X held this extends the selection
+ */
+static void move_cursor(ThumbGridEngine *e, ImeAction action, bool by_word) {
+    ImeSession *s = &e->session;
+
+    if (!e->x_held) {
+        ime_session_clear_selection(s);
+        switch (action) {
+        case IME_ACTION_CURSOR_HOME:  ime_session_cursor_home(s);  break;
+        case IME_ACTION_CURSOR_END:   ime_session_cursor_end(s);   break;
+        case IME_ACTION_CURSOR_LEFT:
+            if (by_word) ime_session_word_left(s);
+            else         ime_session_cursor_left(s);
+            break;
+        case IME_ACTION_CURSOR_RIGHT:
+            if (by_word) ime_session_word_right(s);
+            else         ime_session_cursor_right(s);
+            break;
+        default: break;
+        }
+        return;
+    }
+
+    /* X held + D-pad: select from the anchor to the new cursor */
+    e->x_dpad_used = true;
+    switch (action) {
+    case IME_ACTION_CURSOR_HOME:
+        s->text_cursor = 0;
+        break;
+    case IME_ACTION_CURSOR_END:
+        s->text_cursor = s->output_length;
+        break;
+    case IME_ACTION_CURSOR_LEFT:
+        if (by_word) s->text_cursor = ime_session_word_before(s, s->text_cursor);
+        else         s->text_cursor = ime_session_cluster_before(s, s->text_cursor);
+        break;
+    case IME_ACTION_CURSOR_RIGHT:
+        if (by_word) s->text_cursor = ime_session_word_after(s, s->text_cursor);
+        else         s->text_cursor = ime_session_cluster_after(s, s->text_cursor);
+        break;
+    default:
+        break;
+    }
+    ime_session_set_selection(s, e->x_anchor, s->text_cursor);
+}
+
+/*
+ * Hold-to-repeat timing shared by backspace and the D-pad: nothing
+ * until the initial delay, then every repeat_us, switching to word
+ * steps every TG_ENGINE_WORD_REPEAT_US once held past
+ * TG_ENGINE_WORD_ACCEL_US. Returns 0 (no step yet), 1 (a character)
+ * or 2 (a word).
+ */
+static int repeat_step(uint64_t start_us, uint64_t *last_us, uint64_t now_us,
+                       uint64_t repeat_us) {
+    uint64_t held = now_us - start_us;
+    if (held < TG_ENGINE_BS_DELAY_US) return 0;
+    bool by_word = held >= TG_ENGINE_WORD_ACCEL_US;
+    if (now_us - *last_us < (by_word ? TG_ENGINE_WORD_REPEAT_US : repeat_us)) return 0;
+    *last_us = now_us;
+    return by_word ? 2 : 1;
+}
+
+/* Apply one input action; l2_center selects Cut/Copy/Paste/Caps */
+static uint32_t dispatch_action(ThumbGridEngine *e, ImeAction action,
+                                bool l2_center) {
+    uint32_t fx = 0;
+    bool paste_chain = e->paste_chain;
+    e->paste_chain = false;
+
+    /* Everything but typing and a page switch ends the span first */
+    bool typing = !l2_center && (action == IME_ACTION_FACE_TRIANGLE ||
+                                 action == IME_ACTION_FACE_CIRCLE ||
+                                 action == IME_ACTION_FACE_SQUARE);
+    if (!typing && action != IME_ACTION_PAGE_NEXT && action != IME_ACTION_PAGE_PREV &&
+        action != IME_ACTION_NONE)
+        commit_composition(e);
+
+    switch (action) {
+    case IME_ACTION_CANCEL:
+        ime_session_cancel(&e->session);
+        LOG_INFO("ThumbGrid: cancelled");
+        break;
+
+    case IME_ACTION_SUBMIT:
+        ime_session_submit(&e->session);
+        if (!e->no_learn) tg_learn_commit(e->learn, &e->session.text);
+        LOG_INFO("ThumbGrid: R2 submit (%u chars)", e->session.output_length);
+        break;
+
+    case IME_ACTION_FACE_TRIANGLE:
+        if (l2_center) {
+            /* Again in the same L2 hold: swap in the entry before it */
+            if (paste_chain) ime_session_paste_older(&e->session);
+            else             ime_session_paste(&e->session);
+            e->paste_chain = true;
+            LOG_DEBUG("ThumbGrid: L2+center Triangle = paste%s",
+                      paste_chain ? " older" : "");
+            fx |= TG_FX_TEXT;
+        } else {
+            fx |= dispatch_face_button(e, TG_BTN_TRIANGLE);
+        }
+        break;
+
+    case IME_ACTION_FACE_CIRCLE:
+        if (l2_center) {
+            /* Caps lock: keep the shifted page after L2 is released */
+            e->l2_shift_active = false;
+            e->l2_saved_page = -1;
+            LOG_DEBUG("ThumbGrid: L2+center Circle = caps lock -> page %d",
+                      e->grid.current_page);
+        } else {
+            fx |= dispatch_face_button(e, TG_BTN_CIRCLE);
+        }
+        break;
+
+    case IME_ACTION_FACE_SQUARE:
+        if (l2_center) {
+            ime_session_copy(&e->session);
+            LOG_DEBUG("ThumbGrid: L2+center Square = copy");
+        } else {
+            fx |= dispatch_face_button(e, TG_BTN_SQUARE);
+        }
+        break;
+
+    case IME_ACTION_CURSOR_LEFT:
+    case IME_ACTION_CURSOR_RIGHT:
+        /* L2 held (l2_prev is this sample's trigger) + Left/Right: undo/redo */
+        if (e->l2_prev >= TG_ENGINE_L2_RELEASE && !e->x_held) {
+            bool undo = action == IME_ACTION_CURSOR_LEFT;
+            bool done = undo ? ime_session_undo(&e->session)
+                             : ime_session_redo(&e->session);
+            LOG_DEBUG("ThumbGrid: L2+D-pad %s%s", undo ? "undo" : "redo",
+                      done ? "" : " (nothing to do)");
+            fx |= TG_FX_TEXT;
+            break;
+        }
+        /* fall through */
+    case IME_ACTION_CURSOR_HOME:
+    case IME_ACTION_CURSOR_END:
+        move_cursor(e, action, false);
+        fx |= TG_FX_TEXT;
+        break;
+
+    case IME_ACTION_PAGE_NEXT:
+    case IME_ACTION_PAGE_PREV:
+        thumbgrid_toggle_symbols(&e->grid);
+        LOG_DEBUG("ThumbGrid: L1/R1 symbols -> page %d", e->grid.current_page);
+        break;
+
+    case IME_ACTION_ACCEPT_WORD:
+        fx |= accept_suggestion(e);
+        break;
+
+    case IME_ACTION_NONE:
+    default:
+        break;
+    }
+    return fx;
+}
+
+/* ─── Step ────────────────────────────────────────────────────────── */
+
+uint32_t tg_engine_step(ThumbGridEngine *e, const TgPadInput *pad,
+                        uint64_t now_us) {
+    if (e->session.state != IME_STATE_ACTIVE) return TG_FX_FINISHED;
+    e->step_us = now_us;
+
+    int32_t cell0  = e->grid.selected_cell;
+    int32_t page0  = e->grid.current_page;
+    int32_t off_x0 = e->grid.offset_x;
+    int32_t off_y0 = e->grid.offset_y;
+    uint8_t acc0   = e->grid.accent_layer;
+    bool    shift0 = e->l2_shift_active;
+    uint32_t fx = 0;
+
+    /* 1. Edge detection (always, to keep state current) */
+    input_update(&e->input, pad->buttons, pad->lx, pad->ly,
+                 pad->rx, pad->ry, now_us);
+
+    /* 2. Cell selection from the left stick, position from the right */
+    e->grid.selected_cell = cell_select_update(&e->cellsel, e->input.stick_x,
+                                               e->input.stick_y, now_us,
+                                               (e->input.buttons_pressed |
+                                                e->input.buttons_released) != 0);
+    if (e->input.buttons_pressed || e->grid.selected_cell != cell0)
+        fx |= TG_FX_EVENT;
+
+    thumbgrid_update_position(&e->grid, e->input.rstick_x, e->input.rstick_y,
+                              e->screen_w, e->screen_h);
+
+    /*
+     * 3. Grace period: ignore all actions at first. The player is
+     * likely still holding whatever button opened the text field.
+     * Edges stay tracked so nothing fires on the first frame after.
+     * The stick is usually at rest here, so this also calibrates it.
+     */
+    if (now_us - e->start_us < TG_ENGINE_GRACE_US) {
+        cell_select_calibrate(&e->cellsel, pad->lx, pad->ly);
+        e->l2_prev = pad->l2;
+        e->l3_prev = (pad->buttons & PAD_BUTTON_L3) != 0;
+        fx |= TG_FX_GRACE;
+        goto done;
+    }
+
+    cell_select_calibrate_end(&e->cellsel);
+
+    /* 4. L2 analog trigger: hold for shift */
+    if (pad->l2 >= TG_ENGINE_L2_ENGAGE && !e->l2_shift_active &&
+        e->l2_prev < TG_ENGINE_L2_ENGAGE) {
+        e->l2_saved_page = e->grid.current_page;
+        thumbgrid_shift_toggle(&e->grid);
+        e->l2_shift_active = true;
+    }
+    if (pad->l2 < TG_ENGINE_L2_RELEASE && e->l2_prev >= TG_ENGINE_L2_RELEASE) {
+        if (e->l2_shift_active && e->l2_saved_page >= 0)
+            e->grid.current_page = e->l2_saved_page;
+        e->l2_shift_active = false;
+        e->l2_saved_page = -1;
+        e->paste_chain = false;
+    }
+    e->l2_prev = pad->l2;
+
+    /* 5. L3 (left stick click): next accent layer */
+    {
+        bool l3_now = (pad->buttons & PAD_BUTTON_L3) != 0;
+        if (l3_now && !e->l3_prev) {
+            thumbgrid_cycle_accent(&e->grid);
+            LOG_DEBUG("ThumbGrid: L3 accent layer %s",
+                      e->grid.accent_layer ? tg_dia_name(e->grid.accent_layer) : "off");
+        }
+        e->l3_prev = l3_now;
+    }
+
+    /* 6. L2+center: Cut/Copy/Paste/Caps on the center cell while shifted */
+    bool l2_center = e->l2_shift_active && e->grid.selected_cell == TG_CENTER_CELL;
+
+    /* 7. X (cross) acts on release, so a hold can select with the D-pad */
+    if (input_just_pressed(&e->input, PAD_BUTTON_CROSS)) {
+        e->x_held = true;
+        e->x_dpad_used = false;
+        e->x_anchor = e->session.text_cursor;
+    }
+    if ((e->input.buttons_released & PAD_BUTTON_CROSS) && e->x_held) {
+        if (!e->x_dpad_used) {
+            if (l2_center) {
+                commit_composition(e);
+                ime_session_cut(&e->session);
+                LOG_DEBUG("ThumbGrid: L2+center X = cut");
+                fx |= TG_FX_TEXT;
+            } else {
+                fx |= dispatch_face_button(e, TG_BTN_CROSS);
+            }
+        }
+        /* Selection stays active if the D-pad was used */
+        e->x_held = false;
+    }
+
+    /* 8. Every action from this sample's button edges, in order */
+    InputEvent events[INPUT_MAX_EVENTS];
+    uint32_t n_events = input_get_actions(&e->input, events, INPUT_MAX_EVENTS);
+    for (uint32_t i = 0; i < n_events && e->session.state == IME_STATE_ACTIVE; i++) {
+        fx |= dispatch_action(e, events[i].action, l2_center);
+    }
+
+    if (e->session.state != IME_STATE_ACTIVE) {
+        fx |= TG_FX_FINISHED;
+        goto done;
+    }
+
+    /* 9. Backspace hold-to-repeat, by words once held long enough */
+    const TgKey *square = thumbgrid_get_key(&e->grid, TG_BTN_SQUARE);
+    if (input_is_held(&e->input, PAD_BUTTON_SQUARE) &&
+        square && square->op == TG_OP_BKSP) {
+        if (!e->bs_held) {
+            e->bs_held = true;
+            e->bs_start_us = now_us;
+            e->bs_last_repeat_us = now_us;
+        } else {
+            int step = repeat_step(e->bs_start_us, &e->bs_last_repeat_us, now_us,
+                                   TG_ENGINE_BS_REPEAT_US);
+            if (step == 1 && !tg_composer_backspace(&e->composer, &e->session))
+                ime_session_backspace(&e->session);
+            if (step == 2) {
+                commit_composition(e);
+                ime_session_delete_word(&e->session);
+            }
+            if (step) fx |= TG_FX_TEXT;
+        }
+    } else {
+        e->bs_held = false;
+    }
+
+    /*
+     * 10. D-pad Left/Right hold-to-repeat, likewise; the press itself
+     * moved once as an action. Not while L2 makes them undo/redo.
+     */
+    {
+        bool left  = input_is_held(&e->input, PAD_BUTTON_LEFT);
+        bool right = input_is_held(&e->input, PAD_BUTTON_RIGHT);
+        int8_t dir = (left == right) ? 0 : (left ? -1 : 1);
+        if (e->l2_prev >= TG_ENGINE_L2_RELEASE) dir = 0;
+
+        if (dir == 0) {
+            e->cursor_dir = 0;
+        } else if (dir != e->cursor_dir) {
+            e->cursor_dir = dir;
+            e->cursor_start_us = now_us;
+            e->cursor_last_repeat_us = now_us;
+        } else {
+            int step = repeat_step(e->cursor_start_us, &e->cursor_last_repeat_us,
+                                   now_us, TG_ENGINE_CURSOR_REPEAT_US);
+            if (step) {
+                move_cursor(e, dir < 0 ? IME_ACTION_CURSOR_LEFT : IME_ACTION_CURSOR_RIGHT,
+                            step == 2);
+                fx |= TG_FX_TEXT;
+            }
+        }
+    }
+
+done:
+    if (fx & TG_FX_TEXT) {
+        /* No English completions for a span still being composed */
+        if (tg_composer_active(&e->composer)) e->suggestion_count = 0;
+        else                                  update_suggestions(e);
+    }
+    if (e->grid.selected_cell != cell0  || e->grid.current_page != page0 ||
+        e->grid.offset_x != off_x0 || e->grid.offset_y != off_y0 ||
+        e->grid.accent_layer != acc0 || e->l2_shift_active != shift0)
+        fx |= TG_FX_GRID;
+    return fx;
+}
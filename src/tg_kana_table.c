@@ -0,0 +1,242 @@
+/**
+ * @file tg_kana_table.c
+ * @brief Romaji trie for the kana composer (see tg_composer.h)
+ *
+ * Generated by tools/kanagen from tools/kanagen/romaji.txt.
+ * Do not edit; regenerate instead.
+ */
+
+#include "tg_composer.h"
+
+_Static_assert(TG_KANA_INPUTS == 28, "regenerate the kana table");
+
+const TgKanaNode tg_kana_nodes[228] = {
+    { 0x07FFFFFF,   1, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3042, 0x0000 } },
+    { 0x01104111,  28, { 0x0000, 0x0000 } },
+    { 0x01104081,  34, { 0x0000, 0x0000 } },
+    { 0x01504191,  39, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3048, 0x0000 } },
+    { 0x00104111,  47, { 0x0000, 0x0000 } },
+    { 0x01104111,  52, { 0x0000, 0x0000 } },
+    { 0x01104111,  58, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3044, 0x0000 } },
+    { 0x01104111,  64, { 0x0000, 0x0000 } },
+    { 0x01104111,  70, { 0x0000, 0x0000 } },
+    { 0x01584111,  76, { 0x0000, 0x0000 } },
+    { 0x01104111,  84, { 0x0000, 0x0000 } },
+    { 0x09106111,  90, { 0x3093, 0x0000 } },
+    { 0x00000000,   0, { 0x304A, 0x0000 } },
+    { 0x01104111,  98, { 0x0000, 0x0000 } },
+    { 0x00004111, 104, { 0x0000, 0x0000 } },
+    { 0x01104111, 108, { 0x0000, 0x0000 } },
+    { 0x01104191, 114, { 0x0000, 0x0000 } },
+    { 0x01544191, 121, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3046, 0x0000 } },
+    { 0x00104111, 130, { 0x0000, 0x0000 } },
+    { 0x00004111, 135, { 0x0000, 0x0000 } },
+    { 0x01584111, 139, { 0x0000, 0x0000 } },
+    { 0x00104011, 147, { 0x0000, 0x0000 } },
+    { 0x01104111, 151, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x30FC, 0x0000 } },
+    { 0x00000000,   0, { 0x3070, 0x0000 } },
+    { 0x00000000,   0, { 0x3079, 0x0000 } },
+    { 0x00000000,   0, { 0x3073, 0x0000 } },
+    { 0x00000000,   0, { 0x307C, 0x0000 } },
+    { 0x00000000,   0, { 0x3076, 0x0000 } },
+    { 0x00104001, 157, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x304B, 0x0000 } },
+    { 0x00104111, 160, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3053, 0x0000 } },
+    { 0x00000000,   0, { 0x304F, 0x0000 } },
+    { 0x00104001, 165, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3060, 0x0000 } },
+    { 0x00000000,   0, { 0x3067, 0x0000 } },
+    { 0x00000100, 168, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3062, 0x0000 } },
+    { 0x00000000,   0, { 0x3069, 0x0000 } },
+    { 0x00000000,   0, { 0x3065, 0x0000 } },
+    { 0x00100000, 169, { 0x0000, 0x0000 } },
+    { 0x00104001, 170, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3075, 0x3041 } },
+    { 0x00000000,   0, { 0x3075, 0x3047 } },
+    { 0x00000000,   0, { 0x3075, 0x3043 } },
+    { 0x00000000,   0, { 0x3075, 0x3049 } },
+    { 0x00000000,   0, { 0x3075, 0x0000 } },
+    { 0x00000000,   0, { 0x304C, 0x0000 } },
+    { 0x00000000,   0, { 0x3052, 0x0000 } },
+    { 0x00000000,   0, { 0x304E, 0x0000 } },
+    { 0x00000000,   0, { 0x3054, 0x0000 } },
+    { 0x00000000,   0, { 0x3050, 0x0000 } },
+    { 0x00104001, 173, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x306F, 0x0000 } },
+    { 0x00000000,   0, { 0x3078, 0x0000 } },
+    { 0x00000000,   0, { 0x3072, 0x0000 } },
+    { 0x00000000,   0, { 0x307B, 0x0000 } },
+    { 0x00000000,   0, { 0x3075, 0x0000 } },
+    { 0x00104001, 176, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3058, 0x3083 } },
+    { 0x00000000,   0, { 0x3058, 0x3047 } },
+    { 0x00000000,   0, { 0x3058, 0x0000 } },
+    { 0x00000000,   0, { 0x3058, 0x3087 } },
+    { 0x00000000,   0, { 0x3058, 0x3085 } },
+    { 0x00104001, 179, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x304B, 0x0000 } },
+    { 0x00000000,   0, { 0x3051, 0x0000 } },
+    { 0x00000000,   0, { 0x304D, 0x0000 } },
+    { 0x00000000,   0, { 0x3053, 0x0000 } },
+    { 0x00000000,   0, { 0x304F, 0x0000 } },
+    { 0x00104001, 182, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3041, 0x0000 } },
+    { 0x00000000,   0, { 0x3047, 0x0000 } },
+    { 0x00000000,   0, { 0x3043, 0x0000 } },
+    { 0x00000000,   0, { 0x3049, 0x0000 } },
+    { 0x00140000, 185, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3045, 0x0000 } },
+    { 0x00000001, 187, { 0x0000, 0x0000 } },
+    { 0x00104001, 188, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x307E, 0x0000 } },
+    { 0x00000000,   0, { 0x3081, 0x0000 } },
+    { 0x00000000,   0, { 0x307F, 0x0000 } },
+    { 0x00000000,   0, { 0x3082, 0x0000 } },
+    { 0x00000000,   0, { 0x3080, 0x0000 } },
+    { 0x00104001, 191, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x306A, 0x0000 } },
+    { 0x00000000,   0, { 0x306D, 0x0000 } },
+    { 0x00000000,   0, { 0x306B, 0x0000 } },
+    { 0x00000000,   0, { 0x3093, 0x0000 } },
+    { 0x00000000,   0, { 0x306E, 0x0000 } },
+    { 0x00000000,   0, { 0x306C, 0x0000 } },
+    { 0x00104001, 194, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3093, 0x0000 } },
+    { 0x00000000,   0, { 0x3071, 0x0000 } },
+    { 0x00000000,   0, { 0x307A, 0x0000 } },
+    { 0x00000000,   0, { 0x3074, 0x0000 } },
+    { 0x00000000,   0, { 0x307D, 0x0000 } },
+    { 0x00000000,   0, { 0x3077, 0x0000 } },
+    { 0x00104001, 197, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x304F, 0x3041 } },
+    { 0x00000000,   0, { 0x304F, 0x3047 } },
+    { 0x00000000,   0, { 0x304F, 0x3043 } },
+    { 0x00000000,   0, { 0x304F, 0x3049 } },
+    { 0x00000000,   0, { 0x3089, 0x0000 } },
+    { 0x00000000,   0, { 0x308C, 0x0000 } },
+    { 0x00000000,   0, { 0x308A, 0x0000 } },
+    { 0x00000000,   0, { 0x308D, 0x0000 } },
+    { 0x00000000,   0, { 0x308B, 0x0000 } },
+    { 0x00104001, 200, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3055, 0x0000 } },
+    { 0x00000000,   0, { 0x305B, 0x0000 } },
+    { 0x00104111, 203, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3057, 0x0000 } },
+    { 0x00000000,   0, { 0x305D, 0x0000 } },
+    { 0x00000000,   0, { 0x3059, 0x0000 } },
+    { 0x00104001, 208, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x305F, 0x0000 } },
+    { 0x00000000,   0, { 0x3066, 0x0000 } },
+    { 0x00000100, 211, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3061, 0x0000 } },
+    { 0x00000000,   0, { 0x3068, 0x0000 } },
+    { 0x00100000, 212, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3064, 0x0000 } },
+    { 0x00100000, 213, { 0x0000, 0x0000 } },
+    { 0x00104001, 214, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3094, 0x3041 } },
+    { 0x00000000,   0, { 0x3094, 0x3047 } },
+    { 0x00000000,   0, { 0x3094, 0x3043 } },
+    { 0x00000000,   0, { 0x3094, 0x3049 } },
+    { 0x00000000,   0, { 0x3094, 0x0000 } },
+    { 0x00000000,   0, { 0x308F, 0x0000 } },
+    { 0x00000000,   0, { 0x3046, 0x3047 } },
+    { 0x00000000,   0, { 0x3046, 0x3043 } },
+    { 0x00000000,   0, { 0x3092, 0x0000 } },
+    { 0x00000000,   0, { 0x3041, 0x0000 } },
+    { 0x00000000,   0, { 0x3047, 0x0000 } },
+    { 0x00000000,   0, { 0x3043, 0x0000 } },
+    { 0x00000000,   0, { 0x3049, 0x0000 } },
+    { 0x00140000, 217, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3045, 0x0000 } },
+    { 0x00000001, 219, { 0x0000, 0x0000 } },
+    { 0x00104001, 220, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3084, 0x0000 } },
+    { 0x00000000,   0, { 0x3044, 0x3047 } },
+    { 0x00000000,   0, { 0x3088, 0x0000 } },
+    { 0x00000000,   0, { 0x3086, 0x0000 } },
+    { 0x00000000,   0, { 0x3056, 0x0000 } },
+    { 0x00000000,   0, { 0x305C, 0x0000 } },
+    { 0x00000000,   0, { 0x3058, 0x0000 } },
+    { 0x00000000,   0, { 0x305E, 0x0000 } },
+    { 0x00000000,   0, { 0x305A, 0x0000 } },
+    { 0x00104001, 223, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3073, 0x3083 } },
+    { 0x00000000,   0, { 0x3073, 0x3087 } },
+    { 0x00000000,   0, { 0x3073, 0x3085 } },
+    { 0x00000000,   0, { 0x3061, 0x3083 } },
+    { 0x00000000,   0, { 0x3061, 0x3047 } },
+    { 0x00000000,   0, { 0x3061, 0x0000 } },
+    { 0x00000000,   0, { 0x3061, 0x3087 } },
+    { 0x00000000,   0, { 0x3061, 0x3085 } },
+    { 0x00000000,   0, { 0x3061, 0x3083 } },
+    { 0x00000000,   0, { 0x3061, 0x3087 } },
+    { 0x00000000,   0, { 0x3061, 0x3085 } },
+    { 0x00000000,   0, { 0x3067, 0x3043 } },
+    { 0x00000000,   0, { 0x3069, 0x3045 } },
+    { 0x00000000,   0, { 0x3062, 0x3083 } },
+    { 0x00000000,   0, { 0x3062, 0x3087 } },
+    { 0x00000000,   0, { 0x3062, 0x3085 } },
+    { 0x00000000,   0, { 0x304E, 0x3083 } },
+    { 0x00000000,   0, { 0x304E, 0x3087 } },
+    { 0x00000000,   0, { 0x304E, 0x3085 } },
+    { 0x00000000,   0, { 0x3072, 0x3083 } },
+    { 0x00000000,   0, { 0x3072, 0x3087 } },
+    { 0x00000000,   0, { 0x3072, 0x3085 } },
+    { 0x00000000,   0, { 0x3058, 0x3083 } },
+    { 0x00000000,   0, { 0x3058, 0x3087 } },
+    { 0x00000000,   0, { 0x3058, 0x3085 } },
+    { 0x00000000,   0, { 0x304D, 0x3083 } },
+    { 0x00000000,   0, { 0x304D, 0x3087 } },
+    { 0x00000000,   0, { 0x304D, 0x3085 } },
+    { 0x00100000, 226, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3063, 0x0000 } },
+    { 0x00000000,   0, { 0x308E, 0x0000 } },
+    { 0x00000000,   0, { 0x3083, 0x0000 } },
+    { 0x00000000,   0, { 0x3087, 0x0000 } },
+    { 0x00000000,   0, { 0x3085, 0x0000 } },
+    { 0x00000000,   0, { 0x307F, 0x3083 } },
+    { 0x00000000,   0, { 0x307F, 0x3087 } },
+    { 0x00000000,   0, { 0x307F, 0x3085 } },
+    { 0x00000000,   0, { 0x306B, 0x3083 } },
+    { 0x00000000,   0, { 0x306B, 0x3087 } },
+    { 0x00000000,   0, { 0x306B, 0x3085 } },
+    { 0x00000000,   0, { 0x3074, 0x3083 } },
+    { 0x00000000,   0, { 0x3074, 0x3087 } },
+    { 0x00000000,   0, { 0x3074, 0x3085 } },
+    { 0x00000000,   0, { 0x308A, 0x3083 } },
+    { 0x00000000,   0, { 0x308A, 0x3087 } },
+    { 0x00000000,   0, { 0x308A, 0x3085 } },
+    { 0x00000000,   0, { 0x3057, 0x3083 } },
+    { 0x00000000,   0, { 0x3057, 0x3047 } },
+    { 0x00000000,   0, { 0x3057, 0x0000 } },
+    { 0x00000000,   0, { 0x3057, 0x3087 } },
+    { 0x00000000,   0, { 0x3057, 0x3085 } },
+    { 0x00000000,   0, { 0x3057, 0x3083 } },
+    { 0x00000000,   0, { 0x3057, 0x3087 } },
+    { 0x00000000,   0, { 0x3057, 0x3085 } },
+    { 0x00000000,   0, { 0x3066, 0x3043 } },
+    { 0x00000000,   0, { 0x3064, 0x0000 } },
+    { 0x00000000,   0, { 0x3068, 0x3045 } },
+    { 0x00000000,   0, { 0x3061, 0x3083 } },
+    { 0x00000000,   0, { 0x3061, 0x3087 } },
+    { 0x00000000,   0, { 0x3061, 0x3085 } },
+    { 0x00100000, 227, { 0x0000, 0x0000 } },
+    { 0x00000000,   0, { 0x3063, 0x0000 } },
+    { 0x00000000,   0, { 0x308E, 0x0000 } },
+    { 0x00000000,   0, { 0x3083, 0x0000 } },
+    { 0x00000000,   0, { 0x3087, 0x0000 } },
+    { 0x00000000,   0, { 0x3085, 0x0000 } },
+    { 0x00000000,   0, { 0x3058, 0x3083 } },
+    { 0x00000000,   0, { 0x3058, 0x3087 } },
+    { 0x00000000,   0, { 0x3058, 0x3085 } },
+    { 0x00000000,   0, { 0x3063, 0x0000 } },
+    { 0x00000000,   0, { 0x3063, 0x0000 } },
+};
@@ -0,0 +1,103 @@
+/**
+ * @file tg_layout.c
+ * @brief Layout file parsing and usage logging (see tg_layout.h)
+ *
+ * No I/O: ime_hook.c reads and maps the files. Also built into
+ * tools/layoutopt, which reads the same formats on the host.
+ */
+
+#include <string.h>
+
+#include "plugin_common.h"
+#include "tg_layout.h"
+
+/* ─── Layout text ─────────────────────────────────────────────────── */
+
+int32_t tg_layout_parse(const char *text, size_t len, char slots[TG_LAYOUT_SLOTS]) {
+    if (!text || !slots) return IME_ERROR_INVALID_PARAM;
+
+    uint32_t row = 0, line_no = 0;
+    size_t i = 0;
+    while (i < len) {
+        size_t end = i;
+        while (end < len && text[end] != '\n') end++;
+        line_no++;
+
+        /* Trim a comment, trailing CR and blanks */
+        size_t n = end - i;
+        for (size_t k = 0; k < n; k++) {
+            if (text[i + k] == '#') {
+                n = k;
+                break;
+            }
+        }
+        while (n > 0 && (text[i + n - 1] == '\r' || text[i + n - 1] == ' ' ||
+                         text[i + n - 1] == '\t'))
+            n--;
+
+        if (n > 0) {
+            if (n != TG_BUTTONS || row == TG_CELLS - 1) {
+                LOG_WARN("layout: line %u: want %d characters per row, %d rows",
+                         line_no, TG_BUTTONS, TG_CELLS - 1);
+                return IME_ERROR_INVALID_PARAM;
+            }
+            for (size_t k = 0; k < n; k++) {
+                char c = text[i + k];
+                if (c <= ' ' || c > '~') {
+                    LOG_WARN("layout: line %u: unprintable character", line_no);
+                    return IME_ERROR_INVALID_PARAM;
+                }
+                slots[row * TG_BUTTONS + k] = c;
+            }
+            row++;
+        }
+        i = end + 1;
+    }
+
+    if (row != TG_CELLS - 1) {
+        LOG_WARN("layout: %u rows, want %d", row, TG_CELLS - 1);
+        return IME_ERROR_INVALID_PARAM;
+    }
+    return IME_OK;
+}
+
+/* ─── Usage store ─────────────────────────────────────────────────── */
+
+int32_t tg_usage_attach(TgUsageStore *u) {
+    if (!u) return IME_ERROR_INVALID_PARAM;
+    if (u->hdr.magic == TG_USAGE_MAGIC && u->hdr.version == TG_USAGE_VERSION &&
+        u->hdr.classes == TG_USAGE_CLASSES)
+        return IME_OK;
+
+    LOG_INFO("usage: new store (magic 0x%08X version %u)", u->hdr.magic, u->hdr.version);
+    memset(u, 0, sizeof(*u));
+    u->hdr.magic   = TG_USAGE_MAGIC;
+    u->hdr.version = TG_USAGE_VERSION;
+    u->hdr.classes = TG_USAGE_CLASSES;
+    return IME_OK;
+}
+
+void tg_usage_press(TgUsageStore *u, TgUsageCursor *cur, int32_t cell,
+                    uint16_t ch, uint64_t now_us) {
+    if (!u || !cur) return;
+    int32_t cls = tg_usage_class(ch);
+    if (cls < 0 || cell < 0 || cell >= TG_CELLS) {
+        cur->valid = false;
+        return;
+    }
+
+    if (cur->valid) {
+        u->pairs[cur->cls][cls]++;
+        uint64_t gap = now_us - cur->at_us;
+        if (gap < TG_USAGE_GAP_MAX_US) {
+            u->moves[cur->cell][cell]++;
+            u->move_us[cur->cell][cell] += gap;
+        }
+    }
+    u->hdr.presses++;
+
+    cur->valid = true;
+    cur->cls   = (uint8_t)cls;
+    cur->cell  = cell;
+    cur->at_us = now_us;
+}
@@ -0,0 +1,267 @@
+/**
+ * @file tg_learn.c
+ * @brief Per-user learned word frequencies (see tg_learn.h)
+ *
+ * Works in place on the mapped store; no I/O or allocation. Commits and
+ * queries both run on the IME poll thread.
+ */
+
+#include <string.h>
+
+#include "plugin_common.h"
+#include "tg_learn.h"
+
+/* ─── Hashing ─────────────────────────────────────────────────────── */
+
+#define FNV_OFFSET  1469598103934665603ull
+#define FNV_PRIME   1099511628211ull
+
+static uint64_t fnv_extend(uint64_t h, const char *s, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++)
+        h = (h ^ (uint8_t)s[i]) * FNV_PRIME;
+    return h;
+}
+
+/* A bigram key is "prev word"; words never contain a space */
+static uint64_t bigram_seed(const char *prev, uint32_t prev_len) {
+    return fnv_extend(fnv_extend(FNV_OFFSET, prev, prev_len), " ", 1);
+}
+
+/* Row i uses h1 + i*h2 (double hashing) */
+static uint32_t sketch_slot(uint64_t h, uint32_t row) {
+    uint32_t h1 = (uint32_t)h;
+    uint32_t h2 = (uint32_t)(h >> 32) | 1;
+    return (h1 + row * h2) & (TG_LEARN_WIDTH - 1);
+}
+
+/* ─── Sketch ──────────────────────────────────────────────────────── */
+
+static uint16_t sketch_get(const TgLearnStore *l, uint64_t h) {
+    uint16_t m = UINT16_MAX;
+    for (uint32_t r = 0; r < TG_LEARN_DEPTH; r++) {
+        uint16_t c = l->counts[r][sketch_slot(h, r)];
+        if (c < m) m = c;
+    }
+    return m;
+}
+
+/* Conservative update: only the counters at the minimum move */
+static void sketch_add(TgLearnStore *l, uint64_t h) {
+    uint16_t m = sketch_get(l, h);
+    if (m == UINT16_MAX) return;
+    for (uint32_t r = 0; r < TG_LEARN_DEPTH; r++) {
+        uint16_t *c = &l->counts[r][sketch_slot(h, r)];
+        if (*c == m) (*c)++;
+    }
+}
+
+/* Halve every count; spellings whose count reaches zero are forgotten */
+static void decay(TgLearnStore *l) {
+    for (uint32_t r = 0; r < TG_LEARN_DEPTH; r++)
+        for (uint32_t i = 0; i < TG_LEARN_WIDTH; i++)
+            l->counts[r][i] >>= 1;
+
+    uint32_t forgotten = 0;
+    for (uint32_t i = 0; i < TG_LEARN_WORDS; i++) {
+        TgLearnWord *w = &l->words[i];
+        if (w->text[0] && sketch_get(l, fnv_extend(FNV_OFFSET, w->text,
+                                                   (uint32_t)strlen(w->text))) == 0) {
+            memset(w, 0, sizeof(*w));
+            forgotten++;
+        }
+    }
+    LOG_DEBUG("learn: decayed, %u words forgotten", forgotten);
+}
+
+/* ─── Word table ──────────────────────────────────────────────────── */
+
+/* Remember a spelling; a full table drops its least-used word */
+static void remember(TgLearnStore *l, const char *word, uint32_t len, uint64_t h) {
+    uint32_t victim = 0;
+    uint16_t victim_count = UINT16_MAX;
+    for (uint32_t i = 0; i < TG_LEARN_WORDS; i++) {
+        TgLearnWord *w = &l->words[i];
+        if (!w->text[0]) {
+            if (victim_count) {
+                victim = i;
+                victim_count = 0;
+            }
+            continue;
+        }
+        if (w->hash == (uint32_t)h && strncmp(w->text, word, len) == 0 &&
+            w->text[len] == '\0')
+            return;
+        if (victim_count) {
+            uint16_t c = sketch_get(l, fnv_extend(FNV_OFFSET, w->text,
+                                                  (uint32_t)strlen(w->text)));
+            if (c < victim_count) {
+                victim = i;
+                victim_count = c;
+            }
+        }
+    }
+
+    TgLearnWord *w = &l->words[victim];
+    memset(w, 0, sizeof(*w));
+    memcpy(w->text, word, len);
+    w->hash = (uint32_t)h;
+}
+
+/* ─── Attach ──────────────────────────────────────────────────────── */
+
+int32_t tg_learn_attach(TgLearnStore *l) {
+    if (!l) return IME_ERROR_INVALID_PARAM;
+
+    const TgLearnHeader *h = &l->hdr;
+    if (h->magic == TG_LEARN_MAGIC && h->version == TG_LEARN_VERSION &&
+        h->depth == TG_LEARN_DEPTH && h->width == TG_LEARN_WIDTH &&
+        h->word_slots == TG_LEARN_WORDS) {
+        /* Words are used as C strings; never trust the terminator */
+        for (uint32_t i = 0; i < TG_LEARN_WORDS; i++)
+            l->words[i].text[TG_DICT_WORD_MAX - 1] = '\0';
+        return IME_OK;
+    }
+
+    LOG_INFO("learn: new store (magic 0x%08X version %u)", h->magic, h->version);
+    memset(l, 0, sizeof(*l));
+    l->hdr.magic      = TG_LEARN_MAGIC;
+    l->hdr.version    = TG_LEARN_VERSION;
+    l->hdr.depth      = TG_LEARN_DEPTH;
+    l->hdr.width      = TG_LEARN_WIDTH;
+    l->hdr.word_slots = TG_LEARN_WORDS;
+    return IME_OK;
+}
+
+/* ─── Commit ──────────────────────────────────────────────────────── */
+
+static bool is_word_char(uint16_t c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '\'';
+}
+
+void tg_learn_commit(TgLearnStore *l, const GapBuffer *text) {
+    if (!l || !text) return;
+
+    char prev[TG_DICT_WORD_MAX], word[TG_DICT_WORD_MAX];
+    uint32_t prev_len = 0, learned = 0;
+    uint32_t i = 0, len = gap_buffer_length(text);
+    while (i < len) {
+        if (!is_word_char(gap_buffer_at(text, i))) {
+            /* Pairs are learned across spaces only, not punctuation */
+            if (gap_buffer_at(text, i) != ' ') prev_len = 0;
+            i++;
+            continue;
+        }
+
+        uint32_t n = 0;
+        bool fits = true;
+        for (; i < len && is_word_char(gap_buffer_at(text, i)); i++) {
+            if (n < TG_DICT_WORD_MAX - 1) {
+                uint16_t c = gap_buffer_at(text, i);
+                word[n++] = (char)(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+            } else {
+                fits = false;
+            }
+        }
+        if (!fits) {
+            prev_len = 0;
+            continue;
+        }
+
+        uint64_t h = fnv_extend(FNV_OFFSET, word, n);
+        sketch_add(l, h);
+        if (n >= 2) remember(l, word, n, h);
+        if (prev_len) sketch_add(l, fnv_extend(bigram_seed(prev, prev_len), word, n));
+
+        memcpy(prev, word, n);
+        prev_len = n;
+        learned++;
+    }
+
+    if (++l->hdr.submits >= TG_LEARN_DECAY_SUBMITS) {
+        l->hdr.submits = 0;
+        decay(l);
+    }
+    LOG_DEBUG("learn: %u words from a %u-char submit", learned, len);
+}
+
+/* ─── Query ───────────────────────────────────────────────────────── */
+
+static uint32_t bit_length(uint32_t v) {
+    uint32_t n = 0;
+    while (v) {
+        n++;
+        v >>= 1;
+    }
+    return n;
+}
+
+/* Used at all, then pair count, then use count, then dictionary rank */
+static uint32_t score_word(const TgLearnStore *l, const TgDict *dict,
+                           uint64_t prev_seed, bool have_prev,
+                           const char *word, uint32_t len) {
+    uint32_t uni = sketch_get(l, fnv_extend(FNV_OFFSET, word, len));
+    uint32_t bi  = have_prev ? sketch_get(l, fnv_extend(prev_seed, word, len)) : 0;
+    return (uni ? 1u << 24 : 0) | bit_length(bi) << 16 | bit_length(uni) << 8 |
+           tg_dict_freq(dict, word, len);
+}
+
+typedef struct LearnCand {
+    uint32_t score;
+    char     text[TG_DICT_WORD_MAX];
+} LearnCand;
+
+/* Keep the best @p max candidates, sorted; earlier entries win ties */
+static void cand_offer(LearnCand *best, uint32_t *n, uint32_t max,
+                       uint32_t score, const char *text) {
+    if (*n == max && best[max - 1].score >= score) return;
+    uint32_t i = (*n < max) ? (*n)++ : max - 1;
+    while (i > 0 && best[i - 1].score < score) {
+        best[i] = best[i - 1];
+        i--;
+    }
+    best[i].score = score;
+    strncpy(best[i].text, text, TG_DICT_WORD_MAX - 1);
+    best[i].text[TG_DICT_WORD_MAX - 1] = '\0';
+}
+
+uint32_t tg_learn_complete(const TgLearnStore *l, const TgDict *dict,
+                           const char *prev, uint32_t prev_len,
+                           const char *prefix, uint32_t len,
+                           char out[][TG_DICT_WORD_MAX], uint32_t max) {
+    if (!l) return tg_dict_complete(dict, prefix, len, out, max);
+    if (!prefix || max == 0 || len >= TG_DICT_WORD_MAX - 1) return 0;
+    if (max > TG_LEARN_POOL) max = TG_LEARN_POOL;
+
+    bool have_prev = prev && prev_len > 0;
+    uint64_t prev_seed = have_prev ? bigram_seed(prev, prev_len) : 0;
+
+    LearnCand best[TG_LEARN_POOL];
+    uint32_t n_best = 0;
+
+    char pool[TG_LEARN_POOL][TG_DICT_WORD_MAX];
+    uint32_t n_pool = tg_dict_complete(dict, prefix, len, pool, TG_LEARN_POOL);
+    for (uint32_t i = 0; i < n_pool; i++) {
+        cand_offer(best, &n_best, max,
+                   score_word(l, dict, prev_seed, have_prev, pool[i],
+                              (uint32_t)strlen(pool[i])),
+                   pool[i]);
+    }
+
+    for (uint32_t i = 0; i < TG_LEARN_WORDS; i++) {
+        const char *w = l->words[i].text;
+        if (!w[0] || strncmp(w, prefix, len) != 0 || w[len] == '\0') continue;
+
+        bool pooled = false;
+        for (uint32_t k = 0; k < n_pool && !pooled; k++)
+            pooled = strcmp(pool[k], w) == 0;
+        if (pooled) continue;
+
+        cand_offer(best, &n_best, max,
+                   score_word(l, dict, prev_seed, have_prev, w, (uint32_t)strlen(w)),
+                   w);
+    }
+
+    for (uint32_t i = 0; i < n_best; i++)
+        memcpy(out[i], best[i].text, TG_DICT_WORD_MAX);
+    return n_best;
+}
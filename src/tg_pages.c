@@ -0,0 +1,64 @@
+/**
+ * @file tg_pages.c
+ * @brief Page-file validation (see tg_pages.h)
+ *
+ * Runs once per mapped file, at session start; nothing here is on the
+ * input path.
+ */
+
+#include <string.h>
+
+#include "plugin_common.h"
+#include "tg_pages.h"
+
+static bool key_valid(const TgKey *k) {
+    if (k->label[TG_KEY_LABEL_MAX - 1] != '\0') return false;
+    if (k->op == TG_OP_TEXT) return k->len <= TG_KEY_UNITS;
+    return tg_op_is_action(k->op) && k->len == 0;
+}
+
+int32_t tg_pages_attach(TgPageSet *s, const void *data, size_t size) {
+    if (!s || !data || size < sizeof(TgPagesHeader)) return IME_ERROR_INVALID_PARAM;
+    memset(s, 0, sizeof(*s));
+
+    const TgPagesHeader *h = (const TgPagesHeader *)data;
+    if (h->magic != TG_PAGES_MAGIC || h->version != TG_PAGES_VERSION ||
+        h->page_size != sizeof(ThumbGridPage)) {
+        LOG_WARN("pages: bad header (magic 0x%08X version %u)", h->magic, h->version);
+        return IME_ERROR_INVALID_PARAM;
+    }
+    if (h->page_count == 0 || h->page_count > TG_MAX_PAGES ||
+        (uint64_t)h->page_count * sizeof(ThumbGridPage) > size - sizeof(TgPagesHeader)) {
+        LOG_WARN("pages: bad page count %u (%u bytes)", h->page_count, (uint32_t)size);
+        return IME_ERROR_INVALID_PARAM;
+    }
+
+    const ThumbGridPage *pages = (const ThumbGridPage *)(h + 1);
+    uint32_t sum = tg_pages_checksum(pages, h->page_count * sizeof(ThumbGridPage));
+    if (sum != h->checksum) {
+        LOG_WARN("pages: checksum 0x%08X, expected 0x%08X", sum, h->checksum);
+        return IME_ERROR_INVALID_PARAM;
+    }
+
+    for (uint32_t p = 0; p < h->page_count; p++) {
+        const ThumbGridPage *pg = &pages[p];
+        if (pg->name[TG_PAGE_NAME_MAX - 1] != '\0' ||
+            pg->shift >= h->page_count || pg->next >= h->page_count ||
+            pg->compose >= TG_COMPOSER_MODE_COUNT) {
+            LOG_WARN("pages: page %u name, links or composer invalid", p);
+            return IME_ERROR_INVALID_PARAM;
+        }
+        for (uint32_t c = 0; c < TG_CELLS; c++) {
+            for (uint32_t b = 0; b < TG_BUTTONS; b++) {
+                if (!key_valid(&pg->keys[c][b])) {
+                    LOG_WARN("pages: page %u cell %u button %u invalid", p, c, b);
+                    return IME_ERROR_INVALID_PARAM;
+                }
+            }
+        }
+    }
+
+    s->pages = pages;
+    s->count = h->page_count;
+    return IME_OK;
+}
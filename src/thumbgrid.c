@@ -13,8 +13,10 @@
 #include "thumbgrid.h"
 #include "ime_custom.h"
 #include "overlay.h"
+#include "profile.h"
+#include "tg_composer.h"
+#include "tg_layout.h"
 
-#include <orbis/libkernel.h>
 
 /* ─── Character Pages ────────────────────────────────────────────── */
 
@@ -30,155 +32,198 @@
  *   triangle=Space, circle=Exit IME, cross=select all, square=Backspace
  */
 
-#define SPC TG_SPECIAL_SPACE
-#define BKS TG_SPECIAL_BKSP
-#define ACC TG_SPECIAL_ACCENT
-#define SEL TG_SPECIAL_SELALL
-#define EXT TG_SPECIAL_EXIT
+#define K(c)   { .text = { (c) }, .len = 1 }
+#define OP(o)  { .op = (o) }
+#define SPC OP(TG_OP_SPACE)
+#define BKS OP(TG_OP_BKSP)
+#define SEL OP(TG_OP_SELALL)
+#define EXT OP(TG_OP_EXIT)
 
-static const ThumbGridPage g_thumbgrid_pages[TG_MAX_PAGES] = {
+#define ROW(a, b, c, d) { K(a), K(b), K(c), K(d) }
+#define CENTER          { SPC, EXT, SEL, BKS }
+
+static const ThumbGridPage g_builtin_pages[3] = {
     /* Page 0: lowercase */
     {
-        .name = "abc",
-        .chars = {
-            /* Cell 0 (UL) */ {'a', 'b', 'c', 'd'},
-            /* Cell 1 (UC) */ {'e', 'f', 'g', 'h'},
-            /* Cell 2 (UR) */ {'i', 'j', 'k', 'l'},
-            /* Cell 3 (ML) */ {'m', 'n', 'o', 'p'},
-            /* Cell 4 (MC) */ {SPC, EXT, SEL, BKS},
-            /* Cell 5 (MR) */ {'q', 'r', 's', 't'},
-            /* Cell 6 (BL) */ {'u', 'v', 'w', 'x'},
-            /* Cell 7 (BC) */ {'y', 'z', '.', ','},
-            /* Cell 8 (BR) */ {'!', '?', '\'','-'},
+        .name = "abc", .shift = 1, .next = 2,
+        .keys = {
+            /* Cell 0 (UL) */ ROW('a', 'b', 'c', 'd'),
+            /* Cell 1 (UC) */ ROW('e', 'f', 'g', 'h'),
+            /* Cell 2 (UR) */ ROW('i', 'j', 'k', 'l'),
+            /* Cell 3 (ML) */ ROW('m', 'n', 'o', 'p'),
+            /* Cell 4 (MC) */ CENTER,
+            /* Cell 5 (MR) */ ROW('q', 'r', 's', 't'),
+            /* Cell 6 (BL) */ ROW('u', 'v', 'w', 'x'),
+            /* Cell 7 (BC) */ ROW('y', 'z', '.', ','),
+            /* Cell 8 (BR) */ ROW('!', '?', '\'','-'),
         },
     },
     /* Page 1: UPPERCASE */
     {
-        .name = "ABC",
-        .chars = {
-            /* Cell 0 (UL) */ {'A', 'B', 'C', 'D'},
-            /* Cell 1 (UC) */ {'E', 'F', 'G', 'H'},
-            /* Cell 2 (UR) */ {'I', 'J', 'K', 'L'},
-            /* Cell 3 (ML) */ {'M', 'N', 'O', 'P'},
-            /* Cell 4 (MC) */ {SPC, EXT, SEL, BKS},
-            /* Cell 5 (MR) */ {'Q', 'R', 'S', 'T'},
-            /* Cell 6 (BL) */ {'U', 'V', 'W', 'X'},
-            /* Cell 7 (BC) */ {'Y', 'Z', '.', ','},
-            /* Cell 8 (BR) */ {'!', '?', '\'','-'},
+        .name = "ABC", .shift = 0, .next = 2,
+        .keys = {
+            /* Cell 0 (UL) */ ROW('A', 'B', 'C', 'D'),
+            /* Cell 1 (UC) */ ROW('E', 'F', 'G', 'H'),
+            /* Cell 2 (UR) */ ROW('I', 'J', 'K', 'L'),
+            /* Cell 3 (ML) */ ROW('M', 'N', 'O', 'P'),
+            /* Cell 4 (MC) */ CENTER,
+            /* Cell 5 (MR) */ ROW('Q', 'R', 'S', 'T'),
+            /* Cell 6 (BL) */ ROW('U', 'V', 'W', 'X'),
+            /* Cell 7 (BC) */ ROW('Y', 'Z', '.', ','),
+            /* Cell 8 (BR) */ ROW('!', '?', '\'','-'),
         },
     },
-    /* Page 2: Numbers/Symbols */
+    /* Page 2: Numbers/Symbols; L2 stays here */
     {
-        .name = "123",
-        .chars = {
-            /* Cell 0 (UL) */ {'1', '2', '3', '+'},
-            /* Cell 1 (UC) */ {'4', '5', '6', '='},
-            /* Cell 2 (UR) */ {'7', '8', '9', '0'},
-            /* Cell 3 (ML) */ {'@', '#', '$', '%'},
-            /* Cell 4 (MC) */ {SPC, EXT, SEL, BKS},
-            /* Cell 5 (MR) */ {'&', '*', '(', ')'},
-            /* Cell 6 (BL) */ {'_', '/', '\\','|'},
-            /* Cell 7 (BC) */ {'[', ']', '{', '}'},
-            /* Cell 8 (BR) */ {'<', '>', '"', '~'},
+        .name = "123", .shift = 2, .next = 0,
+        .keys = {
+            /* Cell 0 (UL) */ ROW('1', '2', '3', '+'),
+            /* Cell 1 (UC) */ ROW('4', '5', '6', '='),
+            /* Cell 2 (UR) */ ROW('7', '8', '9', '0'),
+            /* Cell 3 (ML) */ ROW('@', '#', '$', '%'),
+            /* Cell 4 (MC) */ CENTER,
+            /* Cell 5 (MR) */ ROW('&', '*', '(', ')'),
+            /* Cell 6 (BL) */ ROW('_', '/', '\\','|'),
+            /* Cell 7 (BC) */ ROW('[', ']', '{', '}'),
+            /* Cell 8 (BR) */ ROW('<', '>', '"', '~'),
         },
     },
 };
 
+#undef K
+#undef OP
 #undef SPC
 #undef BKS
-#undef ACC
 #undef SEL
 #undef EXT
+#undef ROW
+#undef CENTER
+
+/* The set sessions start with: the built-in pages or a mapped page file */
+static const ThumbGridPage *g_base_pages = g_builtin_pages;
+static uint32_t             g_base_count = 3;
+
+/* The base set with a loaded letter layout (tg_layout.h), used when set */
+static ThumbGridPage g_layout_pages[TG_MAX_PAGES];
+static bool          g_layout_loaded = false;
 
 /* ─── Core Functions ─────────────────────────────────────────────── */
 
+/* A key that types one printable ASCII character: that character, else 0 */
+static char key_ascii(const TgKey *k) {
+    if (k->op != TG_OP_TEXT || k->len != 1) return 0;
+    return (k->text[0] >= 0x20 && k->text[0] < 0x7F) ? (char)k->text[0] : 0;
+}
+
+/*
+ * Start sessions from @p set (validated by tg_pages_attach), or from the
+ * built-in pages when NULL. Drops any letter layout; apply it again.
+ */
+void thumbgrid_set_pages(const TgPageSet *set) {
+    g_base_pages    = set ? set->pages : g_builtin_pages;
+    g_base_count    = set ? set->count : 3;
+    g_layout_loaded = false;
+}
+
+/*
+ * Rearrange the letter pages (page 0 and its shift page) for sessions
+ * started from now on. @p slots (TG_LAYOUT_SLOTS chars) must hold
+ * exactly the characters of page 0's outer cells, which must all be
+ * single ASCII characters; NULL restores the base layout.
+ */
+int32_t thumbgrid_apply_layout(const char *slots) {
+    if (!slots) {
+        g_layout_loaded = false;
+        return IME_OK;
+    }
+
+    uint8_t left[128] = {0};
+    for (uint32_t i = 0; i < TG_LAYOUT_SLOTS; i++) {
+        const TgKey *k = &g_base_pages[0].keys[tg_layout_slot_cell(i)][tg_layout_slot_button(i)];
+        char c = key_ascii(k);
+        if (c == 0) {
+            LOG_WARN("layout: page 0 has keys other than ASCII characters");
+            return IME_ERROR_INVALID_PARAM;
+        }
+        left[(uint8_t)c]++;
+    }
+    for (uint32_t i = 0; i < TG_LAYOUT_SLOTS; i++) {
+        uint8_t c = (uint8_t)slots[i];
+        if (c >= 128 || left[c] == 0) {
+            LOG_WARN("layout: '%c' is not on page 0 or appears twice", slots[i]);
+            return IME_ERROR_INVALID_PARAM;
+        }
+        left[c]--;
+    }
+
+    uint32_t shift = g_base_pages[0].shift;
+    memcpy(g_layout_pages, g_base_pages, g_base_count * sizeof(ThumbGridPage));
+    for (uint32_t i = 0; i < TG_LAYOUT_SLOTS; i++) {
+        int32_t cell = tg_layout_slot_cell(i);
+        int32_t btn  = tg_layout_slot_button(i);
+        char c = slots[i];
+        TgKey *lower = &g_layout_pages[0].keys[cell][btn];
+        memset(lower, 0, sizeof(*lower));
+        lower->text[0] = (uint8_t)c;
+        lower->len     = 1;
+        if (shift != 0) {
+            g_layout_pages[shift].keys[cell][btn] = *lower;
+            if (c >= 'a' && c <= 'z')
+                g_layout_pages[shift].keys[cell][btn].text[0] = (uint16_t)(c - ('a' - 'A'));
+        }
+    }
+    g_layout_loaded = true;
+    return IME_OK;
+}
+
 void thumbgrid_init(ThumbGridState *state) {
     if (!state) return;
     state->selected_cell = TG_CENTER_CELL;
     state->current_page  = 0;
-    state->page_count    = TG_MAX_PAGES;
-    state->pages         = g_thumbgrid_pages;
+    state->page_count    = (int32_t)g_base_count;
+    state->pages         = g_layout_loaded ? g_layout_pages : g_base_pages;
     state->offset_x      = 0;
     state->offset_y      = 0;
-    state->accent_mode   = false;
+    state->accent_layer  = TG_DIA_NONE;
     state->title[0]      = '\0';
 }
 
-void thumbgrid_select_cell(ThumbGridState *state, uint8_t stick_x, uint8_t stick_y) {
-    if (!state) return;
-
-    int col, row;
-
-    if (stick_x < 78)       col = 0;
-    else if (stick_x > 178) col = 2;
-    else                    col = 1;
-
-    if (stick_y < 78)       row = 0;
-    else if (stick_y > 178) row = 2;
-    else                    row = 1;
-
-    state->selected_cell = row * 3 + col;
-}
-
-char thumbgrid_get_char(const ThumbGridState *state, int button_index) {
-    if (!state || !state->pages) return 0;
-    if (button_index < 0 || button_index >= TG_BUTTONS) return 0;
-    if (state->selected_cell < 0 || state->selected_cell >= TG_CELLS) return 0;
-    if (state->current_page < 0 || state->current_page >= state->page_count) return 0;
+/* Key of the selected cell for a face button, NULL if out of range */
+const TgKey *thumbgrid_get_key(const ThumbGridState *state, int button_index) {
+    if (!state || !state->pages) return NULL;
+    if (button_index < 0 || button_index >= TG_BUTTONS) return NULL;
+    if (state->selected_cell < 0 || state->selected_cell >= TG_CELLS) return NULL;
+    if (state->current_page < 0 || state->current_page >= state->page_count) return NULL;
 
-    return state->pages[state->current_page]
-               .chars[state->selected_cell][button_index];
-}
-
-bool thumbgrid_is_special(const ThumbGridState *state, int button_index) {
-    char c = thumbgrid_get_char(state, button_index);
-    return (c == TG_SPECIAL_SPACE  || c == TG_SPECIAL_BKSP   ||
-            c == TG_SPECIAL_ACCENT || c == TG_SPECIAL_SELALL ||
-            c == TG_SPECIAL_EXIT   || c == TG_SPECIAL_CUT    ||
-            c == TG_SPECIAL_COPY   || c == TG_SPECIAL_PASTE  ||
-            c == TG_SPECIAL_CAPS);
+    return &state->pages[state->current_page].keys[state->selected_cell][button_index];
 }
 
+/* Switch to the current page's shift page (a page may shift to itself) */
 void thumbgrid_shift_toggle(ThumbGridState *state) {
-    if (!state) return;
-    if (state->current_page == 0)
-        state->current_page = 1;
-    else if (state->current_page == 1)
-        state->current_page = 0;
-    /* page 2 stays on page 2 — use L1/R1 to leave it */
+    if (!state || !state->pages) return;
+    state->current_page = state->pages[state->current_page].shift;
 }
 
+/* Switch to the current page's L1/R1 page: letters <-> symbols by default */
 void thumbgrid_toggle_symbols(ThumbGridState *state) {
-    if (!state) return;
-    /* Toggle between letter pages (0/1) and symbols page (2) */
-    if (state->current_page == 2)
-        state->current_page = 0;
-    else
-        state->current_page = 2;
+    if (!state || !state->pages) return;
+    state->current_page = state->pages[state->current_page].next;
 }
 
-void thumbgrid_toggle_accent(ThumbGridState *state) {
+/* Step to the next diacritic layer; after the last, accents are off */
+void thumbgrid_cycle_accent(ThumbGridState *state) {
     if (!state) return;
-    state->accent_mode = !state->accent_mode;
+    state->accent_layer = tg_dia_next(state->accent_layer);
 }
 
-/* Accent lookup: base char → accented UTF-16 code point, 0 if none */
-uint16_t thumbgrid_accent_lookup(char base) {
-    switch (base) {
-    case 'a': return 0x00E1; /* á */
-    case 'e': return 0x00E9; /* é */
-    case 'i': return 0x00ED; /* í */
-    case 'o': return 0x00F3; /* ó */
-    case 'u': return 0x00FA; /* ú */
-    case 'n': return 0x00F1; /* ñ */
-    case 'A': return 0x00C1; /* Á */
-    case 'E': return 0x00C9; /* É */
-    case 'I': return 0x00CD; /* Í */
-    case 'O': return 0x00D3; /* Ó */
-    case 'U': return 0x00DA; /* Ú */
-    case 'N': return 0x00D1; /* Ñ */
-    default:  return 0;
-    }
+/*
+ * What @p key types on the current accent layer, 0 if it types its own
+ * text. Only unlabelled single-letter keys compose.
+ */
+uint16_t thumbgrid_compose(const ThumbGridState *state, const TgKey *key) {
+    if (!state || !key || state->accent_layer == TG_DIA_NONE) return 0;
+    if (key->op != TG_OP_TEXT || key->len != 1 || key->label[0]) return 0;
+    return tg_compose(key->text[0], state->accent_layer);
 }
 
 /* ─── Layout Constants ───────────────────────────────────────────── */
@@ -259,79 +304,74 @@ static void draw_cell_border(uint32_t *fb, uint32_t pitch,
     overlay_draw_rect(fb, pitch, x + w - 2, y, 2, h, color);
 }
 
-/* Helper: get display string for a special function char */
-static const char *special_label(char c) {
-    switch (c) {
-    case TG_SPECIAL_BKSP:   return "Del";
-    case TG_SPECIAL_SPACE:  return "Space";
-    case TG_SPECIAL_ACCENT: return "AC";
-    case TG_SPECIAL_SELALL: return "Select";
-    case TG_SPECIAL_EXIT:   return "Exit";
-    case TG_SPECIAL_CUT:    return "Cut";
-    case TG_SPECIAL_COPY:   return "Copy";
-    case TG_SPECIAL_PASTE:  return "Paste";
-    case TG_SPECIAL_CAPS:   return "CAPS";
-    default:                 return "?";
-    }
-}
-
-/* Helper: check if a character has an accent variant */
-static bool is_accentable(char c) {
-    return c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u' || c == 'n' ||
-           c == 'A' || c == 'E' || c == 'I' || c == 'O' || c == 'U' || c == 'N';
-}
+/*
+ * Diacritic marks for the 2x font: up to three 1px rows of eight 2px
+ * columns (bit 7 leftmost), drawn dy pixels from the top of the 16x16
+ * glyph: above it, through it (stroke) or below it (cedilla, ogonek).
+ * The OTHER layer's letters have no mark and show their base letter.
+ */
+static const struct {
+    int8_t  dy;
+    uint8_t rows[3];
+} k_marks_2x[TG_DIA_COUNT] = {
+    [TG_DIA_ACUTE]        = { -3, { 0x02, 0x04, 0x08 } },
+    [TG_DIA_GRAVE]        = { -3, { 0x20, 0x10, 0x08 } },
+    [TG_DIA_CIRCUMFLEX]   = { -3, { 0x18, 0x24, 0x42 } },
+    [TG_DIA_DIAERESIS]    = { -3, { 0x00, 0x66, 0x66 } },
+    [TG_DIA_TILDE]        = { -3, { 0x00, 0x32, 0x4C } },
+    [TG_DIA_CEDILLA]      = { 16, { 0x10, 0x08, 0x30 } },
+    [TG_DIA_RING]         = { -3, { 0x18, 0x24, 0x18 } },
+    [TG_DIA_CARON]        = { -3, { 0x42, 0x24, 0x18 } },
+    [TG_DIA_MACRON]       = { -3, { 0x00, 0x7E, 0x00 } },
+    [TG_DIA_BREVE]        = { -3, { 0x42, 0x3C, 0x00 } },
+    [TG_DIA_OGONEK]       = { 16, { 0x10, 0x20, 0x18 } },
+    [TG_DIA_DOT]          = { -3, { 0x00, 0x18, 0x18 } },
+    [TG_DIA_DOUBLE_ACUTE] = { -3, { 0x09, 0x12, 0x24 } },
+    [TG_DIA_STROKE]       = {  7, { 0x7E, 0x00, 0x00 } },
+};
 
-/* Helper: draw accent mark (´) above a 2x character position */
-static void draw_accent_mark_2x(uint32_t *fb, uint32_t pitch,
-                                 int px, int py, uint32_t color)
-{
-    (void)pitch;
-    /* Acute accent: diagonal 2px-wide line above the 16×16 glyph */
-    overlay_put_pixel_ext(fb, px + 11, py - 3, color);
-    overlay_put_pixel_ext(fb, px + 12, py - 3, color);
-    overlay_put_pixel_ext(fb, px + 9,  py - 2, color);
-    overlay_put_pixel_ext(fb, px + 10, py - 2, color);
-    overlay_put_pixel_ext(fb, px + 7,  py - 1, color);
-    overlay_put_pixel_ext(fb, px + 8,  py - 1, color);
+/* Helper: draw a diacritic mark over a 2x character position */
+static void draw_mark_2x(uint32_t *fb, int px, int py, uint8_t dia, uint32_t color) {
+    if (dia >= TG_DIA_COUNT) return;
+    for (int r = 0; r < 3; r++) {
+        uint8_t bits = k_marks_2x[dia].rows[r];
+        for (int c = 0; bits && c < 8; c++) {
+            if (!(bits & (0x80 >> c))) continue;
+            overlay_put_pixel_ext(fb, px + 2 * c,     py + k_marks_2x[dia].dy + r, color);
+            overlay_put_pixel_ext(fb, px + 2 * c + 1, py + k_marks_2x[dia].dy + r, color);
+        }
+    }
 }
 
-/* Helper: map UTF-16 accented code point to ASCII base letter */
-static char u16_to_base(uint16_t ch) {
-    if (ch < 128) return (char)ch;
-    switch (ch) {
-    case 0x00C1: case 0x00C0: case 0x00C2: case 0x00C3: case 0x00C4: return 'A';
-    case 0x00E1: case 0x00E0: case 0x00E2: case 0x00E3: case 0x00E4: return 'a';
-    case 0x00C9: case 0x00C8: case 0x00CA: case 0x00CB: return 'E';
-    case 0x00E9: case 0x00E8: case 0x00EA: case 0x00EB: return 'e';
-    case 0x00CD: case 0x00CC: case 0x00CE: case 0x00CF: return 'I';
-    case 0x00ED: case 0x00EC: case 0x00EE: case 0x00EF: return 'i';
-    case 0x00D3: case 0x00D2: case 0x00D4: case 0x00D5: case 0x00D6: return 'O';
-    case 0x00F3: case 0x00F2: case 0x00F4: case 0x00F5: case 0x00F6: return 'o';
-    case 0x00DA: case 0x00D9: case 0x00DB: case 0x00DC: return 'U';
-    case 0x00FA: case 0x00F9: case 0x00FB: case 0x00FC: return 'u';
-    case 0x00D1: return 'N';
-    case 0x00F1: return 'n';
-    default: return '?';
-    }
+/* Helper: ASCII letter the 8x8 font draws for a UTF-16 unit ('?' if none), and its mark */
+static char u16_glyph(uint16_t ch, uint8_t *dia) {
+    uint16_t d = tg_decompose(ch);
+    *dia = (uint8_t)(d >> 8);
+    return d ? (char)(d & 0x7F) : '?';
 }
 
-/* Helper: check if a UTF-16 code point is an accented Latin character */
-static bool u16_is_accented(uint16_t ch) {
-    return (ch >= 0x00C0 && ch <= 0x00FF && u16_to_base(ch) != '?');
+/* Helper: what a key shows in the 8x8 font, which is ASCII only */
+static const char *key_label(const TgKey *k, char buf[TG_KEY_UNITS + 1]) {
+    if (k->label[0]) return k->label;
+    if (k->op != TG_OP_TEXT) return k->op == TG_OP_ACCENT ? "AC" : tg_op_label(k->op);
+    uint32_t n = k->len < TG_KEY_UNITS ? k->len : TG_KEY_UNITS;
+    uint8_t dia;
+    for (uint32_t i = 0; i < n; i++) buf[i] = u16_glyph(k->text[i], &dia);
+    buf[n] = '\0';
+    return buf;
 }
 
-/* Helper: draw a single character or special label at button position within a cell (2x font) */
+/* Helper: draw a single key's character or label at button position within a cell (2x font) */
 static void draw_cell_char(uint32_t *fb, uint32_t pitch,
                            int cell_x, int cell_y,
-                           int btn_idx, char ch,
-                           bool is_selected, bool accent_mode)
+                           int btn_idx, const TgKey *key,
+                           bool is_selected, uint16_t composed)
 {
-    bool is_spec = (ch == TG_SPECIAL_SPACE  || ch == TG_SPECIAL_BKSP   ||
-                    ch == TG_SPECIAL_ACCENT || ch == TG_SPECIAL_SELALL ||
-                    ch == TG_SPECIAL_EXIT   || ch == TG_SPECIAL_CUT    ||
-                    ch == TG_SPECIAL_COPY   || ch == TG_SPECIAL_PASTE  ||
-                    ch == TG_SPECIAL_CAPS);
-    int cw = is_spec ? 32 : 16;  /* 2x: 2-char label = 32px, single char = 16px */
+    bool is_spec  = key->op != TG_OP_TEXT;
+    if (!is_spec && key->len == 0) return;
+    /* Actions, labelled keys and strings are drawn as text */
+    bool is_label = is_spec || key->label[0] != '\0' || key->len > 1;
+    int cw = is_label ? 32 : 16;  /* 2x: 2-char label = 32px, single char = 16px */
 
     int ox, oy;
     switch (btn_idx) {
@@ -349,21 +389,22 @@ static void draw_cell_char(uint32_t *fb, uint32_t pitch,
                 : is_selected ? COL_TEXT_HI : COL_TEXT;
     uint32_t bg = COL_BG_DIM;
 
-    if (is_spec) {
-        const char *lbl = special_label(ch);
-        overlay_draw_text_2x(fb, pitch, px, py, lbl, fg, bg);
+    if (is_label) {
+        char buf[TG_KEY_UNITS + 1];
+        overlay_draw_text_2x(fb, pitch, px, py, key_label(key, buf), fg, bg);
     } else {
+        /* A letter the accent layer composes shows as that letter */
+        uint8_t dia;
+        char ch = u16_glyph(composed ? composed : key->text[0], &dia);
         overlay_draw_char_2x(fb, pitch, px, py, ch, fg, bg);
-        if (accent_mode && is_accentable(ch)) {
-            draw_accent_mark_2x(fb, pitch, px, py, COL_TEXT_SPECIAL);
-        }
+        if (dia != TG_DIA_NONE) draw_mark_2x(fb, px, py, dia, COL_TEXT_SPECIAL);
     }
 }
 
 /* ─── Main Draw ──────────────────────────────────────────────────── */
 
 void thumbgrid_draw(const ThumbGridState *state, const struct ImeSession *session,
-              uint32_t *fb, uint32_t pitch,
+              const struct TgComposer *composer, uint32_t *fb, uint32_t pitch,
               uint32_t screen_w, uint32_t screen_h)
 {
     if (!state || !session || !fb) return;
@@ -384,7 +425,7 @@ void thumbgrid_draw(const ThumbGridState *state, const struct ImeSession *sessio
 
     const ThumbGridPage *page = &state->pages[state->current_page];
 
-    uint64_t t_start = sceKernelGetProcessTime();  /* PERF */
+    PROF_BEGIN(PROF_DRAW_BACKDROP);
 
     /* No full backdrop fill — it was 272K pixels (16.5ms).
      * Cell backgrounds, text bar, and status bar provide their own fills. */
@@ -403,7 +444,8 @@ void thumbgrid_draw(const ThumbGridState *state, const struct ImeSession *sessio
     }
     cur_y += TITLE_BAR_H;
 
-    uint64_t t_backdrop = sceKernelGetProcessTime();  /* PERF */
+    PROF_END(PROF_DRAW_BACKDROP);
+    PROF_BEGIN(PROF_DRAW_TEXTBAR);
 
     /* ─── Text display bar ─── */
     int text_y = cur_y;
@@ -432,7 +474,7 @@ void thumbgrid_draw(const ThumbGridState *state, const struct ImeSession *sessio
     overlay_draw_char_2x(fb, pitch, base_x + 8, text_char_y, '>',
                          COL_TEXT_SPECIAL, text_bg);
 
-    /* Draw text chars from UTF-16 buffer with accent support */
+    /* Draw text chars from UTF-16 buffer, accented letters as base plus mark */
     int tx = base_x + 32;
     for (uint32_t i = start; i < end; i++) {
         if (i == cursor_pos) {
@@ -441,13 +483,16 @@ void thumbgrid_draw(const ThumbGridState *state, const struct ImeSession *sessio
                               COL_CURSOR);
             tx += 4;
         }
-        uint16_t ch_val = ses->output[i];
-        char base = u16_to_base(ch_val);
+        uint16_t ch_val = ime_session_char_at(ses, i);
+        uint8_t dia;
+        char base = u16_glyph(ch_val, &dia);
         overlay_draw_char_2x(fb, pitch, tx, text_char_y, base,
                              COL_TEXT_BUF, text_bg);
-        if (u16_is_accented(ch_val)) {
-            draw_accent_mark_2x(fb, pitch, tx, text_char_y, COL_TEXT_SPECIAL);
-        }
+        if (dia != TG_DIA_NONE)
+            draw_mark_2x(fb, tx, text_char_y, dia, COL_TEXT_SPECIAL);
+        /* Underline the span still being composed */
+        if (composer && i >= composer->start && i - composer->start < composer->length)
+            overlay_draw_rect(fb, pitch, tx, text_char_y + 18, 16, 2, COL_CURSOR);
         tx += 16;
     }
     /* Cursor at end of text */
@@ -456,7 +501,8 @@ void thumbgrid_draw(const ThumbGridState *state, const struct ImeSession *sessio
                           COL_CURSOR);
     }
 
-    uint64_t t_textbar = sceKernelGetProcessTime();  /* PERF */
+    PROF_END(PROF_DRAW_TEXTBAR);
+    PROF_BEGIN(PROF_DRAW_GRID);
 
     /* ─── Grid ─── */
     int grid_y = text_y + TEXT_BAR_H + 2;
@@ -480,12 +526,14 @@ void thumbgrid_draw(const ThumbGridState *state, const struct ImeSession *sessio
 
         /* Draw the 4 characters in button positions (2x font) */
         for (int btn = 0; btn < TG_BUTTONS; btn++) {
-            char ch = page->chars[cell][btn];
-            draw_cell_char(fb, pitch, cx, cy, btn, ch, selected, state->accent_mode);
+            const TgKey *key = &page->keys[cell][btn];
+            draw_cell_char(fb, pitch, cx, cy, btn, key, selected,
+                           thumbgrid_compose(state, key));
         }
     }
 
-    uint64_t t_grid = sceKernelGetProcessTime();  /* PERF */
+    PROF_END(PROF_DRAW_GRID);
+    PROF_BEGIN(PROF_DRAW_STATUS);
 
     /* ─── Status bar ─── */
     int page_y = grid_y + GRID_H + 2;
@@ -493,39 +541,14 @@ void thumbgrid_draw(const ThumbGridState *state, const struct ImeSession *sessio
                       OVL_TOTAL_W - 8, PAGE_BAR_H, COL_BG_BAR);
 
     char page_str[64];
-    if (state->accent_mode) {
-        snprintf(page_str, sizeof(page_str), "[%s] ACC  L3:a'  L2:shift  R2:done", page->name);
+    if (state->accent_layer != TG_DIA_NONE) {
+        snprintf(page_str, sizeof(page_str), "[%s] %s  L3:next  L2:shift  R2:done", page->name,
+                 tg_dia_name(state->accent_layer));
     } else {
         snprintf(page_str, sizeof(page_str), "[%s]  L3:a'  L2:shift  R2:done", page->name);
     }
     overlay_draw_text(fb, pitch, base_x + 8, page_y + 9, page_str,
                       COL_TEXT, COL_BG_BAR);
 
-    /* PERF: throttled breakdown log (once per second) */
-    {
-        static uint64_t xd_last_log = 0;
-        static uint32_t xd_count = 0;
-        static uint64_t xd_backdrop_total = 0, xd_textbar_total = 0;
-        static uint64_t xd_grid_total = 0, xd_status_total = 0;
-
-        uint64_t t_end = sceKernelGetProcessTime();
-        xd_count++;
-        xd_backdrop_total += (t_backdrop - t_start);
-        xd_textbar_total  += (t_textbar - t_backdrop);
-        xd_grid_total     += (t_grid - t_textbar);
-        xd_status_total   += (t_end - t_grid);
-
-        if (t_end - xd_last_log >= 1000000) {
-            printf("[CIME] DRAW: calls=%u  backdrop=%luus  text=%luus  grid=%luus  status=%luus  total=%luus\n",
-                xd_count,
-                (unsigned long)(xd_count ? xd_backdrop_total / xd_count : 0),
-                (unsigned long)(xd_count ? xd_textbar_total / xd_count : 0),
-                (unsigned long)(xd_count ? xd_grid_total / xd_count : 0),
-                (unsigned long)(xd_count ? xd_status_total / xd_count : 0),
-                (unsigned long)(xd_count ? (xd_backdrop_total + xd_textbar_total + xd_grid_total + xd_status_total) / xd_count : 0));
-            xd_last_log = t_end;
-            xd_count = 0;
-            xd_backdrop_total = xd_textbar_total = xd_grid_total = xd_status_total = 0;
-        }
-    }
+    PROF_END(PROF_DRAW_STATUS);
 }
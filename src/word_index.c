@@ -0,0 +1,109 @@
+/**
+ * @file word_index.c
+ * @brief Word-start index over the session text (see word_index.h)
+ */
+
+#include <string.h>
+
+#include "word_index.h"
+
+#define INDEX_BITS (WORD_INDEX_WORDS * 64)
+
+/* The 64 bits from bit p up; bits outside the index read as 0 */
+static uint64_t bits_at(const uint64_t *b, int64_t p) {
+    if (p <= -64 || p >= INDEX_BITS) return 0;
+    if (p < 0) return b[0] << -p;
+    uint32_t i = (uint32_t)p >> 6, o = (uint32_t)p & 63;
+    if (o == 0) return b[i];
+    uint64_t hi = (i + 1 < WORD_INDEX_WORDS) ? b[i + 1] : 0;
+    return (b[i] >> o) | (hi << (64 - o));
+}
+
+/* Bits of word k below text position pos */
+static uint64_t below(uint32_t k, uint32_t pos) {
+    uint32_t base = k * 64;
+    if (pos <= base) return 0;
+    return (pos - base >= 64) ? ~0ull : (1ull << (pos - base)) - 1;
+}
+
+/* Recompute the bits for positions [from, to) */
+static void recheck(WordIndex *w, const GapBuffer *g, uint32_t from, uint32_t to) {
+    uint32_t len = gap_buffer_length(g);
+    if (to > INDEX_BITS) to = INDEX_BITS;
+    bool prev_word = from > 0 && from - 1 < len &&
+                     word_index_is_word(gap_buffer_at(g, from - 1));
+    for (uint32_t i = from; i < to; i++) {
+        bool word = i < len && word_index_is_word(gap_buffer_at(g, i));
+        uint64_t bit = 1ull << (i & 63);
+        if (word && !prev_word) w->starts[i >> 6] |= bit;
+        else                    w->starts[i >> 6] &= ~bit;
+        prev_word = word;
+    }
+}
+
+void word_index_rebuild(WordIndex *w, const GapBuffer *g) {
+    memset(w->starts, 0, sizeof(w->starts));
+    recheck(w, g, 0, gap_buffer_length(g));
+}
+
+void word_index_insert(WordIndex *w, const GapBuffer *g, uint32_t pos, uint32_t n) {
+    if (n == 0) return;
+
+    /* Shift the bits from pos up by n, top word first */
+    uint32_t top = gap_buffer_length(g) >> 6;
+    if (top >= WORD_INDEX_WORDS) top = WORD_INDEX_WORDS - 1;
+    for (int64_t k = top; k >= (int64_t)(pos >> 6); k--) {
+        uint64_t keep = below((uint32_t)k, pos);
+        uint64_t moved = bits_at(w->starts, k * 64 - (int64_t)n);
+        w->starts[k] = (w->starts[k] & keep) | (moved & ~keep);
+    }
+
+    /* The new units, and the one after them, which has a new neighbour */
+    recheck(w, g, pos, pos + n + 1);
+}
+
+void word_index_delete(WordIndex *w, const GapBuffer *g, uint32_t pos, uint32_t n) {
+    if (n == 0) return;
+
+    /* Shift the bits from pos + n down by n, bottom word first */
+    uint32_t top = (gap_buffer_length(g) + n) >> 6;
+    if (top >= WORD_INDEX_WORDS) top = WORD_INDEX_WORDS - 1;
+    for (uint32_t k = pos >> 6; k <= top; k++) {
+        uint64_t keep = below(k, pos);
+        uint64_t moved = bits_at(w->starts, (int64_t)k * 64 + n);
+        w->starts[k] = (w->starts[k] & keep) | (moved & ~keep);
+    }
+
+    /* The unit now at pos has a new neighbour */
+    recheck(w, g, pos, pos + 1);
+}
+
+uint32_t word_index_before(const WordIndex *w, uint32_t pos) {
+    if (pos == 0) return 0;
+    uint32_t i = pos - 1;
+    if (i >= INDEX_BITS) i = INDEX_BITS - 1;
+
+    uint32_t k = i >> 6;
+    uint64_t m = w->starts[k] & below(k, i + 1);
+    for (;;) {
+        if (m) return k * 64 + 63 - (uint32_t)__builtin_clzll(m);
+        if (k == 0) return 0;
+        m = w->starts[--k];
+    }
+}
+
+uint32_t word_index_after(const WordIndex *w, uint32_t pos, uint32_t length) {
+    uint32_t i = pos + 1;
+    if (i >= length || i >= INDEX_BITS) return length;
+
+    uint32_t k = i >> 6;
+    uint64_t m = w->starts[k] & ~below(k, i);
+    for (;;) {
+        if (m) {
+            uint32_t r = k * 64 + (uint32_t)__builtin_ctzll(m);
+            return r < length ? r : length;
+        }
+        if (++k >= WORD_INDEX_WORDS) return length;
+        m = w->starts[k];
+    }
+}
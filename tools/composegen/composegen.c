@@ -0,0 +1,292 @@
+/**
+ * @file composegen.c
+ * @brief Generate and check the accent composition table
+ *
+ * gen reads UnicodeData.txt from the Unicode Character Database
+ * (https://www.unicode.org/Public/UCD/latest/ucd/UnicodeData.txt) and
+ * writes src/tg_compose_table.c: the decompose table and the perfect
+ * hash described in include/tg_compose.h. Letters in the range with a
+ * canonical decomposition into an ASCII letter and one of the layer
+ * marks get that layer; the letters below (k_extra) have none and are
+ * placed by hand. Any other letter left over is reported.
+ *
+ * check verifies the table built into this binary: every letter
+ * composes back from its decomposition, and every other (base, layer)
+ * pair misses.
+ *
+ * Usage: composegen gen UnicodeData.txt > tg_compose_table.c
+ *        composegen check
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tg_compose.h"
+
+/* ─── gen ─────────────────────────────────────────────────────────── */
+
+static const struct {
+    uint32_t mark;
+    uint8_t  dia;
+} k_marks[] = {
+    { 0x0301, TG_DIA_ACUTE },
+    { 0x0300, TG_DIA_GRAVE },
+    { 0x0302, TG_DIA_CIRCUMFLEX },
+    { 0x0308, TG_DIA_DIAERESIS },
+    { 0x0303, TG_DIA_TILDE },
+    { 0x0327, TG_DIA_CEDILLA },
+    { 0x030A, TG_DIA_RING },
+    { 0x030C, TG_DIA_CARON },
+    { 0x0304, TG_DIA_MACRON },
+    { 0x0306, TG_DIA_BREVE },
+    { 0x0328, TG_DIA_OGONEK },
+    { 0x0307, TG_DIA_DOT },
+    { 0x030B, TG_DIA_DOUBLE_ACUTE },
+};
+
+/* Letters with no canonical decomposition, under the key they are typed from */
+static const struct {
+    uint16_t cp;
+    char     base;
+    uint8_t  dia;
+} k_extra[] = {
+    { 0x00D8, 'O', TG_DIA_STROKE }, { 0x00F8, 'o', TG_DIA_STROKE },
+    { 0x0110, 'D', TG_DIA_STROKE }, { 0x0111, 'd', TG_DIA_STROKE },
+    { 0x0126, 'H', TG_DIA_STROKE }, { 0x0127, 'h', TG_DIA_STROKE },
+    { 0x0141, 'L', TG_DIA_STROKE }, { 0x0142, 'l', TG_DIA_STROKE },
+    { 0x0166, 'T', TG_DIA_STROKE }, { 0x0167, 't', TG_DIA_STROKE },
+    { 0x00C6, 'A', TG_DIA_OTHER },  { 0x00E6, 'a', TG_DIA_OTHER },   /* ae */
+    { 0x0152, 'O', TG_DIA_OTHER },  { 0x0153, 'o', TG_DIA_OTHER },   /* oe */
+    { 0x00D0, 'D', TG_DIA_OTHER },  { 0x00F0, 'd', TG_DIA_OTHER },   /* eth */
+    { 0x00DE, 'T', TG_DIA_OTHER },  { 0x00FE, 't', TG_DIA_OTHER },   /* thorn */
+    { 0x014A, 'N', TG_DIA_OTHER },  { 0x014B, 'n', TG_DIA_OTHER },   /* eng */
+    { 0x0132, 'J', TG_DIA_OTHER },  { 0x0133, 'j', TG_DIA_OTHER },   /* ij */
+    { 0x013F, 'L', TG_DIA_OTHER },  { 0x0140, 'l', TG_DIA_OTHER },   /* l middle dot */
+    { 0x00DF, 's', TG_DIA_OTHER },                                   /* sharp s */
+    { 0x0131, 'i', TG_DIA_OTHER },                                   /* dotless i */
+    { 0x0138, 'k', TG_DIA_OTHER },                                   /* kra */
+    { 0x017F, 'f', TG_DIA_OTHER },                                   /* long s */
+};
+
+static uint16_t g_decomp[TG_COMPOSE_COUNT];
+static bool     g_letter[TG_COMPOSE_COUNT];
+
+static uint8_t mark_dia(uint32_t mark) {
+    for (size_t i = 0; i < sizeof(k_marks) / sizeof(k_marks[0]); i++)
+        if (k_marks[i].mark == mark) return k_marks[i].dia;
+    return TG_DIA_NONE;
+}
+
+/*
+ * Take "code;name;category;...;decomposition;..." lines in the range.
+ * Letters are noted so the ones left without an entry can be reported.
+ */
+static bool load_unicode_data(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+
+    char line[512];
+    uint32_t decomposed = 0;
+    while (fgets(line, sizeof(line), f)) {
+        char *field[6];
+        char *p = line;
+        int n = 0;
+        while (n < 6 && p) {
+            field[n++] = p;
+            p = strchr(p, ';');
+            if (p) *p++ = '\0';
+        }
+        if (n < 6) continue;
+
+        unsigned long cp = strtoul(field[0], NULL, 16);
+        if (cp < TG_COMPOSE_FIRST || cp >= TG_COMPOSE_FIRST + TG_COMPOSE_COUNT) continue;
+        uint32_t idx = (uint32_t)cp - TG_COMPOSE_FIRST;
+        g_letter[idx] = field[2][0] == 'L';
+
+        /* Canonical only: "<compat> ..." starts with '<' */
+        char *end;
+        unsigned long base = strtoul(field[5], &end, 16);
+        if (end == field[5] || field[5][0] == '<') continue;
+        unsigned long mark = strtoul(end, &end, 16);
+        uint8_t dia = mark_dia((uint32_t)mark);
+        if (base < 0x80 && dia != TG_DIA_NONE) {
+            g_decomp[idx] = (uint16_t)(base | (uint32_t)dia << 8);
+            decomposed++;
+        }
+    }
+    fclose(f);
+    fprintf(stderr, "%s: %u canonical decompositions\n", path, decomposed);
+    return true;
+}
+
+/*
+ * Hash and displace: place the fullest buckets first, each with the
+ * first displacement that lands all its keys on free slots.
+ */
+static bool build_hash(uint8_t disp[TG_COMPOSE_BUCKETS], uint8_t slot[TG_COMPOSE_SLOTS]) {
+    uint32_t keys[TG_COMPOSE_BUCKETS][TG_COMPOSE_COUNT];
+    uint8_t  idxs[TG_COMPOSE_BUCKETS][TG_COMPOSE_COUNT];
+    uint32_t size[TG_COMPOSE_BUCKETS] = { 0 };
+
+    for (uint32_t i = 0; i < TG_COMPOSE_COUNT; i++) {
+        if (!g_decomp[i]) continue;
+        uint32_t key = tg_compose_key(g_decomp[i] & 0x7F, g_decomp[i] >> 8);
+        uint32_t b = tg_compose_bucket(key);
+        keys[b][size[b]] = key;
+        idxs[b][size[b]++] = (uint8_t)i;
+    }
+
+    uint32_t order[TG_COMPOSE_BUCKETS];
+    for (uint32_t b = 0; b < TG_COMPOSE_BUCKETS; b++) order[b] = b;
+    for (uint32_t i = 1; i < TG_COMPOSE_BUCKETS; i++) {
+        uint32_t b = order[i], j = i;
+        for (; j > 0 && size[order[j - 1]] < size[b]; j--) order[j] = order[j - 1];
+        order[j] = b;
+    }
+
+    memset(slot, TG_COMPOSE_EMPTY, TG_COMPOSE_SLOTS);
+    memset(disp, 0, TG_COMPOSE_BUCKETS);
+    for (uint32_t o = 0; o < TG_COMPOSE_BUCKETS; o++) {
+        uint32_t b = order[o];
+        if (size[b] == 0) break;
+        uint32_t d;
+        for (d = 0; d < 256; d++) {
+            uint32_t taken[TG_COMPOSE_COUNT];
+            uint32_t k;
+            for (k = 0; k < size[b]; k++) {
+                uint32_t s = tg_compose_slot_of(keys[b][k], d);
+                bool clash = slot[s] != TG_COMPOSE_EMPTY;
+                for (uint32_t t = 0; t < k && !clash; t++) clash = taken[t] == s;
+                if (clash) break;
+                taken[k] = s;
+            }
+            if (k == size[b]) {
+                for (k = 0; k < size[b]; k++) slot[taken[k]] = idxs[b][k];
+                break;
+            }
+        }
+        if (d == 256) {
+            fprintf(stderr, "bucket %u (%u keys) does not fit; raise TG_COMPOSE_SLOT_BITS\n",
+                    b, size[b]);
+            return false;
+        }
+        disp[b] = (uint8_t)d;
+    }
+    return true;
+}
+
+static int cmd_gen(const char *path) {
+    if (!load_unicode_data(path)) return 1;
+
+    for (size_t i = 0; i < sizeof(k_extra) / sizeof(k_extra[0]); i++) {
+        uint32_t idx = k_extra[i].cp - TG_COMPOSE_FIRST;
+        g_decomp[idx] = (uint16_t)((uint8_t)k_extra[i].base | (uint32_t)k_extra[i].dia << 8);
+    }
+
+    /* A (base, layer) pair must name one letter */
+    uint32_t entries = 0;
+    for (uint32_t i = 0; i < TG_COMPOSE_COUNT; i++) {
+        if (!g_decomp[i]) {
+            if (g_letter[i]) fprintf(stderr, "U+%04X: letter left out\n", TG_COMPOSE_FIRST + i);
+            continue;
+        }
+        entries++;
+        for (uint32_t j = 0; j < i; j++) {
+            if (g_decomp[j] == g_decomp[i]) {
+                fprintf(stderr, "U+%04X and U+%04X share a key\n",
+                        TG_COMPOSE_FIRST + j, TG_COMPOSE_FIRST + i);
+                return 1;
+            }
+        }
+    }
+
+    uint8_t disp[TG_COMPOSE_BUCKETS], slot[TG_COMPOSE_SLOTS];
+    if (!build_hash(disp, slot)) return 1;
+
+    printf("/**\n");
+    printf(" * @file tg_compose_table.c\n");
+    printf(" * @brief Accent composition tables (see tg_compose.h)\n");
+    printf(" *\n");
+    printf(" * Generated by tools/composegen from UnicodeData.txt.\n");
+    printf(" * Do not edit; regenerate instead.\n");
+    printf(" */\n\n");
+    printf("#include \"tg_compose.h\"\n\n");
+    printf("_Static_assert(TG_COMPOSE_BUCKETS == %u && TG_COMPOSE_SLOT_BITS == %u,\n"
+           "               \"regenerate the composition table\");\n\n",
+           TG_COMPOSE_BUCKETS, TG_COMPOSE_SLOT_BITS);
+
+    printf("const uint16_t tg_compose_decomp[TG_COMPOSE_COUNT] = {");
+    for (uint32_t i = 0; i < TG_COMPOSE_COUNT; i++) {
+        if (i % 16 == 0) printf("\n    /* U+%04X */", TG_COMPOSE_FIRST + i);
+        printf(" 0x%04X,", g_decomp[i]);
+    }
+    printf("\n};\n\n");
+
+    printf("const uint8_t tg_compose_disp[TG_COMPOSE_BUCKETS] = {");
+    for (uint32_t b = 0; b < TG_COMPOSE_BUCKETS; b++)
+        printf("%s%u,", (b % 16) ? " " : "\n    ", disp[b]);
+    printf("\n};\n\n");
+
+    printf("const uint8_t tg_compose_slot[TG_COMPOSE_SLOTS] = {");
+    for (uint32_t s = 0; s < TG_COMPOSE_SLOTS; s++)
+        printf("%s%u,", (s % 16) ? " " : "\n    ", slot[s]);
+    printf("\n};\n");
+
+    fprintf(stderr, "%u letters in %u slots: %u + %u + %u = %u bytes\n", entries,
+            TG_COMPOSE_SLOTS, TG_COMPOSE_COUNT * 2, TG_COMPOSE_BUCKETS, TG_COMPOSE_SLOTS,
+            TG_COMPOSE_COUNT * 2 + TG_COMPOSE_BUCKETS + TG_COMPOSE_SLOTS);
+    return 0;
+}
+
+/* ─── check ───────────────────────────────────────────────────────── */
+
+static int cmd_check(void) {
+    uint32_t letters = 0, hits = 0, errors = 0;
+
+    for (uint32_t i = 0; i < TG_COMPOSE_COUNT; i++) {
+        uint16_t cp = (uint16_t)(TG_COMPOSE_FIRST + i);
+        uint16_t d = tg_decompose(cp);
+        if (!d) continue;
+        letters++;
+        if (tg_compose(d & 0xFF, (uint8_t)(d >> 8)) != cp) {
+            fprintf(stderr, "U+%04X does not compose from '%c' + layer %u\n",
+                    cp, d & 0xFF, d >> 8);
+            errors++;
+        }
+    }
+
+    for (uint32_t base = 0; base < 0x80; base++) {
+        for (uint32_t dia = 0; dia < TG_DIA_COUNT; dia++) {
+            uint16_t cp = tg_compose((uint16_t)base, (uint8_t)dia);
+            if (!cp) continue;
+            hits++;
+            if (tg_decompose(cp) != (uint16_t)(base | dia << 8)) {
+                fprintf(stderr, "'%c' + layer %u gives U+%04X, which is not it\n",
+                        (char)base, dia, cp);
+                errors++;
+            }
+        }
+    }
+
+    printf("%u letters, %u of %u pairs compose, %u errors\n",
+           letters, hits, 0x80 * TG_DIA_COUNT, errors);
+    return errors != 0 || hits != letters;
+}
+
+/* ─── Main ────────────────────────────────────────────────────────── */
+
+int main(int argc, char **argv) {
+    if (argc == 3 && strcmp(argv[1], "gen") == 0) return cmd_gen(argv[2]);
+    if (argc == 2 && strcmp(argv[1], "check") == 0) return cmd_check();
+
+    fprintf(stderr,
+            "usage: composegen gen UnicodeData.txt > tg_compose_table.c\n"
+            "       composegen check\n");
+    return 2;
+}
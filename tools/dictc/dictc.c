@@ -0,0 +1,338 @@
+/**
+ * @file dictc.c
+ * @brief Compile a word list into a ThumbGrid completion dictionary
+ *
+ * Input is one word per line, optionally followed by whitespace and a
+ * count ("the 23135851162"). Without counts, earlier lines rank higher,
+ * which suits the usual frequency-sorted lists. Words are lowercased;
+ * words with characters other than a-z and apostrophe, or longer than
+ * TG_DICT_WORD_MAX - 1, are skipped. Duplicates keep their best count.
+ *
+ * Output is the format in include/tg_dict.h: a trie whose identical
+ * subtrees are merged, laid out so each node's children are contiguous.
+ *
+ * Usage: dictc [-v] words.txt thumbgrid_dict.bin
+ */
+
+#include <ctype.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tg_dict.h"
+
+/* ─── Word list ───────────────────────────────────────────────────── */
+
+typedef struct Word {
+    char     text[TG_DICT_WORD_MAX];
+    double   count;
+} Word;
+
+static Word    *g_words;
+static uint32_t g_word_count;
+
+static int cmp_word(const void *a, const void *b) {
+    return strcmp(((const Word *)a)->text, ((const Word *)b)->text);
+}
+
+static bool load_words(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+
+    uint32_t cap = 0, line_no = 0, skipped = 0;
+    bool any_count = false;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        char word[256];
+        double count = 0;
+        int fields = sscanf(line, "%255s %lf", word, &count);
+        if (fields < 1 || word[0] == '#') continue;
+
+        size_t len = strlen(word);
+        bool ok = len < TG_DICT_WORD_MAX;
+        for (size_t i = 0; ok && i < len; i++) {
+            word[i] = (char)tolower((unsigned char)word[i]);
+            ok = (word[i] >= 'a' && word[i] <= 'z') || word[i] == '\'';
+        }
+        if (!ok) {
+            skipped++;
+            continue;
+        }
+
+        if (g_word_count == cap) {
+            cap = cap ? cap * 2 : 4096;
+            g_words = realloc(g_words, cap * sizeof(Word));
+        }
+        Word *w = &g_words[g_word_count++];
+        memcpy(w->text, word, len + 1);
+        if (fields == 2) {
+            w->count = count > 0 ? count : 0;
+            any_count = true;
+        } else {
+            w->count = -(double)line_no;   /* rank; fixed up below */
+        }
+    }
+    fclose(f);
+
+    /* Rank-only lists: line n of N counts as N - n + 1. In a list that
+     * has counts, a word without one counts as 0. */
+    for (uint32_t i = 0; i < g_word_count; i++) {
+        if (g_words[i].count < 0)
+            g_words[i].count = any_count ? 0 : (double)line_no + 1 + g_words[i].count;
+    }
+    if (skipped)
+        fprintf(stderr, "dictc: skipped %u words (characters or length)\n", skipped);
+    return true;
+}
+
+/* Zipf-ish counts -> 1..255 on a log scale */
+static uint8_t scale_freq(double count, double max_count) {
+    if (max_count <= 1) return 255;
+    double v = log(count + 1) / log(max_count + 1);
+    int f = 1 + (int)(v * 254.0 + 0.5);
+    return (uint8_t)(f < 1 ? 1 : f > 255 ? 255 : f);
+}
+
+/* ─── Trie ────────────────────────────────────────────────────────── */
+
+typedef struct Node {
+    uint8_t   ch;
+    uint8_t   freq;
+    uint8_t   best;
+    uint32_t  child_count;
+    uint32_t *children;         /* node ids, sorted by label (input is sorted) */
+    uint32_t  canon;            /* id of the node it merged into */
+} Node;
+
+static Node    *g_nodes;
+static uint32_t g_node_count, g_node_cap;
+
+static uint32_t node_new(uint8_t ch) {
+    if (g_node_count == g_node_cap) {
+        g_node_cap = g_node_cap ? g_node_cap * 2 : 65536;
+        g_nodes = realloc(g_nodes, g_node_cap * sizeof(Node));
+    }
+    Node *n = &g_nodes[g_node_count];
+    memset(n, 0, sizeof(*n));
+    n->ch = ch;
+    return g_node_count++;
+}
+
+static void node_add_child(uint32_t parent, uint32_t child) {
+    Node *p = &g_nodes[parent];
+    p->children = realloc(p->children, (p->child_count + 1) * sizeof(uint32_t));
+    p->children[p->child_count++] = child;
+}
+
+/* Sorted input: a child, if present, is always the last one added */
+static uint32_t build_trie(double max_count) {
+    uint32_t root = node_new(0);
+    for (uint32_t i = 0; i < g_word_count; i++) {
+        uint32_t n = root;
+        for (const char *c = g_words[i].text; *c; c++) {
+            Node *p = &g_nodes[n];
+            uint32_t last = p->child_count ? p->children[p->child_count - 1] : 0;
+            if (p->child_count && g_nodes[last].ch == (uint8_t)*c) {
+                n = last;
+            } else {
+                uint32_t child = node_new((uint8_t)*c);
+                node_add_child(n, child);
+                n = child;
+            }
+        }
+        uint8_t f = scale_freq(g_words[i].count, max_count);
+        if (f > g_nodes[n].freq) g_nodes[n].freq = f;
+    }
+    return root;
+}
+
+/* ─── Suffix merging ──────────────────────────────────────────────── */
+
+/* Nodes are equal when label, freqs and (canonical) children match */
+static uint64_t node_hash(const Node *n) {
+    uint64_t h = 1469598103934665603ull;
+    h = (h ^ n->ch)   * 1099511628211ull;
+    h = (h ^ n->freq) * 1099511628211ull;
+    h = (h ^ n->best) * 1099511628211ull;
+    for (uint32_t i = 0; i < n->child_count; i++)
+        h = (h ^ g_nodes[n->children[i]].canon) * 1099511628211ull;
+    return h;
+}
+
+static bool node_equal(const Node *a, const Node *b) {
+    if (a->ch != b->ch || a->freq != b->freq || a->best != b->best ||
+        a->child_count != b->child_count)
+        return false;
+    for (uint32_t i = 0; i < a->child_count; i++)
+        if (g_nodes[a->children[i]].canon != g_nodes[b->children[i]].canon)
+            return false;
+    return true;
+}
+
+static uint32_t *g_table;       /* open addressing: node id + 1, 0 = empty */
+static uint32_t  g_table_mask;
+static uint32_t  g_unique;
+
+/* Post-order: children are canonical before their parent is hashed */
+static void canonicalize(uint32_t id) {
+    Node *n = &g_nodes[id];
+    n->best = n->freq;
+    for (uint32_t i = 0; i < n->child_count; i++) {
+        canonicalize(n->children[i]);
+        n = &g_nodes[id];
+        if (g_nodes[n->children[i]].best > n->best)
+            n->best = g_nodes[n->children[i]].best;
+    }
+
+    uint64_t h = node_hash(n);
+    for (uint32_t slot = (uint32_t)h & g_table_mask;; slot = (slot + 1) & g_table_mask) {
+        if (g_table[slot] == 0) {
+            g_table[slot] = id + 1;
+            n->canon = id;
+            g_unique++;
+            return;
+        }
+        if (node_equal(&g_nodes[g_table[slot] - 1], n)) {
+            n->canon = g_table[slot] - 1;
+            return;
+        }
+    }
+}
+
+/* ─── Layout ──────────────────────────────────────────────────────── */
+
+/*
+ * Breadth-first from the root. Each canonical node owns one child block;
+ * a node shared by several parents is written once per block it appears
+ * in (8 bytes), but its own children are written only once.
+ */
+static TgDictNode *layout(uint32_t root, uint32_t *out_count) {
+    uint32_t *block  = malloc(g_node_count * sizeof(uint32_t));
+    uint32_t *rec_of = malloc(g_node_count * sizeof(uint32_t));  /* record -> canon */
+    uint32_t *queue  = malloc(g_node_count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < g_node_count; i++) block[i] = UINT32_MAX;
+
+    uint32_t n_out = 0, head = 0, tail = 0;
+    rec_of[n_out++] = g_nodes[root].canon;
+    queue[tail++]   = g_nodes[root].canon;
+
+    while (head < tail) {
+        uint32_t c = queue[head++];
+        if (block[c] != UINT32_MAX) continue;
+        block[c] = n_out;
+        const Node *n = &g_nodes[c];
+        for (uint32_t i = 0; i < n->child_count; i++) {
+            uint32_t k = g_nodes[n->children[i]].canon;
+            rec_of[n_out++] = k;
+            if (block[k] == UINT32_MAX) queue[tail++] = k;
+        }
+    }
+
+    TgDictNode *out = calloc(n_out, sizeof(TgDictNode));
+    for (uint32_t r = 0; r < n_out; r++) {
+        const Node *n = &g_nodes[rec_of[r]];
+        if (n->child_count > 255) {
+            fprintf(stderr, "dictc: node with %u children\n", n->child_count);
+            exit(1);
+        }
+        out[r].first_child = n->child_count ? block[rec_of[r]] : 0;
+        out[r].child_count = (uint8_t)n->child_count;
+        out[r].ch          = n->ch;
+        out[r].freq        = n->freq;
+        out[r].best        = n->best;
+    }
+
+    free(block);
+    free(rec_of);
+    free(queue);
+    *out_count = n_out;
+    return out;
+}
+
+/* ─── Main ────────────────────────────────────────────────────────── */
+
+int main(int argc, char **argv) {
+    bool verbose = false;
+    int argi = 1;
+    if (argi < argc && strcmp(argv[argi], "-v") == 0) {
+        verbose = true;
+        argi++;
+    }
+    if (argc - argi != 2) {
+        fprintf(stderr, "usage: dictc [-v] words.txt thumbgrid_dict.bin\n");
+        return 2;
+    }
+
+    if (!load_words(argv[argi])) return 1;
+    if (g_word_count == 0) {
+        fprintf(stderr, "dictc: no usable words\n");
+        return 1;
+    }
+
+    /* Sort and fold duplicates, keeping the highest count */
+    qsort(g_words, g_word_count, sizeof(Word), cmp_word);
+    uint32_t w = 0;
+    double max_count = 0;
+    for (uint32_t i = 0; i < g_word_count; i++) {
+        if (w && strcmp(g_words[w - 1].text, g_words[i].text) == 0) {
+            if (g_words[i].count > g_words[w - 1].count)
+                g_words[w - 1].count = g_words[i].count;
+        } else {
+            g_words[w++] = g_words[i];
+        }
+    }
+    g_word_count = w;
+    for (uint32_t i = 0; i < g_word_count; i++)
+        if (g_words[i].count > max_count) max_count = g_words[i].count;
+
+    uint32_t root = build_trie(max_count);
+
+    uint32_t size = 1;
+    while (size < g_node_count * 2) size <<= 1;
+    g_table = calloc(size, sizeof(uint32_t));
+    g_table_mask = size - 1;
+    canonicalize(root);
+
+    uint32_t n_out;
+    TgDictNode *nodes = layout(root, &n_out);
+
+    TgDictHeader hdr = {
+        .magic      = TG_DICT_MAGIC,
+        .version    = TG_DICT_VERSION,
+        .node_size  = sizeof(TgDictNode),
+        .node_count = n_out,
+        .word_count = g_word_count,
+        .root       = 0,
+    };
+
+    FILE *f = fopen(argv[argi + 1], "wb");
+    if (!f) {
+        perror(argv[argi + 1]);
+        return 1;
+    }
+    bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+              fwrite(nodes, sizeof(TgDictNode), n_out, f) == n_out;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        fprintf(stderr, "dictc: write failed\n");
+        return 1;
+    }
+
+    printf("%u words, %u trie nodes, %u after merging, %u records, %zu bytes\n",
+           g_word_count, g_node_count, g_unique, n_out,
+           sizeof(hdr) + (size_t)n_out * sizeof(TgDictNode));
+    if (verbose) {
+        uint32_t top = 0;
+        for (uint32_t i = 1; i < g_word_count; i++)
+            if (g_words[i].count > g_words[top].count) top = i;
+        printf("most frequent: %s\n", g_words[top].text);
+    }
+    return 0;
+}
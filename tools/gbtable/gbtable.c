@@ -0,0 +1,246 @@
+/**
+ * @file gbtable.c
+ * @brief Generate and benchmark the grapheme break-property table
+ *
+ * gen reads GraphemeBreakProperty.txt and emoji-data.txt from the Unicode
+ * Character Database (https://www.unicode.org/Public/UCD/latest/ucd/ and
+ * .../ucd/emoji/) and writes src/grapheme_table.c: the two-stage table
+ * described in include/grapheme.h, with identical blocks merged.
+ *
+ * bench times the table built into this binary: grapheme_prop() over
+ * every code point and over BMP text, and grapheme_after() stepping
+ * through mixed text in a gap buffer.
+ *
+ * Usage: gbtable gen GraphemeBreakProperty.txt emoji-data.txt > grapheme_table.c
+ *        gbtable bench
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "grapheme.h"
+
+#define CODE_POINTS 0x110000
+#define BLOCK_SIZE  (1u << GRAPHEME_SHIFT)
+
+/* ─── gen ─────────────────────────────────────────────────────────── */
+
+static const struct {
+    const char *name;
+    uint8_t     prop;
+} k_props[] = {
+    { "CR",                 GRAPHEME_CR },
+    { "LF",                 GRAPHEME_LF },
+    { "Control",            GRAPHEME_CONTROL },
+    { "Extend",             GRAPHEME_EXTEND },
+    { "ZWJ",                GRAPHEME_ZWJ },
+    { "Regional_Indicator", GRAPHEME_RI },
+    { "Prepend",            GRAPHEME_PREPEND },
+    { "SpacingMark",        GRAPHEME_SPACING_MARK },
+    { "L",                  GRAPHEME_L },
+    { "V",                  GRAPHEME_V },
+    { "T",                  GRAPHEME_T },
+    { "LV",                 GRAPHEME_LV },
+    { "LVT",                GRAPHEME_LVT },
+    { "Extended_Pictographic", GRAPHEME_PICTO },
+};
+
+static uint8_t g_props[CODE_POINTS];
+
+/* Trim blanks from both ends in place */
+static char *trim(char *s) {
+    while (*s == ' ' || *s == '\t') s++;
+    size_t n = strlen(s);
+    while (n > 0 && (s[n - 1] == ' ' || s[n - 1] == '\t' || s[n - 1] == '\n' ||
+                     s[n - 1] == '\r'))
+        s[--n] = '\0';
+    return s;
+}
+
+/*
+ * Apply "XXXX..YYYY ; Property # comment" lines. Properties not in
+ * k_props (other emoji-data properties) are skipped. The first line,
+ * which names the file and version, goes to @p title.
+ */
+static bool load_ucd(const char *path, char *title, size_t title_len) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+
+    char line[512];
+    uint32_t line_no = 0, ranges = 0;
+    title[0] = '\0';
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        if (line_no == 1 && line[0] == '#') {
+            snprintf(title, title_len, "%s", trim(line + 1));
+            continue;
+        }
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char *semi = strchr(line, ';');
+        if (!semi) continue;
+        *semi = '\0';
+
+        char *range = trim(line), *name = trim(semi + 1);
+        char *end;
+        unsigned long lo = strtoul(range, &end, 16), hi = lo;
+        if (end[0] == '.' && end[1] == '.') hi = strtoul(end + 2, &end, 16);
+        if (end == range || hi < lo || hi >= CODE_POINTS) {
+            fprintf(stderr, "%s:%u: bad range\n", path, line_no);
+            fclose(f);
+            return false;
+        }
+
+        for (size_t i = 0; i < sizeof(k_props) / sizeof(k_props[0]); i++) {
+            if (strcmp(name, k_props[i].name) != 0) continue;
+            for (unsigned long cp = lo; cp <= hi; cp++) {
+                if (k_props[i].prop == GRAPHEME_PICTO) g_props[cp] |= GRAPHEME_PICTO;
+                else g_props[cp] = (uint8_t)((g_props[cp] & GRAPHEME_PICTO) | k_props[i].prop);
+            }
+            ranges++;
+            break;
+        }
+    }
+    fclose(f);
+    fprintf(stderr, "%s: %u ranges\n", path, ranges);
+    return true;
+}
+
+static int cmd_gen(const char *gbp_path, const char *emoji_path) {
+    char gbp_title[128], emoji_title[128];
+    if (!load_ucd(gbp_path, gbp_title, sizeof(gbp_title)) ||
+        !load_ucd(emoji_path, emoji_title, sizeof(emoji_title)))
+        return 1;
+
+    /* Merge identical blocks */
+    static uint8_t stage1[GRAPHEME_BLOCKS];
+    static uint32_t first_of[256];      /* block number -> first code point */
+    uint32_t unique = 0;
+    for (uint32_t b = 0; b < GRAPHEME_BLOCKS; b++) {
+        const uint8_t *block = &g_props[b * BLOCK_SIZE];
+        uint32_t u = 0;
+        while (u < unique && memcmp(&g_props[first_of[u]], block, BLOCK_SIZE) != 0) u++;
+        if (u == unique) {
+            if (unique == 256) {
+                fprintf(stderr, "more than 256 distinct blocks; lower GRAPHEME_SHIFT\n");
+                return 1;
+            }
+            first_of[unique++] = b * BLOCK_SIZE;
+        }
+        stage1[b] = (uint8_t)u;
+    }
+
+    printf("/**\n");
+    printf(" * @file grapheme_table.c\n");
+    printf(" * @brief Grapheme break-property table (see grapheme.h)\n");
+    printf(" *\n");
+    printf(" * Generated by tools/gbtable from:\n");
+    printf(" *   %s\n", gbp_title);
+    printf(" *   %s (Extended_Pictographic)\n", emoji_title);
+    printf(" * Do not edit; regenerate instead.\n");
+    printf(" */\n\n");
+    printf("#include \"grapheme.h\"\n\n");
+    printf("_Static_assert(GRAPHEME_SHIFT == %u, \"regenerate the grapheme table\");\n\n",
+           GRAPHEME_SHIFT);
+
+    printf("const uint8_t grapheme_stage1[GRAPHEME_BLOCKS] = {");
+    for (uint32_t b = 0; b < GRAPHEME_BLOCKS; b++)
+        printf("%s%u,", (b % 24) ? " " : "\n    ", stage1[b]);
+    printf("\n};\n\n");
+
+    printf("const uint8_t grapheme_stage2[%u << GRAPHEME_SHIFT] = {", unique);
+    for (uint32_t u = 0; u < unique; u++) {
+        printf("\n    /* block %u: U+%04X */", u, first_of[u]);
+        for (uint32_t i = 0; i < BLOCK_SIZE; i++)
+            printf("%s%u,", (i % 32) ? " " : "\n    ", g_props[first_of[u] + i]);
+    }
+    printf("\n};\n");
+
+    fprintf(stderr, "%u distinct blocks of %u: %u + %u = %u bytes\n", unique,
+            BLOCK_SIZE, GRAPHEME_BLOCKS, unique * BLOCK_SIZE,
+            GRAPHEME_BLOCKS + unique * BLOCK_SIZE);
+    return 0;
+}
+
+/* ─── bench ───────────────────────────────────────────────────────── */
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int cmd_bench(void) {
+    enum { ROUNDS = 20, TEXT_UNITS = 4096 };
+    volatile uint32_t sink = 0;
+
+    /* Every code point, in order */
+    uint64_t t0 = now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        uint32_t acc = 0;
+        for (uint32_t cp = 0; cp < CODE_POINTS; cp++) acc += grapheme_prop(cp);
+        sink += acc;
+    }
+    double all_ns = (double)(now_ns() - t0) / ((double)ROUNDS * CODE_POINTS);
+
+    /* Mixed text: ASCII, accents, kana, Hangul, an emoji ZWJ sequence, a flag */
+    static const uint16_t sample[] = {
+        'H', 'e', 'l', 'l', 'o', ' ', 'e', 0x0301, ' ', 0x3053, 0x3093, 0x306B,
+        0xD55C, 0x1100, 0x1161, ' ', 0xD83D, 0xDC69, 0x200D, 0xD83D, 0xDCBB,
+        ' ', 0xD83C, 0xDDEF, 0xD83C, 0xDDF5, ' ',
+    };
+    static uint16_t arena[GAP_MAX_CHUNKS][GAP_CHUNK_UNITS];
+    static uint16_t text[TEXT_UNITS];
+    for (uint32_t i = 0; i < TEXT_UNITS; i++)
+        text[i] = sample[i % (sizeof(sample) / sizeof(sample[0]))];
+
+    t0 = now_ns();
+    for (int r = 0; r < ROUNDS * 64; r++) {
+        uint32_t acc = 0;
+        for (uint32_t i = 0; i < TEXT_UNITS; i++) acc += grapheme_prop(text[i]);
+        sink += acc;
+    }
+    double text_ns = (double)(now_ns() - t0) / ((double)ROUNDS * 64 * TEXT_UNITS);
+
+    GapPool pool;
+    GapBuffer g;
+    gap_pool_init(&pool, arena, GAP_MAX_CHUNKS);
+    gap_buffer_init(&g, &pool, TEXT_UNITS);
+    gap_buffer_insert(&g, 0, text, TEXT_UNITS);
+    gap_buffer_insert(&g, TEXT_UNITS / 2, text, 0);     /* gap mid-text */
+
+    uint32_t clusters = 0;
+    t0 = now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        clusters = 0;
+        for (uint32_t p = 0; p < TEXT_UNITS; p = grapheme_after(&g, p)) clusters++;
+    }
+    double step_ns = (double)(now_ns() - t0) / ((double)ROUNDS * TEXT_UNITS);
+
+    printf("grapheme_prop, all code points: %.2f ns/lookup\n", all_ns);
+    printf("grapheme_prop, mixed text:      %.2f ns/unit\n", text_ns);
+    printf("grapheme_after, mixed text:     %.2f ns/unit (%u clusters in %u units)\n",
+           step_ns, clusters, TEXT_UNITS);
+    return sink == 0xFFFFFFFFu;     /* keep the loops */
+}
+
+/* ─── Main ────────────────────────────────────────────────────────── */
+
+int main(int argc, char **argv) {
+    if (argc == 4 && strcmp(argv[1], "gen") == 0) return cmd_gen(argv[2], argv[3]);
+    if (argc == 2 && strcmp(argv[1], "bench") == 0) return cmd_bench();
+
+    fprintf(stderr,
+            "usage: gbtable gen GraphemeBreakProperty.txt emoji-data.txt > grapheme_table.c\n"
+            "       gbtable bench\n");
+    return 2;
+}
@@ -0,0 +1,216 @@
+/**
+ * @file kanagen.c
+ * @brief Generate and check the romaji trie for the kana composer
+ *
+ * gen reads romaji.txt (one "spelling kana" pair per line) and writes
+ * src/tg_kana_table.c: the bitmap trie described in
+ * include/tg_composer.h, numbered breadth first so each node's children
+ * are adjacent and in input order.
+ *
+ * check walks every spelling of romaji.txt through the table built into
+ * this binary and compares the kana it ends on.
+ *
+ * Usage: kanagen gen romaji.txt > tg_kana_table.c
+ *        kanagen check romaji.txt
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tg_composer.h"
+
+#define MAX_NODES     1024
+#define SPELLING_MAX  8
+
+typedef struct Entry {
+    char     spelling[SPELLING_MAX];
+    uint16_t kana[2];
+} Entry;
+
+static Entry    g_entries[MAX_NODES];
+static uint32_t g_entry_count;
+
+/* Decode one UTF-8 BMP character; returns bytes used, 0 if invalid */
+static uint32_t utf8_bmp(const char *s, uint16_t *out) {
+    const uint8_t *u = (const uint8_t *)s;
+    if (u[0] < 0x80) { *out = u[0]; return 1; }
+    if ((u[0] & 0xE0) == 0xC0 && (u[1] & 0xC0) == 0x80) {
+        *out = (uint16_t)((u[0] & 0x1F) << 6 | (u[1] & 0x3F));
+        return 2;
+    }
+    if ((u[0] & 0xF0) == 0xE0 && (u[1] & 0xC0) == 0x80 && (u[2] & 0xC0) == 0x80) {
+        *out = (uint16_t)((u[0] & 0x0F) << 12 | (u[1] & 0x3F) << 6 | (u[2] & 0x3F));
+        return 3;
+    }
+    return 0;
+}
+
+static bool load_romaji(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+
+    char line[256];
+    uint32_t line_no = 0;
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char *spelling = strtok(line, " \t\r\n");
+        if (!spelling) continue;
+        char *kana = strtok(NULL, " \t\r\n");
+
+        Entry *e = &g_entries[g_entry_count];
+        memset(e, 0, sizeof(*e));
+        bool ok = kana && strtok(NULL, " \t\r\n") == NULL &&
+                  strlen(spelling) < SPELLING_MAX && g_entry_count < MAX_NODES;
+        for (const char *p = spelling; ok && *p; p++) ok = tg_kana_input((uint8_t)*p) >= 0;
+        uint32_t units = 0;
+        for (const char *p = kana; ok && *p; units++) {
+            uint32_t used = units < 2 ? utf8_bmp(p, &e->kana[units]) : 0;
+            ok = used != 0;
+            p += used;
+        }
+        if (!ok) {
+            fprintf(stderr, "%s:%u: expected: spelling kana (at most 2 units)\n",
+                    path, line_no);
+            fclose(f);
+            return false;
+        }
+        for (uint32_t i = 0; i < g_entry_count; i++) {
+            if (strcmp(g_entries[i].spelling, spelling) == 0) {
+                fprintf(stderr, "%s:%u: \"%s\" again\n", path, line_no, spelling);
+                fclose(f);
+                return false;
+            }
+        }
+        strcpy(e->spelling, spelling);
+        g_entry_count++;
+    }
+    fclose(f);
+    fprintf(stderr, "%s: %u spellings\n", path, g_entry_count);
+    return true;
+}
+
+/* ─── gen ─────────────────────────────────────────────────────────── */
+
+typedef struct TrieNode {
+    int32_t  child[TG_KANA_INPUTS];
+    uint16_t kana[2];
+    int32_t  index;             /* breadth-first number */
+} TrieNode;
+
+static TrieNode g_trie[MAX_NODES];
+static uint32_t g_trie_count;
+
+static int32_t new_node(void) {
+    if (g_trie_count == MAX_NODES) return -1;
+    TrieNode *n = &g_trie[g_trie_count];
+    for (uint32_t i = 0; i < TG_KANA_INPUTS; i++) n->child[i] = -1;
+    n->kana[0] = n->kana[1] = 0;
+    n->index = -1;
+    return (int32_t)g_trie_count++;
+}
+
+static int cmd_gen(const char *path) {
+    if (!load_romaji(path)) return 1;
+
+    new_node();
+    for (uint32_t i = 0; i < g_entry_count; i++) {
+        int32_t n = 0;
+        for (const char *p = g_entries[i].spelling; *p; p++) {
+            int32_t in = tg_kana_input((uint8_t)*p);
+            if (g_trie[n].child[in] < 0) {
+                int32_t c = new_node();
+                if (c < 0) {
+                    fprintf(stderr, "more than %u trie nodes\n", MAX_NODES);
+                    return 1;
+                }
+                g_trie[n].child[in] = c;
+            }
+            n = g_trie[n].child[in];
+        }
+        g_trie[n].kana[0] = g_entries[i].kana[0];
+        g_trie[n].kana[1] = g_entries[i].kana[1];
+    }
+
+    /* Breadth first: a node's children get consecutive numbers */
+    static int32_t order[MAX_NODES];
+    uint32_t head = 0, tail = 0;
+    order[tail++] = 0;
+    g_trie[0].index = 0;
+    while (head < tail) {
+        TrieNode *n = &g_trie[order[head++]];
+        for (uint32_t in = 0; in < TG_KANA_INPUTS; in++) {
+            if (n->child[in] < 0) continue;
+            g_trie[n->child[in]].index = (int32_t)tail;
+            order[tail++] = n->child[in];
+        }
+    }
+
+    printf("/**\n");
+    printf(" * @file tg_kana_table.c\n");
+    printf(" * @brief Romaji trie for the kana composer (see tg_composer.h)\n");
+    printf(" *\n");
+    printf(" * Generated by tools/kanagen from tools/kanagen/romaji.txt.\n");
+    printf(" * Do not edit; regenerate instead.\n");
+    printf(" */\n\n");
+    printf("#include \"tg_composer.h\"\n\n");
+    printf("_Static_assert(TG_KANA_INPUTS == %u, \"regenerate the kana table\");\n\n",
+           TG_KANA_INPUTS);
+    printf("const TgKanaNode tg_kana_nodes[%u] = {\n", tail);
+    for (uint32_t i = 0; i < tail; i++) {
+        const TrieNode *n = &g_trie[order[i]];
+        uint32_t next = 0;
+        int32_t child = 0;
+        for (uint32_t in = TG_KANA_INPUTS; in-- > 0; ) {
+            if (n->child[in] < 0) continue;
+            next |= 1u << in;
+            child = g_trie[n->child[in]].index;
+        }
+        printf("    { 0x%08X, %3d, { 0x%04X, 0x%04X } },\n",
+               next, next ? child : 0, n->kana[0], n->kana[1]);
+    }
+    printf("};\n");
+
+    fprintf(stderr, "%u nodes, %u bytes\n", tail, tail * (uint32_t)sizeof(TgKanaNode));
+    return 0;
+}
+
+/* ─── check ───────────────────────────────────────────────────────── */
+
+static int cmd_check(const char *path) {
+    if (!load_romaji(path)) return 1;
+
+    uint32_t errors = 0;
+    for (uint32_t i = 0; i < g_entry_count; i++) {
+        const Entry *e = &g_entries[i];
+        int32_t n = 0;
+        for (const char *p = e->spelling; *p && n >= 0; p++)
+            n = tg_kana_child((uint32_t)n, tg_kana_input((uint8_t)*p));
+        if (n < 0 || tg_kana_nodes[n].kana[0] != e->kana[0] ||
+            tg_kana_nodes[n].kana[1] != e->kana[1]) {
+            fprintf(stderr, "\"%s\" does not spell its kana\n", e->spelling);
+            errors++;
+        }
+    }
+    printf("%u spellings, %u errors\n", g_entry_count, errors);
+    return errors != 0;
+}
+
+/* ─── Main ────────────────────────────────────────────────────────── */
+
+int main(int argc, char **argv) {
+    if (argc == 3 && strcmp(argv[1], "gen") == 0) return cmd_gen(argv[2]);
+    if (argc == 3 && strcmp(argv[1], "check") == 0) return cmd_check(argv[2]);
+
+    fprintf(stderr,
+            "usage: kanagen gen romaji.txt > tg_kana_table.c\n"
+            "       kanagen check romaji.txt\n");
+    return 2;
+}
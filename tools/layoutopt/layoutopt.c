@@ -0,0 +1,358 @@
+/**
+ * @file layoutopt.c
+ * @brief Score ThumbGrid letter layouts and search for faster ones
+ *
+ * Typing cost is modelled per character as the time from the previous
+ * press: one button press, plus a stick move when the cell changes that
+ * grows with the distance between cells. Space is on the center cell,
+ * where the stick rests, so the start of a text counts as a space too.
+ * Buttons within a cell cost the same; only which cell a character
+ * sits in matters.
+ *
+ * What is typed comes from a text corpus (-c), from the plugin's usage
+ * log (-u, /user/data/thumbgrid_usage.bin), or both. With a usage log,
+ * cell-to-cell moves measured on the console replace the modelled time
+ * once there are enough samples.
+ *
+ * Usage:
+ *   layoutopt [-c corpus.txt] [-u usage.bin] bench layout.txt...
+ *   layoutopt [-c corpus.txt] [-u usage.bin] [-i iters] [-s seed]
+ *             optimize base.txt out.txt
+ *
+ * bench prints the expected cost of each layout and its speedup over
+ * the first. optimize starts from base.txt and anneals over swaps of
+ * the 32 outer slots, then writes the best layout found.
+ */
+
+#include <ctype.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "plugin_common.h"
+#include "tg_layout.h"
+
+/* ─── Cost model ──────────────────────────────────────────────────── */
+
+/* Rough thumb timings; measured moves override them per cell pair */
+#define PRESS_MS          180.0     /* press after the stick is in place */
+#define MOVE_MS            90.0     /* any stick move */
+#define MOVE_DIST_MS       70.0     /* per cell of distance */
+#define MEASURED_MIN        30      /* timed moves before the log is trusted */
+
+/* Keys: 0 is space (center cell), 1..TG_LAYOUT_SLOTS the layout's characters */
+#define KEYS  (TG_LAYOUT_SLOTS + 1)
+
+static char    g_charset[TG_LAYOUT_SLOTS];  /* characters in base layout order */
+static int     g_key_of[128];               /* char -> key, -1 = not typed */
+static double  g_pairs[KEYS][KEYS];         /* [previous][typed] counts */
+static double  g_pair_total;
+static double  g_move_ms[TG_CELLS][TG_CELLS];
+static uint32_t g_measured;                 /* cell pairs using the usage log */
+
+static void build_move_model(const TgUsageStore *u) {
+    for (int a = 0; a < TG_CELLS; a++) {
+        for (int b = 0; b < TG_CELLS; b++) {
+            if (u && u->moves[a][b] >= MEASURED_MIN) {
+                g_move_ms[a][b] = (double)u->move_us[a][b] / u->moves[a][b] / 1000.0;
+                g_measured++;
+                continue;
+            }
+            double dx = a % 3 - b % 3, dy = a / 3 - b / 3;
+            double dist = sqrt(dx * dx + dy * dy);
+            g_move_ms[a][b] = PRESS_MS + (a == b ? 0.0 : MOVE_MS + MOVE_DIST_MS * dist);
+        }
+    }
+}
+
+/* Expected milliseconds per character with key k in cell cell_of[k] */
+static double layout_cost(const int cell_of[KEYS]) {
+    double sum = 0;
+    for (int p = 0; p < KEYS; p++) {
+        const double *row = g_move_ms[cell_of[p]];
+        for (int c = 0; c < KEYS; c++)
+            sum += g_pairs[p][c] * row[cell_of[c]];
+    }
+    return sum / g_pair_total;
+}
+
+static void cells_of(const char slots[TG_LAYOUT_SLOTS], int cell_of[KEYS]) {
+    cell_of[0] = TG_CENTER_CELL;
+    for (uint32_t s = 0; s < TG_LAYOUT_SLOTS; s++)
+        cell_of[g_key_of[(uint8_t)slots[s]]] = tg_layout_slot_cell(s);
+}
+
+/* ─── Inputs ──────────────────────────────────────────────────────── */
+
+static bool read_file(const char *path, char **data, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    size_t cap = 1 << 16, n = 0;
+    char *buf = malloc(cap);
+    size_t got;
+    while ((got = fread(buf + n, 1, cap - n, f)) > 0) {
+        n += got;
+        if (n == cap) buf = realloc(buf, cap *= 2);
+    }
+    fclose(f);
+    *data = buf;
+    *len  = n;
+    return true;
+}
+
+static bool load_layout(const char *path, char slots[TG_LAYOUT_SLOTS]) {
+    char *text;
+    size_t len;
+    if (!read_file(path, &text, &len)) return false;
+    int32_t rc = tg_layout_parse(text, len, slots);
+    free(text);
+    if (rc != IME_OK) {
+        fprintf(stderr, "%s: want %d lines of %d characters\n",
+                path, TG_CELLS - 1, TG_BUTTONS);
+        return false;
+    }
+    return true;
+}
+
+/* The first layout fixes the character set; later ones must permute it */
+static bool check_charset(const char *path, const char slots[TG_LAYOUT_SLOTS]) {
+    int left[128] = {0};
+    for (uint32_t s = 0; s < TG_LAYOUT_SLOTS; s++) left[(uint8_t)g_charset[s]]++;
+    for (uint32_t s = 0; s < TG_LAYOUT_SLOTS; s++) {
+        if (--left[(uint8_t)slots[s]] < 0) {
+            fprintf(stderr, "%s: '%c' is not in the first layout or repeats\n",
+                    path, slots[s]);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void set_charset(const char slots[TG_LAYOUT_SLOTS]) {
+    memcpy(g_charset, slots, TG_LAYOUT_SLOTS);
+    for (int c = 0; c < 128; c++) g_key_of[c] = -1;
+    for (uint32_t s = 0; s < TG_LAYOUT_SLOTS; s++) g_key_of[(uint8_t)slots[s]] = (int)s + 1;
+}
+
+/* Whitespace is space; characters off the letter page reset to rest */
+static void count_corpus(const char *text, size_t len) {
+    int prev = 0;
+    for (size_t i = 0; i < len; i++) {
+        int c = tolower((unsigned char)text[i]);
+        int key = isspace(c) ? 0 : (c < 128 ? g_key_of[c] : -1);
+        if (key < 0) {
+            prev = 0;
+            continue;
+        }
+        if (key != 0 || prev != 0) {
+            g_pairs[prev][key] += 1;
+            g_pair_total += 1;
+        }
+        prev = key;
+    }
+}
+
+static int key_of_class(int cls) {
+    int c = cls + 0x20;
+    return c == ' ' ? 0 : (c < 128 ? g_key_of[c] : -1);
+}
+
+static void count_usage(const TgUsageStore *u) {
+    for (int p = 0; p < TG_USAGE_CLASSES; p++) {
+        int kp = key_of_class(p);
+        for (int c = 0; c < TG_USAGE_CLASSES && kp >= 0; c++) {
+            int kc = key_of_class(c);
+            if (kc < 0 || u->pairs[p][c] == 0) continue;
+            g_pairs[kp][kc] += u->pairs[p][c];
+            g_pair_total    += u->pairs[p][c];
+        }
+    }
+}
+
+static TgUsageStore *load_usage(const char *path) {
+    char *data;
+    size_t len;
+    if (!read_file(path, &data, &len)) return NULL;
+    TgUsageStore *u = (TgUsageStore *)data;
+    if (len < sizeof(TgUsageStore) || u->hdr.magic != TG_USAGE_MAGIC ||
+        u->hdr.version != TG_USAGE_VERSION || u->hdr.classes != TG_USAGE_CLASSES) {
+        fprintf(stderr, "%s: not a usage log from this plugin version\n", path);
+        free(data);
+        return NULL;
+    }
+    return u;
+}
+
+/* ─── Annealing ───────────────────────────────────────────────────── */
+
+static uint64_t g_rng = 1;
+
+static uint32_t rng_next(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return (uint32_t)(g_rng >> 32);
+}
+
+static double rng_unit(void) {
+    return rng_next() / 4294967296.0;
+}
+
+static double anneal(char slots[TG_LAYOUT_SLOTS], uint32_t iters) {
+    int cell_of[KEYS];
+    cells_of(slots, cell_of);
+    double cost = layout_cost(cell_of);
+
+    char best[TG_LAYOUT_SLOTS];
+    memcpy(best, slots, sizeof(best));
+    double best_cost = cost;
+
+    /* Geometric cooling from a temperature that accepts most early swaps */
+    const double t0 = 5.0, t1 = 0.01;
+    for (uint32_t i = 0; i < iters; i++) {
+        double t = t0 * pow(t1 / t0, (double)i / iters);
+        uint32_t a = rng_next() % TG_LAYOUT_SLOTS;
+        uint32_t b = rng_next() % TG_LAYOUT_SLOTS;
+        if (tg_layout_slot_cell(a) == tg_layout_slot_cell(b)) continue;
+
+        int ka = g_key_of[(uint8_t)slots[a]], kb = g_key_of[(uint8_t)slots[b]];
+        cell_of[ka] = tg_layout_slot_cell(b);
+        cell_of[kb] = tg_layout_slot_cell(a);
+        double next = layout_cost(cell_of);
+
+        if (next <= cost || rng_unit() < exp((cost - next) / t)) {
+            char tmp = slots[a];
+            slots[a] = slots[b];
+            slots[b] = tmp;
+            cost = next;
+            if (cost < best_cost) {
+                best_cost = cost;
+                memcpy(best, slots, sizeof(best));
+            }
+        } else {
+            cell_of[ka] = tg_layout_slot_cell(a);
+            cell_of[kb] = tg_layout_slot_cell(b);
+        }
+    }
+    memcpy(slots, best, sizeof(best));
+    return best_cost;
+}
+
+/* Within a cell the button does not change the cost; keep base order */
+static void sort_cells(char slots[TG_LAYOUT_SLOTS]) {
+    for (uint32_t cell = 0; cell < TG_CELLS - 1; cell++) {
+        char *c = &slots[cell * TG_BUTTONS];
+        for (int i = 1; i < TG_BUTTONS; i++) {
+            for (int j = i; j > 0 && g_key_of[(uint8_t)c[j]] < g_key_of[(uint8_t)c[j - 1]]; j--) {
+                char tmp = c[j];
+                c[j] = c[j - 1];
+                c[j - 1] = tmp;
+            }
+        }
+    }
+}
+
+static bool write_layout(const char *path, const char slots[TG_LAYOUT_SLOTS],
+                         double cost, double base_cost) {
+    static const char *const k_cell_names[TG_CELLS - 1] = {
+        "0 UL", "1 UC", "2 UR", "3 ML", "5 MR", "6 BL", "7 BC", "8 BR",
+    };
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    fprintf(f, "# ThumbGrid letter layout from layoutopt\n");
+    fprintf(f, "# Expected %.1f ms/char (base %.1f ms/char, %+.1f%% speed)\n",
+            cost, base_cost, (base_cost / cost - 1.0) * 100.0);
+    fprintf(f, "# Copy to %s\n", TG_LAYOUT_PATH);
+    for (uint32_t cell = 0; cell < TG_CELLS - 1; cell++)
+        fprintf(f, "%.4s    # cell %s\n", &slots[cell * TG_BUTTONS], k_cell_names[cell]);
+    return fclose(f) == 0;
+}
+
+/* ─── Main ────────────────────────────────────────────────────────── */
+
+static int usage(void) {
+    fprintf(stderr,
+        "usage: layoutopt [-c corpus.txt] [-u usage.bin] bench layout.txt...\n"
+        "       layoutopt [-c corpus.txt] [-u usage.bin] [-i iters] [-s seed]\n"
+        "                 optimize base.txt out.txt\n");
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    const char *corpus = NULL, *usage_path = NULL;
+    uint32_t iters = 200000;
+
+    int argi = 1;
+    for (; argi < argc && argv[argi][0] == '-'; argi++) {
+        if (argi + 1 >= argc) return usage();
+        switch (argv[argi][1]) {
+        case 'c': corpus     = argv[++argi]; break;
+        case 'u': usage_path = argv[++argi]; break;
+        case 'i': iters      = (uint32_t)strtoul(argv[++argi], NULL, 0); break;
+        case 's': g_rng      = strtoull(argv[++argi], NULL, 0) | 1; break;
+        default:  return usage();
+        }
+    }
+    if (argi >= argc || (!corpus && !usage_path)) return usage();
+    const char *cmd = argv[argi++];
+    bool bench = strcmp(cmd, "bench") == 0;
+    if (!bench && (strcmp(cmd, "optimize") != 0 || argc - argi != 2)) return usage();
+    if (argi >= argc) return usage();
+
+    char base[TG_LAYOUT_SLOTS];
+    if (!load_layout(argv[argi], base)) return 1;
+    set_charset(base);
+
+    TgUsageStore *u = NULL;
+    if (usage_path && !(u = load_usage(usage_path))) return 1;
+    if (corpus) {
+        char *text;
+        size_t len;
+        if (!read_file(corpus, &text, &len)) return 1;
+        count_corpus(text, len);
+        free(text);
+    }
+    if (u) count_usage(u);
+    if (g_pair_total == 0) {
+        fprintf(stderr, "layoutopt: nothing typeable in the inputs\n");
+        return 1;
+    }
+    build_move_model(u);
+    printf("%.0f character pairs, %u of %d cell moves measured\n",
+           g_pair_total, g_measured, TG_CELLS * TG_CELLS);
+
+    int cell_of[KEYS];
+    cells_of(base, cell_of);
+    double base_cost = layout_cost(cell_of);
+
+    if (bench) {
+        for (int i = argi; i < argc; i++) {
+            char slots[TG_LAYOUT_SLOTS];
+            if (i > argi && (!load_layout(argv[i], slots) || !check_charset(argv[i], slots)))
+                return 1;
+            if (i == argi) memcpy(slots, base, sizeof(slots));
+            cells_of(slots, cell_of);
+            double cost = layout_cost(cell_of);
+            printf("%-32s %7.1f ms/char  %6.1f chars/min  %+6.1f%%\n", argv[i],
+                   cost, 60000.0 / cost, (base_cost / cost - 1.0) * 100.0);
+        }
+        return 0;
+    }
+
+    char slots[TG_LAYOUT_SLOTS];
+    memcpy(slots, base, sizeof(slots));
+    double cost = anneal(slots, iters);
+    sort_cells(slots);
+    printf("%s: %.1f ms/char -> %.1f ms/char (%+.1f%% speed)\n",
+           argv[argi], base_cost, cost, (base_cost / cost - 1.0) * 100.0);
+    return write_layout(argv[argi + 1], slots, cost, base_cost) ? 0 : 1;
+}
@@ -0,0 +1,432 @@
+/**
+ * @file pagec.c
+ * @brief Compile a page description into a ThumbGrid page file
+ *
+ * Input is line-based text; '#' at the start of a token begins a
+ * comment. A page starts with "page NAME" and is followed by:
+ *
+ *   shift NAME           page shown while L2 is held (default: itself)
+ *   next NAME            page L1/R1 switches to (default: itself)
+ *   compose MODE         hiragana, katakana or hangul: one-unit keys go
+ *                        through that composer (default: none)
+ *   cell N K K K K       keys of cell N (0-8) in button order triangle,
+ *                        circle, cross, square; unlisted cells are empty
+ *
+ * A key K is text to type (UTF-8, up to TG_KEY_UNITS UTF-16 units), an
+ * action (@bksp @space @accent @selall @exit @cut @copy @paste @caps),
+ * or @none. Either may be followed by "|LABEL" to show LABEL instead.
+ * In keys and labels, \s is a space, \u{XXXX} a code point, and a
+ * backslash makes any other character literal (\@ \# \| \\).
+ *
+ * Output is the format in include/tg_pages.h. -d prints a page file
+ * back as a description.
+ *
+ * Usage: pagec pages.txt thumbgrid_pages.bin
+ *        pagec -d thumbgrid_pages.bin
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tg_pages.h"
+
+static const struct {
+    const char *name;
+    uint8_t     op;
+} k_ops[] = {
+    { "bksp",   TG_OP_BKSP },
+    { "space",  TG_OP_SPACE },
+    { "accent", TG_OP_ACCENT },
+    { "selall", TG_OP_SELALL },
+    { "exit",   TG_OP_EXIT },
+    { "cut",    TG_OP_CUT },
+    { "copy",   TG_OP_COPY },
+    { "paste",  TG_OP_PASTE },
+    { "caps",   TG_OP_CAPS },
+};
+
+#define OP_COUNT  (sizeof(k_ops) / sizeof(k_ops[0]))
+
+static const char *const k_composers[TG_COMPOSER_MODE_COUNT] = {
+    [TG_COMPOSER_NONE]     = "none",
+    [TG_COMPOSER_HIRAGANA] = "hiragana",
+    [TG_COMPOSER_KATAKANA] = "katakana",
+    [TG_COMPOSER_HANGUL]   = "hangul",
+};
+
+#define TOKEN_MAX 64
+
+static ThumbGridPage g_pages[TG_MAX_PAGES];
+static char          g_shift[TG_MAX_PAGES][TG_PAGE_NAME_MAX];
+static char          g_next[TG_MAX_PAGES][TG_PAGE_NAME_MAX];
+static uint32_t      g_page_count;
+
+static const char *g_path;
+static uint32_t    g_line_no;
+
+static bool fail(const char *msg) {
+    fprintf(stderr, "%s:%u: %s\n", g_path, g_line_no, msg);
+    return false;
+}
+
+/* ─── Tokens ──────────────────────────────────────────────────────── */
+
+/*
+ * Split @p line into raw tokens at unescaped blanks, stopping at a
+ * comment. Escapes are kept for decode_text().
+ */
+static uint32_t tokenize(char *line, char *tok[], uint32_t max) {
+    uint32_t n = 0;
+    char *p = line;
+    for (;;) {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+        if (*p == '\0' || *p == '#' || n == max) return n;
+        tok[n++] = p;
+        while (*p && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+            if (*p == '\\' && p[1]) p++;
+            p++;
+        }
+        if (*p) *p++ = '\0';
+    }
+}
+
+/* Append code point @p cp as UTF-8 */
+static bool put_utf8(char *out, uint32_t *len, uint32_t max, uint32_t cp) {
+    uint8_t b[4];
+    uint32_t n;
+    if (cp < 0x80)         { b[0] = (uint8_t)cp; n = 1; }
+    else if (cp < 0x800)   { b[0] = (uint8_t)(0xC0 | cp >> 6); n = 2; }
+    else if (cp < 0x10000) { b[0] = (uint8_t)(0xE0 | cp >> 12); n = 3; }
+    else                   { b[0] = (uint8_t)(0xF0 | cp >> 18); n = 4; }
+    for (uint32_t i = 1; i < n; i++)
+        b[i] = (uint8_t)(0x80 | ((cp >> (6 * (n - 1 - i))) & 0x3F));
+    if (*len + n > max) return false;
+    memcpy(out + *len, b, n);
+    *len += n;
+    return true;
+}
+
+/*
+ * Resolve escapes in [s, end) into UTF-8 in @p out (at most max - 1
+ * bytes, NUL terminated).
+ */
+static bool decode_text(const char *s, const char *end, char *out, uint32_t max) {
+    uint32_t len = 0;
+    while (s < end) {
+        uint32_t cp;
+        if (*s != '\\') {
+            if (len + 1 >= max) return fail("text too long");
+            out[len++] = *s++;
+            continue;
+        }
+        s++;
+        if (s == end) return fail("trailing backslash");
+        if (*s == 's') {
+            cp = ' ';
+            s++;
+        } else if (*s == 'u' && s + 1 < end && s[1] == '{') {
+            char *close;
+            cp = (uint32_t)strtoul(s + 2, &close, 16);
+            if (close >= end || *close != '}' || close == s + 2 || cp == 0 ||
+                cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+                return fail("bad \\u{...} escape");
+            s = close + 1;
+        } else {
+            cp = (uint8_t)*s++;
+        }
+        if (!put_utf8(out, &len, max - 1, cp)) return fail("text too long");
+    }
+    out[len] = '\0';
+    return true;
+}
+
+/* UTF-8 to UTF-16; returns the unit count, or -1 if invalid or too long */
+static int32_t utf8_to_16(const char *s, uint16_t *out, uint32_t max) {
+    const uint8_t *p = (const uint8_t *)s;
+    uint32_t n = 0;
+    while (*p) {
+        uint32_t cp, extra;
+        if (p[0] < 0x80)                { cp = p[0];        extra = 0; }
+        else if ((p[0] & 0xE0) == 0xC0) { cp = p[0] & 0x1F; extra = 1; }
+        else if ((p[0] & 0xF0) == 0xE0) { cp = p[0] & 0x0F; extra = 2; }
+        else if ((p[0] & 0xF8) == 0xF0) { cp = p[0] & 0x07; extra = 3; }
+        else return -1;
+        for (uint32_t i = 1; i <= extra; i++) {
+            if ((p[i] & 0xC0) != 0x80) return -1;
+            cp = cp << 6 | (p[i] & 0x3F);
+        }
+        p += extra + 1;
+        if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return -1;
+
+        if (cp >= 0x10000) {
+            if (n + 2 > max) return -1;
+            cp -= 0x10000;
+            out[n++] = (uint16_t)(0xD800 + (cp >> 10));
+            out[n++] = (uint16_t)(0xDC00 + (cp & 0x3FF));
+        } else {
+            if (n + 1 > max) return -1;
+            out[n++] = (uint16_t)cp;
+        }
+    }
+    return (int32_t)n;
+}
+
+/* ─── Parse ───────────────────────────────────────────────────────── */
+
+static bool parse_key(const char *tok, TgKey *k) {
+    memset(k, 0, sizeof(*k));
+
+    /* The label starts at the first unescaped '|' */
+    const char *bar = tok;
+    while (*bar && *bar != '|') bar += (*bar == '\\' && bar[1]) ? 2 : 1;
+    if (*bar == '|') {
+        if (!decode_text(bar + 1, bar + strlen(bar), k->label, TG_KEY_LABEL_MAX))
+            return false;
+        if (k->label[0] == '\0') return fail("empty label");
+    }
+
+    if (tok[0] == '@') {
+        size_t n = (size_t)(bar - tok - 1);
+        if (n == 4 && strncmp(tok + 1, "none", 4) == 0) return true;
+        for (size_t i = 0; i < OP_COUNT; i++) {
+            if (strlen(k_ops[i].name) == n && strncmp(tok + 1, k_ops[i].name, n) == 0) {
+                k->op = k_ops[i].op;
+                return true;
+            }
+        }
+        return fail("unknown action");
+    }
+
+    char text[TOKEN_MAX];
+    if (!decode_text(tok, bar, text, sizeof(text))) return false;
+    int32_t units = utf8_to_16(text, k->text, TG_KEY_UNITS);
+    if (units <= 0) return fail("key text must be 1-4 UTF-16 units of valid UTF-8");
+    k->len = (uint8_t)units;
+    return true;
+}
+
+static bool copy_name(char *dst, const char *src) {
+    if (strlen(src) >= TG_PAGE_NAME_MAX) return fail("page name too long");
+    strncpy(dst, src, TG_PAGE_NAME_MAX);
+    return true;
+}
+
+static bool parse_line(char *line) {
+    char *tok[8];
+    uint32_t n = tokenize(line, tok, 8);
+    if (n == 0) return true;
+
+    if (strcmp(tok[0], "page") == 0) {
+        if (n != 2) return fail("expected: page NAME");
+        if (g_page_count == TG_MAX_PAGES) return fail("too many pages");
+        ThumbGridPage *pg = &g_pages[g_page_count];
+        char name[TG_PAGE_NAME_MAX * 2];
+        if (!decode_text(tok[1], tok[1] + strlen(tok[1]), name, sizeof(name)) ||
+            !copy_name(pg->name, name))
+            return false;
+        for (uint32_t i = 0; i < g_page_count; i++)
+            if (strcmp(g_pages[i].name, pg->name) == 0) return fail("duplicate page name");
+        strcpy(g_shift[g_page_count], pg->name);
+        strcpy(g_next[g_page_count], pg->name);
+        g_page_count++;
+        return true;
+    }
+
+    if (g_page_count == 0) return fail("expected a page line first");
+    uint32_t p = g_page_count - 1;
+
+    if (strcmp(tok[0], "shift") == 0 || strcmp(tok[0], "next") == 0) {
+        if (n != 2) return fail("expected: shift NAME / next NAME");
+        char *dst = tok[0][0] == 's' ? g_shift[p] : g_next[p];
+        char name[TG_PAGE_NAME_MAX * 2];
+        return decode_text(tok[1], tok[1] + strlen(tok[1]), name, sizeof(name)) &&
+               copy_name(dst, name);
+    }
+
+    if (strcmp(tok[0], "compose") == 0) {
+        if (n != 2) return fail("expected: compose MODE");
+        for (uint32_t m = 0; m < TG_COMPOSER_MODE_COUNT; m++) {
+            if (strcmp(tok[1], k_composers[m]) == 0) {
+                g_pages[p].compose = (uint8_t)m;
+                return true;
+            }
+        }
+        return fail("compose MODE is none, hiragana, katakana or hangul");
+    }
+
+    if (strcmp(tok[0], "cell") == 0) {
+        char *end;
+        unsigned long cell = strtoul(tok[1], &end, 10);
+        if (n != 2 + TG_BUTTONS || *end || cell >= TG_CELLS)
+            return fail("expected: cell 0-8 followed by 4 keys");
+        for (uint32_t b = 0; b < TG_BUTTONS; b++)
+            if (!parse_key(tok[2 + b], &g_pages[p].keys[cell][b])) return false;
+        return true;
+    }
+
+    return fail("unknown directive");
+}
+
+static bool resolve(const char *name, uint8_t *out) {
+    for (uint32_t i = 0; i < g_page_count; i++) {
+        if (strcmp(g_pages[i].name, name) == 0) {
+            *out = (uint8_t)i;
+            return true;
+        }
+    }
+    fprintf(stderr, "%s: no page named \"%s\"\n", g_path, name);
+    return false;
+}
+
+static int compile(const char *in_path, const char *out_path) {
+    FILE *f = fopen(in_path, "r");
+    if (!f) {
+        perror(in_path);
+        return 1;
+    }
+    g_path = in_path;
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        g_line_no++;
+        if (!parse_line(line)) {
+            fclose(f);
+            return 1;
+        }
+    }
+    fclose(f);
+
+    if (g_page_count == 0) {
+        fprintf(stderr, "%s: no pages\n", in_path);
+        return 1;
+    }
+    for (uint32_t p = 0; p < g_page_count; p++) {
+        if (!resolve(g_shift[p], &g_pages[p].shift) ||
+            !resolve(g_next[p], &g_pages[p].next))
+            return 1;
+    }
+
+    TgPagesHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic      = TG_PAGES_MAGIC;
+    h.version    = TG_PAGES_VERSION;
+    h.page_size  = sizeof(ThumbGridPage);
+    h.page_count = g_page_count;
+    h.checksum   = tg_pages_checksum(g_pages, g_page_count * sizeof(ThumbGridPage));
+
+    FILE *out = fopen(out_path, "wb");
+    if (!out) {
+        perror(out_path);
+        return 1;
+    }
+    bool ok = fwrite(&h, sizeof(h), 1, out) == 1 &&
+              fwrite(g_pages, sizeof(ThumbGridPage), g_page_count, out) == g_page_count;
+    ok = (fclose(out) == 0) && ok;
+    if (!ok) {
+        perror(out_path);
+        return 1;
+    }
+
+    fprintf(stderr, "%u pages, %u bytes\n", g_page_count,
+            (uint32_t)(sizeof(h) + g_page_count * sizeof(ThumbGridPage)));
+    return 0;
+}
+
+/* ─── Dump ────────────────────────────────────────────────────────── */
+
+/* Print UTF-8 @p s escaped so tokenize() and decode_text() read it back */
+static void put_escaped(const char *s) {
+    for (; *s; s++) {
+        if (*s == ' ')                                 fputs("\\s", stdout);
+        else if (*s == '\\' || *s == '|' || *s == '#') printf("\\%c", *s);
+        else if ((uint8_t)*s < 0x20)                   printf("\\u{%X}", (uint8_t)*s);
+        else                                           putchar(*s);
+    }
+}
+
+static void put_key(const TgKey *k) {
+    if (k->op != TG_OP_TEXT) {
+        const char *name = "?";
+        for (size_t i = 0; i < OP_COUNT; i++)
+            if (k_ops[i].op == k->op) name = k_ops[i].name;
+        printf("@%s", name);
+    } else if (k->len == 0) {
+        fputs("@none", stdout);
+    } else {
+        char text[TOKEN_MAX];
+        uint32_t len = 0;
+        for (uint32_t i = 0; i < k->len; i++) {
+            uint32_t cp = k->text[i];
+            if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < k->len)
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (k->text[++i] - 0xDC00);
+            put_utf8(text, &len, sizeof(text) - 1, cp);
+        }
+        text[len] = '\0';
+        /* A leading '@' would read back as an action */
+        if (text[0] == '@') fputs("\\", stdout);
+        put_escaped(text);
+    }
+    if (k->label[0]) {
+        putchar('|');
+        put_escaped(k->label);
+    }
+}
+
+static int dump(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    TgPagesHeader h;
+    bool ok = fread(&h, sizeof(h), 1, f) == 1 && h.magic == TG_PAGES_MAGIC &&
+              h.version == TG_PAGES_VERSION && h.page_size == sizeof(ThumbGridPage) &&
+              h.page_count > 0 && h.page_count <= TG_MAX_PAGES &&
+              fread(g_pages, sizeof(ThumbGridPage), h.page_count, f) == h.page_count;
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "%s: not a version %u page file\n", path, TG_PAGES_VERSION);
+        return 1;
+    }
+    uint32_t sum = tg_pages_checksum(g_pages, h.page_count * sizeof(ThumbGridPage));
+    if (sum != h.checksum)
+        fprintf(stderr, "%s: checksum 0x%08X, expected 0x%08X\n", path, sum, h.checksum);
+
+    for (uint32_t p = 0; p < h.page_count; p++) {
+        const ThumbGridPage *pg = &g_pages[p];
+        printf("%spage %.*s\n", p ? "\n" : "", TG_PAGE_NAME_MAX, pg->name);
+        if (pg->shift != p && pg->shift < h.page_count)
+            printf("shift %.*s\n", TG_PAGE_NAME_MAX, g_pages[pg->shift].name);
+        if (pg->next != p && pg->next < h.page_count)
+            printf("next %.*s\n", TG_PAGE_NAME_MAX, g_pages[pg->next].name);
+        if (pg->compose != TG_COMPOSER_NONE && pg->compose < TG_COMPOSER_MODE_COUNT)
+            printf("compose %s\n", k_composers[pg->compose]);
+        for (uint32_t c = 0; c < TG_CELLS; c++) {
+            bool empty = true;
+            for (uint32_t b = 0; b < TG_BUTTONS; b++)
+                if (pg->keys[c][b].op || pg->keys[c][b].len || pg->keys[c][b].label[0])
+                    empty = false;
+            if (empty) continue;
+            printf("cell %u", c);
+            for (uint32_t b = 0; b < TG_BUTTONS; b++) {
+                putchar(' ');
+                put_key(&pg->keys[c][b]);
+            }
+            putchar('\n');
+        }
+    }
+    return sum == h.checksum ? 0 : 1;
+}
+
+/* ─── Main ────────────────────────────────────────────────────────── */
+
+int main(int argc, char **argv) {
+    if (argc == 3 && strcmp(argv[1], "-d") == 0) return dump(argv[2]);
+    if (argc == 3 && argv[1][0] != '-') return compile(argv[1], argv[2]);
+
+    fprintf(stderr, "usage: pagec pages.txt thumbgrid_pages.bin\n"
+                    "       pagec -d thumbgrid_pages.bin\n");
+    return 2;
+}
@@ -0,0 +1,330 @@
+/**
+ * @file shim.c
+ * @brief Host implementations of the PS4 SDK calls made by the replayed code
+ *
+ * Only what ime_hook.c, ime_custom.c, input.c, thumbgrid.c, log_ring.c
+ * and profile.c reach is provided. overlay.c is replaced wholesale: the
+ * framebuffer overlay is disabled in the shipping plugin, so it reports
+ * itself active (no notification fallback) and draws nothing.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <Detour.h>
+#include <GoldHEN.h>
+#include <orbis/libkernel.h>
+#include <orbis/Pad.h>
+#include <orbis/UserService.h>
+
+#include "overlay.h"
+#include "shim.h"
+
+/* SCE_KERNEL_ERROR_* is 0x80020000 | errno */
+#define SHIM_KERNEL_ERROR(e)  ((int)(0x80020000u | (unsigned)(e)))
+#define SHIM_PAD_ERROR        ((int)0x80920001u)
+
+/* ─── Clock ───────────────────────────────────────────────────────── */
+
+static uint64_t g_clock_us = 0;
+
+void shim_set_clock_us(uint64_t t_us) {
+    g_clock_us = t_us;
+}
+
+uint64_t sceKernelGetProcessTime(void) {
+    return g_clock_us;
+}
+
+/* The TSC only times phases; real time keeps those meaningful */
+uint64_t sceKernelReadTsc(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t sceKernelGetTscFrequency(void) {
+    return 1000000000ull;
+}
+
+int sceKernelUsleep(unsigned int usec) {
+    return usleep(usec);
+}
+
+/* ─── Files ───────────────────────────────────────────────────────── */
+
+static const char *g_out_dir = ".";
+static void       *g_last_map = NULL;
+static int         g_ipc_fd   = -1;
+
+void shim_set_out_dir(const char *dir) {
+    g_out_dir = dir;
+}
+
+void *shim_last_map(void) {
+    return g_last_map;
+}
+
+void shim_remove(const char *name) {
+    char host_path[1024];
+    snprintf(host_path, sizeof(host_path), "%s/%s", g_out_dir, name);
+    unlink(host_path);
+}
+
+int sceKernelOpen(const char *path, int flags, int mode) {
+    /* Keep the file name, drop the console directory */
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    char host_path[1024];
+    snprintf(host_path, sizeof(host_path), "%s/%s", g_out_dir, base);
+
+    int oflags = flags & 3;                 /* O_RDONLY/O_WRONLY/O_RDWR */
+    if (flags & 0x0008) oflags |= O_APPEND;
+    if (flags & 0x0200) oflags |= O_CREAT;
+    if (flags & 0x0400) oflags |= O_TRUNC;
+    if (flags & 0x0800) oflags |= O_EXCL;
+
+    int fd = open(host_path, oflags, mode);
+    if (fd >= 0 && strcmp(base, "thumbgrid_ipc.bin") == 0) g_ipc_fd = fd;
+    return fd < 0 ? SHIM_KERNEL_ERROR(errno) : fd;
+}
+
+int sceKernelClose(int fd) {
+    return close(fd) < 0 ? SHIM_KERNEL_ERROR(errno) : 0;
+}
+
+int64_t sceKernelLseek(int fd, int64_t offset, int whence) {
+    off_t r = lseek(fd, (off_t)offset, whence);
+    return r < 0 ? SHIM_KERNEL_ERROR(errno) : r;
+}
+
+int64_t sceKernelWrite(int fd, const void *buf, size_t len) {
+    ssize_t r = write(fd, buf, len);
+    return r < 0 ? SHIM_KERNEL_ERROR(errno) : r;
+}
+
+int64_t sceKernelRead(int fd, void *buf, size_t len) {
+    ssize_t r = read(fd, buf, len);
+    return r < 0 ? SHIM_KERNEL_ERROR(errno) : r;
+}
+
+int sceKernelMmap(void *addr, size_t len, int prot, int flags,
+                  int fd, int64_t offset, void **out) {
+    void *p = mmap(addr, len, prot, flags, fd, (off_t)offset);
+    if (p == MAP_FAILED) return SHIM_KERNEL_ERROR(errno);
+    if (fd == g_ipc_fd) g_last_map = p;     /* the IPC page, not the word stores */
+    *out = p;
+    return 0;
+}
+
+int sceKernelMunmap(void *addr, size_t len) {
+    if (addr == g_last_map) g_last_map = NULL;
+    return munmap(addr, len) < 0 ? SHIM_KERNEL_ERROR(errno) : 0;
+}
+
+/* ─── Modules and detours ─────────────────────────────────────────── */
+
+#define SHIM_IME_MODULE  1
+#define SHIM_ADDR_BASE   0x10000u
+
+static const char *const g_symbols[] = {
+    "sceImeDialogInit",
+    "sceImeDialogGetStatus",
+    "sceImeDialogGetResult",
+    "sceImeDialogTerm",
+};
+#define SHIM_SYMBOL_COUNT  (sizeof(g_symbols) / sizeof(g_symbols[0]))
+
+static void *g_hooks[SHIM_SYMBOL_COUNT];
+
+int sceKernelLoadStartModule(const char *name, size_t argc, const void *argv,
+                             uint32_t flags, void *opt, int *res) {
+    return strcmp(name, "libSceImeDialog.sprx") == 0
+        ? SHIM_IME_MODULE : SHIM_KERNEL_ERROR(ENOENT);
+}
+
+/* Resolved addresses are symbol indices; nothing ever calls them */
+int sceKernelDlsym(int handle, const char *symbol, void **addr) {
+    *addr = NULL;
+    if (handle != SHIM_IME_MODULE) return SHIM_KERNEL_ERROR(ESRCH);
+    for (size_t i = 0; i < SHIM_SYMBOL_COUNT; i++) {
+        if (strcmp(symbol, g_symbols[i]) == 0) {
+            *addr = (void *)(uintptr_t)(SHIM_ADDR_BASE + i);
+            return 0;
+        }
+    }
+    return SHIM_KERNEL_ERROR(ESRCH);
+}
+
+static void **hook_slot(uint64_t target) {
+    if (target < SHIM_ADDR_BASE || target >= SHIM_ADDR_BASE + SHIM_SYMBOL_COUNT)
+        return NULL;
+    return &g_hooks[target - SHIM_ADDR_BASE];
+}
+
+void Detour_Construct(Detour *d, DetourMode mode) {
+    memset(d, 0, sizeof(*d));
+}
+
+void Detour_DetourFunction(Detour *d, uint64_t target, void *hook) {
+    void **slot = hook_slot(target);
+    if (slot) *slot = hook;
+    d->target  = target;
+    d->StubPtr = NULL;
+}
+
+void Detour_RestoreFunction(Detour *d) {
+    void **slot = hook_slot(d->target);
+    if (slot) *slot = NULL;
+}
+
+void Detour_Destroy(Detour *d) {
+    memset(d, 0, sizeof(*d));
+}
+
+void *shim_hook(const char *symbol) {
+    for (size_t i = 0; i < SHIM_SYMBOL_COUNT; i++) {
+        if (strcmp(symbol, g_symbols[i]) == 0) return g_hooks[i];
+    }
+    return NULL;
+}
+
+/* ─── Threads ─────────────────────────────────────────────────────── */
+
+int scePthreadCreate(OrbisPthread *thr, const OrbisPthreadAttr *attr,
+                     void *(*entry)(void *), void *arg, const char *name) {
+    return pthread_create(thr, NULL, entry, arg);
+}
+
+int scePthreadJoin(OrbisPthread thr, void **ret) {
+    return pthread_join(thr, ret);
+}
+
+OrbisPthread scePthreadSelf(void) {
+    return pthread_self();
+}
+
+int scePthreadMutexInit(OrbisPthreadMutex *m, const OrbisPthreadMutexattr *attr,
+                        const char *name) {
+    return pthread_mutex_init(m, NULL);
+}
+
+int scePthreadMutexDestroy(OrbisPthreadMutex *m) {
+    return pthread_mutex_destroy(m);
+}
+
+int scePthreadMutexLock(OrbisPthreadMutex *m) {
+    return pthread_mutex_lock(m);
+}
+
+int scePthreadMutexUnlock(OrbisPthreadMutex *m) {
+    return pthread_mutex_unlock(m);
+}
+
+int scePthreadKeyCreate(OrbisPthreadKey *key, void (*destructor)(void *)) {
+    return pthread_key_create(key, destructor);
+}
+
+int scePthreadKeyDelete(OrbisPthreadKey key) {
+    return pthread_key_delete(key);
+}
+
+int scePthreadSetspecific(OrbisPthreadKey key, const void *value) {
+    return pthread_setspecific(key, value);
+}
+
+void *scePthreadGetspecific(OrbisPthreadKey key) {
+    return pthread_getspecific(key);
+}
+
+/* ─── Pad / user service / notifications ──────────────────────────── */
+
+#define SHIM_PAD_HANDLE  1
+
+static OrbisPadData g_pad;
+static int32_t      g_pad_rc = SHIM_PAD_ERROR;
+static bool         g_pad_queued = false;   /* unread by scePadRead */
+static uint32_t     g_notifications = 0;
+
+void shim_set_pad(const OrbisPadData *pad, int32_t rc) {
+    g_pad    = *pad;
+    g_pad_rc = rc == 0 ? 0 : SHIM_PAD_ERROR;
+    g_pad_queued = true;
+}
+
+int scePadGetHandle(int32_t user_id, int32_t type, int32_t index) {
+    return SHIM_PAD_HANDLE;
+}
+
+int scePadOpen(int32_t user_id, int32_t type, int32_t index, void *param) {
+    return SHIM_PAD_HANDLE;
+}
+
+int scePadClose(int32_t handle) {
+    return 0;
+}
+
+int scePadReadState(int32_t handle, OrbisPadData *data) {
+    *data = g_pad;
+    return g_pad_rc;
+}
+
+/* One buffered sample per shim_set_pad, consumed by the read */
+int scePadRead(int32_t handle, OrbisPadData *data, int32_t num) {
+    if (g_pad_rc != 0) return g_pad_rc;
+    if (!g_pad_queued || num < 1) return 0;
+    data[0] = g_pad;
+    g_pad_queued = false;
+    return 1;
+}
+
+int sceUserServiceGetInitialUser(int32_t *user_id) {
+    *user_id = 1;
+    return 0;
+}
+
+int sceKernelSendNotificationRequest(int device, OrbisNotificationRequest *req,
+                                     size_t size, int blocking) {
+    g_notifications++;
+    return 0;
+}
+
+uint32_t shim_notifications(void) {
+    return g_notifications;
+}
+
+/* ─── overlay.c replacement ───────────────────────────────────────── */
+
+int32_t overlay_init(void)                              { return 0; }
+void    overlay_cleanup(void)                           { }
+void    overlay_set_draw_callback(overlay_draw_cb_t cb) { }
+bool    overlay_is_active(void)                         { return true; }
+int32_t overlay_get_tiling_mode(void)                   { return 1; }
+bool    overlay_is_flipping(void)                       { return false; }
+void    overlay_force_draw(overlay_draw_cb_t cb)        { }
+void    overlay_force_draw_single(overlay_draw_cb_t cb) { }
+void    overlay_draw_last_flipped(overlay_draw_cb_t cb) { }
+
+void overlay_draw_rect(uint32_t *fb, uint32_t pitch,
+                       int x, int y, int w, int h, uint32_t color) { }
+void overlay_draw_char(uint32_t *fb, uint32_t pitch,
+                       int x, int y, char ch, uint32_t fg, uint32_t bg) { }
+void overlay_draw_text(uint32_t *fb, uint32_t pitch,
+                       int x, int y, const char *str,
+                       uint32_t fg, uint32_t bg) { }
+void overlay_draw_rect_alpha(uint32_t *fb, uint32_t pitch,
+                             int x, int y, int w, int h,
+                             uint32_t color, uint8_t alpha) { }
+void overlay_put_pixel_ext(uint32_t *fb, int x, int y, uint32_t color) { }
+void overlay_draw_char_2x(uint32_t *fb, uint32_t pitch,
+                          int x, int y, char ch, uint32_t fg, uint32_t bg) { }
+void overlay_draw_text_2x(uint32_t *fb, uint32_t pitch,
+                          int x, int y, const char *str,
+                          uint32_t fg, uint32_t bg) { }
@@ -0,0 +1,34 @@
+/**
+ * @file shim.h
+ * @brief Replay control surface of the host shims (shim.c)
+ */
+
+#ifndef TG_REPLAY_SHIM_H
+#define TG_REPLAY_SHIM_H
+
+#include <stdint.h>
+
+#include <orbis/Pad.h>
+
+/* Virtual process clock returned by sceKernelGetProcessTime */
+void     shim_set_clock_us(uint64_t t_us);
+
+/* Sample and return code for the next scePadReadState calls */
+void     shim_set_pad(const OrbisPadData *pad, int32_t rc);
+
+/* Hook registered for a libSceImeDialog symbol, or NULL */
+void    *shim_hook(const char *symbol);
+
+/* Directory that console paths are relocated into ("." by default) */
+void     shim_set_out_dir(const char *dir);
+
+/* Delete a file the plugin wrote into the out directory, if it is there */
+void     shim_remove(const char *name);
+
+/* Base of the most recent sceKernelMmap that is still mapped, or NULL */
+void    *shim_last_map(void);
+
+/* sceKernelSendNotificationRequest calls so far */
+uint32_t shim_notifications(void);
+
+#endif /* TG_REPLAY_SHIM_H */
@@ -0,0 +1,29 @@
+/**
+ * @file Detour.h
+ * @brief Host shim: GoldHEN detours recorded instead of patched
+ *
+ * Detour_DetourFunction registers the hook against the symbol that
+ * sceKernelDlsym resolved, so the player can call the hooked entry
+ * points directly (shim_hook()). There is no original to chain to.
+ */
+
+#ifndef TG_SHIM_DETOUR_H
+#define TG_SHIM_DETOUR_H
+
+#include <stdint.h>
+
+typedef enum DetourMode {
+    DetourMode_x64 = 0,
+} DetourMode;
+
+typedef struct Detour {
+    void    *StubPtr;     /* always NULL: no original function */
+    uint64_t target;
+} Detour;
+
+void Detour_Construct(Detour *d, DetourMode mode);
+void Detour_DetourFunction(Detour *d, uint64_t target, void *hook);
+void Detour_RestoreFunction(Detour *d);
+void Detour_Destroy(Detour *d);
+
+#endif /* TG_SHIM_DETOUR_H */
@@ -0,0 +1,36 @@
+/**
+ * @file GoldHEN.h
+ * @brief Host shim: notification request type (counted, not shown)
+ */
+
+#ifndef TG_SHIM_GOLDHEN_H
+#define TG_SHIM_GOLDHEN_H
+
+#include <stddef.h>
+
+typedef enum OrbisNotificationRequestType {
+    NotificationRequest = 0,
+} OrbisNotificationRequestType;
+
+typedef struct OrbisNotificationRequest {
+    OrbisNotificationRequestType type;
+    int  reqId;
+    int  priority;
+    int  msgId;
+    int  targetId;
+    int  userId;
+    int  unk1;
+    int  unk2;
+    int  appId;
+    int  errorNum;
+    int  unk3;
+    char useIconImageUri;
+    char message[1024];
+    char iconUri[1024];
+    char unk[1024];
+} OrbisNotificationRequest;
+
+int sceKernelSendNotificationRequest(int device, OrbisNotificationRequest *req,
+                                     size_t size, int blocking);
+
+#endif /* TG_SHIM_GOLDHEN_H */
@@ -0,0 +1,42 @@
+/**
+ * @file Pad.h
+ * @brief Host shim: OrbisPadData and the scePad calls used by ime_hook.c
+ *
+ * scePadReadState returns whatever sample the player queued with
+ * shim_set_pad(); scePadRead returns it once, as a one-sample buffer.
+ */
+
+#ifndef TG_SHIM_PAD_H
+#define TG_SHIM_PAD_H
+
+#include <stdint.h>
+
+typedef struct OrbisPadAnalogStick {
+    uint8_t x, y;
+} OrbisPadAnalogStick;
+
+typedef struct OrbisPadAnalogButtons {
+    uint8_t l2, r2;
+    uint8_t padding[2];
+} OrbisPadAnalogButtons;
+
+typedef struct OrbisPadData {
+    uint32_t              buttons;
+    OrbisPadAnalogStick   leftStick;
+    OrbisPadAnalogStick   rightStick;
+    OrbisPadAnalogButtons analogButtons;
+    uint8_t               motion_touch[60];  /* unused by the replay */
+    uint8_t               connected;
+    uint64_t              timestamp;
+    uint8_t               ext[16];
+    uint8_t               count;
+    uint8_t               unknown[15];
+} OrbisPadData;
+
+int scePadGetHandle(int32_t user_id, int32_t type, int32_t index);
+int scePadOpen(int32_t user_id, int32_t type, int32_t index, void *param);
+int scePadClose(int32_t handle);
+int scePadReadState(int32_t handle, OrbisPadData *data);
+int scePadRead(int32_t handle, OrbisPadData *data, int32_t num);
+
+#endif /* TG_SHIM_PAD_H */
@@ -0,0 +1,13 @@
+/**
+ * @file UserService.h
+ * @brief Host shim: initial user lookup
+ */
+
+#ifndef TG_SHIM_USER_SERVICE_H
+#define TG_SHIM_USER_SERVICE_H
+
+#include <stdint.h>
+
+int sceUserServiceGetInitialUser(int32_t *user_id);
+
+#endif /* TG_SHIM_USER_SERVICE_H */
@@ -0,0 +1,60 @@
+/**
+ * @file libkernel.h
+ * @brief Host shim: the libkernel subset used by the replayed sources
+ *
+ * Threads and mutexes map onto pthreads, files onto POSIX calls
+ * (relocated under the replay output directory), and the process clock
+ * onto the replay's virtual clock. See shim.c.
+ */
+
+#ifndef TG_SHIM_LIBKERNEL_H
+#define TG_SHIM_LIBKERNEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#include <GoldHEN.h>
+
+typedef pthread_t       OrbisPthread;
+typedef pthread_mutex_t OrbisPthreadMutex;
+typedef int             OrbisPthreadMutexattr;
+typedef int             OrbisPthreadAttr;
+typedef pthread_key_t   OrbisPthreadKey;
+
+uint64_t sceKernelGetProcessTime(void);
+uint64_t sceKernelReadTsc(void);
+uint64_t sceKernelGetTscFrequency(void);
+int      sceKernelUsleep(unsigned int usec);
+
+int      sceKernelOpen(const char *path, int flags, int mode);
+int      sceKernelClose(int fd);
+int64_t  sceKernelLseek(int fd, int64_t offset, int whence);
+int64_t  sceKernelWrite(int fd, const void *buf, size_t len);
+int64_t  sceKernelRead(int fd, void *buf, size_t len);
+int      sceKernelMmap(void *addr, size_t len, int prot, int flags,
+                       int fd, int64_t offset, void **out);
+int      sceKernelMunmap(void *addr, size_t len);
+
+int      sceKernelLoadStartModule(const char *name, size_t argc,
+                                  const void *argv, uint32_t flags,
+                                  void *opt, int *res);
+int      sceKernelDlsym(int handle, const char *symbol, void **addr);
+
+int          scePthreadCreate(OrbisPthread *thr, const OrbisPthreadAttr *attr,
+                              void *(*entry)(void *), void *arg,
+                              const char *name);
+int          scePthreadJoin(OrbisPthread thr, void **ret);
+OrbisPthread scePthreadSelf(void);
+int          scePthreadMutexInit(OrbisPthreadMutex *m,
+                                 const OrbisPthreadMutexattr *attr,
+                                 const char *name);
+int          scePthreadMutexDestroy(OrbisPthreadMutex *m);
+int          scePthreadMutexLock(OrbisPthreadMutex *m);
+int          scePthreadMutexUnlock(OrbisPthreadMutex *m);
+int          scePthreadKeyCreate(OrbisPthreadKey *key, void (*destructor)(void *));
+int          scePthreadKeyDelete(OrbisPthreadKey key);
+int          scePthreadSetspecific(OrbisPthreadKey key, const void *value);
+void        *scePthreadGetspecific(OrbisPthreadKey key);
+
+#endif /* TG_SHIM_LIBKERNEL_H */
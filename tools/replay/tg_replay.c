@@ -0,0 +1,426 @@
+/**
+ * @file tg_replay.c
+ * @brief Replay recorded pad traces through the IME hooks on a host
+ *
+ * Loads a TG_PAD_RECORD trace (include/pad_record.h), installs the real
+ * ime_hook.c hooks against the host shims, and drives
+ * sceImeDialogInit / GetStatus / GetResult / Term with the recorded
+ * samples on a virtual clock. Reports the resulting text, per-poll CPU
+ * time and heap calls made by plugin code. With -e the samples go
+ * straight into tg_engine_step instead, timing the engine alone.
+ *
+ * Usage: tg_replay [-e] [-v] [-n runs] [-o out_dir] [-x expected] trace.rec...
+ */
+
+#define _GNU_SOURCE
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "plugin_common.h"
+#include "ime_hook.h"
+#include "ime_custom.h"
+#include "pad_record.h"
+#include "tg_engine.h"
+#include "thumbgrid_ipc.h"
+
+#include "shim.h"
+
+/* Virtual clock value at sceImeDialogInit (0 reads as "never" in places) */
+#define REPLAY_CLOCK_BASE_US  1000000ull
+
+/* ─── Heap accounting (-Wl,--wrap=...) ────────────────────────────── */
+
+void *__real_malloc(size_t n);
+void *__real_calloc(size_t n, size_t sz);
+void *__real_realloc(void *p, size_t n);
+void  __real_free(void *p);
+
+static _Thread_local bool g_count_heap = false;
+static uint64_t           g_heap_allocs = 0;
+static uint64_t           g_heap_frees  = 0;
+
+void *__wrap_malloc(size_t n) {
+    if (g_count_heap) g_heap_allocs++;
+    return __real_malloc(n);
+}
+
+void *__wrap_calloc(size_t n, size_t sz) {
+    if (g_count_heap) g_heap_allocs++;
+    return __real_calloc(n, sz);
+}
+
+void *__wrap_realloc(void *p, size_t n) {
+    if (g_count_heap) g_heap_allocs++;
+    return __real_realloc(p, n);
+}
+
+void __wrap_free(void *p) {
+    if (g_count_heap && p) g_heap_frees++;
+    __real_free(p);
+}
+
+/* ─── Trace loading ───────────────────────────────────────────────── */
+
+typedef struct Trace {
+    TgPadRecHeader  hdr;
+    uint16_t        prefill[IME_MAX_OUTPUT_LENGTH + 1];
+    TgPadRecSample *samples;
+    uint32_t        count;
+} Trace;
+
+static bool trace_load(const char *path, Trace *t) {
+    memset(t, 0, sizeof(*t));
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+
+    bool ok = false;
+    if (fread(&t->hdr, sizeof(t->hdr), 1, f) != 1 ||
+        t->hdr.magic != TG_PADREC_MAGIC) {
+        fprintf(stderr, "%s: not a pad trace\n", path);
+        goto out;
+    }
+    if (t->hdr.version != TG_PADREC_VERSION ||
+        t->hdr.sample_size != sizeof(TgPadRecSample)) {
+        fprintf(stderr, "%s: unsupported trace version %u (sample %u bytes)\n",
+                path, t->hdr.version, t->hdr.sample_size);
+        goto out;
+    }
+    if (t->hdr.prefill_len > IME_MAX_OUTPUT_LENGTH ||
+        fread(t->prefill, sizeof(uint16_t), t->hdr.prefill_len, f)
+            != t->hdr.prefill_len) {
+        fprintf(stderr, "%s: truncated prefill\n", path);
+        goto out;
+    }
+    t->prefill[t->hdr.prefill_len] = 0;
+
+    uint32_t cap = 0;
+    TgPadRecSample s;
+    while (fread(&s, sizeof(s), 1, f) == 1) {
+        if (t->count == cap) {
+            cap = cap ? cap * 2 : 1024;
+            t->samples = realloc(t->samples, cap * sizeof(s));
+        }
+        t->samples[t->count++] = s;
+    }
+    ok = true;
+out:
+    fclose(f);
+    return ok;
+}
+
+/* ─── Replay ──────────────────────────────────────────────────────── */
+
+typedef struct RunResult {
+    OrbisImeDialogStatus status;
+    int32_t              end_status;
+    uint32_t             polls;
+    uint16_t             text[IME_MAX_OUTPUT_LENGTH + 1];
+} RunResult;
+
+static uint64_t thread_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void to_pad(const TgPadRecSample *s, OrbisPadData *pad) {
+    memset(pad, 0, sizeof(*pad));
+    pad->timestamp       = REPLAY_CLOCK_BASE_US + s->t_us;
+    pad->buttons         = s->buttons;
+    pad->leftStick.x     = s->lx;
+    pad->leftStick.y     = s->ly;
+    pad->rightStick.x    = s->rx;
+    pad->rightStick.y    = s->ry;
+    pad->analogButtons.l2 = s->l2;
+    pad->analogButtons.r2 = s->r2;
+    pad->connected       = 1;
+}
+
+/* Live text from the IPC page, for sessions that did not submit. Only
+ * the window around the cursor is there, which is all of any text up to
+ * TG_IPC_WINDOW units. */
+static void ipc_text(uint16_t *out) {
+    const ThumbGridSharedState *m = shim_last_map();
+    uint32_t n = 0;
+    if (m && m->window_length <= TG_IPC_WINDOW) {
+        n = m->window_length;
+        memcpy(out, m->output, n * sizeof(uint16_t));
+    }
+    out[n] = 0;
+}
+
+static bool replay_once(const Trace *t, uint32_t *poll_ns, RunResult *res) {
+    memset(res, 0, sizeof(*res));
+
+    /* Every run starts with an empty clipboard history */
+    shim_remove("thumbgrid_ipc.bin");
+    ime_hook_install();
+    sceImeDialogInit_t      init   = shim_hook("sceImeDialogInit");
+    sceImeDialogGetStatus_t status = shim_hook("sceImeDialogGetStatus");
+    sceImeDialogGetResult_t result = shim_hook("sceImeDialogGetResult");
+    sceImeDialogTerm_t      term   = shim_hook("sceImeDialogTerm");
+    if (!init || !status || !result || !term) {
+        fprintf(stderr, "hooks were not installed\n");
+        ime_hook_remove();
+        return false;
+    }
+
+    static const uint16_t title[] = { 'r', 'e', 'p', 'l', 'a', 'y', 0 };
+    uint16_t caller_buf[IME_MAX_OUTPUT_LENGTH + 1];
+    memcpy(caller_buf, t->prefill, sizeof(caller_buf));
+
+    OrbisImeDialogParam param;
+    memset(&param, 0, sizeof(param));
+    param.user_id           = 1;
+    param.type              = t->hdr.panel_type;
+    param.max_text_length   = t->hdr.max_text_length;
+    param.input_text_buffer = caller_buf;
+    param.title             = title;
+
+    shim_set_clock_us(REPLAY_CLOCK_BASE_US);
+    g_count_heap = true;
+    init(&param, NULL);
+    g_count_heap = false;
+
+    res->status = ORBIS_IME_DIALOG_STATUS_RUNNING;
+    for (uint32_t i = 0; i < t->count; i++) {
+        const TgPadRecSample *s = &t->samples[i];
+        OrbisPadData pad;
+        to_pad(s, &pad);
+        shim_set_pad(&pad, (s->flags & TG_PADREC_READ_OK) ? 0 : -1);
+        shim_set_clock_us(REPLAY_CLOCK_BASE_US + s->t_us);
+
+        g_count_heap = true;
+        uint64_t t0 = thread_cpu_ns();
+        res->status = status();
+        uint64_t t1 = thread_cpu_ns();
+        g_count_heap = false;
+
+        poll_ns[res->polls++] = (uint32_t)(t1 - t0);
+        if (res->status != ORBIS_IME_DIALOG_STATUS_RUNNING) break;
+    }
+
+    OrbisImeDialogResult r;
+    g_count_heap = true;
+    result(&r);
+    g_count_heap = false;
+    res->end_status = r.end_status;
+
+    if (res->status == ORBIS_IME_DIALOG_STATUS_FINISHED &&
+        r.end_status == ORBIS_IME_DIALOG_END_STATUS_OK) {
+        memcpy(res->text, caller_buf, sizeof(res->text));
+        res->text[IME_MAX_OUTPUT_LENGTH] = 0;
+    } else {
+        ipc_text(res->text);
+    }
+
+    g_count_heap = true;
+    term();
+    g_count_heap = false;
+    ime_hook_remove();
+    return true;
+}
+
+/* Same trace, engine only: no hooks, pad shim or IPC */
+static bool replay_engine(const Trace *t, uint32_t *poll_ns, RunResult *res) {
+    static ThumbGridEngine e;
+    uint16_t caller_buf[IME_MAX_OUTPUT_LENGTH + 1];
+    memcpy(caller_buf, t->prefill, sizeof(caller_buf));
+    memset(res, 0, sizeof(*res));
+
+    uint32_t max_len = t->hdr.max_text_length;
+    if (tg_engine_init(&e, t->hdr.panel_type, 0, max_len ? max_len : 256,
+                       caller_buf, caller_buf, NULL,
+                       REPLAY_CLOCK_BASE_US) != IME_OK) {
+        fprintf(stderr, "tg_engine_init failed\n");
+        return false;
+    }
+
+    res->status = ORBIS_IME_DIALOG_STATUS_RUNNING;
+    for (uint32_t i = 0; i < t->count; i++) {
+        const TgPadRecSample *s = &t->samples[i];
+        TgPadInput pad = {
+            .buttons = s->buttons,
+            .lx = s->lx, .ly = s->ly, .rx = s->rx, .ry = s->ry,
+            .l2 = s->l2, .r2 = s->r2,
+        };
+        if (!(s->flags & TG_PADREC_READ_OK)) memset(&pad, 0, sizeof(pad));
+
+        g_count_heap = true;
+        uint64_t t0 = thread_cpu_ns();
+        uint32_t fx = tg_engine_step(&e, &pad, REPLAY_CLOCK_BASE_US + s->t_us);
+        uint64_t t1 = thread_cpu_ns();
+        g_count_heap = false;
+
+        poll_ns[res->polls++] = (uint32_t)(t1 - t0);
+        if (fx & TG_FX_FINISHED) {
+            res->status = ORBIS_IME_DIALOG_STATUS_FINISHED;
+            break;
+        }
+    }
+
+    res->end_status = e.session.state == IME_STATE_CONFIRMING
+        ? ORBIS_IME_DIALOG_END_STATUS_OK
+        : ORBIS_IME_DIALOG_END_STATUS_USER_CANCELED;
+    if (res->status == ORBIS_IME_DIALOG_STATUS_FINISHED &&
+        res->end_status == ORBIS_IME_DIALOG_END_STATUS_OK) {
+        uint32_t n = safe_u16_strlen(caller_buf, IME_MAX_OUTPUT_LENGTH);
+        memcpy(res->text, caller_buf, n * sizeof(uint16_t));
+        res->text[n] = 0;
+    } else {
+        ime_session_get_text(&e.session, res->text, IME_MAX_OUTPUT_LENGTH + 1);
+    }
+    return true;
+}
+
+/* ─── Reporting ───────────────────────────────────────────────────── */
+
+static size_t utf16_to_utf8(const uint16_t *in, char *out, size_t cap) {
+    size_t o = 0;
+    for (; *in && o + 4 < cap; in++) {
+        uint16_t c = *in;
+        if (c < 0x80) {
+            out[o++] = (char)c;
+        } else if (c < 0x800) {
+            out[o++] = (char)(0xC0 | (c >> 6));
+            out[o++] = (char)(0x80 | (c & 0x3F));
+        } else {
+            out[o++] = (char)(0xE0 | (c >> 12));
+            out[o++] = (char)(0x80 | ((c >> 6) & 0x3F));
+            out[o++] = (char)(0x80 | (c & 0x3F));
+        }
+    }
+    out[o] = '\0';
+    return o;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static const char *outcome(const RunResult *r) {
+    if (r->status != ORBIS_IME_DIALOG_STATUS_FINISHED) return "running";
+    return r->end_status == ORBIS_IME_DIALOG_END_STATUS_OK ? "submitted"
+                                                           : "cancelled";
+}
+
+static void discard_sink(const char *buf, size_t len, void *ctx) {
+    (void)buf; (void)len; (void)ctx;
+}
+
+static void stderr_sink(const char *buf, size_t len, void *ctx) {
+    (void)ctx;
+    fwrite(buf, 1, len, stderr);
+}
+
+static void usage(void) {
+    fprintf(stderr,
+        "usage: tg_replay [-e] [-v] [-n runs] [-o out_dir] [-x expected] trace.rec...\n"
+        "  -e         step the engine directly (no hooks, pad or IPC)\n"
+        "  -v         print plugin log output to stderr\n"
+        "  -n runs    replay each trace this many times (timing)\n"
+        "  -o dir     where console paths (IPC file, traces) are written\n"
+        "  -x text    fail unless every trace ends with this text (UTF-8)\n");
+}
+
+int main(int argc, char **argv) {
+    bool        engine   = false;
+    bool        verbose  = false;
+    uint32_t    runs     = 1;
+    const char *expected = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "evn:o:x:")) != -1) {
+        switch (opt) {
+        case 'e': engine = true; break;
+        case 'v': verbose = true; break;
+        case 'n': runs = (uint32_t)strtoul(optarg, NULL, 10); break;
+        case 'o': shim_set_out_dir(optarg); break;
+        case 'x': expected = optarg; break;
+        default:  usage(); return 2;
+        }
+    }
+    if (optind >= argc || runs == 0) {
+        usage();
+        return 2;
+    }
+
+    log_ring_init(verbose ? stderr_sink : discard_sink, NULL);
+
+    int rc = 0;
+    for (int a = optind; a < argc; a++) {
+        Trace t;
+        if (!trace_load(argv[a], &t)) {
+            rc = 2;
+            continue;
+        }
+
+        uint32_t *poll_ns = malloc(((size_t)t.count * runs + 1) * sizeof(uint32_t));
+        uint32_t  total = 0;
+        uint64_t  allocs0 = g_heap_allocs, frees0 = g_heap_frees;
+        uint32_t  notes0 = shim_notifications();
+        bool      stable = true;
+        RunResult first, res;
+        char      text[IME_MAX_OUTPUT_LENGTH * 3 + 1];
+
+        for (uint32_t r = 0; r < runs; r++) {
+            bool ok = engine ? replay_engine(&t, poll_ns + total, &res)
+                             : replay_once(&t, poll_ns + total, &res);
+            if (!ok) {
+                rc = 2;
+                break;
+            }
+            total += res.polls;
+            if (r == 0) first = res;
+            else if (memcmp(first.text, res.text, sizeof(res.text)) != 0 ||
+                     first.status != res.status)
+                stable = false;
+        }
+        if (total == 0) {
+            free(poll_ns);
+            free(t.samples);
+            continue;
+        }
+
+        utf16_to_utf8(first.text, text, sizeof(text));
+        printf("%s: %u samples, %u polls, %s, text=\"%s\"\n",
+               argv[a], t.count, first.polls, outcome(&first), text);
+
+        qsort(poll_ns, total, sizeof(uint32_t), cmp_u32);
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < total; i++) sum += poll_ns[i];
+        printf("  %s cpu (%u polls): avg=%luns p50=%uns p99=%uns max=%uns\n",
+               engine ? "step" : "poll", total, (unsigned long)(sum / total), poll_ns[total / 2],
+               poll_ns[(uint32_t)((uint64_t)total * 99 / 100)],
+               poll_ns[total - 1]);
+        printf("  heap: %lu allocs, %lu frees; notifications: %u\n",
+               (unsigned long)(g_heap_allocs - allocs0),
+               (unsigned long)(g_heap_frees - frees0),
+               shim_notifications() - notes0);
+
+        if (!stable) {
+            printf("  FAIL: result differs between runs\n");
+            rc = rc ? rc : 1;
+        }
+        if (expected && strcmp(expected, text) != 0) {
+            printf("  FAIL: expected \"%s\"\n", expected);
+            rc = rc ? rc : 1;
+        }
+
+        free(poll_ns);
+        free(t.samples);
+    }
+
+    log_ring_shutdown();
+    return rc;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file test.h
+ * @brief Shared helpers for the host unit tests
+ *
+ * Each test is one program built with the plugin sources it covers. A
+ * failed CHECK prints where and why and counts; test_done() reports
+ * the total and gives the exit code. Random runs take their seed from
+ * the command line so a failure can be replayed.
+ *
+ * RefText is the naive reference the chunked structures are checked
+ * against: the whole text in one array, edited with memmove.
+ */
+
+#ifndef TG_TEST_H
+#define TG_TEST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gap_buffer.h"
+
+/* ─── Checks ──────────────────────────────────────────────────────── */
+
+#define TEST_MAX_REPORTS 20
+
+static uint32_t g_test_checks;
+static uint32_t g_test_failures;
+
+#define CHECK(cond, ...)                                                \
+    do {                                                                \
+        g_test_checks++;                                                \
+        if (!(cond)) {                                                  \
+            if (g_test_failures++ < TEST_MAX_REPORTS) {                 \
+                fprintf(stderr, "%s:%d: ", __FILE__, __LINE__);         \
+                fprintf(stderr, __VA_ARGS__);                           \
+                fputc('\n', stderr);                                    \
+            }                                                           \
+        }                                                               \
+    } while (0)
+
+/* Print the summary line; returns the process exit code */
+static inline int test_done(const char *name) {
+    if (g_test_failures) {
+        printf("%s: %u of %u checks FAILED\n", name, g_test_failures, g_test_checks);
+        return 1;
+    }
+    printf("%s: %u checks pass\n", name, g_test_checks);
+    return 0;
+}
+
+/* ─── Random ──────────────────────────────────────────────────────── */
+
+static uint64_t g_test_rng = 0x9E3779B97F4A7C15ull;
+
+static inline void test_seed(int argc, char **argv) {
+    for (int i = 1; i + 1 < argc; i++)
+        if (strcmp(argv[i], "-s") == 0) g_test_rng = strtoull(argv[i + 1], NULL, 0) | 1;
+}
+
+/* xorshift64* */
+static inline uint64_t test_rand(void) {
+    g_test_rng ^= g_test_rng >> 12;
+    g_test_rng ^= g_test_rng << 25;
+    g_test_rng ^= g_test_rng >> 27;
+    return g_test_rng * 0x2545F4914F6CDD1Dull;
+}
+
+/* Uniform in [0, n), n > 0 */
+static inline uint32_t test_below(uint32_t n) {
+    return (uint32_t)(test_rand() % n);
+}
+
+/* ─── Reference text ──────────────────────────────────────────────── */
+
+typedef struct RefText {
+    uint16_t u[GAP_MAX_UNITS];
+    uint32_t len;
+} RefText;
+
+static inline void ref_insert(RefText *r, uint32_t pos, const uint16_t *src, uint32_t n) {
+    memmove(&r->u[pos + n], &r->u[pos], (r->len - pos) * sizeof(uint16_t));
+    memcpy(&r->u[pos], src, n * sizeof(uint16_t));
+    r->len += n;
+}
+
+static inline void ref_delete(RefText *r, uint32_t pos, uint32_t n) {
+    memmove(&r->u[pos], &r->u[pos + n], (r->len - pos - n) * sizeof(uint16_t));
+    r->len -= n;
+}
+
+/* True if g holds exactly the reference text, read back in one copy */
+static inline bool ref_equal(const RefText *r, const GapBuffer *g) {
+    static uint16_t out[GAP_MAX_UNITS];
+    if (gap_buffer_length(g) != r->len) return false;
+    if (gap_buffer_copy(g, 0, r->len, out) != r->len) return false;
+    return memcmp(out, r->u, r->len * sizeof(uint16_t)) == 0;
+}
+
+#endif /* TG_TEST_H */
@@ -0,0 +1,218 @@
+/**
+ * @file test_gap_buffer.c
+ * @brief Gap buffer against a flat reference array
+ *
+ * Random inserts and deletes of every size, from a single unit to spans
+ * of several chunks, so the gap moves up and down across chunk edges
+ * and grows while it sits mid-text. After each edit the whole text, a
+ * few single units and a random copy are compared with RefText. Fixed
+ * cases cover the length limit, a pool shared until it runs dry, and
+ * clear handing chunks back.
+ *
+ * Usage: test_gap_buffer [-s seed]
+ */
+
+#include "test.h"
+
+static uint16_t g_arena[GAP_POOL_MAX][GAP_CHUNK_UNITS];
+static RefText  g_ref;
+
+/* Distinct units, so a misplaced span never compares equal by luck */
+static uint16_t g_next_unit = 1;
+
+static void fill(uint16_t *dst, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        dst[i] = g_next_unit++;
+        if (g_next_unit == 0) g_next_unit = 1;
+    }
+}
+
+/* Sizes weighted toward what the engine does: mostly one unit, with
+ * pastes and selection deletes up to several chunks */
+static uint32_t random_size(void) {
+    uint32_t r = test_below(100);
+    if (r < 50) return 1 + test_below(2);
+    if (r < 80) return 1 + test_below(64);
+    if (r < 95) return 1 + test_below(3 * GAP_CHUNK_UNITS);
+    return 1 + test_below(GAP_MAX_UNITS / 2);
+}
+
+static void compare(const GapBuffer *g, const char *what, uint32_t step) {
+    static uint16_t out[GAP_MAX_UNITS];
+
+    CHECK(ref_equal(&g_ref, g), "step %u (%s): text differs, length %u vs %u",
+          step, what, gap_buffer_length(g), g_ref.len);
+    if (g_ref.len == 0) return;
+
+    for (int k = 0; k < 4; k++) {
+        uint32_t i = test_below(g_ref.len);
+        CHECK(gap_buffer_at(g, i) == g_ref.u[i], "step %u: unit %u differs", step, i);
+    }
+    uint32_t pos = test_below(g_ref.len + 8);
+    uint32_t n   = test_below(g_ref.len + 8);
+    uint32_t want = pos >= g_ref.len ? 0 : (n < g_ref.len - pos ? n : g_ref.len - pos);
+    uint32_t got  = gap_buffer_copy(g, pos, n, out);
+    CHECK(got == want, "step %u: copy(%u, %u) gave %u units, want %u", step, pos, n, got, want);
+    if (got == want && want)
+        CHECK(memcmp(out, &g_ref.u[pos], want * sizeof(uint16_t)) == 0,
+              "step %u: copy(%u, %u) differs", step, pos, n);
+}
+
+/* ─── Random edits ────────────────────────────────────────────────── */
+
+static void test_random(uint32_t steps) {
+    static uint16_t src[GAP_MAX_UNITS];
+    GapPool   pool;
+    GapBuffer g;
+    uint32_t  last_end = 0;
+
+    gap_pool_init(&pool, g_arena, GAP_POOL_MAX);
+    gap_buffer_init(&g, &pool, GAP_MAX_UNITS);
+    g_ref.len = 0;
+
+    for (uint32_t step = 0; step < steps; step++) {
+        uint32_t r = test_below(100);
+        if (r < 55) {
+            uint32_t n   = random_size();
+            uint32_t pos = test_below(g_ref.len + 1);
+            fill(src, n);
+            bool ok   = gap_buffer_insert(&g, pos, src, n);
+            bool want = n <= GAP_MAX_UNITS - g_ref.len;
+            CHECK(ok == want, "step %u: insert(%u, %u) at length %u returned %d",
+                  step, pos, n, g_ref.len, ok);
+            if (ok) {
+                ref_insert(&g_ref, pos, src, n);
+                last_end = pos + n;
+            }
+            compare(&g, "insert", step);
+        } else if (r < 75 && last_end > 0 && last_end <= g_ref.len) {
+            /* Backspace: delete just before the gap, with no move */
+            uint32_t n = 1 + test_below(last_end < 4 ? last_end : 4);
+            gap_buffer_delete(&g, last_end - n, n);
+            ref_delete(&g_ref, last_end - n, n);
+            last_end -= n;
+            compare(&g, "backspace", step);
+        } else if (r < 98) {
+            uint32_t pos = test_below(g_ref.len + 2);
+            uint32_t n   = random_size();
+            gap_buffer_delete(&g, pos, n);
+            if (pos < g_ref.len)
+                ref_delete(&g_ref, pos, n < g_ref.len - pos ? n : g_ref.len - pos);
+            last_end = 0;
+            compare(&g, "delete", step);
+        } else {
+            gap_buffer_clear(&g);
+            g_ref.len = 0;
+            last_end  = 0;
+            CHECK(pool.free_count == GAP_POOL_MAX, "step %u: clear left %u chunks free",
+                  step, pool.free_count);
+            compare(&g, "clear", step);
+        }
+        CHECK(g.chunk_count + pool.free_count == GAP_POOL_MAX,
+              "step %u: %u chunks held and %u free", step, g.chunk_count, pool.free_count);
+    }
+}
+
+/* ─── Fixed cases ─────────────────────────────────────────────────── */
+
+/* The gap moving down, then up, over spans that start and end mid-chunk */
+static void test_span_move(void) {
+    static uint16_t src[GAP_MAX_UNITS];
+    GapPool   pool;
+    GapBuffer g;
+
+    gap_pool_init(&pool, g_arena, GAP_POOL_MAX);
+    gap_buffer_init(&g, &pool, GAP_MAX_UNITS);
+    g_ref.len = 0;
+
+    static const struct { uint32_t pos, n; } k_edits[] = {
+        { 0,    3 * GAP_CHUNK_UNITS + 17 },   /* fills three chunks and a bit */
+        { 5,    300 },                        /* gap down across three chunks */
+        { 1085, 1 },                          /* and back up to the end */
+        { 255,  2 },                          /* straddling a chunk edge */
+        { 513,  GAP_CHUNK_UNITS },            /* grow with the gap mid-text */
+        { 1,    GAP_CHUNK_UNITS - 1 },
+        { 1500, 5 * GAP_CHUNK_UNITS + 3 },
+    };
+    for (uint32_t i = 0; i < sizeof(k_edits) / sizeof(k_edits[0]); i++) {
+        fill(src, k_edits[i].n);
+        CHECK(gap_buffer_insert(&g, k_edits[i].pos, src, k_edits[i].n),
+              "span insert %u failed", i);
+        ref_insert(&g_ref, k_edits[i].pos, src, k_edits[i].n);
+        compare(&g, "span insert", i);
+    }
+
+    /* Deletes that pull the gap across the same edges */
+    static const struct { uint32_t pos, n; } k_cuts[] = {
+        { 3, 700 }, { 1800, 300 }, { 254, 3 }, { 0, 257 }, { 900, 700 },
+    };
+    for (uint32_t i = 0; i < sizeof(k_cuts) / sizeof(k_cuts[0]); i++) {
+        gap_buffer_delete(&g, k_cuts[i].pos, k_cuts[i].n);
+        ref_delete(&g_ref, k_cuts[i].pos, k_cuts[i].n);
+        compare(&g, "span delete", i);
+    }
+    gap_buffer_clear(&g);
+}
+
+static void test_limit(void) {
+    static uint16_t src[GAP_MAX_UNITS];
+    GapPool   pool;
+    GapBuffer g;
+
+    gap_pool_init(&pool, g_arena, GAP_POOL_MAX);
+    gap_buffer_init(&g, &pool, 1000);
+    fill(src, 1001);
+
+    CHECK(!gap_buffer_insert(&g, 0, src, 1001), "insert past the limit succeeded");
+    CHECK(gap_buffer_length(&g) == 0 && g.chunk_count == 0, "failed insert changed the buffer");
+    CHECK(gap_buffer_insert(&g, 0, src, 1000), "insert up to the limit failed");
+    CHECK(!gap_buffer_insert(&g, 500, src, 1), "insert past a full limit succeeded");
+    CHECK(gap_buffer_length(&g) == 1000, "length %u after a refused insert",
+          gap_buffer_length(&g));
+
+    /* Deletes are clamped to the text */
+    gap_buffer_delete(&g, 990, 100);
+    CHECK(gap_buffer_length(&g) == 990, "clamped delete left %u units", gap_buffer_length(&g));
+    gap_buffer_delete(&g, 990, 1);
+    CHECK(gap_buffer_length(&g) == 990, "delete at the end removed text");
+    gap_buffer_clear(&g);
+}
+
+/* Two buffers drawing on one pool, as the sessions do */
+static void test_pool(void) {
+    static uint16_t src[GAP_MAX_UNITS];
+    GapPool   pool;
+    GapBuffer a, b;
+    const uint32_t chunks = 20;
+
+    gap_pool_init(&pool, g_arena, chunks);
+    gap_buffer_init(&a, &pool, GAP_MAX_UNITS);
+    gap_buffer_init(&b, &pool, GAP_MAX_UNITS);
+    fill(src, GAP_MAX_UNITS);
+
+    CHECK(gap_buffer_insert(&a, 0, src, GAP_MAX_UNITS), "filling a failed");
+    CHECK(!gap_buffer_insert(&a, 0, src, 1), "a grew past GAP_MAX_CHUNKS");
+    CHECK(gap_buffer_insert(&b, 0, src, 4 * GAP_CHUNK_UNITS), "b failed with chunks free");
+    CHECK(pool.free_count == 0, "%u chunks left, want 0", pool.free_count);
+
+    /* Dry: the insert is refused and b is unchanged */
+    CHECK(!gap_buffer_insert(&b, 7, src, 1), "insert into a dry pool succeeded");
+    CHECK(gap_buffer_length(&b) == 4 * GAP_CHUNK_UNITS && b.chunk_count == 4,
+          "refused insert changed b");
+    CHECK(gap_buffer_at(&b, 7) == src[7], "refused insert moved b's text");
+
+    gap_buffer_clear(&a);
+    CHECK(pool.free_count == GAP_MAX_CHUNKS, "clear gave back %u chunks", pool.free_count);
+    CHECK(gap_buffer_insert(&b, 7, src, 1), "insert after clear failed");
+    gap_buffer_clear(&b);
+    CHECK(pool.free_count == chunks, "%u chunks free after both cleared", pool.free_count);
+}
+
+int main(int argc, char **argv) {
+    test_seed(argc, argv);
+    test_span_move();
+    test_limit();
+    test_pool();
+    test_random(200000);
+    return test_done("gap_buffer");
+}
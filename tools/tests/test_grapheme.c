@@ -0,0 +1,263 @@
+/**
+ * @file test_grapheme.c
+ * @brief Grapheme cluster boundaries against GraphemeBreakTest.txt
+ *
+ * Each test line, in the UCD format ("÷ 0061 × 0308 ÷ 0062 ÷"), is
+ * encoded to UTF-16 and put in a gap buffer with the gap at a random
+ * place. grapheme_is_boundary() must match the ÷/× marks at every unit,
+ * never splitting a surrogate pair; grapheme_after()/_before() from
+ * every position and grapheme_fit() for every length must land on the
+ * marked boundaries.
+ *
+ * The lines come from the file named on the command line, which must be
+ * GraphemeBreakTest.txt of the Unicode version the table was built from
+ * (14.0.0, see src/grapheme_table.c), and from a built-in set covering
+ * each rule. Random strings of the interesting properties are then
+ * checked against a naive forward pass over the rules, which keeps the
+ * emoji and regional-indicator state the library finds by looking back
+ * (GB11, GB12/13).
+ *
+ * Usage: test_grapheme [-s seed] [GraphemeBreakTest.txt]
+ */
+
+#include "test.h"
+#include "grapheme.h"
+
+#define MAX_UNITS 256
+
+static uint16_t g_arena[GAP_POOL_MAX][GAP_CHUNK_UNITS];
+static GapPool  g_pool;
+
+/* ─── Checking one text ───────────────────────────────────────────── */
+
+/* Is boundary[i] for units 0..n; inside a surrogate pair it is false */
+static void check_text(const uint16_t *u, uint32_t n, const bool *boundary, const char *what) {
+    GapBuffer g;
+    gap_buffer_init(&g, &g_pool, GAP_MAX_UNITS);
+
+    /* Tail first, then head in front of it: the gap ends up mid-text */
+    uint32_t split = test_below(n + 1);
+    gap_buffer_insert(&g, 0, u + split, n - split);
+    gap_buffer_insert(&g, 0, u, split);
+
+    for (uint32_t i = 0; i <= n; i++)
+        CHECK(grapheme_is_boundary(&g, i) == boundary[i], "%s: unit %u should %sbe a boundary",
+              what, i, boundary[i] ? "" : "not ");
+
+    for (uint32_t i = 0; i <= n; i++) {
+        uint32_t after = n, before = 0;
+        for (uint32_t k = i + 1; k <= n; k++) if (boundary[k]) { after = k; break; }
+        for (uint32_t k = i; k-- > 0; )       if (boundary[k]) { before = k; break; }
+        CHECK(grapheme_after(&g, i) == after, "%s: after(%u) is %u, want %u",
+              what, i, grapheme_after(&g, i), after);
+        CHECK(grapheme_before(&g, i) == before, "%s: before(%u) is %u, want %u",
+              what, i, grapheme_before(&g, i), before);
+
+        uint32_t fit = i;
+        while (!boundary[fit]) fit--;
+        CHECK(grapheme_fit(u, n, i) == fit, "%s: fit(%u) is %u, want %u",
+              what, i, grapheme_fit(u, n, i), fit);
+    }
+    gap_buffer_clear(&g);
+}
+
+/* ─── Test lines ──────────────────────────────────────────────────── */
+
+/*
+ * Parse "÷ 0061 × 0308 ÷ ..." up to any '#'. Returns false for lines
+ * with no code points (comments and blanks).
+ */
+static bool parse_line(const char *line, uint16_t *u, uint32_t *n, bool *boundary) {
+    *n = 0;
+    for (const char *p = line; *p && *p != '#'; ) {
+        if (strncmp(p, "\xC3\xB7", 2) == 0 || strncmp(p, "\xC3\x97", 2) == 0) {  /* ÷ × */
+            if (*n > MAX_UNITS - 2) return false;
+            boundary[*n] = p[1] == '\xB7';
+            p += 2;
+        } else if ((*p >= '0' && *p <= '9') || (*p >= 'A' && *p <= 'F')) {
+            char *end;
+            uint32_t cp = (uint32_t)strtoul(p, &end, 16);
+            p = end;
+            if (cp >= 0x10000) {
+                cp -= 0x10000;
+                u[(*n)++] = (uint16_t)(0xD800 + (cp >> 10));
+                boundary[*n] = false;
+                u[(*n)++] = (uint16_t)(0xDC00 + (cp & 0x3FF));
+            } else {
+                u[(*n)++] = (uint16_t)cp;
+            }
+        } else {
+            p++;
+        }
+    }
+    return *n > 0;
+}
+
+/* One line per rule, in the order UAX #29 applies them */
+static const char *const k_lines[] = {
+    "÷ 0061 ÷ 0062 ÷",                                  /* GB999 */
+    "÷ 000D × 000A ÷ 0061 ÷ 000A ÷ 000D ÷",             /* GB3-5 */
+    "÷ 0001 ÷ 0308 ÷ 0061 ÷ 0001 ÷",                    /* GB4/5 before marks */
+    "÷ 1100 × 1161 × 11A8 ÷ 1100 × AC00 × 11A8 ÷ AC01 × 11A8 ÷ 0061 ÷",  /* GB6-8 */
+    "÷ 1161 × 1161 ÷ 1100 ÷ 11A8 ÷ 1161 ÷",             /* V V, T then V does not join */
+    "÷ 0061 × 0308 × 200D ÷ 0062 ÷",                    /* GB9 */
+    "÷ 0061 × 0903 ÷ 0600 × 0062 ÷",                    /* GB9a, GB9b */
+    "÷ 0600 ÷ 000A ÷",                                  /* GB5 before GB9b */
+    "÷ 1F476 × 1F3FF × 0308 × 200D × 1F476 × 1F3FF ÷",  /* GB11, Extend* look-behind */
+    "÷ 2701 × 200D × 2701 ÷",                           /* GB11 in the BMP */
+    "÷ 00A9 × 200D × 1F476 ÷ 0061 ÷",
+    "÷ 0061 × 200D ÷ 1F6D1 ÷",                          /* GB11 needs a pictograph */
+    "÷ 1F6D1 × 200D × 200D ÷ 1F6D1 ÷",                  /* and ZWJ is not Extend */
+    "÷ 1F6D1 × 0308 ÷ 0061 × 200D ÷ 1F6D1 ÷",           /* look-behind stops at a */
+    "÷ 1F1E6 × 1F1E8 ÷ 1F1E6 × 1F1E8 ÷ 1F1E6 ÷",        /* GB12/13 */
+    "÷ 0061 ÷ 1F1E6 × 1F1E8 ÷ 1F1E6 × 0308 ÷ 1F1E8 ÷",
+    "÷ 0061 × 0308 ÷ 1F1E6 × 1F1E8 × 200D ÷ 1F1E6 ÷",
+    "÷ 1F476 × 1F3FF ÷ 1F476 ÷",
+    "÷ D800 ÷ 0308 ÷ 0061 ÷ DC00 ÷",                    /* lone surrogates are controls */
+    "÷ 0020 ÷ 0020 ÷",
+};
+
+static void check_line(const char *line, const char *what) {
+    uint16_t u[MAX_UNITS];
+    bool     boundary[MAX_UNITS + 1];
+    uint32_t n;
+    if (parse_line(line, u, &n, boundary)) check_text(u, n, boundary, what);
+}
+
+static uint32_t run_file(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "cannot open %s\n", path);
+        g_test_failures++;
+        return 0;
+    }
+    char     line[4096], what[64];
+    uint32_t number = 0, lines = 0;
+    while (fgets(line, sizeof(line), f)) {
+        number++;
+        if (line[0] == '#' || line[0] == '\n') continue;
+        snprintf(what, sizeof(what), "line %u", number);
+        check_line(line, what);
+        lines++;
+    }
+    fclose(f);
+    return lines;
+}
+
+/* ─── Naive reference ─────────────────────────────────────────────── */
+
+/*
+ * The rules applied left to right over decoded code points, carrying
+ * what GB11 and GB12/13 need forward instead of looking back.
+ */
+static void ref_boundaries(const uint16_t *u, uint32_t n, bool *boundary) {
+    uint8_t  prev = 0;
+    bool     have_prev = false;
+    bool     picto_run = false;     /* text so far ends ExtPict Extend* */
+    bool     emoji_zwj = false;     /* ... ends ExtPict Extend* ZWJ */
+    uint32_t ri_run    = 0;         /* regional indicators at the end */
+
+    for (uint32_t i = 0; i <= n; i++) boundary[i] = false;
+    boundary[0] = boundary[n] = true;
+
+    for (uint32_t i = 0; i < n; ) {
+        uint32_t cp = u[i], len = 1;
+        uint8_t  p;
+        if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < n && u[i + 1] >= 0xDC00 && u[i + 1] <= 0xDFFF) {
+            cp  = 0x10000 + ((cp - 0xD800) << 10) + (u[i + 1] - 0xDC00);
+            len = 2;
+            p   = grapheme_prop(cp);
+        } else {
+            p = (cp >= 0xD800 && cp <= 0xDFFF) ? GRAPHEME_CONTROL : grapheme_prop(cp);
+        }
+
+        if (have_prev) {
+            uint8_t l = prev & GRAPHEME_PROP_MASK, r = p & GRAPHEME_PROP_MASK;
+            bool brk;
+            if (l == GRAPHEME_CR && r == GRAPHEME_LF)                               brk = false;
+            else if (l == GRAPHEME_CR || l == GRAPHEME_LF || l == GRAPHEME_CONTROL) brk = true;
+            else if (r == GRAPHEME_CR || r == GRAPHEME_LF || r == GRAPHEME_CONTROL) brk = true;
+            else if (l == GRAPHEME_L && (r == GRAPHEME_L || r == GRAPHEME_V ||
+                                         r == GRAPHEME_LV || r == GRAPHEME_LVT))    brk = false;
+            else if ((l == GRAPHEME_LV || l == GRAPHEME_V) &&
+                     (r == GRAPHEME_V || r == GRAPHEME_T))                          brk = false;
+            else if ((l == GRAPHEME_LVT || l == GRAPHEME_T) && r == GRAPHEME_T)     brk = false;
+            else if (r == GRAPHEME_EXTEND || r == GRAPHEME_ZWJ)                     brk = false;
+            else if (r == GRAPHEME_SPACING_MARK)                                    brk = false;
+            else if (l == GRAPHEME_PREPEND)                                         brk = false;
+            else if (emoji_zwj && (p & GRAPHEME_PICTO))                             brk = false;
+            else if (l == GRAPHEME_RI && r == GRAPHEME_RI)                          brk = (ri_run & 1) == 0;
+            else                                                                    brk = true;
+            boundary[i] = brk;
+        }
+
+        uint8_t r = p & GRAPHEME_PROP_MASK;
+        emoji_zwj = picto_run && r == GRAPHEME_ZWJ;
+        picto_run = (p & GRAPHEME_PICTO) || (picto_run && r == GRAPHEME_EXTEND);
+        ri_run    = r == GRAPHEME_RI ? ri_run + 1 : 0;
+        prev      = p;
+        have_prev = true;
+        i += len;
+    }
+}
+
+/* Units with every property the rules look at, lone surrogates included */
+static const uint32_t k_points[] = {
+    0x0061, 0x0020, 0x000D, 0x000A, 0x0001,     /* Other, CR, LF, Control */
+    0x0308, 0x1F3FF, 0x200D,                    /* Extend, Extend (modifier), ZWJ */
+    0x1F1E6, 0x1F1E8, 0x1F1E6, 0x1F1E8,         /* RI, weighted up */
+    0x0600, 0x0903,                             /* Prepend, SpacingMark */
+    0x1100, 0x1161, 0x11A8, 0xAC00, 0xAC01,     /* L V T LV LVT */
+    0x1F476, 0x1F6D1, 0x2701, 0x00A9,           /* Extended_Pictographic */
+    0xD800, 0xDC00,                             /* lone surrogates */
+};
+
+static void test_random(uint32_t strings) {
+    uint16_t u[MAX_UNITS];
+    bool     boundary[MAX_UNITS + 1];
+    char     what[32];
+
+    for (uint32_t s = 0; s < strings; s++) {
+        uint32_t n = 0, count = 1 + test_below(24);
+        for (uint32_t k = 0; k < count; k++) {
+            uint32_t cp = k_points[test_below(sizeof(k_points) / sizeof(k_points[0]))];
+            if (cp >= 0x10000) {
+                u[n++] = (uint16_t)(0xD800 + ((cp - 0x10000) >> 10));
+                u[n++] = (uint16_t)(0xDC00 + ((cp - 0x10000) & 0x3FF));
+            } else {
+                u[n++] = (uint16_t)cp;
+            }
+        }
+        ref_boundaries(u, n, boundary);
+        snprintf(what, sizeof(what), "random %u", s);
+        check_text(u, n, boundary, what);
+    }
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0) i++;
+        else path = argv[i];
+    }
+    test_seed(argc, argv);
+    gap_pool_init(&g_pool, g_arena, GAP_POOL_MAX);
+
+    /* The built-in lines also check the reference before it is used */
+    for (uint32_t i = 0; i < sizeof(k_lines) / sizeof(k_lines[0]); i++) {
+        uint16_t u[MAX_UNITS];
+        bool     boundary[MAX_UNITS + 1], ref[MAX_UNITS + 1];
+        uint32_t n;
+        char     what[32];
+        parse_line(k_lines[i], u, &n, boundary);
+        ref_boundaries(u, n, ref);
+        CHECK(memcmp(boundary, ref, n + 1) == 0, "reference disagrees with built-in line %u", i);
+        snprintf(what, sizeof(what), "built-in line %u", i);
+        check_text(u, n, boundary, what);
+    }
+    if (path) printf("grapheme: %u lines from %s\n", run_file(path), path);
+    else      printf("grapheme: no GraphemeBreakTest.txt given, built-in lines only\n");
+
+    test_random(100000);
+    return test_done("grapheme");
+}
@@ -0,0 +1,321 @@
+/**
+ * @file test_ime_journal.c
+ * @brief Undo/redo journal against snapshots of the text
+ *
+ * Random sessions of typing, backspace runs, cursor moves, pastes,
+ * forward deletes and replacements, recorded the way ime_custom.c
+ * records them. The text is saved after every edit. Undoing everything
+ * must then walk back through those snapshots, newest first, and redo
+ * must walk forward through them to the final text. Sessions long
+ * enough to overflow the rings only need to reach some earlier
+ * snapshot; short ones must get back to where they started.
+ *
+ * Fixed cases cover a backspace run over surrogate pairs (a reversed
+ * payload put back by restore), and the oldest op dropped out from
+ * under a joined replacement, which leaves its insert to undo alone.
+ *
+ * Usage: test_ime_journal [-s seed]
+ */
+
+#include "test.h"
+#include "ime_journal.h"
+
+static uint16_t   g_arena[GAP_POOL_MAX][GAP_CHUNK_UNITS];
+static GapPool    g_pool;
+static GapBuffer  g_text;
+static ImeJournal g_journal;
+static uint32_t   g_cursor;
+
+/* ─── Snapshots ───────────────────────────────────────────────────── */
+
+#define MAX_SNAPS 512
+
+typedef struct Snap {
+    uint32_t  len;
+    uint16_t *u;
+} Snap;
+
+static Snap     g_snaps[MAX_SNAPS];
+static uint32_t g_snap_count;
+
+static void snap_clear(void) {
+    for (uint32_t i = 0; i < g_snap_count; i++) free(g_snaps[i].u);
+    g_snap_count = 0;
+}
+
+static void snap_take(void) {
+    if (g_snap_count == MAX_SNAPS) return;
+    Snap *s = &g_snaps[g_snap_count++];
+    s->len = gap_buffer_length(&g_text);
+    s->u   = malloc((s->len + 1) * sizeof(uint16_t));
+    gap_buffer_copy(&g_text, 0, s->len, s->u);
+}
+
+static bool snap_equal(uint32_t i) {
+    static uint16_t out[GAP_MAX_UNITS];
+    uint32_t len = gap_buffer_length(&g_text);
+    if (len != g_snaps[i].len) return false;
+    gap_buffer_copy(&g_text, 0, len, out);
+    return memcmp(out, g_snaps[i].u, len * sizeof(uint16_t)) == 0;
+}
+
+/* ─── Edits, recorded as the session records them ─────────────────── */
+
+static uint32_t room(void) {
+    return GAP_MAX_UNITS - gap_buffer_length(&g_text);
+}
+
+static void edit_insert(uint32_t pos, const uint16_t *src, uint32_t n, bool joined) {
+    gap_buffer_insert(&g_text, pos, src, n);
+    ime_journal_insert(&g_journal, &g_text, pos, n, joined);
+    g_cursor = pos + n;
+    snap_take();
+}
+
+static void edit_delete(uint32_t pos, uint32_t n, bool joined) {
+    ime_journal_delete(&g_journal, &g_text, pos, n, joined);
+    gap_buffer_delete(&g_text, pos, n);
+    g_cursor = pos;
+    snap_take();
+}
+
+static void move_to(uint32_t pos) {
+    g_cursor = pos;
+    ime_journal_seal(&g_journal);
+}
+
+static void reset(void) {
+    gap_buffer_clear(&g_text);
+    ime_journal_reset(&g_journal);
+    snap_clear();
+    g_cursor = 0;
+    snap_take();
+}
+
+/* Letters and spaces, so words end and coalescing restarts */
+static uint16_t random_unit(void) {
+    static const char k_chars[] = "abcdefg   ";
+    return (uint16_t)k_chars[test_below(sizeof(k_chars) - 1)];
+}
+
+static void random_units(uint16_t *dst, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) dst[i] = random_unit();
+}
+
+static void random_edit(uint32_t max_paste) {
+    uint16_t src[GAP_MAX_UNITS];
+    uint32_t len = gap_buffer_length(&g_text);
+    uint32_t r   = test_below(100);
+
+    if (r < 40) {
+        /* Type a character, now and then an emoji (a surrogate pair) */
+        uint32_t n = test_below(10) ? 1 : 2;
+        if (n == 1) src[0] = random_unit();
+        else { src[0] = 0xD83D; src[1] = 0xDE00; }
+        if (room() >= n) edit_insert(g_cursor, src, n, false);
+    } else if (r < 65) {
+        /* Backspace one cluster */
+        if (g_cursor == 0) return;
+        uint32_t n = (g_cursor >= 2 && test_below(4) == 0) ? 2 : 1;
+        edit_delete(g_cursor - n, n, false);
+    } else if (r < 75) {
+        move_to(test_below(len + 1));
+    } else if (r < 83) {
+        uint32_t n = 2 + test_below(max_paste);
+        if (n > room()) return;
+        random_units(src, n);
+        edit_insert(g_cursor, src, n, false);
+    } else if (r < 88) {
+        if (g_cursor == len) return;
+        uint32_t n = 1 + test_below(len - g_cursor < 40 ? len - g_cursor : 40);
+        edit_delete(g_cursor, n, false);
+    } else {
+        /* Replace a selection: delete, then an insert joined to it */
+        if (len == 0) return;
+        uint32_t a = test_below(len);
+        uint32_t n = 1 + test_below(len - a < max_paste ? len - a : max_paste);
+        uint32_t m = 1 + test_below(max_paste);
+        ime_journal_seal(&g_journal);
+        edit_delete(a, n, false);
+        if (m > room()) return;
+        random_units(src, m);
+        edit_insert(a, src, m, true);
+    }
+}
+
+/* ─── Undo and redo against the snapshots ─────────────────────────── */
+
+/*
+ * Undo to the start, then redo to the end. Each step must land on a
+ * snapshot strictly before (undo) or after (redo) the previous one; the
+ * latest (earliest) match is taken, which is never wrong even if two
+ * snapshots hold the same text.
+ */
+static void walk(uint32_t round, bool must_reach_start) {
+    uint32_t at = g_snap_count - 1, steps = 0, cursor;
+
+    while (ime_journal_undo(&g_journal, &g_text, &cursor)) {
+        steps++;
+        CHECK(cursor <= gap_buffer_length(&g_text), "round %u: undo cursor %u past the text",
+              round, cursor);
+        uint32_t i = at;
+        while (i > 0 && !snap_equal(i - 1)) i--;
+        CHECK(i > 0, "round %u: undo %u gave text that was never there", round, steps);
+        if (i == 0) return;
+        at = i - 1;
+    }
+    CHECK(steps <= IME_JOURNAL_OPS, "round %u: %u undo steps from %u ops", round, steps,
+          IME_JOURNAL_OPS);
+    if (must_reach_start)
+        CHECK(at == 0, "round %u: undo stopped at snapshot %u, not the start", round, at);
+
+    uint32_t redos = 0;
+    while (ime_journal_redo(&g_journal, &g_text, &cursor)) {
+        redos++;
+        CHECK(cursor <= gap_buffer_length(&g_text), "round %u: redo cursor %u past the text",
+              round, cursor);
+        uint32_t i = at + 1;
+        while (i < g_snap_count && !snap_equal(i)) i++;
+        CHECK(i < g_snap_count, "round %u: redo %u gave text that was never there", round, redos);
+        if (i == g_snap_count) return;
+        at = i;
+    }
+    CHECK(redos == steps, "round %u: %u undos but %u redos", round, steps, redos);
+    CHECK(at == g_snap_count - 1, "round %u: redo stopped at snapshot %u of %u", round, at,
+          g_snap_count - 1);
+}
+
+static void test_random(uint32_t rounds) {
+    uint32_t dropped = 0;
+
+    for (uint32_t round = 0; round < rounds; round++) {
+        /* Short rounds fit the rings; long ones overflow and wrap them */
+        bool     short_round = (round & 1) == 0;
+        uint32_t edits       = short_round ? 1 + test_below(30) : 100 + test_below(300);
+        uint32_t max_paste   = short_round ? 40 : 600;
+
+        reset();
+        for (uint32_t i = 0; i < edits && g_snap_count < MAX_SNAPS - 2; i++)
+            random_edit(max_paste);
+        bool kept_all = g_journal.first == 0;
+        if (!kept_all) dropped++;
+        walk(round, kept_all);
+
+        /* Undo part way, then edit: nothing is left to redo */
+        uint32_t cursor, k = test_below(4);
+        for (uint32_t i = 0; i < k; i++) ime_journal_undo(&g_journal, &g_text, &cursor);
+        snap_clear();
+        snap_take();
+        uint16_t c = 'z';
+        edit_insert(gap_buffer_length(&g_text), &c, 1, false);
+        CHECK(!ime_journal_redo(&g_journal, &g_text, &cursor), "round %u: redo after a new edit",
+              round);
+        CHECK(ime_journal_undo(&g_journal, &g_text, &cursor) && snap_equal(0),
+              "round %u: undo of the new edit", round);
+    }
+    CHECK(dropped > rounds / 4, "only %u rounds overflowed the journal", dropped);
+}
+
+/* ─── Fixed cases ─────────────────────────────────────────────────── */
+
+static void put_ascii(uint32_t pos, const char *s, bool joined) {
+    uint16_t src[256];
+    uint32_t n = 0;
+    while (s[n]) { src[n] = (uint16_t)s[n]; n++; }
+    edit_insert(pos, src, n, joined);
+}
+
+/* Backspaces over single units and surrogate pairs, one reversed op */
+static void test_backspace_run(void) {
+    uint16_t src[80];
+    uint32_t n = 0, cursor;
+
+    reset();
+    for (uint32_t i = 0; i < 25; i++) {
+        src[n++] = (uint16_t)('a' + i);
+        src[n++] = 0xD83D;
+        src[n++] = (uint16_t)(0xDE00 + i);
+    }
+    edit_insert(0, src, n, false);
+    move_to(n);
+
+    /* Pair, letter, pair, letter...: up to the coalescing limit */
+    uint32_t deleted = 0;
+    while (deleted < IME_JOURNAL_COALESCE_MAX - 2) {
+        uint32_t k = (deleted % 3 == 0) ? 2 : 1;
+        edit_delete(g_cursor - k, k, false);
+        deleted += k;
+    }
+    CHECK(g_journal.count == 2, "backspace run made %u ops, want 2", g_journal.count);
+    CHECK(g_journal.ops[1].reversed, "backspace run payload not reversed");
+
+    CHECK(ime_journal_undo(&g_journal, &g_text, &cursor) && snap_equal(1),
+          "undoing the backspace run did not restore the text");
+    CHECK(cursor == n, "cursor %u after undo, want %u", cursor, n);
+    CHECK(ime_journal_redo(&g_journal, &g_text, &cursor) && snap_equal(g_snap_count - 1),
+          "redoing the backspace run");
+    CHECK(cursor == n - deleted, "cursor %u after redo, want %u", cursor, n - deleted);
+
+    /* Past the limit the run goes on in a new op */
+    move_to(g_cursor);
+    for (uint32_t i = 0; i < IME_JOURNAL_COALESCE_MAX + 4 && g_cursor > 0; i++)
+        edit_delete(g_cursor - 1, 1, false);
+    CHECK(g_journal.count == 4, "long backspace run made %u ops, want 4", g_journal.count);
+    walk(0, true);
+}
+
+/*
+ * Fill the ring with replacements (delete + joined insert), then one
+ * more op: the oldest delete is dropped and its insert, now first, must
+ * undo and redo on its own.
+ */
+static void test_drop_unjoins(void) {
+    uint32_t cursor;
+
+    reset();
+    put_ascii(0, "0123456789", false);
+    ime_journal_reset(&g_journal);
+    snap_clear();
+    snap_take();
+
+    for (uint32_t i = 0; i < IME_JOURNAL_OPS / 2; i++) {
+        char word[2] = { (char)('a' + i % 26), 0 };
+        ime_journal_seal(&g_journal);
+        edit_delete(i % 10, 1, false);
+        put_ascii(i % 10, word, true);
+    }
+    CHECK(g_journal.count == IME_JOURNAL_OPS && g_journal.first == 0, "ring not full");
+
+    move_to(0);
+    put_ascii(0, "x", false);
+    const ImeJournalOp *oldest = &g_journal.ops[g_journal.first % IME_JOURNAL_OPS];
+    CHECK(g_journal.first == 1, "%u ops dropped, want 1", g_journal.first);
+    CHECK(oldest->kind == IME_JOURNAL_INSERT && !oldest->joined,
+          "orphaned insert still joined to a dropped op");
+
+    /* 1 typed insert, 31 whole replacements, then the orphan alone */
+    uint32_t undos = 0;
+    while (ime_journal_undo(&g_journal, &g_text, &cursor)) undos++;
+    CHECK(undos == IME_JOURNAL_OPS / 2 + 1, "%u undo steps, want %u", undos,
+          IME_JOURNAL_OPS / 2 + 1);
+    CHECK(snap_equal(1), "undo stopped short of the dropped delete's text");
+
+    CHECK(ime_journal_redo(&g_journal, &g_text, &cursor) && snap_equal(2),
+          "first redo did not reapply the orphan alone");
+    uint32_t redos = 1;
+    while (ime_journal_redo(&g_journal, &g_text, &cursor)) redos++;
+    CHECK(redos == undos, "%u redos, want %u", redos, undos);
+    CHECK(snap_equal(g_snap_count - 1), "redo did not reach the last edit");
+}
+
+int main(int argc, char **argv) {
+    test_seed(argc, argv);
+    gap_pool_init(&g_pool, g_arena, GAP_POOL_MAX);
+    gap_buffer_init(&g_text, &g_pool, GAP_MAX_UNITS);
+
+    test_backspace_run();
+    test_drop_unjoins();
+    test_random(4000);
+    snap_clear();
+    return test_done("ime_journal");
+}
@@ -0,0 +1,139 @@
+/**
+ * @file test_word_index.c
+ * @brief Word-start index against a scan of a flat reference array
+ *
+ * Random inserts and deletes of 1 to a few hundred units, anywhere in a
+ * text of up to GAP_MAX_UNITS, so the bit shifts in word_index_insert()
+ * and word_index_delete() cross 64-bit words by every amount and run
+ * into the top word. After each edit the bits must equal those worked
+ * out from RefText directly (and from word_index_rebuild()), including
+ * zeros past the end of the text, and word_index_before()/_after() must
+ * agree with a linear scan.
+ *
+ * Usage: test_word_index [-s seed]
+ */
+
+#include "test.h"
+#include "word_index.h"
+
+static uint16_t  g_arena[GAP_POOL_MAX][GAP_CHUNK_UNITS];
+static RefText   g_ref;
+
+/* ─── Reference ───────────────────────────────────────────────────── */
+
+static bool ref_start(uint32_t i) {
+    return i < g_ref.len && word_index_is_word(g_ref.u[i]) &&
+           (i == 0 || !word_index_is_word(g_ref.u[i - 1]));
+}
+
+static uint32_t ref_before(uint32_t pos) {
+    for (uint32_t i = pos; i-- > 0; )
+        if (ref_start(i)) return i;
+    return 0;
+}
+
+static uint32_t ref_after(uint32_t pos) {
+    for (uint32_t i = pos + 1; i < g_ref.len; i++)
+        if (ref_start(i)) return i;
+    return g_ref.len;
+}
+
+/* ─── Checks ──────────────────────────────────────────────────────── */
+
+static void compare(const WordIndex *w, const GapBuffer *g, uint32_t step) {
+    WordIndex rebuilt;
+    word_index_rebuild(&rebuilt, g);
+
+    for (uint32_t k = 0; k < WORD_INDEX_WORDS; k++) {
+        uint64_t want = 0;
+        for (uint32_t b = 0; b < 64; b++)
+            if (ref_start(k * 64 + b)) want |= 1ull << b;
+        CHECK(w->starts[k] == want, "step %u: word %u is %016llx, want %016llx", step, k,
+              (unsigned long long)w->starts[k], (unsigned long long)want);
+        CHECK(rebuilt.starts[k] == want, "step %u: rebuilt word %u differs", step, k);
+    }
+
+    /* Every position in a short text; elsewhere, around the 64-bit edges */
+    uint32_t len = g_ref.len;
+    for (uint32_t n = 0; n < 48; n++) {
+        uint32_t pos;
+        if (len <= 48)       pos = n;
+        else if (n < 16)     pos = test_below(len + 1);
+        else {
+            uint32_t edge = (test_below(len / 64 + 1)) * 64;
+            pos = edge + (n % 5) - 2;
+            if (pos > len) pos = len;
+        }
+        CHECK(word_index_before(w, pos) == ref_before(pos), "step %u: before(%u) is %u, want %u",
+              step, pos, word_index_before(w, pos), ref_before(pos));
+        CHECK(word_index_after(w, pos, len) == ref_after(pos), "step %u: after(%u) is %u, want %u",
+              step, pos, word_index_after(w, pos, len), ref_after(pos));
+    }
+}
+
+/* ─── Random edits ────────────────────────────────────────────────── */
+
+/* Word and non-word units in runs, with the edges of the word range */
+static uint16_t random_unit(void) {
+    static const uint16_t k_units[] = {
+        'a', 'z', 'A', '0', '9', '\'', '_', 0xC0, 0x3042, 0xAC00,   /* word */
+        ' ', ' ', '.', '-', '\n', 0xBF, 0xD7, 0xF7,                 /* not */
+    };
+    return k_units[test_below(sizeof(k_units) / sizeof(k_units[0]))];
+}
+
+static uint32_t random_size(void) {
+    uint32_t r = test_below(100);
+    if (r < 50) return 1 + test_below(3);
+    if (r < 85) return 1 + test_below(130);
+    return 1 + test_below(700);
+}
+
+static void test_random(uint32_t steps) {
+    static uint16_t src[GAP_MAX_UNITS];
+    GapPool   pool;
+    GapBuffer g;
+    WordIndex w;
+
+    gap_pool_init(&pool, g_arena, GAP_POOL_MAX);
+    gap_buffer_init(&g, &pool, GAP_MAX_UNITS);
+    word_index_rebuild(&w, &g);
+    g_ref.len = 0;
+
+    for (uint32_t step = 0; step < steps; step++) {
+        /* Grow toward the limit, then hover near it */
+        bool grow = g_ref.len < GAP_MAX_UNITS / 2 ? test_below(100) < 65 : test_below(100) < 55;
+        uint32_t n = random_size();
+
+        if (grow) {
+            if (n > GAP_MAX_UNITS - g_ref.len) n = GAP_MAX_UNITS - g_ref.len;
+            if (n == 0) continue;
+            uint32_t pos = test_below(g_ref.len + 1);
+
+            /* Runs, so words of every length land on every bit offset */
+            uint16_t c = random_unit();
+            for (uint32_t i = 0; i < n; i++) {
+                if (test_below(6) == 0) c = random_unit();
+                src[i] = c;
+            }
+            gap_buffer_insert(&g, pos, src, n);
+            word_index_insert(&w, &g, pos, n);
+            ref_insert(&g_ref, pos, src, n);
+        } else {
+            if (g_ref.len == 0) continue;
+            uint32_t pos = test_below(g_ref.len);
+            if (n > g_ref.len - pos) n = g_ref.len - pos;
+            gap_buffer_delete(&g, pos, n);
+            word_index_delete(&w, &g, pos, n);
+            ref_delete(&g_ref, pos, n);
+        }
+        CHECK(ref_equal(&g_ref, &g), "step %u: text differs", step);
+        compare(&w, &g, step);
+    }
+}
+
+int main(int argc, char **argv) {
+    test_seed(argc, argv);
+    test_random(40000);
+    return test_done("word_index");
+}